@@ -22,6 +22,7 @@ class UniqueIdServiceIf {
  public:
   virtual ~UniqueIdServiceIf() {}
   virtual void UploadUniqueId(const int64_t req_id, const std::map<std::string, std::string> & carrier) = 0;
+  virtual void ComposeUniqueIds(std::vector<int64_t> & _return, const int64_t req_id, const int32_t num_ids, const std::map<std::string, std::string> & carrier) = 0;
 };
 
 class UniqueIdServiceIfFactory {
@@ -54,6 +55,9 @@ class UniqueIdServiceNull : virtual public UniqueIdServiceIf {
   void UploadUniqueId(const int64_t /* req_id */, const std::map<std::string, std::string> & /* carrier */) {
     return;
   }
+  void ComposeUniqueIds(std::vector<int64_t> & /* _return */, const int64_t /* req_id */, const int32_t /* num_ids */, const std::map<std::string, std::string> & /* carrier */) {
+    return;
+  }
 };
 
 typedef struct _UniqueIdService_UploadUniqueId_args__isset {
@@ -167,6 +171,132 @@ class UniqueIdService_UploadUniqueId_presult {
 
 };
 
+typedef struct _UniqueIdService_ComposeUniqueIds_args__isset {
+  _UniqueIdService_ComposeUniqueIds_args__isset() : req_id(false), num_ids(false), carrier(false) {}
+  bool req_id :1;
+  bool num_ids :1;
+  bool carrier :1;
+} _UniqueIdService_ComposeUniqueIds_args__isset;
+
+class UniqueIdService_ComposeUniqueIds_args {
+ public:
+
+  UniqueIdService_ComposeUniqueIds_args(const UniqueIdService_ComposeUniqueIds_args&);
+  UniqueIdService_ComposeUniqueIds_args& operator=(const UniqueIdService_ComposeUniqueIds_args&);
+  UniqueIdService_ComposeUniqueIds_args() : req_id(0), num_ids(0) {
+  }
+
+  virtual ~UniqueIdService_ComposeUniqueIds_args() throw();
+  int64_t req_id;
+  int32_t num_ids;
+  std::map<std::string, std::string>  carrier;
+
+  _UniqueIdService_ComposeUniqueIds_args__isset __isset;
+
+  void __set_req_id(const int64_t val);
+
+  void __set_num_ids(const int32_t val);
+
+  void __set_carrier(const std::map<std::string, std::string> & val);
+
+  bool operator == (const UniqueIdService_ComposeUniqueIds_args & rhs) const
+  {
+    if (!(req_id == rhs.req_id))
+      return false;
+    if (!(num_ids == rhs.num_ids))
+      return false;
+    if (!(carrier == rhs.carrier))
+      return false;
+    return true;
+  }
+  bool operator != (const UniqueIdService_ComposeUniqueIds_args &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const UniqueIdService_ComposeUniqueIds_args & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+
+class UniqueIdService_ComposeUniqueIds_pargs {
+ public:
+
+
+  virtual ~UniqueIdService_ComposeUniqueIds_pargs() throw();
+  const int64_t* req_id;
+  const int32_t* num_ids;
+  const std::map<std::string, std::string> * carrier;
+
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+typedef struct _UniqueIdService_ComposeUniqueIds_result__isset {
+  _UniqueIdService_ComposeUniqueIds_result__isset() : success(false), se(false) {}
+  bool success :1;
+  bool se :1;
+} _UniqueIdService_ComposeUniqueIds_result__isset;
+
+class UniqueIdService_ComposeUniqueIds_result {
+ public:
+
+  UniqueIdService_ComposeUniqueIds_result(const UniqueIdService_ComposeUniqueIds_result&);
+  UniqueIdService_ComposeUniqueIds_result& operator=(const UniqueIdService_ComposeUniqueIds_result&);
+  UniqueIdService_ComposeUniqueIds_result() {
+  }
+
+  virtual ~UniqueIdService_ComposeUniqueIds_result() throw();
+  std::vector<int64_t>  success;
+  ServiceException se;
+
+  _UniqueIdService_ComposeUniqueIds_result__isset __isset;
+
+  void __set_success(const std::vector<int64_t> & val);
+
+  void __set_se(const ServiceException& val);
+
+  bool operator == (const UniqueIdService_ComposeUniqueIds_result & rhs) const
+  {
+    if (!(success == rhs.success))
+      return false;
+    if (!(se == rhs.se))
+      return false;
+    return true;
+  }
+  bool operator != (const UniqueIdService_ComposeUniqueIds_result &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const UniqueIdService_ComposeUniqueIds_result & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+typedef struct _UniqueIdService_ComposeUniqueIds_presult__isset {
+  _UniqueIdService_ComposeUniqueIds_presult__isset() : success(false), se(false) {}
+  bool success :1;
+  bool se :1;
+} _UniqueIdService_ComposeUniqueIds_presult__isset;
+
+class UniqueIdService_ComposeUniqueIds_presult {
+ public:
+
+
+  virtual ~UniqueIdService_ComposeUniqueIds_presult() throw();
+  std::vector<int64_t> * success;
+  ServiceException se;
+
+  _UniqueIdService_ComposeUniqueIds_presult__isset __isset;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+
+};
+
 class UniqueIdServiceClient : virtual public UniqueIdServiceIf {
  public:
   UniqueIdServiceClient(apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> prot) {
@@ -195,6 +325,9 @@ class UniqueIdServiceClient : virtual public UniqueIdServiceIf {
   void UploadUniqueId(const int64_t req_id, const std::map<std::string, std::string> & carrier);
   void send_UploadUniqueId(const int64_t req_id, const std::map<std::string, std::string> & carrier);
   void recv_UploadUniqueId();
+  void ComposeUniqueIds(std::vector<int64_t> & _return, const int64_t req_id, const int32_t num_ids, const std::map<std::string, std::string> & carrier);
+  void send_ComposeUniqueIds(const int64_t req_id, const int32_t num_ids, const std::map<std::string, std::string> & carrier);
+  void recv_ComposeUniqueIds(std::vector<int64_t> & _return);
  protected:
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> piprot_;
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> poprot_;
@@ -211,10 +344,12 @@ class UniqueIdServiceProcessor : public ::apache::thrift::TDispatchProcessor {
   typedef std::map<std::string, ProcessFunction> ProcessMap;
   ProcessMap processMap_;
   void process_UploadUniqueId(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
+  void process_ComposeUniqueIds(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
  public:
   UniqueIdServiceProcessor(::apache::thrift::stdcxx::shared_ptr<UniqueIdServiceIf> iface) :
     iface_(iface) {
     processMap_["UploadUniqueId"] = &UniqueIdServiceProcessor::process_UploadUniqueId;
+    processMap_["ComposeUniqueIds"] = &UniqueIdServiceProcessor::process_ComposeUniqueIds;
   }
 
   virtual ~UniqueIdServiceProcessor() {}
@@ -252,6 +387,16 @@ class UniqueIdServiceMultiface : virtual public UniqueIdServiceIf {
     ifaces_[i]->UploadUniqueId(req_id, carrier);
   }
 
+  void ComposeUniqueIds(std::vector<int64_t> & _return, const int64_t req_id, const int32_t num_ids, const std::map<std::string, std::string> & carrier) {
+    size_t sz = ifaces_.size();
+    size_t i = 0;
+    for (; i < (sz - 1); ++i) {
+      ifaces_[i]->ComposeUniqueIds(_return, req_id, num_ids, carrier);
+    }
+    ifaces_[i]->ComposeUniqueIds(_return, req_id, num_ids, carrier);
+    return;
+  }
+
 };
 
 // The 'concurrent' client is a thread safe client that correctly handles
@@ -285,6 +430,9 @@ class UniqueIdServiceConcurrentClient : virtual public UniqueIdServiceIf {
   void UploadUniqueId(const int64_t req_id, const std::map<std::string, std::string> & carrier);
   int32_t send_UploadUniqueId(const int64_t req_id, const std::map<std::string, std::string> & carrier);
   void recv_UploadUniqueId(const int32_t seqid);
+  void ComposeUniqueIds(std::vector<int64_t> & _return, const int64_t req_id, const int32_t num_ids, const std::map<std::string, std::string> & carrier);
+  int32_t send_ComposeUniqueIds(const int64_t req_id, const int32_t num_ids, const std::map<std::string, std::string> & carrier);
+  void recv_ComposeUniqueIds(std::vector<int64_t> & _return, const int32_t seqid);
  protected:
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> piprot_;
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> poprot_;
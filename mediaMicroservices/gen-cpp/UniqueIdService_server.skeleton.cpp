@@ -25,6 +25,11 @@ class UniqueIdServiceHandler : virtual public UniqueIdServiceIf {
     printf("UploadUniqueId\n");
   }
 
+  void ComposeUniqueIds(std::vector<int64_t> & _return, const int64_t req_id, const int32_t num_ids, const std::map<std::string, std::string> & carrier) {
+    // Your implementation goes here
+    printf("ComposeUniqueIds\n");
+  }
+
 };
 
 int main(int argc, char **argv) {
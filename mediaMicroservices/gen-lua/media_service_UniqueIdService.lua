@@ -115,6 +115,135 @@ function UploadUniqueId_result:write(oprot)
   oprot:writeStructEnd()
 end
 
+local ComposeUniqueIds_args = __TObject:new{
+  req_id,
+  num_ids,
+  carrier
+}
+
+function ComposeUniqueIds_args:read(iprot)
+  iprot:readStructBegin()
+  while true do
+    local fname, ftype, fid = iprot:readFieldBegin()
+    if ftype == TType.STOP then
+      break
+    elseif fid == 1 then
+      if ftype == TType.I64 then
+        self.req_id = iprot:readI64()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 2 then
+      if ftype == TType.I32 then
+        self.num_ids = iprot:readI32()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 3 then
+      if ftype == TType.MAP then
+        self.carrier = {}
+        local _ktype45, _vtype46, _size44 = iprot:readMapBegin()
+        for _i=1,_size44 do
+          local _key48 = iprot:readString()
+          local _val49 = iprot:readString()
+          self.carrier[_key48] = _val49
+        end
+        iprot:readMapEnd()
+      else
+        iprot:skip(ftype)
+      end
+    else
+      iprot:skip(ftype)
+    end
+    iprot:readFieldEnd()
+  end
+  iprot:readStructEnd()
+end
+
+function ComposeUniqueIds_args:write(oprot)
+  oprot:writeStructBegin('ComposeUniqueIds_args')
+  if self.req_id ~= nil then
+    oprot:writeFieldBegin('req_id', TType.I64, 1)
+    oprot:writeI64(self.req_id)
+    oprot:writeFieldEnd()
+  end
+  if self.num_ids ~= nil then
+    oprot:writeFieldBegin('num_ids', TType.I32, 2)
+    oprot:writeI32(self.num_ids)
+    oprot:writeFieldEnd()
+  end
+  if self.carrier ~= nil then
+    oprot:writeFieldBegin('carrier', TType.MAP, 3)
+    oprot:writeMapBegin(TType.STRING, TType.STRING, ttable_size(self.carrier))
+    for kiter50,viter51 in pairs(self.carrier) do
+      oprot:writeString(kiter50)
+      oprot:writeString(viter51)
+    end
+    oprot:writeMapEnd()
+    oprot:writeFieldEnd()
+  end
+  oprot:writeFieldStop()
+  oprot:writeStructEnd()
+end
+
+local ComposeUniqueIds_result = __TObject:new{
+  success,
+  se
+}
+
+function ComposeUniqueIds_result:read(iprot)
+  iprot:readStructBegin()
+  while true do
+    local fname, ftype, fid = iprot:readFieldBegin()
+    if ftype == TType.STOP then
+      break
+    elseif fid == 0 then
+      if ftype == TType.LIST then
+        self.success = {}
+        local _etype55, _size52 = iprot:readListBegin()
+        for _i=1,_size52 do
+          local _elem56 = iprot:readI64()
+          table.insert(self.success, _elem56)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 1 then
+      if ftype == TType.STRUCT then
+        self.se = ServiceException:new{}
+        self.se:read(iprot)
+      else
+        iprot:skip(ftype)
+      end
+    else
+      iprot:skip(ftype)
+    end
+    iprot:readFieldEnd()
+  end
+  iprot:readStructEnd()
+end
+
+function ComposeUniqueIds_result:write(oprot)
+  oprot:writeStructBegin('ComposeUniqueIds_result')
+  if self.success ~= nil then
+    oprot:writeFieldBegin('success', TType.LIST, 0)
+    oprot:writeListBegin(TType.I64, #self.success)
+    for _,iter57 in ipairs(self.success) do
+      oprot:writeI64(iter57)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.se ~= nil then
+    oprot:writeFieldBegin('se', TType.STRUCT, 1)
+    self.se:write(oprot)
+    oprot:writeFieldEnd()
+  end
+  oprot:writeFieldStop()
+  oprot:writeStructEnd()
+end
+
 local UniqueIdServiceClient = __TObject.new(__TClient, {
   __type = 'UniqueIdServiceClient'
 })
@@ -149,6 +278,41 @@ function UniqueIdServiceClient:recv_UploadUniqueId(req_id, carrier)
     error(result.se)
   end
 end
+
+function UniqueIdServiceClient:ComposeUniqueIds(req_id, num_ids, carrier)
+  self:send_ComposeUniqueIds(req_id, num_ids, carrier)
+  return self:recv_ComposeUniqueIds(req_id, num_ids, carrier)
+end
+
+function UniqueIdServiceClient:send_ComposeUniqueIds(req_id, num_ids, carrier)
+  self.oprot:writeMessageBegin('ComposeUniqueIds', TMessageType.CALL, self._seqid)
+  local args = ComposeUniqueIds_args:new{}
+  args.req_id = req_id
+  args.num_ids = num_ids
+  args.carrier = carrier
+  args:write(self.oprot)
+  self.oprot:writeMessageEnd()
+  self.oprot.trans:flush()
+end
+
+function UniqueIdServiceClient:recv_ComposeUniqueIds(req_id, num_ids, carrier)
+  local fname, mtype, rseqid = self.iprot:readMessageBegin()
+  if mtype == TMessageType.EXCEPTION then
+    local x = TApplicationException:new{}
+    x:read(self.iprot)
+    self.iprot:readMessageEnd()
+    error(x)
+  end
+  local result = ComposeUniqueIds_result:new{}
+  result:read(self.iprot)
+  self.iprot:readMessageEnd()
+  if result.success ~= nil then
+    return result.success
+  elseif result.se then
+    error(result.se)
+  end
+  error(TApplicationException:new{errorCode = TApplicationException.MISSING_RESULT})
+end
 local UniqueIdServiceIface = __TObject:new{
   __type = 'UniqueIdServiceIface'
 }
@@ -198,4 +362,25 @@ function UniqueIdServiceProcessor:process_UploadUniqueId(seqid, iprot, oprot, se
   oprot.trans:flush()
 end
 
-return UniqueIdServiceClient
\ No newline at end of file
+return UniqueIdServiceClienfunction UniqueIdServiceProcessor:process_ComposeUniqueIds(seqid, iprot, oprot, server_ctx)
+  local args = ComposeUniqueIds_args:new{}
+  local reply_type = TMessageType.REPLY
+  args:read(iprot)
+  iprot:readMessageEnd()
+  local result = ComposeUniqueIds_result:new{}
+  local status, res = pcall(self.handler.ComposeUniqueIds, self.handler, args.req_id, args.num_ids, args.carrier)
+  if not status then
+    reply_type = TMessageType.EXCEPTION
+    result = TApplicationException:new{message = res}
+  elseif ttype(res) == 'ServiceException' then
+    result.se = res
+  else
+    result.success = res
+  end
+  oprot:writeMessageBegin('ComposeUniqueIds', reply_type, seqid)
+  result:write(oprot)
+  oprot:writeMessageEnd()
+  oprot.trans:flush()
+end
+
+t
\ No newline at end of file
@@ -1,6 +1,14 @@
 {{- define "mediamicroservices.templates.other.service-config.json"  }}
 {
   "secret": "secret",
+  "thrift": {
+    "compression": {
+      "codec": "none",
+      "threshold_bytes": 4096,
+      "zstd_level": 1,
+      "metrics_interval_ms": 60000
+    }
+  },
   "unique-id-service": {
     "addr": "unique-id-service",
     "port": 9090
@@ -39,11 +47,14 @@
   },
   "user-service": {
     "addr": "user-service",
-    "port": 9090
+    "port": 9090,
+    "password_hash_backend": "openssl"
   },
   "compose-review-service": {
     "addr": "compose-review-service",
-    "port": 9090
+    "port": 9090,
+    "rendezvous": "memcached",
+    "rendezvous_timeout_ms": 10000
   },
   "compose-review-memcached": {
     "addr": "compose-review-memcached",
@@ -75,7 +86,8 @@
   },
   "movie-review-service": {
     "addr": "movie-review-service",
-    "port": 9090
+    "port": 9090,
+    "review_index_size": 1000
   },
   "movie-review-mongodb": {
     "addr": "movie-review-mongodb",
@@ -111,7 +123,9 @@
   },
   "movie-info-service": {
     "addr": "movie-info-service",
-    "port": 9090
+    "port": 9090,
+    "rating_aggregation_interval_ms": 1000,
+    "rating_aggregation_batch_size": 1000
   },
   "movie-info-mongodb": {
     "addr": "movie-info-mongodb",
@@ -123,7 +137,9 @@
   },
   "page-service": {
     "addr": "page-service",
-    "port": 9090
+    "port": 9090,
+    "page_cache_size": 10000,
+    "page_cache_ttl_ms": 60000
   }
 }
 {{- end }}
\ No newline at end of file
@@ -73,6 +73,12 @@ service UniqueIdService {
       1: i64 req_id,
       2: map<string, string> carrier
   ) throws (1: ServiceException se)
+
+  list<i64> ComposeUniqueIds (
+      1: i64 req_id,
+      2: i32 num_ids,
+      3: map<string, string> carrier
+  ) throws (1: ServiceException se)
 }
 
 service MovieIdService {
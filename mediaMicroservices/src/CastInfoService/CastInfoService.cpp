@@ -5,6 +5,7 @@
 #include <signal.h>
 
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "../utils_memcached.h"
 #include "../utils_mongodb.h"
 #include "CastInfoHandler.h"
@@ -12,7 +13,6 @@
 using json = nlohmann::json;
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using namespace media_service;
 
@@ -30,6 +30,7 @@ int main(int argc, char *argv[]) {
   if (load_config_file("config/service-config.json", &config_json) != 0) {
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
   int port = config_json["cast-info-service"]["port"];
 
@@ -63,7 +64,7 @@ int main(int argc, char *argv[]) {
       std::make_shared<CastInfoHandler>(
               memcached_client_pool, mongodb_client_pool)),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
   std::cout << "Starting the cast-service server ..." << std::endl;
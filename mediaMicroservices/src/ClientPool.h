@@ -6,6 +6,8 @@
 #include <condition_variable>
 #include <deque>
 #include <chrono>
+#include <memory>
+#include <sstream>
 #include <string>
 
 #include "logger.h"
@@ -143,6 +145,64 @@ void ClientPool<TClient>::Remove(TClient *client) {
   lock.unlock();
 }
 
+// A ClientPool per replica of a service, its addr listing the replicas
+// separated by commas, each with an optional ":port". All calls with the
+// same key go to the same replica, for services that keep per-key state in
+// memory, such as compose-review-service with req_id.
+template<class TClient>
+class AffinityClientPool {
+ public:
+  AffinityClientPool(const std::string &client_type, const std::string &addr,
+      int port, int min_size, int max_size, int timeout_ms);
+
+  TClient * Pop(int64_t key);
+  void Push(int64_t key, TClient *);
+
+ private:
+  ClientPool<TClient> *_Pool(int64_t key);
+
+  std::vector<std::unique_ptr<ClientPool<TClient>>> _pools;
+};
+
+template<class TClient>
+AffinityClientPool<TClient>::AffinityClientPool(
+    const std::string &client_type, const std::string &addr, int port,
+    int min_size, int max_size, int timeout_ms) {
+  std::istringstream replicas(addr);
+  std::string replica;
+  while (std::getline(replicas, replica, ',')) {
+    replica.erase(0, replica.find_first_not_of(' '));
+    replica.erase(replica.find_last_not_of(' ') + 1);
+    if (replica.empty()) {
+      continue;
+    }
+    auto colon = replica.find(':');
+    int replica_port = colon == std::string::npos ?
+        port : std::stoi(replica.substr(colon + 1));
+    _pools.emplace_back(new ClientPool<TClient>(
+        client_type, replica.substr(0, colon), replica_port, min_size,
+        max_size, timeout_ms));
+  }
+}
+
+template<class TClient>
+ClientPool<TClient> *AffinityClientPool<TClient>::_Pool(int64_t key) {
+  // Fibonacci hashing, as keys such as req_id are not uniform in their low
+  // bits
+  uint64_t hash = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+  return _pools[(hash >> 32) % _pools.size()].get();
+}
+
+template<class TClient>
+TClient * AffinityClientPool<TClient>::Pop(int64_t key) {
+  return _Pool(key)->Pop();
+}
+
+template<class TClient>
+void AffinityClientPool<TClient>::Push(int64_t key, TClient *client) {
+  _Pool(key)->Push(client);
+}
+
 } // namespace media_service
 
 
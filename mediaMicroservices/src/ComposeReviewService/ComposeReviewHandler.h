@@ -18,6 +18,7 @@
 #include "../ThriftClient.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "ReviewRendezvous.h"
 
 namespace media_service {
 #define NUM_COMPONENTS 5
@@ -33,7 +34,8 @@ class ComposeReviewHandler : public ComposeReviewServiceIf {
       memcached_pool_st *,
       ClientPool<ThriftClient<ReviewStorageServiceClient>> *,
       ClientPool<ThriftClient<UserReviewServiceClient>> *,
-      ClientPool<ThriftClient<MovieReviewServiceClient>> *);
+      ClientPool<ThriftClient<MovieReviewServiceClient>> *,
+      ReviewRendezvous * = nullptr);
   ~ComposeReviewHandler() override = default;
 
   void UploadText(int64_t, const std::string &,
@@ -50,6 +52,8 @@ class ComposeReviewHandler : public ComposeReviewServiceIf {
 
  private:
   memcached_pool_st *_memcached_client_pool;
+  // Composes reviews in memory instead of memcached, when not null
+  ReviewRendezvous *_rendezvous;
   ClientPool<ThriftClient<ReviewStorageServiceClient>>
       *_review_storage_client_pool;
   ClientPool<ThriftClient<UserReviewServiceClient>>
@@ -57,6 +61,8 @@ class ComposeReviewHandler : public ComposeReviewServiceIf {
   ClientPool<ThriftClient<MovieReviewServiceClient>>
       *_movie_review_client_pool;
   void _ComposeAndUpload(int64_t, const std::map<std::string, std::string> &);
+  void _UploadReview(int64_t, Review *,
+                     const std::map<std::string, std::string> &);
 };
 
 ComposeReviewHandler::ComposeReviewHandler(
@@ -66,8 +72,10 @@ ComposeReviewHandler::ComposeReviewHandler(
     ClientPool<ThriftClient<UserReviewServiceClient>>
         *user_review_client_pool,
     ClientPool<ThriftClient<MovieReviewServiceClient>>
-        *movie_review_client_pool ) {
+        *movie_review_client_pool,
+    ReviewRendezvous *rendezvous) {
   _memcached_client_pool = memcached_client_pool;
+  _rendezvous = rendezvous;
   _review_storage_client_pool = review_storage_client_pool;
   _user_review_client_pool = user_review_client_pool;
   _movie_review_client_pool = movie_review_client_pool;
@@ -175,6 +183,13 @@ void ComposeReviewHandler::_ComposeAndUpload(
   memcached_quit(client);
   memcached_pool_push(_memcached_client_pool, client);
 
+  _UploadReview(req_id, &new_review, writer_text_map);
+}
+
+void ComposeReviewHandler::_UploadReview(
+    int64_t req_id, Review *review,
+    const std::map<std::string, std::string> &writer_text_map) {
+  Review &new_review = *review;
   new_review.timestamp = duration_cast<milliseconds>(
       system_clock::now().time_since_epoch()).count();
   new_review.req_id = req_id;
@@ -266,6 +281,18 @@ void ComposeReviewHandler::UploadMovieId(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  if (_rendezvous) {
+    Review review;
+    if (_rendezvous->Add(
+            req_id, ReviewRendezvous::MOVIE_ID,
+            [&](Review *partial) { partial->movie_id = movie_id; },
+            &review)) {
+      _UploadReview(req_id, &review, writer_text_map);
+    }
+    span->Finish();
+    return;
+  }
+
   memcached_return_t memcached_rc;
   std::string key_counter = std::to_string(req_id) + ":counter";
   memcached_st *memcached_client = memcached_pool_pop(
@@ -374,6 +401,18 @@ void ComposeReviewHandler::UploadUserId(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  if (_rendezvous) {
+    Review review;
+    if (_rendezvous->Add(
+            req_id, ReviewRendezvous::USER_ID,
+            [&](Review *partial) { partial->user_id = user_id; },
+            &review)) {
+      _UploadReview(req_id, &review, writer_text_map);
+    }
+    span->Finish();
+    return;
+  }
+
   memcached_return_t memcached_rc;
   std::string key_counter = std::to_string(req_id) + ":counter";
   memcached_st *memcached_client = memcached_pool_pop(
@@ -484,6 +523,18 @@ void ComposeReviewHandler::UploadUniqueId(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  if (_rendezvous) {
+    Review review;
+    if (_rendezvous->Add(
+            req_id, ReviewRendezvous::REVIEW_ID,
+            [&](Review *partial) { partial->review_id = review_id; },
+            &review)) {
+      _UploadReview(req_id, &review, writer_text_map);
+    }
+    span->Finish();
+    return;
+  }
+
   memcached_return_t memcached_rc;
   std::string key_counter = std::to_string(req_id) + ":counter";
   memcached_st *memcached_client = memcached_pool_pop(
@@ -596,6 +647,18 @@ void ComposeReviewHandler::UploadText(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  if (_rendezvous) {
+    Review review;
+    if (_rendezvous->Add(
+            req_id, ReviewRendezvous::TEXT,
+            [&](Review *partial) { partial->text = text; },
+            &review)) {
+      _UploadReview(req_id, &review, writer_text_map);
+    }
+    span->Finish();
+    return;
+  }
+
   memcached_return_t memcached_rc;
   std::string key_counter = std::to_string(req_id) + ":counter";
   memcached_st *memcached_client = memcached_pool_pop(
@@ -702,6 +765,18 @@ void ComposeReviewHandler::UploadRating(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  if (_rendezvous) {
+    Review review;
+    if (_rendezvous->Add(
+            req_id, ReviewRendezvous::RATING,
+            [&](Review *partial) { partial->rating = rating; },
+            &review)) {
+      _UploadReview(req_id, &review, writer_text_map);
+    }
+    span->Finish();
+    return;
+  }
+
   memcached_return_t memcached_rc;
   std::string key_counter = std::to_string(req_id) + ":counter";
   memcached_st *memcached_client = memcached_pool_pop(
@@ -6,12 +6,12 @@
 
 #include "ComposeReviewHandler.h"
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "../utils_memcached.h"
 
 using json = nlohmann::json;
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using namespace media_service;
 
@@ -29,6 +29,7 @@ int main(int argc, char *argv[]) {
   if (load_config_file("config/service-config.json", &config_json) != 0) {
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
   int port = config_json["compose-review-service"]["port"];
   std::string review_storage_addr =
@@ -60,15 +61,26 @@ int main(int argc, char *argv[]) {
   auto memcached_client_pool = memcached_pool_create(
       memcached_client, MEMCACHED_POOL_MIN_SIZE, MEMCACHED_POOL_MAX_SIZE);
 
+  // "memory" composes reviews in this process, which takes all components
+  // of a review to reach the same replica (see AffinityClientPool).
+  // "memcached" lets any replica take any component.
+  auto &compose_config = config_json["compose-review-service"];
+  std::unique_ptr<ReviewRendezvous> rendezvous;
+  if (compose_config.value("rendezvous", "memcached") == "memory") {
+    rendezvous.reset(new ReviewRendezvous(
+        compose_config.value("rendezvous_timeout_ms", MMC_EXP_TIME * 1000)));
+  }
+
   TThreadedServer server(
       std::make_shared<ComposeReviewServiceProcessor>(
           std::make_shared<ComposeReviewHandler>(
               memcached_client_pool,
               &compose_client_pool,
               &user_client_pool,
-              &movie_client_pool)),
+              &movie_client_pool,
+              rendezvous.get())),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
   std::cout << "Starting the compose-review-service server ..." << std::endl;
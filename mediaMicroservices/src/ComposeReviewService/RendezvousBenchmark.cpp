@@ -0,0 +1,186 @@
+/*
+ * Reviews/s that compose-review-service can assemble from their five
+ * components, in memory with ReviewRendezvous and through memcached.
+ *
+ * Usage: RendezvousBenchmark [reviews] [threads per component]
+ *                            [memcached addr:port]
+ *
+ * Uploads every component of every review from its own threads, as the five
+ * upstream services do, each thread taking the reviews in a different order.
+ * Without a memcached address, only the in-memory table is measured. With
+ * one, also the memcached protocol of ComposeReviewHandler: add the counter,
+ * add the component, increment the counter, and mget the five components
+ * for the last one.
+ */
+
+#include <libmemcached/memcached.h>
+#include <libmemcached/util.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ReviewRendezvous.h"
+
+using namespace media_service;
+
+static const int kNumComponents = 5;
+static const char *kComponentNames[kNumComponents] = {
+    "review_id", "movie_id", "user_id", "text", "rating"};
+
+static void SetComponent(int component, int64_t req_id, Review *review) {
+  switch (component) {
+    case 0: review->review_id = req_id; break;
+    case 1: review->movie_id = "tt" + std::to_string(req_id); break;
+    case 2: review->user_id = req_id; break;
+    case 3: review->text = std::string(256, 'x'); break;
+    case 4: review->rating = static_cast<int32_t>(req_id % 10); break;
+  }
+}
+
+// Uploads component of every review, in an order of its own
+template <class Upload>
+static double Run(int num_reviews, int threads_per_component,
+                  Upload &&upload) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int component = 0; component < kNumComponents; ++component) {
+    for (int t = 0; t < threads_per_component; ++t) {
+      threads.emplace_back([=, &upload]() {
+        std::vector<int64_t> req_ids;
+        for (int64_t i = t; i < num_reviews; i += threads_per_component) {
+          req_ids.push_back(i);
+        }
+        std::mt19937_64 gen(component * threads_per_component + t);
+        std::shuffle(req_ids.begin(), req_ids.end(), gen);
+        for (auto req_id : req_ids) {
+          upload(component, req_id);
+        }
+      });
+    }
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+static void RunMemory(int num_reviews, int threads_per_component) {
+  ReviewRendezvous rendezvous(10000);
+  const ReviewRendezvous::Component components[kNumComponents] = {
+      ReviewRendezvous::REVIEW_ID, ReviewRendezvous::MOVIE_ID,
+      ReviewRendezvous::USER_ID, ReviewRendezvous::TEXT,
+      ReviewRendezvous::RATING};
+  std::atomic<int> composed(0);
+  double elapsed =
+      Run(num_reviews, threads_per_component, [&](int component,
+                                                  int64_t req_id) {
+        Review review;
+        if (rendezvous.Add(
+                req_id, components[component],
+                [&](Review *partial) {
+                  SetComponent(component, req_id, partial);
+                },
+                &review)) {
+          composed++;
+        }
+      });
+  std::cout << "memory:    " << composed.load() << " reviews, "
+            << static_cast<int64_t>(composed.load() / elapsed)
+            << " reviews/s" << std::endl;
+}
+
+static void RunMemcached(int num_reviews, int threads_per_component,
+                         const std::string &addr) {
+  std::string config_str = "--SERVER=" + addr;
+  auto memcached_client = memcached(config_str.c_str(), config_str.length());
+  memcached_behavior_set(memcached_client, MEMCACHED_BEHAVIOR_NO_BLOCK, 1);
+  memcached_behavior_set(memcached_client, MEMCACHED_BEHAVIOR_TCP_NODELAY, 1);
+  memcached_behavior_set(
+      memcached_client, MEMCACHED_BEHAVIOR_BINARY_PROTOCOL, 1);
+  auto pool = memcached_pool_create(
+      memcached_client, kNumComponents * threads_per_component,
+      kNumComponents * threads_per_component);
+  // Apart from the reviews of earlier runs
+  int64_t base = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count() << 20;
+
+  std::atomic<int> composed(0);
+  std::atomic<int> failed(0);
+  double elapsed = Run(
+      num_reviews, threads_per_component, [&](int component, int64_t i) {
+        int64_t req_id = base + i;
+        Review review;
+        SetComponent(component, req_id, &review);
+        std::string value;
+        switch (component) {
+          case 0: value = std::to_string(review.review_id); break;
+          case 1: value = review.movie_id; break;
+          case 2: value = std::to_string(review.user_id); break;
+          case 3: value = review.text; break;
+          case 4: value = std::to_string(review.rating); break;
+        }
+        memcached_return_t rc;
+        auto client = memcached_pool_pop(pool, true, &rc);
+        std::string key_counter = std::to_string(req_id) + ":counter";
+        std::string key =
+            std::to_string(req_id) + ":" + kComponentNames[component];
+        memcached_add(client, key_counter.c_str(), key_counter.size(), "0",
+                      1, 10, 0);
+        rc = memcached_add(client, key.c_str(), key.size(), value.c_str(),
+                           value.size(), 10, 0);
+        uint64_t counter_value = 0;
+        if (rc == MEMCACHED_SUCCESS) {
+          rc = memcached_increment(client, key_counter.c_str(),
+                                   key_counter.size(), 1, &counter_value);
+        }
+        if (rc != MEMCACHED_SUCCESS) {
+          failed++;
+        } else if (counter_value == kNumComponents) {
+          std::string keys[kNumComponents];
+          const char *key_ptrs[kNumComponents];
+          size_t key_sizes[kNumComponents];
+          for (int c = 0; c < kNumComponents; ++c) {
+            keys[c] = std::to_string(req_id) + ":" + kComponentNames[c];
+            key_ptrs[c] = keys[c].c_str();
+            key_sizes[c] = keys[c].size();
+          }
+          memcached_mget(client, key_ptrs, key_sizes, kNumComponents);
+          memcached_result_st *result;
+          int fetched = 0;
+          while ((result = memcached_fetch_result(client, nullptr, &rc))) {
+            fetched++;
+            memcached_result_free(result);
+          }
+          if (fetched == kNumComponents) {
+            composed++;
+          } else {
+            failed++;
+          }
+        }
+        memcached_pool_push(pool, client);
+      });
+  std::cout << "memcached: " << composed.load() << " reviews, "
+            << static_cast<int64_t>(composed.load() / elapsed)
+            << " reviews/s, " << failed.load() << " failures" << std::endl;
+  memcached_pool_destroy(pool);
+  memcached_free(memcached_client);
+}
+
+int main(int argc, char *argv[]) {
+  int num_reviews = argc > 1 ? std::atoi(argv[1]) : 100000;
+  int threads_per_component = argc > 2 ? std::atoi(argv[2]) : 4;
+  RunMemory(num_reviews, threads_per_component);
+  if (argc > 3) {
+    RunMemcached(num_reviews, threads_per_component, argv[3]);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+#ifndef MEDIA_MICROSERVICES_REVIEWRENDEZVOUS_H
+#define MEDIA_MICROSERVICES_REVIEWRENDEZVOUS_H
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../gen-cpp/media_service_types.h"
+#include "../logger.h"
+
+namespace media_service {
+
+// The reviews being composed, in memory, until the last of their five
+// components arrives. Sharded by req_id, each shard under its own mutex.
+// A review still missing components timeout_ms after its first one is
+// dropped, as its memcached keys would expire.
+class ReviewRendezvous {
+ public:
+  enum Component : uint8_t {
+    REVIEW_ID = 1 << 0,
+    MOVIE_ID = 1 << 1,
+    USER_ID = 1 << 2,
+    TEXT = 1 << 3,
+    RATING = 1 << 4,
+  };
+
+  explicit ReviewRendezvous(int timeout_ms, int num_shards = 64)
+      : _timeout(timeout_ms), _shards(num_shards), _expired(0) {}
+
+  // Sets component of the review of req_id with set(Review *). Returns true,
+  // with the complete review in *review, for the last of the five.
+  template <class Set>
+  bool Add(int64_t req_id, Component component, Set &&set, Review *review) {
+    auto now = std::chrono::steady_clock::now();
+    auto &shard = _shards[static_cast<uint64_t>(req_id) % _shards.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    _Expire(&shard, now);
+    auto inserted = shard.reviews.emplace(req_id, Partial());
+    auto &partial = inserted.first->second;
+    if (inserted.second) {
+      partial.deadline = now + _timeout;
+      shard.deadlines.emplace_back(partial.deadline, req_id);
+    } else if (partial.components & component) {
+      LOG(warning) << "Component " << static_cast<int>(component)
+                   << " of request " << req_id
+                   << " has already been uploaded";
+      return false;
+    }
+    set(&partial.review);
+    partial.components |= component;
+    if (partial.components != kAllComponents) {
+      return false;
+    }
+    *review = std::move(partial.review);
+    shard.reviews.erase(inserted.first);
+    return true;
+  }
+
+  // Reviews dropped with components missing
+  uint64_t expired() const { return _expired.load(); }
+
+ private:
+  static constexpr uint8_t kAllComponents =
+      REVIEW_ID | MOVIE_ID | USER_ID | TEXT | RATING;
+
+  struct Partial {
+    Review review;
+    uint8_t components = 0;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<int64_t, Partial> reviews;
+    // In the order of the reviews' first components, thus of deadlines. A
+    // review completed in time leaves its entry, ignored when it expires.
+    std::deque<std::pair<std::chrono::steady_clock::time_point, int64_t>>
+        deadlines;
+  };
+
+  void _Expire(Shard *shard, std::chrono::steady_clock::time_point now) {
+    while (!shard->deadlines.empty() &&
+           shard->deadlines.front().first <= now) {
+      auto it = shard->reviews.find(shard->deadlines.front().second);
+      if (it != shard->reviews.end() &&
+          it->second.deadline == shard->deadlines.front().first) {
+        LOG(warning) << "Dropped review of request " << it->first
+                     << " with components "
+                     << static_cast<int>(it->second.components)
+                     << " after " << _timeout.count() << " ms";
+        shard->reviews.erase(it);
+        _expired.fetch_add(1, std::memory_order_relaxed);
+      }
+      shard->deadlines.pop_front();
+    }
+  }
+
+  std::chrono::milliseconds _timeout;
+  std::vector<Shard> _shards;
+  std::atomic<uint64_t> _expired;
+};
+
+} // namespace media_service
+
+#endif //MEDIA_MICROSERVICES_REVIEWRENDEZVOUS_H
@@ -26,7 +26,7 @@ class MovieIdHandler : public MovieIdServiceIf {
   MovieIdHandler(
       memcached_pool_st *,
       mongoc_client_pool_t *,
-      ClientPool<ThriftClient<ComposeReviewServiceClient>> *,
+      AffinityClientPool<ThriftClient<ComposeReviewServiceClient>> *,
       ClientPool<ThriftClient<RatingServiceClient>> *);
   ~MovieIdHandler() override = default;
   void UploadMovieId(int64_t, const std::string &, int32_t,
@@ -37,14 +37,16 @@ class MovieIdHandler : public MovieIdServiceIf {
  private:
   memcached_pool_st *_memcached_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
-  ClientPool<ThriftClient<ComposeReviewServiceClient>> *_compose_client_pool;
+  AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+      *_compose_client_pool;
   ClientPool<ThriftClient<RatingServiceClient>> *_rating_client_pool;
 };
 
 MovieIdHandler::MovieIdHandler(
     memcached_pool_st *memcached_client_pool,
     mongoc_client_pool_t *mongodb_client_pool,
-    ClientPool<ThriftClient<ComposeReviewServiceClient>> *compose_client_pool,
+    AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+        *compose_client_pool,
     ClientPool<ThriftClient<RatingServiceClient>> *rating_client_pool) {
   _memcached_client_pool = memcached_client_pool;
   _mongodb_client_pool = mongodb_client_pool;
@@ -207,7 +209,7 @@ void MovieIdHandler::UploadMovieId(
   });
 
   movie_id_future = std::async(std::launch::async, [&]() {
-    auto compose_client_wrapper = _compose_client_pool->Pop();
+    auto compose_client_wrapper = _compose_client_pool->Pop(req_id);
     if (!compose_client_wrapper) {
       ServiceException se;
       se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
@@ -218,11 +220,11 @@ void MovieIdHandler::UploadMovieId(
     try {
       compose_client->UploadMovieId(req_id, movie_id_str, writer_text_map);
     } catch (...) {
-      _compose_client_pool->Push(compose_client_wrapper);
+      _compose_client_pool->Push(req_id, compose_client_wrapper);
       LOG(error) << "Failed to upload movie_id to compose-review-service";
       throw;
     }
-    _compose_client_pool->Push(compose_client_wrapper);
+    _compose_client_pool->Push(req_id, compose_client_wrapper);
   });
 
   rating_future = std::async(std::launch::async, [&]() {
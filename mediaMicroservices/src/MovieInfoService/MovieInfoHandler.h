@@ -13,6 +13,7 @@
 #include "../../gen-cpp/MovieInfoService.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "RatingAggregator.h"
 
 namespace media_service {
 using json = nlohmann::json;
@@ -21,7 +22,8 @@ class MovieInfoHandler : public MovieInfoServiceIf {
  public:
   MovieInfoHandler(
       memcached_pool_st *,
-      mongoc_client_pool_t *);
+      mongoc_client_pool_t *,
+      ClientPool<RedisClient> *);
   ~MovieInfoHandler() override = default;
   void ReadMovieInfo(MovieInfo& _return, int64_t req_id,
       const std::string& movie_id,
@@ -37,17 +39,21 @@ class MovieInfoHandler : public MovieInfoServiceIf {
       int32_t sum_uncommitted_rating, int32_t num_uncommitted_rating,
       const std::map<std::string, std::string> & carrier) override;
 
-
  private:
+  static void _SetRating(const json &movie_info_json, MovieInfo *);
+
   memcached_pool_st *_memcached_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
+  ClientPool<RedisClient> *_rating_redis_client_pool;
 };
 
 MovieInfoHandler::MovieInfoHandler(
     memcached_pool_st *memcached_client_pool,
-    mongoc_client_pool_t *mongodb_client_pool) {
+    mongoc_client_pool_t *mongodb_client_pool,
+    ClientPool<RedisClient> *rating_redis_client_pool) {
   _memcached_client_pool = memcached_client_pool;
   _mongodb_client_pool = mongodb_client_pool;
+  _rating_redis_client_pool = rating_redis_client_pool;
 }
 
 void MovieInfoHandler::WriteMovieInfo(
@@ -221,8 +227,7 @@ void MovieInfoHandler::ReadMovieInfo(
         movie_info_mmc, movie_info_mmc + movie_info_mmc_size));
     _return.movie_id = movie_info_json["movie_id"];
     _return.title = movie_info_json["title"];
-    _return.avg_rating = movie_info_json["avg_rating"];
-    _return.num_rating = movie_info_json["num_rating"];
+    _SetRating(movie_info_json, &_return);
     _return.plot_id = movie_info_json["plot_id"];
     for (auto &item : movie_info_json["photo_ids"]) {
       _return.photo_ids.emplace_back(item);
@@ -299,8 +304,7 @@ void MovieInfoHandler::ReadMovieInfo(
       json movie_info_json = json::parse(movie_info_json_char);
       _return.movie_id = movie_info_json["movie_id"];
       _return.title = movie_info_json["title"];
-      _return.avg_rating = movie_info_json["avg_rating"];
-      _return.num_rating = movie_info_json["num_rating"];
+      _SetRating(movie_info_json, &_return);
       _return.plot_id = movie_info_json["plot_id"];
       for (auto &item : movie_info_json["photo_ids"]) {
         _return.photo_ids.emplace_back(item);
@@ -369,9 +373,6 @@ void MovieInfoHandler::UpdateRating(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
-  bson_t *query = bson_new();
-  BSON_APPEND_UTF8(query, "movie_id", movie_id.c_str());
-
   mongoc_client_t *mongodb_client = mongoc_client_pool_pop(
       _mongodb_client_pool);
   if (!mongodb_client) {
@@ -380,72 +381,24 @@ void MovieInfoHandler::UpdateRating(
     se.message = "Failed to pop a client from MongoDB pool";
     throw se;
   }
-  auto collection = mongoc_client_get_collection(
-      mongodb_client, "social-graph", "social-graph");
-  if (!collection) {
+  bson_error_t error;
+  auto update_span = opentracing::Tracer::Global()->StartSpan(
+      "MongoUpdateRating", {opentracing::ChildOf(&span->context())});
+  bool updated = CommitRatingDeltas(
+      mongodb_client,
+      {{movie_id, sum_uncommitted_rating, num_uncommitted_rating}},
+      &error) == 1;
+  update_span->Finish();
+  mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  if (!updated) {
+    LOG(error) << "Failed to update rating for movie " << movie_id
+               << " to MongoDB: " << error.message;
     ServiceException se;
     se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-    se.message = "Failed to create collection social_graph from MongoDB";
-    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+    se.message = "Failed to update rating for movie " + movie_id +
+        " to MongoDB: " + error.message;
     throw se;
   }
-  auto find_span = opentracing::Tracer::Global()->StartSpan(
-      "MongoFindMovieInfo", {opentracing::ChildOf(&span->context())});
-  mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
-      collection, query, nullptr, nullptr);
-  const bson_t *doc;
-  bool found = mongoc_cursor_next(cursor, &doc);
-  if (found) {
-    bson_iter_t iter_0;
-    bson_iter_t iter_1;
-    bson_iter_init(&iter_0, doc);
-    bson_iter_init(&iter_1, doc);
-    double avg_rating;
-    int32_t num_rating;
-    if (bson_iter_init_find(&iter_0, doc, "avg_rating") &&
-        bson_iter_init_find(&iter_1, doc, "num_rating")) {
-      avg_rating = bson_iter_value(&iter_0)->value.v_double;
-      num_rating = bson_iter_value(&iter_1)->value.v_int32;
-
-      avg_rating = (avg_rating * num_rating + sum_uncommitted_rating) /
-          (num_rating + num_uncommitted_rating);
-      num_rating += num_uncommitted_rating;
-
-      bson_t *update = BCON_NEW(
-          "$set", "{",
-          "avg_rating", BCON_DOUBLE(avg_rating),
-          "num_rating", BCON_INT32(num_rating), "}");
-      bson_error_t error;
-      bson_t reply;
-      auto update_span = opentracing::Tracer::Global()->StartSpan(
-          "MongoUpdateRating", {opentracing::ChildOf(&span->context())});
-      bool updated = mongoc_collection_find_and_modify(
-          collection,
-          query,
-          nullptr,
-          update,
-          nullptr,
-          false,
-          false,
-          true,
-          &reply,
-          &error);
-      if (!updated) {
-        LOG(error) << "Failed to update rating for movie " << movie_id
-                   << " to MongoDB: " << error.message;
-        ServiceException se;
-        se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-        se.message = "Failed to update rating for movie " + movie_id +
-            " to MongoDB: " + error.message;
-        bson_destroy(&reply);
-        bson_destroy(update);
-        mongoc_collection_destroy(collection);
-        mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-        throw se;
-      }
-      update_span->Finish();
-    }
-  }
 
   auto delete_span = opentracing::Tracer::Global()->StartSpan(
       "MmcDelete", {opentracing::ChildOf(&span->context())});
@@ -461,10 +414,30 @@ void MovieInfoHandler::UpdateRating(
   memcached_delete(memcached_client, movie_id.c_str(), movie_id.length(), 0);
   memcached_pool_push(_memcached_client_pool, memcached_client);
   delete_span->Finish();
+  IncrementRatingVersions(
+      _rating_redis_client_pool,
+      {{movie_id, sum_uncommitted_rating, num_uncommitted_rating}}, 1);
 
   span->Finish();
 }
 
+// avg_rating and num_rating are those of the movie when written, and
+// rating_sum and rating_num the ratings committed since (see
+// CommitRatingDeltas).
+void MovieInfoHandler::_SetRating(
+    const json &movie_info_json, MovieInfo *movie_info) {
+  double avg_rating = movie_info_json["avg_rating"];
+  int64_t num_rating = movie_info_json["num_rating"];
+  int64_t rating_sum = movie_info_json.value("rating_sum", 0);
+  int64_t rating_num = movie_info_json.value("rating_num", 0);
+  if (num_rating + rating_num > 0) {
+    avg_rating = (avg_rating * num_rating + rating_sum) /
+        (num_rating + rating_num);
+  }
+  movie_info->avg_rating = avg_rating;
+  movie_info->num_rating = num_rating + rating_num;
+}
+
 } // namespace media_service
 
 #endif //MEDIA_MICROSERVICES_SRC_MOVIEINFOSERVICE_MOVIEINFOHANDLER_H_
@@ -5,6 +5,7 @@
 #include <signal.h>
 
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "../utils_memcached.h"
 #include "../utils_mongodb.h"
 #include "MovieInfoHandler.h"
@@ -12,7 +13,6 @@
 using json = nlohmann::json;
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using namespace media_service;
 
@@ -30,6 +30,7 @@ int main(int argc, char *argv[]) {
   if (load_config_file("config/service-config.json", &config_json) != 0) {
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
   int port = config_json["movie-info-service"]["port"];
 
@@ -58,12 +59,29 @@ int main(int argc, char *argv[]) {
   }
   mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
 
+  // Ratings uploaded to rating-service, committed in the background
+  auto &service_config = config_json["movie-info-service"];
+  int rating_interval_ms =
+      service_config.value("rating_aggregation_interval_ms", 1000);
+  std::string redis_addr = config_json["rating-redis"]["addr"];
+  int redis_port = config_json["rating-redis"]["port"];
+  ClientPool<RedisClient> redis_client_pool("rating-redis",
+      redis_addr, redis_port, 0, 128, 1000);
+  RatingAggregator rating_aggregator(
+      &redis_client_pool, mongodb_client_pool, memcached_client_pool,
+      rating_interval_ms,
+      service_config.value("rating_aggregation_batch_size", 1000));
+  if (rating_interval_ms > 0) {
+    rating_aggregator.Start();
+  }
+
   TThreadedServer server(
       std::make_shared<MovieInfoServiceProcessor>(
           std::make_shared<MovieInfoHandler>(
-              memcached_client_pool, mongodb_client_pool)),
+              memcached_client_pool, mongodb_client_pool,
+              &redis_client_pool)),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
   std::cout << "Starting the movie-info-service server ..." << std::endl;
@@ -0,0 +1,341 @@
+#ifndef MEDIA_MICROSERVICES_SRC_MOVIEINFOSERVICE_RATINGAGGREGATOR_H_
+#define MEDIA_MICROSERVICES_SRC_MOVIEINFOSERVICE_RATINGAGGREGATOR_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libmemcached/memcached.h>
+#include <libmemcached/util.h>
+#include <mongoc.h>
+#include <bson/bson.h>
+
+#include "../ClientPool.h"
+#include "../RedisClient.h"
+#include "../logger.h"
+
+namespace media_service {
+
+// Ratings of a movie that its movie-info document does not count yet
+struct RatingDelta {
+  std::string movie_id;
+  int64_t sum;
+  int64_t num;
+};
+
+// Adds the deltas to the rating_sum and rating_num of their movies with one
+// ordered bulk write. ReadMovieInfo folds these into avg_rating and
+// num_rating. $inc commutes, so concurrent commits need no read-modify-write.
+// Returns the number of leading deltas written: all of them, or those before
+// the first that failed, with *error set.
+size_t CommitRatingDeltas(
+    mongoc_client_t *mongodb_client,
+    const std::vector<RatingDelta> &deltas,
+    bson_error_t *error) {
+  if (deltas.empty()) {
+    return 0;
+  }
+  auto collection = mongoc_client_get_collection(
+      mongodb_client, "movie-info", "movie-info");
+  auto bulk = mongoc_collection_create_bulk_operation_with_opts(
+      collection, nullptr);
+  for (auto &delta : deltas) {
+    bson_t *selector = BCON_NEW("movie_id", BCON_UTF8(delta.movie_id.c_str()));
+    bson_t *update = BCON_NEW(
+        "$inc", "{",
+        "rating_sum", BCON_INT64(delta.sum),
+        "rating_num", BCON_INT64(delta.num), "}");
+    bool added = mongoc_bulk_operation_update_one_with_opts(
+        bulk, selector, update, nullptr, error);
+    bson_destroy(selector);
+    bson_destroy(update);
+    if (!added) {
+      mongoc_bulk_operation_destroy(bulk);
+      mongoc_collection_destroy(collection);
+      return 0;
+    }
+  }
+
+  bson_t reply;
+  size_t committed = deltas.size();
+  if (!mongoc_bulk_operation_execute(bulk, &reply, error)) {
+    // An ordered bulk write stops at its first write error. Without one, as
+    // when the connection failed, nothing is known to be written.
+    bson_iter_t iter;
+    bson_iter_t index_iter;
+    committed = 0;
+    if (bson_iter_init(&iter, &reply) &&
+        bson_iter_find_descendant(&iter, "writeErrors.0.index", &index_iter) &&
+        BSON_ITER_HOLDS_INT32(&index_iter)) {
+      committed = bson_iter_int32(&index_iter);
+    }
+  }
+  bson_destroy(&reply);
+  mongoc_bulk_operation_destroy(bulk);
+  mongoc_collection_destroy(collection);
+  return committed;
+}
+
+// Increments <movie_id>:rating_version in rating-redis for the first count
+// deltas, once committed and their cached movie-info deleted, so that
+// page-service stops serving the pages it cached with the former ratings
+void IncrementRatingVersions(
+    ClientPool<RedisClient> *redis_client_pool,
+    const std::vector<RatingDelta> &deltas,
+    size_t count) {
+  if (count == 0) {
+    return;
+  }
+  try {
+    auto redis_client_wrapper = redis_client_pool->Pop();
+    if (!redis_client_wrapper) {
+      LOG(warning) << "Failed to increment rating versions: "
+                   << "cannot connected to Redis server";
+      return;
+    }
+    auto redis_client = redis_client_wrapper->GetClient();
+    for (size_t i = 0; i < count; ++i) {
+      redis_client->incr(deltas[i].movie_id + ":rating_version");
+    }
+    redis_client->sync_commit();
+    redis_client_pool->Push(redis_client_wrapper);
+  } catch (...) {
+    LOG(warning) << "Failed to increment rating versions in rating-redis";
+  }
+}
+
+// Folds the ratings that rating-service counts in rating-redis into
+// movie-info. rating-service adds the rating to <movie_id>:uncommit_sum and
+// <movie_id>:uncommit_num, and the movie to the set uncommit_movie_ids.
+// Every interval_ms, the aggregator takes up to batch_size movies of the set
+// together with their counters and commits them with CommitRatingDeltas. It
+// then deletes the movies' cached movie-info and invalidates page-service's
+// cached pages with IncrementRatingVersions. A full batch is followed by the
+// next one right away. Ratings thus stay two increments to write, and are
+// read within about interval_ms.
+class RatingAggregator {
+ public:
+  RatingAggregator(
+      ClientPool<RedisClient> *,
+      mongoc_client_pool_t *,
+      memcached_pool_st *,
+      int interval_ms,
+      int batch_size);
+  ~RatingAggregator();
+
+  RatingAggregator(const RatingAggregator &) = delete;
+  RatingAggregator &operator=(const RatingAggregator &) = delete;
+
+  void Start();
+
+  // Commits the ratings of up to batch_size movies. Returns the number of
+  // movies taken from rating-redis.
+  size_t CommitBatch();
+
+ private:
+  bool _TakeDeltas(std::vector<RatingDelta> *);
+  void _RestoreDeltas(const std::vector<RatingDelta> &, size_t);
+  void _DeleteCachedMovieInfo(const std::vector<RatingDelta> &, size_t);
+
+  ClientPool<RedisClient> *_redis_client_pool;
+  mongoc_client_pool_t *_mongodb_client_pool;
+  memcached_pool_st *_memcached_client_pool;
+  std::chrono::milliseconds _interval;
+  int _batch_size;
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _stopping;
+};
+
+// Pops up to ARGV[1] movies of KEYS[1] and returns their movie_id, sum and
+// count, deleting the counters, in one atomic step: a rating transaction of
+// rating-service is taken either whole or not at all. The counter keys are
+// not declared in KEYS, so rating-redis cannot be a Redis Cluster.
+static const char *kTakeRatingDeltasScript = R"(
+redis.replicate_commands()
+local movie_ids = redis.call('SPOP', KEYS[1], ARGV[1])
+local deltas = {}
+for _, movie_id in ipairs(movie_ids) do
+  local sum_key = movie_id .. ':uncommit_sum'
+  local num_key = movie_id .. ':uncommit_num'
+  deltas[#deltas + 1] = movie_id
+  deltas[#deltas + 1] = redis.call('GET', sum_key) or '0'
+  deltas[#deltas + 1] = redis.call('GET', num_key) or '0'
+  redis.call('DEL', sum_key, num_key)
+end
+return deltas
+)";
+
+RatingAggregator::RatingAggregator(
+    ClientPool<RedisClient> *redis_client_pool,
+    mongoc_client_pool_t *mongodb_client_pool,
+    memcached_pool_st *memcached_client_pool,
+    int interval_ms,
+    int batch_size)
+    : _redis_client_pool(redis_client_pool),
+      _mongodb_client_pool(mongodb_client_pool),
+      _memcached_client_pool(memcached_client_pool),
+      _interval(interval_ms),
+      _batch_size(batch_size),
+      _stopping(false) {}
+
+RatingAggregator::~RatingAggregator() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _cv.notify_one();
+  if (_thread.joinable()) {
+    _thread.join();
+  }
+}
+
+void RatingAggregator::Start() {
+  _thread = std::thread([this]() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopping) {
+      lock.unlock();
+      size_t taken = 0;
+      try {
+        taken = CommitBatch();
+      } catch (...) {
+        LOG(error) << "Failed to commit ratings";
+      }
+      lock.lock();
+      if (taken < static_cast<size_t>(_batch_size)) {
+        _cv.wait_for(lock, _interval, [this] { return _stopping; });
+      }
+    }
+  });
+}
+
+size_t RatingAggregator::CommitBatch() {
+  std::vector<RatingDelta> deltas;
+  if (!_TakeDeltas(&deltas) || deltas.empty()) {
+    return 0;
+  }
+
+  size_t committed = 0;
+  bson_error_t error;
+  mongoc_client_t *mongodb_client = mongoc_client_pool_pop(
+      _mongodb_client_pool);
+  if (mongodb_client) {
+    committed = CommitRatingDeltas(mongodb_client, deltas, &error);
+    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  } else {
+    bson_set_error(&error, 0, 0, "Failed to pop a client from MongoDB pool");
+  }
+  if (committed < deltas.size()) {
+    LOG(error) << "Failed to commit the ratings of "
+               << deltas.size() - committed << " movies to MongoDB: "
+               << error.message;
+    _RestoreDeltas(deltas, committed);
+  }
+  _DeleteCachedMovieInfo(deltas, committed);
+  IncrementRatingVersions(_redis_client_pool, deltas, committed);
+  LOG(debug) << "Committed the ratings of " << committed << " movies";
+  return deltas.size();
+}
+
+bool RatingAggregator::_TakeDeltas(std::vector<RatingDelta> *deltas) {
+  auto redis_client_wrapper = _redis_client_pool->Pop();
+  if (!redis_client_wrapper) {
+    LOG(error) << "Cannot connected to Redis server";
+    return false;
+  }
+  auto redis_client = redis_client_wrapper->GetClient();
+  auto reply_future = redis_client->eval(
+      kTakeRatingDeltasScript, 1, {"uncommit_movie_ids"},
+      {std::to_string(_batch_size)});
+  redis_client->sync_commit();
+  cpp_redis::reply reply;
+  try {
+    reply = reply_future.get();
+  } catch (...) {
+    LOG(error) << "Failed to take uncommitted ratings from rating-redis";
+    _redis_client_pool->Push(redis_client_wrapper);
+    return false;
+  }
+  _redis_client_pool->Push(redis_client_wrapper);
+  if (!reply.is_array()) {
+    LOG(error) << "Failed to take uncommitted ratings from rating-redis: "
+               << (reply.is_error() ? reply.error() : "unexpected reply");
+    return false;
+  }
+
+  auto &values = reply.as_array();
+  for (size_t i = 0; i + 2 < values.size(); i += 3) {
+    RatingDelta delta;
+    delta.movie_id = values[i].as_string();
+    delta.sum = std::stoll(values[i + 1].as_string());
+    delta.num = std::stoll(values[i + 2].as_string());
+    if (delta.num != 0) {
+      deltas->emplace_back(std::move(delta));
+    }
+  }
+  return true;
+}
+
+// Gives the deltas from the first one not committed back to rating-redis,
+// to be committed in a later batch
+void RatingAggregator::_RestoreDeltas(
+    const std::vector<RatingDelta> &deltas, size_t from) {
+  auto redis_client_wrapper = _redis_client_pool->Pop();
+  if (!redis_client_wrapper) {
+    LOG(error) << "Lost the uncommitted ratings of " << deltas.size() - from
+               << " movies: cannot connected to Redis server";
+    return;
+  }
+  auto redis_client = redis_client_wrapper->GetClient();
+  std::vector<std::string> movie_ids;
+  redis_client->multi();
+  for (size_t i = from; i < deltas.size(); ++i) {
+    redis_client->incrby(deltas[i].movie_id + ":uncommit_sum", deltas[i].sum);
+    redis_client->incrby(deltas[i].movie_id + ":uncommit_num", deltas[i].num);
+    movie_ids.emplace_back(deltas[i].movie_id);
+  }
+  redis_client->sadd("uncommit_movie_ids", movie_ids);
+  auto exec_future = redis_client->exec();
+  redis_client->sync_commit();
+  try {
+    exec_future.get();
+  } catch (...) {
+    LOG(error) << "Lost the uncommitted ratings of " << deltas.size() - from
+               << " movies: failed to restore them to rating-redis";
+  }
+  _redis_client_pool->Push(redis_client_wrapper);
+}
+
+void RatingAggregator::_DeleteCachedMovieInfo(
+    const std::vector<RatingDelta> &deltas, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  memcached_return_t memcached_rc;
+  memcached_st *memcached_client = memcached_pool_pop(
+      _memcached_client_pool, true, &memcached_rc);
+  if (!memcached_client) {
+    LOG(error) << "Failed to pop a client from memcached pool";
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    memcached_rc = memcached_delete(
+        memcached_client, deltas[i].movie_id.c_str(),
+        deltas[i].movie_id.length(), 0);
+    if (memcached_rc != MEMCACHED_SUCCESS &&
+        memcached_rc != MEMCACHED_NOTFOUND) {
+      LOG(warning) << "Failed to delete movie-info " << deltas[i].movie_id
+                   << " from Memcached: "
+                   << memcached_strerror(memcached_client, memcached_rc);
+    }
+  }
+  memcached_pool_push(_memcached_client_pool, memcached_client);
+}
+
+} // namespace media_service
+
+#endif //MEDIA_MICROSERVICES_SRC_MOVIEINFOSERVICE_RATINGAGGREGATOR_H_
@@ -11,17 +11,34 @@
 #include "../../gen-cpp/ReviewStorageService.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "../utils.h"
+#include "../utils_mongodb.h"
 #include "../ClientPool.h"
 #include "../RedisClient.h"
 #include "../ThriftClient.h"
 
 namespace media_service {
+
+// Reviews of a movie, newest first, are kept in two places.
+//
+// MongoDB "movie-review"."reviews" has one document per review: movie_id,
+// review_id and timestamp, indexed by movie_id and then timestamp and
+// review_id descending. Any page of reviews is thus a range of the index.
+//
+// In movie-review-redis, the sorted set movie_id has the review_ids of the
+// newest index_size reviews, scored by timestamp. Uploads add to it and trim
+// it in one pipelined round trip. It counts as complete only with the member
+// kIndexComplete, scored +inf so that it ranks first. A read that misses it
+// rebuilds the set from the newest index_size reviews in MongoDB. The rebuild
+// adds to the set instead of replacing it, so reviews uploaded meanwhile are
+// kept. Pages beyond index_size come from MongoDB.
 class MovieReviewHandler : public MovieReviewServiceIf {
  public:
   MovieReviewHandler(
       ClientPool<RedisClient> *,
       mongoc_client_pool_t *,
-      ClientPool<ThriftClient<ReviewStorageServiceClient>> *);
+      ClientPool<ThriftClient<ReviewStorageServiceClient>> *,
+      int index_size);
   ~MovieReviewHandler() override = default;
   void UploadMovieReview(int64_t, const std::string&, int64_t, int64_t,
                          const std::map<std::string, std::string> &) override;
@@ -30,18 +47,30 @@ class MovieReviewHandler : public MovieReviewServiceIf {
       const std::map<std::string, std::string> & carrier) override;
   
  private:
+  static constexpr const char *kIndexComplete = "complete";
+
+  void _FindReviews(
+      const std::string &movie_id, int64_t skip, int64_t limit,
+      std::vector<std::pair<int64_t, int64_t>> *reviews,
+      opentracing::Span *span);
+
   ClientPool<RedisClient> *_redis_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
   ClientPool<ThriftClient<ReviewStorageServiceClient>> *_review_client_pool;
+  int _index_size;
 };
 
+constexpr const char *MovieReviewHandler::kIndexComplete;
+
 MovieReviewHandler::MovieReviewHandler(
     ClientPool<RedisClient> *redis_client_pool,
     mongoc_client_pool_t *mongodb_pool,
-    ClientPool<ThriftClient<ReviewStorageServiceClient>> *review_storage_client_pool) {
+    ClientPool<ThriftClient<ReviewStorageServiceClient>> *review_storage_client_pool,
+    int index_size) {
   _redis_client_pool = redis_client_pool;
   _mongodb_client_pool = mongodb_pool;
   _review_client_pool = review_storage_client_pool;
+  _index_size = index_size;
 }
 
 void MovieReviewHandler::UploadMovieReview(
@@ -71,91 +100,37 @@ void MovieReviewHandler::UploadMovieReview(
   }
 
   auto collection = mongoc_client_get_collection(
-      mongodb_client, "movie-review", "movie-review");
+      mongodb_client, "movie-review", "reviews");
   if (!collection) {
     ServiceException se;
     se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-    se.message = "Failed to create collection movie-review from DB movie-review";
+    se.message = "Failed to create collection reviews from DB movie-review";
     mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
     throw se;
   }
 
-  bson_t *query = bson_new();
-  BSON_APPEND_UTF8(query, "movie_id", movie_id.c_str());
-  auto find_span = opentracing::Tracer::Global()->StartSpan(
-      "MongoFindMovie", {opentracing::ChildOf(&span->context())});
-  mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
-      collection, query, nullptr, nullptr);
-  const bson_t *doc;
-  bool found = mongoc_cursor_next(cursor, &doc);
-  if (!found) {
-    bson_t *new_doc = BCON_NEW(
-        "movie_id", BCON_UTF8(movie_id.c_str()),
-        "reviews",
-        "[", "{", "review_id", BCON_INT64(review_id),
-        "timestamp", BCON_INT64(timestamp), "}", "]"
-    );
-    bson_error_t error;
-    auto insert_span = opentracing::Tracer::Global()->StartSpan(
-        "MongoInsert", {opentracing::ChildOf(&span->context())});
-    bool plotinsert = mongoc_collection_insert_one(
-        collection, new_doc, nullptr, nullptr, &error);
-    insert_span->Finish();
-    if (!plotinsert) {
-      LOG(error) << "Failed to insert movie review of movie " << movie_id
-                 << " to MongoDB: " << error.message;
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = error.message;
-      bson_destroy(new_doc);
-      bson_destroy(query);
-      mongoc_cursor_destroy(cursor);
-      mongoc_collection_destroy(collection);
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-      throw se;
-    }
-    bson_destroy(new_doc);
-  } else {
-    bson_t *update = BCON_NEW(
-        "$push", "{",
-        "reviews", "{",
-        "$each", "[", "{",
-        "review_id", BCON_INT64(review_id),
-        "timestamp", BCON_INT64(timestamp),
-        "}", "]",
-        "$position", BCON_INT32(0),
-        "}",
-        "}"
-    );
-    bson_error_t error;
-    bson_t reply;
-    auto update_span = opentracing::Tracer::Global()->StartSpan(
-        "MongoUpdate.", {opentracing::ChildOf(&span->context())});
-    bool plotupdate = mongoc_collection_find_and_modify(
-        collection, query, nullptr, update, nullptr, false, false,
-        true, &reply, &error);
-    update_span->Finish();
-    if (!plotupdate) {
-      LOG(error) << "Failed to update movie-review for movie " << movie_id
-                 << " to MongoDB: " << error.message;
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = error.message;
-      bson_destroy(update);
-      bson_destroy(query);
-      bson_destroy(&reply);
-      mongoc_cursor_destroy(cursor);
-      mongoc_collection_destroy(collection);
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-      throw se;
-    }
-    bson_destroy(update);
-    bson_destroy(&reply);
-  }
-  bson_destroy(query);
-  mongoc_cursor_destroy(cursor);
+  bson_t *new_doc = BCON_NEW(
+      "movie_id", BCON_UTF8(movie_id.c_str()),
+      "review_id", BCON_INT64(review_id),
+      "timestamp", BCON_INT64(timestamp));
+  bson_error_t error;
+  auto insert_span = opentracing::Tracer::Global()->StartSpan(
+      "MongoInsert", {opentracing::ChildOf(&span->context())});
+  bool inserted = mongoc_collection_insert_one(
+      collection, new_doc, nullptr, nullptr, &error);
+  insert_span->Finish();
+  bson_destroy(new_doc);
   mongoc_collection_destroy(collection);
   mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  // A retried upload finds its review already inserted
+  if (!inserted && error.code != MONGOC_ERROR_DUPLICATE_KEY) {
+    LOG(error) << "Failed to insert movie review of movie " << movie_id
+               << " to MongoDB: " << error.message;
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = error.message;
+    throw se;
+  }
 
   auto redis_client_wrapper = _redis_client_pool->Pop();
   if (!redis_client_wrapper) {
@@ -167,16 +142,14 @@ void MovieReviewHandler::UploadMovieReview(
   auto redis_client = redis_client_wrapper->GetClient();
   auto redis_span = opentracing::Tracer::Global()->StartSpan(
       "RedisUpdate", {opentracing::ChildOf(&span->context())});
-  auto num_reviews = redis_client->zcard(movie_id);
-  redis_client->sync_commit();
-  auto num_reviews_reply = num_reviews.get();
-  std::vector<std::string> options{"NX"};
-  if (num_reviews_reply.ok() && num_reviews_reply.as_integer()) {
-    std::multimap<std::string, std::string> value = {{
+  std::multimap<std::string, std::string> value = {{
       std::to_string(timestamp), std::to_string(review_id)}};
-    redis_client->zadd(movie_id, options, value);
-    redis_client->sync_commit();
-  }
+  redis_client->zadd(movie_id, {}, value);
+  // Keeps kIndexComplete, if any, and the newest index_size reviews
+  redis_client->zremrangebyrank(movie_id, 0, -(_index_size + 2));
+  // After the review, so that page-service drops the pages cached before it
+  redis_client->incr(movie_id + ":reviews_version");
+  redis_client->sync_commit();
   _redis_client_pool->Push(redis_client_wrapper);
   redis_span->Finish();
   span->Finish();
@@ -201,106 +174,71 @@ void MovieReviewHandler::ReadMovieReviews(
     return;
   }
 
-  auto redis_client_wrapper = _redis_client_pool->Pop();
-  if (!redis_client_wrapper) {
-    ServiceException se;
-    se.errorCode = ErrorCode::SE_REDIS_ERROR;
-    se.message = "Cannot connected to Redis server";
-    throw se;
-  }
-  auto redis_client = redis_client_wrapper->GetClient();
-  auto redis_span = opentracing::Tracer::Global()->StartSpan(
-      "RedisFind", {opentracing::ChildOf(&span->context())});
-  auto review_ids_future = redis_client->zrevrange(movie_id, start, stop - 1);
-  redis_client->commit();
-  redis_span->Finish();
-
-  cpp_redis::reply review_ids_reply;
-  try {
-    review_ids_reply = review_ids_future.get();
-  } catch (...) {
-    LOG(error) << "Failed to read review_ids from movie-review-redis";
-    _redis_client_pool->Push(redis_client_wrapper);
-    throw;
-  }
-  _redis_client_pool->Push(redis_client_wrapper);
   std::vector<int64_t> review_ids;
-  auto review_ids_reply_array = review_ids_reply.as_array();
-  for (auto &review_id_reply : review_ids_reply_array) {
-    review_ids.emplace_back(std::stoul(review_id_reply.as_string()));
-  }
-
-  int mongo_start = start + review_ids.size();
-  std::multimap<std::string, std::string> redis_update_map;
-  if (mongo_start < stop) {
-    // Instead find review_ids from mongodb
-    mongoc_client_t *mongodb_client = mongoc_client_pool_pop(
-        _mongodb_client_pool);
-    if (!mongodb_client) {
+  // Whether the reviews after review_ids, if any, are beyond the index
+  bool beyond_index = start >= _index_size;
+  bool rebuild_index = false;
+  std::vector<std::pair<int64_t, int64_t>> index_reviews;
+  if (!beyond_index) {
+    auto redis_client_wrapper = _redis_client_pool->Pop();
+    if (!redis_client_wrapper) {
       ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to pop a client from MongoDB pool";
+      se.errorCode = ErrorCode::SE_REDIS_ERROR;
+      se.message = "Cannot connected to Redis server";
       throw se;
     }
-    auto collection = mongoc_client_get_collection(
-        mongodb_client, "movie-review", "movie-review");
-    if (!collection) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to create collection movie-review from MongoDB";
-      throw se;
+    auto redis_client = redis_client_wrapper->GetClient();
+    auto redis_span = opentracing::Tracer::Global()->StartSpan(
+        "RedisFind", {opentracing::ChildOf(&span->context())});
+    auto complete_future = redis_client->zscore(movie_id, kIndexComplete);
+    auto num_reviews_future = redis_client->zcard(movie_id);
+    // Ranks are one more than positions, behind kIndexComplete
+    auto review_ids_future = redis_client->zrevrange(movie_id, start + 1, stop);
+    redis_client->commit();
+    redis_span->Finish();
+
+    cpp_redis::reply complete_reply;
+    cpp_redis::reply num_reviews_reply;
+    cpp_redis::reply review_ids_reply;
+    try {
+      complete_reply = complete_future.get();
+      num_reviews_reply = num_reviews_future.get();
+      review_ids_reply = review_ids_future.get();
+    } catch (...) {
+      LOG(error) << "Failed to read review_ids from movie-review-redis";
+      _redis_client_pool->Push(redis_client_wrapper);
+      throw;
     }
+    _redis_client_pool->Push(redis_client_wrapper);
 
-    bson_t *query = BCON_NEW("movie_id", BCON_UTF8(movie_id.c_str()));
-    bson_t *opts = BCON_NEW(
-        "projection", "{",
-        "reviews", "{",
-        "$slice", "[",
-        BCON_INT32(0), BCON_INT32(stop),
-        "]", "}", "}");
-    auto find_span = opentracing::Tracer::Global()->StartSpan(
-        "MongoFindMovieReviews", {opentracing::ChildOf(&span->context())});
-    mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
-        collection, query, opts, nullptr);
-    find_span->Finish();
-    const bson_t *doc;
-    bool found = mongoc_cursor_next(cursor, &doc);
-    if (found) {
-      bson_iter_t iter_0;
-      bson_iter_t iter_1;
-      bson_iter_t review_id_child;
-      bson_iter_t timestamp_child;
-      int idx = 0;
-      bson_iter_init(&iter_0, doc);
-      bson_iter_init(&iter_1, doc);
-      while (bson_iter_find_descendant(&iter_0,
-                                       ("reviews." + std::to_string(idx)
-                                           + ".review_id").c_str(),
-                                       &review_id_child)
-          && BSON_ITER_HOLDS_INT64(&review_id_child)
-          && bson_iter_find_descendant(&iter_1,
-                                       ("reviews." + std::to_string(idx)
-                                           + ".timestamp").c_str(),
-                                       &timestamp_child)
-          && BSON_ITER_HOLDS_INT64(&timestamp_child)) {
-        auto curr_review_id = bson_iter_int64(&review_id_child);
-        auto curr_timestamp = bson_iter_int64(&timestamp_child);
-        if (idx >= mongo_start) {
-          review_ids.emplace_back(curr_review_id);
-        }
-        redis_update_map.insert(
-            {std::to_string(curr_timestamp), std::to_string(curr_review_id)});
-        bson_iter_init(&iter_0, doc);
-        bson_iter_init(&iter_1, doc);
-        idx++;
+    if (complete_reply.is_string() && review_ids_reply.is_array() &&
+        num_reviews_reply.is_integer()) {
+      for (auto &review_id_reply : review_ids_reply.as_array()) {
+        review_ids.emplace_back(std::stoul(review_id_reply.as_string()));
+      }
+      beyond_index = num_reviews_reply.as_integer() > _index_size;
+    } else {
+      // Rebuild the index, and read what it covers of the page from it
+      rebuild_index = true;
+      _FindReviews(movie_id, 0, _index_size, &index_reviews, span.get());
+      for (int i = start;
+           i < stop && i < static_cast<int>(index_reviews.size()); ++i) {
+        review_ids.emplace_back(index_reviews[i].first);
       }
+      beyond_index =
+          static_cast<int>(index_reviews.size()) == _index_size;
+    }
+  }
+
+  // The rest of the page is beyond the index
+  int mongo_start = start + review_ids.size();
+  if (beyond_index && mongo_start < stop) {
+    std::vector<std::pair<int64_t, int64_t>> reviews;
+    _FindReviews(movie_id, mongo_start, stop - mongo_start, &reviews,
+                 span.get());
+    for (auto &review : reviews) {
+      review_ids.emplace_back(review.first);
     }
-    find_span->Finish();
-    bson_destroy(opts);
-    bson_destroy(query);
-    mongoc_cursor_destroy(cursor);
-    mongoc_collection_destroy(collection);
-    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
   }
 
   std::future<std::vector<Review>> review_future = std::async(
@@ -326,57 +264,112 @@ void MovieReviewHandler::ReadMovieReviews(
         return _return_reviews;
       });
 
-  std::future<cpp_redis::reply> zadd_reply_future;
-  if (!redis_update_map.empty()) {
-    // Update Redis
-    redis_client_wrapper = _redis_client_pool->Pop();
-    if (!redis_client_wrapper) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_REDIS_ERROR;
-      se.message = "Cannot connected to Redis server";
-      throw se;
+  if (rebuild_index) {
+    // Update Redis while the reviews are read
+    std::multimap<std::string, std::string> redis_update_map = {
+        {"+inf", kIndexComplete}};
+    for (auto &review : index_reviews) {
+      redis_update_map.insert(
+          {std::to_string(review.second), std::to_string(review.first)});
+    }
+    try {
+      auto redis_client_wrapper = _redis_client_pool->Pop();
+      if (redis_client_wrapper) {
+        auto redis_client = redis_client_wrapper->GetClient();
+        auto redis_update_span = opentracing::Tracer::Global()->StartSpan(
+            "RedisUpdate", {opentracing::ChildOf(&span->context())});
+        redis_client->zadd(movie_id, {}, redis_update_map);
+        redis_client->zremrangebyrank(movie_id, 0, -(_index_size + 2));
+        redis_client->sync_commit();
+        _redis_client_pool->Push(redis_client_wrapper);
+        redis_update_span->Finish();
+      } else {
+        LOG(error) << "Cannot connected to Redis server";
+      }
+    } catch (...) {
+      LOG(error) << "Failed to Update Redis Server";
     }
-    redis_client = redis_client_wrapper->GetClient();
-    auto redis_update_span = opentracing::Tracer::Global()->StartSpan(
-        "RedisUpdate", {opentracing::ChildOf(&span->context())});
-    redis_client->del(std::vector<std::string>{movie_id});
-    std::vector<std::string> options{"NX"};
-    zadd_reply_future = redis_client->zadd(
-        movie_id, options, redis_update_map);
-    redis_client->commit();
-    redis_update_span->Finish();
   }
 
   try {
     _return = review_future.get();
   } catch (...) {
     LOG(error) << "Failed to get review from review-storage-service";
-    if (!redis_update_map.empty()) {
-      try {
-        zadd_reply_future.get();
-      } catch (...) {
-        LOG(error) << "Failed to Update Redis Server";
-      }
-      _redis_client_pool->Push(redis_client_wrapper);
-    }
     throw;
   }
 
-  if (!redis_update_map.empty()) {
-    try {
-      zadd_reply_future.get();
-    } catch (...) {
-      LOG(error) << "Failed to Update Redis Server";
-      _redis_client_pool->Push(redis_client_wrapper);
-      throw;
-    }
-    _redis_client_pool->Push(redis_client_wrapper);
-  }
-
   span->Finish();
   
 }
 
+// Appends the (review_id, timestamp) of the reviews of movie_id, newest
+// first, from the skip-th on, up to limit of them
+void MovieReviewHandler::_FindReviews(
+    const std::string &movie_id, int64_t skip, int64_t limit,
+    std::vector<std::pair<int64_t, int64_t>> *reviews,
+    opentracing::Span *span) {
+  mongoc_client_t *mongodb_client = mongoc_client_pool_pop(
+      _mongodb_client_pool);
+  if (!mongodb_client) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to pop a client from MongoDB pool";
+    throw se;
+  }
+  auto collection = mongoc_client_get_collection(
+      mongodb_client, "movie-review", "reviews");
+  if (!collection) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to create collection reviews from MongoDB";
+    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+    throw se;
+  }
+
+  bson_t *query = BCON_NEW("movie_id", BCON_UTF8(movie_id.c_str()));
+  bson_t *opts = BCON_NEW(
+      "projection", "{",
+      "_id", BCON_BOOL(false),
+      "review_id", BCON_BOOL(true),
+      "timestamp", BCON_BOOL(true), "}",
+      "sort", "{",
+      "timestamp", BCON_INT32(-1),
+      "review_id", BCON_INT32(-1), "}",
+      "skip", BCON_INT64(skip),
+      "limit", BCON_INT64(limit));
+  auto find_span = opentracing::Tracer::Global()->StartSpan(
+      "MongoFindMovieReviews", {opentracing::ChildOf(&span->context())});
+  mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
+      collection, query, opts, nullptr);
+  const bson_t *doc;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    bson_iter_t iter;
+    int64_t review_id;
+    int64_t timestamp;
+    if (bson_iter_init(&iter, doc) &&
+        GetInt64Field(&iter, "review_id", &review_id) &&
+        GetInt64Field(&iter, "timestamp", &timestamp)) {
+      reviews->emplace_back(review_id, timestamp);
+    }
+  }
+  find_span->Finish();
+  bson_error_t error;
+  bool failed = mongoc_cursor_error(cursor, &error);
+  bson_destroy(opts);
+  bson_destroy(query);
+  mongoc_cursor_destroy(cursor);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  if (failed) {
+    LOG(error) << "Failed to find reviews of movie " << movie_id
+               << " from MongoDB: " << error.message;
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = error.message;
+    throw se;
+  }
+}
+
 } // namespace media_service
 
 
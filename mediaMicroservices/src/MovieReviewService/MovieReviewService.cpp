@@ -6,11 +6,11 @@
 
 #include "MovieReviewHandler.h"
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "../utils_mongodb.h"
 
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using media_service::MovieReviewHandler;
 using namespace media_service;
@@ -30,6 +30,7 @@ int main(int argc, char *argv[]) {
     LOG(fatal) << "Cannot open the config file.";
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
   int port = config_json["movie-review-service"]["port"];
   std::string redis_addr =
@@ -57,7 +58,8 @@ int main(int argc, char *argv[]) {
   }
   bool r = false;
   while (!r) {
-    r = CreateIndex(mongodb_client, "movie-review", "movie_id", true);
+    r = CreateIndex(mongodb_client, "movie-review", "reviews",
+        {{"movie_id", 1}, {"timestamp", -1}, {"review_id", -1}}, true);
     if (!r) {
       LOG(error) << "Failed to create mongodb index, try again";
       sleep(1);
@@ -70,9 +72,11 @@ int main(int argc, char *argv[]) {
           std::make_shared<MovieReviewHandler>(
               &redis_client_pool,
               mongodb_client_pool,
-              &review_storage_client_pool)),
+              &review_storage_client_pool,
+              config_json["movie-review-service"].value(
+                  "review_index_size", 1000))),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
   std::cout << "Starting the movie-review-service server ..." << std::endl;
@@ -0,0 +1,78 @@
+#ifndef MEDIA_MICROSERVICES_SRC_PAGESERVICE_LRUCACHE_H_
+#define MEDIA_MICROSERVICES_SRC_PAGESERVICE_LRUCACHE_H_
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace media_service {
+
+// At most capacity values, each valid for ttl_ms after it is put, evicting
+// the least recently used first. A capacity of 0 caches nothing.
+template <class Value>
+class LruCache {
+ public:
+  LruCache(size_t capacity, int ttl_ms) : _capacity(capacity), _ttl(ttl_ms) {}
+
+  LruCache(const LruCache &) = delete;
+  LruCache &operator=(const LruCache &) = delete;
+
+  // Copies the value of key, if any and still valid, to *value
+  bool Get(const std::string &key, Value *value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+      return false;
+    }
+    if (it->second->expiry <= std::chrono::steady_clock::now()) {
+      _entries.erase(it->second);
+      _index.erase(it);
+      return false;
+    }
+    _entries.splice(_entries.begin(), _entries, it->second);
+    *value = it->second->value;
+    return true;
+  }
+
+  void Put(const std::string &key, Value value) {
+    if (_capacity == 0) {
+      return;
+    }
+    auto expiry = std::chrono::steady_clock::now() + _ttl;
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+      it->second->value = std::move(value);
+      it->second->expiry = expiry;
+      _entries.splice(_entries.begin(), _entries, it->second);
+      return;
+    }
+    if (_entries.size() >= _capacity) {
+      _index.erase(_entries.back().key);
+      _entries.pop_back();
+    }
+    _entries.push_front(Entry{key, std::move(value), expiry});
+    _index.emplace(key, _entries.begin());
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    Value value;
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  size_t _capacity;
+  std::chrono::milliseconds _ttl;
+  std::mutex _mutex;
+  // Most recently used first
+  std::list<Entry> _entries;
+  std::unordered_map<std::string, typename std::list<Entry>::iterator> _index;
+};
+
+} // namespace media_service
+
+#endif //MEDIA_MICROSERVICES_SRC_PAGESERVICE_LRUCACHE_H_
@@ -13,18 +13,36 @@
 #include "../logger.h"
 #include "../tracing.h"
 #include "../ClientPool.h"
+#include "../RedisClient.h"
 #include "../ThriftClient.h"
+#include "LruCache.h"
 
 
 namespace media_service {
 
+// Pages, assembled from a movie's info, reviews, cast and plot, are cached
+// by (movie_id, review_start, review_stop) together with the versions of the
+// movie's reviews and rating when they were read. movie-review-service
+// increments <movie_id>:reviews_version in movie-review-redis with each
+// review, and movie-info-service <movie_id>:rating_version in rating-redis
+// with each rating it commits, after the write. A cached page is served only
+// while both versions are unchanged, which costs one Redis read each, in
+// parallel. Cast and plot never change once written.
+//
+// On a miss, cast and plot are read together with the movie's info and
+// reviews when the plot_id and cast_info_ids of the movie are known from an
+// earlier page, and checked against the movie's info when it arrives.
 class PageHandler : public PageServiceIf {
  public:
   PageHandler(
       ClientPool<ThriftClient<MovieReviewServiceClient>> *,
       ClientPool<ThriftClient<MovieInfoServiceClient>> *,
       ClientPool<ThriftClient<CastInfoServiceClient>> *,
-      ClientPool<ThriftClient<PlotServiceClient>> *);
+      ClientPool<ThriftClient<PlotServiceClient>> *,
+      ClientPool<RedisClient> *,
+      ClientPool<RedisClient> *,
+      int page_cache_size,
+      int page_cache_ttl_ms);
   ~PageHandler() override = default;
 
   void ReadPage(Page& _return, int64_t req_id, const std::string& movie_id,
@@ -32,21 +50,54 @@ class PageHandler : public PageServiceIf {
                 const std::map<std::string, std::string> & carrier) override;
 
  private:
+  struct CachedPage {
+    int64_t reviews_version;
+    int64_t rating_version;
+    Page page;
+  };
+
+  struct MovieLayout {
+    int64_t plot_id;
+    std::vector<int64_t> cast_info_ids;
+  };
+
+  bool _ReadVersions(const std::string &movie_id, int64_t *reviews_version,
+                     int64_t *rating_version);
+  std::vector<CastInfo> _ReadCastInfo(
+      int64_t req_id, const std::vector<int64_t> &cast_info_ids,
+      const std::map<std::string, std::string> &carrier);
+  std::string _ReadPlot(int64_t req_id, int64_t plot_id,
+                        const std::map<std::string, std::string> &carrier);
+
   ClientPool<ThriftClient<MovieReviewServiceClient>> *_movie_review_client_pool;
   ClientPool<ThriftClient<MovieInfoServiceClient>> *_movie_info_client_pool;
   ClientPool<ThriftClient<CastInfoServiceClient>> *_cast_info_client_pool;
   ClientPool<ThriftClient<PlotServiceClient>> *_plot_client_pool;
+  ClientPool<RedisClient> *_movie_review_redis_client_pool;
+  ClientPool<RedisClient> *_rating_redis_client_pool;
+  LruCache<CachedPage> _page_cache;
+  LruCache<MovieLayout> _movie_layout_cache;
 };
+
 PageHandler::PageHandler(
     ClientPool<ThriftClient<MovieReviewServiceClient>> *movie_review_client_pool,
     ClientPool<ThriftClient<MovieInfoServiceClient>> *movie_info_client_pool,
     ClientPool<ThriftClient<CastInfoServiceClient>> *cast_info_client_pool,
-    ClientPool<ThriftClient<PlotServiceClient>> *plot_client_pool) {
+    ClientPool<ThriftClient<PlotServiceClient>> *plot_client_pool,
+    ClientPool<RedisClient> *movie_review_redis_client_pool,
+    ClientPool<RedisClient> *rating_redis_client_pool,
+    int page_cache_size,
+    int page_cache_ttl_ms)
+    : _page_cache(page_cache_size, page_cache_ttl_ms),
+      _movie_layout_cache(page_cache_size, page_cache_ttl_ms) {
   _movie_review_client_pool = movie_review_client_pool;
   _movie_info_client_pool = movie_info_client_pool;
   _cast_info_client_pool = cast_info_client_pool;
   _plot_client_pool = plot_client_pool;
+  _movie_review_redis_client_pool = movie_review_redis_client_pool;
+  _rating_redis_client_pool = rating_redis_client_pool;
 }
+
 void PageHandler::ReadPage(
     Page &_return,
     int64_t req_id,
@@ -65,6 +116,26 @@ void PageHandler::ReadPage(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  std::string page_key = movie_id + ":" + std::to_string(review_start) +
+      ":" + std::to_string(review_stop);
+  CachedPage cached_page;
+  auto versions_span = opentracing::Tracer::Global()->StartSpan(
+      "RedisGetVersions", {opentracing::ChildOf(&span->context())});
+  bool versioned = _ReadVersions(movie_id, &cached_page.reviews_version,
+                                 &cached_page.rating_version);
+  versions_span->Finish();
+  if (versioned) {
+    CachedPage hit;
+    if (_page_cache.Get(page_key, &hit) &&
+        hit.reviews_version == cached_page.reviews_version &&
+        hit.rating_version == cached_page.rating_version) {
+      LOG(debug) << "Page " << page_key << " cache hit";
+      _return = std::move(hit.page);
+      span->Finish();
+      return;
+    }
+  }
+
   std::future<std::vector<Review>> movie_review_future;
   std::future<MovieInfo> movie_info_future;
   std::future<std::vector<CastInfo>> cast_info_future;
@@ -114,6 +185,18 @@ void PageHandler::ReadPage(
     return _return_movie_reviews;
   });
 
+  // Speculatively, with the plot and cast of the movie's last page
+  MovieLayout layout;
+  bool speculative = _movie_layout_cache.Get(movie_id, &layout);
+  if (speculative) {
+    cast_info_future = std::async(
+        std::launch::async, &PageHandler::_ReadCastInfo, this, req_id,
+        layout.cast_info_ids, writer_text_map);
+    plot_future = std::async(
+        std::launch::async, &PageHandler::_ReadPlot, this, req_id,
+        layout.plot_id, writer_text_map);
+  }
+
   try {
     _return.movie_info = movie_info_future.get();
   } catch (...) {
@@ -125,49 +208,21 @@ void PageHandler::ReadPage(
     cast_info_ids.emplace_back(cast.cast_info_id);
   }
 
-  cast_info_future = std::async(std::launch::async, [&](){
-    std::vector<CastInfo> _return_cast_infos;
-    auto cast_info_client_wrapper = _cast_info_client_pool->Pop();
-    if (!cast_info_client_wrapper) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
-      se.message = "Failed to connected to cast-info-service";
-      throw se;
-    }
-    auto cast_info_client = cast_info_client_wrapper->GetClient();
-    try {
-      cast_info_client->ReadCastInfo(_return_cast_infos, req_id,
-          cast_info_ids, writer_text_map);
-    } catch (...) {
-      _cast_info_client_pool->Push(cast_info_client_wrapper);
-      LOG(error) << "Failed to read cast-info to cast-info-service";
-      throw;
-    }
-    _cast_info_client_pool->Push(cast_info_client_wrapper);
-    return _return_cast_infos;
-  });
-
-  plot_future = std::async(std::launch::async, [&](){
-    std::string _return_plot;
-    auto plot_client_wrapper = _plot_client_pool->Pop();
-    if (!plot_client_wrapper) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
-      se.message = "Failed to connected to plot-service";
-      throw se;
+  if (!speculative || layout.plot_id != _return.movie_info.plot_id ||
+      layout.cast_info_ids != cast_info_ids) {
+    if (speculative) {
+      LOG(debug) << "Plot or cast of movie " << movie_id << " changed";
     }
-    auto plot_client = plot_client_wrapper->GetClient();
-    try {
-      plot_client->ReadPlot(_return_plot, req_id, _return.movie_info.plot_id,
-          writer_text_map);
-    } catch (...) {
-      _plot_client_pool->Push(plot_client_wrapper);
-      LOG(error) << "Failed to read plot to plot-service";
-      throw;
-    }
-    _plot_client_pool->Push(plot_client_wrapper);
-    return _return_plot;
-  });
+    cast_info_future = std::async(
+        std::launch::async, &PageHandler::_ReadCastInfo, this, req_id,
+        cast_info_ids, writer_text_map);
+    plot_future = std::async(
+        std::launch::async, &PageHandler::_ReadPlot, this, req_id,
+        _return.movie_info.plot_id, writer_text_map);
+    layout.plot_id = _return.movie_info.plot_id;
+    layout.cast_info_ids = std::move(cast_info_ids);
+    _movie_layout_cache.Put(movie_id, layout);
+  }
 
   try {
     _return.reviews = movie_review_future.get();
@@ -176,9 +231,110 @@ void PageHandler::ReadPage(
   } catch (...) {
     throw;
   }
+
+  if (versioned) {
+    cached_page.page = _return;
+    _page_cache.Put(page_key, std::move(cached_page));
+  }
   span->Finish();
 }
 
+// Versions of the reviews and the rating of movie_id, 0 before the first
+// change, read from both Redis servers at once
+bool PageHandler::_ReadVersions(
+    const std::string &movie_id, int64_t *reviews_version,
+    int64_t *rating_version) {
+  RedisClient *movie_review_redis_client_wrapper = nullptr;
+  RedisClient *rating_redis_client_wrapper = nullptr;
+  bool read = false;
+  try {
+    movie_review_redis_client_wrapper = _movie_review_redis_client_pool->Pop();
+    rating_redis_client_wrapper = _rating_redis_client_pool->Pop();
+    if (movie_review_redis_client_wrapper && rating_redis_client_wrapper) {
+      auto movie_review_redis_client =
+          movie_review_redis_client_wrapper->GetClient();
+      auto rating_redis_client = rating_redis_client_wrapper->GetClient();
+      auto reviews_version_future =
+          movie_review_redis_client->get(movie_id + ":reviews_version");
+      auto rating_version_future =
+          rating_redis_client->get(movie_id + ":rating_version");
+      movie_review_redis_client->commit();
+      rating_redis_client->commit();
+      auto reviews_version_reply = reviews_version_future.get();
+      auto rating_version_reply = rating_version_future.get();
+      if ((reviews_version_reply.is_string() ||
+           reviews_version_reply.is_null()) &&
+          (rating_version_reply.is_string() ||
+           rating_version_reply.is_null())) {
+        *reviews_version = reviews_version_reply.is_null() ? 0 :
+            std::stoll(reviews_version_reply.as_string());
+        *rating_version = rating_version_reply.is_null() ? 0 :
+            std::stoll(rating_version_reply.as_string());
+        read = true;
+      }
+    }
+  } catch (...) {
+  }
+  if (movie_review_redis_client_wrapper) {
+    _movie_review_redis_client_pool->Push(movie_review_redis_client_wrapper);
+  }
+  if (rating_redis_client_wrapper) {
+    _rating_redis_client_pool->Push(rating_redis_client_wrapper);
+  }
+  if (!read) {
+    LOG(warning) << "Failed to read the versions of movie " << movie_id
+                 << ", reading its page without cache";
+  }
+  return read;
+}
+
+std::vector<CastInfo> PageHandler::_ReadCastInfo(
+    int64_t req_id, const std::vector<int64_t> &cast_info_ids,
+    const std::map<std::string, std::string> &carrier) {
+  std::vector<CastInfo> _return_cast_infos;
+  auto cast_info_client_wrapper = _cast_info_client_pool->Pop();
+  if (!cast_info_client_wrapper) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
+    se.message = "Failed to connected to cast-info-service";
+    throw se;
+  }
+  auto cast_info_client = cast_info_client_wrapper->GetClient();
+  try {
+    cast_info_client->ReadCastInfo(_return_cast_infos, req_id,
+        cast_info_ids, carrier);
+  } catch (...) {
+    _cast_info_client_pool->Push(cast_info_client_wrapper);
+    LOG(error) << "Failed to read cast-info to cast-info-service";
+    throw;
+  }
+  _cast_info_client_pool->Push(cast_info_client_wrapper);
+  return _return_cast_infos;
+}
+
+std::string PageHandler::_ReadPlot(
+    int64_t req_id, int64_t plot_id,
+    const std::map<std::string, std::string> &carrier) {
+  std::string _return_plot;
+  auto plot_client_wrapper = _plot_client_pool->Pop();
+  if (!plot_client_wrapper) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
+    se.message = "Failed to connected to plot-service";
+    throw se;
+  }
+  auto plot_client = plot_client_wrapper->GetClient();
+  try {
+    plot_client->ReadPlot(_return_plot, req_id, plot_id, carrier);
+  } catch (...) {
+    _plot_client_pool->Push(plot_client_wrapper);
+    LOG(error) << "Failed to read plot to plot-service";
+    throw;
+  }
+  _plot_client_pool->Push(plot_client_wrapper);
+  return _return_plot;
+}
+
 } //namespace media_service
 
 
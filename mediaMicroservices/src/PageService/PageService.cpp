@@ -5,12 +5,12 @@
 #include <signal.h>
 
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "PageHandler.h"
 
 using json = nlohmann::json;
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using namespace media_service;
 
@@ -28,6 +28,7 @@ int main(int argc, char *argv[]) {
   if (load_config_file("config/service-config.json", &config_json) != 0) {
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
   int port = config_json["page-service"]["port"];
   std::string cast_info_addr = config_json["cast-info-service"]["addr"];
@@ -38,6 +39,12 @@ int main(int argc, char *argv[]) {
   int movie_info_port = config_json["movie-info-service"]["port"];
   std::string plot_addr = config_json["plot-service"]["addr"];
   int plot_port = config_json["plot-service"]["port"];
+  std::string movie_review_redis_addr =
+      config_json["movie-review-redis"]["addr"];
+  int movie_review_redis_port = config_json["movie-review-redis"]["port"];
+  std::string rating_redis_addr = config_json["rating-redis"]["addr"];
+  int rating_redis_port = config_json["rating-redis"]["port"];
+  auto &service_config = config_json["page-service"];
 
   ClientPool<ThriftClient<MovieInfoServiceClient>>
       movie_info_client_pool("movie-info-client", movie_info_addr,
@@ -50,6 +57,11 @@ int main(int argc, char *argv[]) {
                                movie_review_port, 0, 128, 1000);
   ClientPool<ThriftClient<PlotServiceClient>>
       plot_client_pool("plot-client", plot_addr, plot_port, 0, 128, 1000);
+  ClientPool<RedisClient> movie_review_redis_client_pool(
+      "movie-review-redis", movie_review_redis_addr, movie_review_redis_port,
+      0, 128, 1000);
+  ClientPool<RedisClient> rating_redis_client_pool(
+      "rating-redis", rating_redis_addr, rating_redis_port, 0, 128, 1000);
 
   TThreadedServer server(
       std::make_shared<PageServiceProcessor>(
@@ -57,9 +69,13 @@ int main(int argc, char *argv[]) {
               &movie_review_client_pool,
               &movie_info_client_pool,
               &cast_info_client_pool,
-              &plot_client_pool)),
+              &plot_client_pool,
+              &movie_review_redis_client_pool,
+              &rating_redis_client_pool,
+              service_config.value("page_cache_size", 10000),
+              service_config.value("page_cache_ttl_ms", 60000))),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
   std::cout << "Starting the page-service server ..." << std::endl;
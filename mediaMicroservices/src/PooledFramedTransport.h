@@ -0,0 +1,560 @@
+#ifndef MEDIA_MICROSERVICES_POOLEDFRAMEDTRANSPORT_H
+#define MEDIA_MICROSERVICES_POOLEDFRAMEDTRANSPORT_H
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/transport/TSocket.h>
+#include <thrift/transport/TSSLSocket.h>
+
+#include "FrameCompression.h"
+
+namespace media_service {
+using apache::thrift::transport::TBufferBase;
+using apache::thrift::transport::TSocket;
+using apache::thrift::transport::TSSLSocket;
+using apache::thrift::transport::TTransport;
+using apache::thrift::transport::TTransportException;
+using apache::thrift::transport::TTransportFactory;
+using apache::thrift::transport::TVirtualTransport;
+
+struct FrameBufferPoolStats {
+  uint64_t acquires;     // buffers handed out
+  uint64_t allocations;  // of which newly allocated
+  uint64_t idle_bytes;   // held by the pool for reuse
+};
+
+// Frame buffers of the Thrift connections of a process, in power-of-two size
+// classes from 4 KiB to 4 MiB. Larger frames get buffers of their own size,
+// which are freed on release.
+class FrameBufferPool {
+ public:
+  static constexpr int kMinClassShift = 12;
+  static constexpr int kMaxClassShift = 22;
+  static constexpr uint32_t kMinBufferSize = 1u << kMinClassShift;
+  // Buffers beyond this many bytes per size class are freed on release
+  static constexpr uint64_t kMaxIdleBytesPerClass = 8u << 20;
+
+  static FrameBufferPool &Instance() {
+    static FrameBufferPool *pool = new FrameBufferPool();
+    return *pool;
+  }
+
+  // Returns a buffer of at least size bytes, and its size in *capacity.
+  uint8_t *Acquire(uint32_t size, uint32_t *capacity) {
+    _acquires.fetch_add(1, std::memory_order_relaxed);
+    int shift = kMinClassShift;
+    while (shift <= kMaxClassShift && (1u << shift) < size) {
+      ++shift;
+    }
+    if (shift > kMaxClassShift) {
+      *capacity = size;
+      _allocations.fetch_add(1, std::memory_order_relaxed);
+      return new uint8_t[size];
+    }
+    *capacity = 1u << shift;
+    auto &size_class = _classes[shift - kMinClassShift];
+    {
+      std::lock_guard<std::mutex> lock(size_class.mtx);
+      if (!size_class.idle.empty()) {
+        uint8_t *buf = size_class.idle.back();
+        size_class.idle.pop_back();
+        return buf;
+      }
+    }
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+    return new uint8_t[*capacity];
+  }
+
+  void Release(uint8_t *buf, uint32_t capacity) {
+    int shift = kMinClassShift;
+    while (shift <= kMaxClassShift && (1u << shift) != capacity) {
+      ++shift;
+    }
+    if (shift <= kMaxClassShift) {
+      auto &size_class = _classes[shift - kMinClassShift];
+      std::lock_guard<std::mutex> lock(size_class.mtx);
+      if ((size_class.idle.size() + 1) * capacity <= kMaxIdleBytesPerClass) {
+        size_class.idle.push_back(buf);
+        return;
+      }
+    }
+    delete[] buf;
+  }
+
+  FrameBufferPoolStats GetStats() {
+    FrameBufferPoolStats stats;
+    stats.acquires = _acquires.load();
+    stats.allocations = _allocations.load();
+    stats.idle_bytes = 0;
+    for (int i = 0; i <= kMaxClassShift - kMinClassShift; ++i) {
+      std::lock_guard<std::mutex> lock(_classes[i].mtx);
+      stats.idle_bytes += static_cast<uint64_t>(_classes[i].idle.size())
+                          << (i + kMinClassShift);
+    }
+    return stats;
+  }
+
+ private:
+  struct SizeClass {
+    std::mutex mtx;
+    std::vector<uint8_t *> idle;
+  };
+
+  FrameBufferPool() : _acquires(0), _allocations(0) {}
+
+  SizeClass _classes[kMaxClassShift - kMinClassShift + 1];
+  std::atomic<uint64_t> _acquires;
+  std::atomic<uint64_t> _allocations;
+};
+
+// Drop-in replacement of TFramedTransport, the wire format being the same: a
+// 4-byte big-endian length, then the message.
+//
+// TFramedTransport grows its buffers by doubling from 512 bytes on every new
+// connection and then keeps them at their peak size for the life of the
+// connection. It reads the length and the payload of every frame with two
+// recv() calls. This transport instead:
+//  - takes its buffers from FrameBufferPool, keeps one of the smallest size
+//    and gives larger ones back after each frame;
+//  - reads the length of a frame into a separate 4-byte header with readv(),
+//    together with as much of the payload as the socket has and fits in the
+//    buffer. Bytes of the next frames that arrive with it are kept for the
+//    next read. A frame that fits in the buffer takes a single system call;
+//  - serves the payload in place, so that TBinaryProtocol borrows strings
+//    straight from the frame buffer (see get_protocol_factory()).
+// TLS sockets have no descriptor to readv() from and are read through
+// TSSLSocket::read().
+//
+// With a FrameCompression, frames of at least its threshold are compressed
+// once the peer has shown that it accepts them. Bits of the frame length,
+// which TFramedTransport limits to 256 MiB, carry the negotiation:
+//  - bits 28-29: the FrameCodec the sender accepts, on the frames of a
+//    client from the start, and on the frames of a server once its client
+//    has sent them; in a compressed frame, the codec it is compressed with;
+//  - bit 30: the payload is the size of the message, then the message
+//    compressed.
+// Peers without compression, like TFramedTransport and the nginx Lua
+// clients, neither send nor get these bits.
+//
+// Unlike TSocket::read(), reads are not woken up by
+// TServerSocket::interruptChildren(), so TThreadedServer::stop() waits for
+// clients to disconnect. The services never stop their servers.
+class PooledFramedTransport
+    : public TVirtualTransport<PooledFramedTransport, TBufferBase> {
+ public:
+  static const uint32_t kHeaderSize = sizeof(uint32_t);
+  static const uint32_t kSizeMask = (1u << 28) - 1;
+  static const uint32_t kCodecShift = 28;
+  static const uint32_t kCodecMask = 3u << kCodecShift;
+  static const uint32_t kCompressedFlag = 1u << 30;
+  static const uint32_t kNegativeFlag = 1u << 31;
+  static const uint32_t kDefaultMaxFrameSize = kSizeMask;
+
+  explicit PooledFramedTransport(
+      std::shared_ptr<TTransport> transport,
+      std::shared_ptr<FrameCompression> compression = nullptr,
+      bool client = false)
+      : _transport(transport),
+        _compression(compression),
+        _client(client),
+        _max_frame_size(kDefaultMaxFrameSize) {
+    auto socket = std::dynamic_pointer_cast<TSocket>(transport);
+    if (socket && !std::dynamic_pointer_cast<TSSLSocket>(transport)) {
+      _socket = socket.get();
+    }
+  }
+
+  PooledFramedTransport(const PooledFramedTransport &) = delete;
+  PooledFramedTransport &operator=(const PooledFramedTransport &) = delete;
+
+  ~PooledFramedTransport() override {
+    if (_rbuf) {
+      FrameBufferPool::Instance().Release(_rbuf, _rcap);
+    }
+    if (_wbuf) {
+      FrameBufferPool::Instance().Release(_wbuf, _wcap);
+    }
+    if (_dbuf) {
+      FrameBufferPool::Instance().Release(_dbuf, _dcap);
+    }
+  }
+
+  void open() override {
+    ResetRead();
+    _peer_codec = FrameCodec::NONE;
+    _transport->open();
+  }
+
+  bool isOpen() override { return _transport->isOpen(); }
+
+  bool peek() override {
+    return rBase_ < rBound_ || _ahead < _ahead_end || _transport->peek();
+  }
+
+  void close() override {
+    flush();
+    ResetRead();
+    _peer_codec = FrameCodec::NONE;
+    _transport->close();
+  }
+
+  uint32_t readSlow(uint8_t *buf, uint32_t len) override {
+    uint32_t have = static_cast<uint32_t>(rBound_ - rBase_);
+    // As TFramedTransport: hand over the rest of the frame rather than
+    // block on the next one.
+    if (have > 0) {
+      std::memcpy(buf, rBase_, have);
+      rBase_ = rBound_;
+      return have;
+    }
+    if (!ReadFrame()) {
+      return 0;
+    }
+    uint32_t give = std::min(len, static_cast<uint32_t>(rBound_ - rBase_));
+    std::memcpy(buf, rBase_, give);
+    rBase_ += give;
+    return give;
+  }
+
+  void writeSlow(const uint8_t *buf, uint32_t len) override {
+    uint32_t have =
+        _wbuf ? static_cast<uint32_t>(wBase_ - _wbuf) : kHeaderSize;
+    if (len + have < have || len + have > 0x7fffffff) {
+      throw TTransportException(
+          TTransportException::BAD_ARGS,
+          "Attempted to write over 2 GB to PooledFramedTransport.");
+    }
+    // Doubles beyond the largest size class too
+    uint32_t want = std::max(have + len, std::min(2 * _wcap, 0x7fffffffu));
+    uint32_t capacity;
+    uint8_t *new_buf = FrameBufferPool::Instance().Acquire(want, &capacity);
+    if (_wbuf) {
+      std::memcpy(new_buf, _wbuf, have);
+      FrameBufferPool::Instance().Release(_wbuf, _wcap);
+    }
+    _wbuf = new_buf;
+    _wcap = capacity;
+    setWriteBuffer(_wbuf + have, _wcap - have);
+    std::memcpy(wBase_, buf, len);
+    wBase_ += len;
+  }
+
+  const uint8_t *borrowSlow(uint8_t *buf, uint32_t *len) override {
+    // As TFramedTransport: borrowing never spans frames.
+    return nullptr;
+  }
+
+  void flush() override {
+    if (_wbuf) {
+      uint32_t size = static_cast<uint32_t>(wBase_ - _wbuf) - kHeaderSize;
+      if (size > 0) {
+        // Reset before writing, as TFramedTransport, so that a failed
+        // write does not leave the frame behind.
+        wBase_ = _wbuf + kHeaderSize;
+        if (!(_compression && _peer_codec != FrameCodec::NONE &&
+              size >= _compression->threshold() && WriteCompressed(size))) {
+          WriteHeader(_wbuf, size | AcceptFlags());
+          _transport->write(_wbuf, kHeaderSize + size);
+        }
+      }
+    }
+    _transport->flush();
+    if (_wbuf && _wcap > FrameBufferPool::kMinBufferSize) {
+      FrameBufferPool::Instance().Release(_wbuf, _wcap);
+      _wbuf = nullptr;
+      _wcap = 0;
+      setWriteBuffer(nullptr, 0);
+    }
+  }
+
+  uint32_t readEnd() override {
+    uint32_t bytes_read = _frame_bytes;
+    if (_dbuf) {
+      FrameBufferPool::Instance().Release(_dbuf, _dcap);
+      _dbuf = nullptr;
+      _dcap = 0;
+      setReadBuffer(_rbuf, 0);
+    }
+    // Read-ahead bytes keep the buffer; so does the smallest size.
+    if (_rbuf && _ahead == _ahead_end &&
+        _rcap > FrameBufferPool::kMinBufferSize) {
+      FrameBufferPool::Instance().Release(_rbuf, _rcap);
+      _rbuf = nullptr;
+      _rcap = 0;
+      ResetRead();
+    }
+    return bytes_read;
+  }
+
+  uint32_t writeEnd() override {
+    return _wbuf ? static_cast<uint32_t>(wBase_ - _wbuf) : 0;
+  }
+
+  std::shared_ptr<TTransport> getUnderlyingTransport() { return _transport; }
+
+  void setMaxFrameSize(uint32_t max_frame_size) {
+    _max_frame_size = max_frame_size < kSizeMask ? max_frame_size : kSizeMask;
+  }
+
+  using TBufferBase::readAll;
+
+ private:
+  // Discards the current frame and the bytes read ahead, keeping the
+  // buffer.
+  void ResetRead() {
+    setReadBuffer(_rbuf, 0);
+    _ahead = _ahead_end = _rbuf;
+  }
+
+  static void WriteHeader(uint8_t *buf, uint32_t header) {
+    uint32_t header_nbo = htonl(header);
+    std::memcpy(buf, &header_nbo, kHeaderSize);
+  }
+
+  uint32_t AcceptFlags() const {
+    if (!_compression || (!_client && _peer_codec == FrameCodec::NONE)) {
+      return 0;
+    }
+    return static_cast<uint32_t>(_compression->codec()) << kCodecShift;
+  }
+
+  // Sends the message of size bytes in _wbuf compressed with the codec of
+  // the peer. Returns false, having sent nothing, when it does not shrink.
+  bool WriteCompressed(uint32_t size) {
+    if (size <= 2 * kHeaderSize) {
+      return false;
+    }
+    uint32_t capacity;
+    uint8_t *buf = FrameBufferPool::Instance().Acquire(size, &capacity);
+    uint32_t compressed = _compression->Compress(
+        _peer_codec, _wbuf + kHeaderSize, size, buf + 2 * kHeaderSize,
+        size - 2 * kHeaderSize - 1);
+    if (compressed == 0) {
+      FrameBufferPool::Instance().Release(buf, capacity);
+      return false;
+    }
+    WriteHeader(buf, (kHeaderSize + compressed) | kCompressedFlag |
+                         static_cast<uint32_t>(_peer_codec) << kCodecShift);
+    WriteHeader(buf + kHeaderSize, size);
+    try {
+      _transport->write(buf, 2 * kHeaderSize + compressed);
+    } catch (...) {
+      FrameBufferPool::Instance().Release(buf, capacity);
+      throw;
+    }
+    FrameBufferPool::Instance().Release(buf, capacity);
+    return true;
+  }
+
+  // Reads into header, then into body, what the transport has; returns 0 at
+  // end of file.
+  uint32_t Read(uint8_t *header, uint32_t header_len, uint8_t *body,
+                uint32_t body_len) {
+    if (!_socket) {
+      return header_len > 0 ? _transport->read(header, header_len)
+                            : _transport->read(body, body_len);
+    }
+    int fd = _socket->getSocketFD();
+    if (fd < 0) {
+      throw TTransportException(TTransportException::NOT_OPEN,
+                                "Called read on non-open socket");
+    }
+    struct iovec iov[2];
+    int iovcnt = 0;
+    if (header_len > 0) {
+      iov[iovcnt].iov_base = header;
+      iov[iovcnt++].iov_len = header_len;
+    }
+    iov[iovcnt].iov_base = body;
+    iov[iovcnt++].iov_len = body_len;
+    while (true) {
+      ssize_t n = ::readv(fd, iov, iovcnt);
+      if (n >= 0) {
+        return static_cast<uint32_t>(n);
+      }
+      // The errors of TSocket::read()
+      int errno_copy = errno;
+      if (errno_copy == EINTR) {
+        continue;
+      }
+      if (errno_copy == EAGAIN || errno_copy == EWOULDBLOCK) {
+        throw TTransportException(TTransportException::TIMED_OUT,
+                                  "EAGAIN (timed out)");
+      }
+      if (errno_copy == ECONNRESET) {
+        return 0;
+      }
+      if (errno_copy == ENOTCONN) {
+        throw TTransportException(TTransportException::NOT_OPEN, "ENOTCONN");
+      }
+      if (errno_copy == ETIMEDOUT) {
+        throw TTransportException(TTransportException::TIMED_OUT, "ETIMEDOUT");
+      }
+      throw TTransportException(TTransportException::UNKNOWN, "Unknown",
+                                errno_copy);
+    }
+  }
+
+  // Makes the next frame the read buffer. Returns false on end of file
+  // before the frame.
+  bool ReadFrame() {
+    uint8_t header[kHeaderSize];
+    uint32_t header_have = 0;
+    // Bytes of the payload in _rbuf
+    uint32_t have = static_cast<uint32_t>(_ahead_end - _ahead);
+    if (have > 0) {
+      header_have = have < kHeaderSize ? have : kHeaderSize;
+      std::memcpy(header, _ahead, header_have);
+      have -= header_have;
+      std::memmove(_rbuf, _ahead + header_have, have);
+    }
+    if (!_rbuf) {
+      _rbuf = FrameBufferPool::Instance().Acquire(
+          FrameBufferPool::kMinBufferSize, &_rcap);
+    }
+    ResetRead();
+
+    while (header_have < kHeaderSize) {
+      uint32_t n = Read(header + header_have, kHeaderSize - header_have,
+                        _rbuf + have, _rcap - have);
+      if (n == 0) {
+        if (header_have == 0) {
+          return false;
+        }
+        throw TTransportException(
+            TTransportException::END_OF_FILE,
+            "No more data to read after partial frame header.");
+      }
+      uint32_t header_got =
+          n < kHeaderSize - header_have ? n : kHeaderSize - header_have;
+      header_have += header_got;
+      have += n - header_got;
+    }
+    uint32_t header_nbo;
+    std::memcpy(&header_nbo, header, kHeaderSize);
+    uint32_t flags = ntohl(header_nbo) & ~kSizeMask;
+    uint32_t size = ntohl(header_nbo) & kSizeMask;
+    auto codec = static_cast<FrameCodec>((flags & kCodecMask) >> kCodecShift);
+    bool compressed = flags & kCompressedFlag;
+    if (flags & kNegativeFlag) {
+      throw TTransportException("Frame size has negative value");
+    }
+    if (size > _max_frame_size) {
+      throw TTransportException(TTransportException::CORRUPTED_DATA,
+                                "Received an oversized frame");
+    }
+    if (codec > FrameCodec::ZSTD ||
+        (compressed && (!_compression || codec == FrameCodec::NONE))) {
+      throw TTransportException(TTransportException::CORRUPTED_DATA,
+                                "Received a frame of an unknown codec");
+    }
+    if (_compression) {
+      _peer_codec = codec;
+    }
+
+    if (size > _rcap) {
+      uint32_t capacity;
+      uint8_t *new_buf = FrameBufferPool::Instance().Acquire(size, &capacity);
+      std::memcpy(new_buf, _rbuf, have);
+      FrameBufferPool::Instance().Release(_rbuf, _rcap);
+      _rbuf = new_buf;
+      _rcap = capacity;
+    }
+    while (have < size) {
+      uint32_t n = Read(nullptr, 0, _rbuf + have, _rcap - have);
+      if (n == 0) {
+        throw TTransportException(
+            TTransportException::END_OF_FILE,
+            "No more data to read after partial frame.");
+      }
+      have += n;
+    }
+    _frame_bytes = kHeaderSize + size;
+    _ahead = _rbuf + size;
+    _ahead_end = _rbuf + have;
+    if (!compressed) {
+      setReadBuffer(_rbuf, size);
+      return true;
+    }
+
+    if (size < kHeaderSize) {
+      throw TTransportException(TTransportException::CORRUPTED_DATA,
+                                "Received a truncated compressed frame");
+    }
+    uint32_t message_nbo;
+    std::memcpy(&message_nbo, _rbuf, kHeaderSize);
+    uint32_t message_size = ntohl(message_nbo);
+    if (message_size > _max_frame_size) {
+      throw TTransportException(TTransportException::CORRUPTED_DATA,
+                                "Received an oversized frame");
+    }
+    if (_dbuf && _dcap < message_size) {
+      FrameBufferPool::Instance().Release(_dbuf, _dcap);
+      _dbuf = nullptr;
+    }
+    if (!_dbuf) {
+      _dbuf = FrameBufferPool::Instance().Acquire(message_size, &_dcap);
+    }
+    _compression->Decompress(codec, _rbuf + kHeaderSize, size - kHeaderSize,
+                             _dbuf, message_size);
+    setReadBuffer(_dbuf, message_size);
+    return true;
+  }
+
+  std::shared_ptr<TTransport> _transport;
+  // _transport, when its descriptor can be read directly
+  TSocket *_socket = nullptr;
+  std::shared_ptr<FrameCompression> _compression;
+  bool _client;
+  // The codec the peer accepts, as of its last frame
+  FrameCodec _peer_codec = FrameCodec::NONE;
+  uint32_t _max_frame_size;
+
+  // The current frame is [rBase_, rBound_) of _rbuf, followed by the bytes
+  // of the next frames already read, [_ahead, _ahead_end).
+  uint8_t *_rbuf = nullptr;
+  uint32_t _rcap = 0;
+  uint8_t *_ahead = nullptr;
+  uint8_t *_ahead_end = nullptr;
+  // Bytes of the current frame on the wire
+  uint32_t _frame_bytes = 0;
+  // The current frame decompressed, if it was compressed
+  uint8_t *_dbuf = nullptr;
+  uint32_t _dcap = 0;
+
+  // The frame being written, after a 4-byte space for its length, is
+  // [_wbuf + kHeaderSize, wBase_).
+  uint8_t *_wbuf = nullptr;
+  uint32_t _wcap = 0;
+};
+
+class PooledFramedTransportFactory : public TTransportFactory {
+ public:
+  explicit PooledFramedTransportFactory(
+      std::shared_ptr<FrameCompression> compression = nullptr,
+      bool client = false)
+      : _compression(compression), _client(client) {}
+
+  std::shared_ptr<TTransport> getTransport(
+      std::shared_ptr<TTransport> trans) override {
+    return std::make_shared<PooledFramedTransport>(trans, _compression,
+                                                   _client);
+  }
+
+ private:
+  std::shared_ptr<FrameCompression> _compression;
+  bool _client;
+};
+
+} // namespace media_service
+
+#endif //MEDIA_MICROSERVICES_POOLEDFRAMEDTRANSPORT_H
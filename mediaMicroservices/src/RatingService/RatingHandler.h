@@ -19,19 +19,21 @@ namespace media_service {
 class RatingHandler : public RatingServiceIf {
  public:
   RatingHandler(
-      ClientPool<ThriftClient<ComposeReviewServiceClient>> *,
+      AffinityClientPool<ThriftClient<ComposeReviewServiceClient>> *,
       ClientPool<RedisClient> *);
   ~RatingHandler() override = default;
   void UploadRating(int64_t, const std::string &, int32_t,
       const std::map<std::string, std::string> &) override;
 
  private:
-  ClientPool<ThriftClient<ComposeReviewServiceClient>> *_compose_client_pool;
+  AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+      *_compose_client_pool;
   ClientPool<RedisClient> *_redis_client_pool;
 };
 
 RatingHandler::RatingHandler(
-    ClientPool<ThriftClient<ComposeReviewServiceClient>> *compose_client_pool,
+    AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+        *compose_client_pool,
     ClientPool<RedisClient> *redis_client_pool) {
   _compose_client_pool = compose_client_pool;
   _redis_client_pool = redis_client_pool;
@@ -56,7 +58,7 @@ void RatingHandler::UploadRating(
   std::future<void> redis_future;
 
   upload_future = std::async(std::launch::async, [&](){
-    auto compose_client_wrapper = _compose_client_pool->Pop();
+    auto compose_client_wrapper = _compose_client_pool->Pop(req_id);
     if (!compose_client_wrapper) {
       ServiceException se;
       se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
@@ -67,11 +69,11 @@ void RatingHandler::UploadRating(
     try {
       compose_client->UploadRating(req_id, rating, writer_text_map);
     } catch (...) {
-      _compose_client_pool->Push(compose_client_wrapper);
+      _compose_client_pool->Push(req_id, compose_client_wrapper);
       LOG(error) << "Failed to upload rating to compose-review-service";
       throw;
     }
-    _compose_client_pool->Push(compose_client_wrapper);
+    _compose_client_pool->Push(req_id, compose_client_wrapper);
   });
 
   redis_future = std::async(std::launch::async, [&](){
@@ -85,8 +87,13 @@ void RatingHandler::UploadRating(
     auto redis_client = redis_client_wrapper->GetClient();
     auto redis_span = opentracing::Tracer::Global()->StartSpan(
         "RedisInsert", {opentracing::ChildOf(&span->context())});
+    // One transaction, so that movie-info-service folds the sum and the
+    // count of a rating in together (see RatingAggregator.h)
+    redis_client->multi();
     redis_client->incrby(movie_id + ":uncommit_sum", rating);
     redis_client->incr(movie_id + ":uncommit_num");
+    redis_client->sadd("uncommit_movie_ids", {movie_id});
+    redis_client->exec();
     redis_client->sync_commit();
     redis_span->Finish();
     _redis_client_pool->Push(redis_client_wrapper);
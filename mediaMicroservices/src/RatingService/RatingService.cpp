@@ -6,11 +6,11 @@
 #include <thrift/transport/TBufferTransports.h>
 
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "RatingHandler.h"
 
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using namespace media_service;
 
@@ -28,6 +28,7 @@ int main(int argc, char *argv[]) {
   if (load_config_file("config/service-config.json", &config_json) != 0) {
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
   int port = config_json["rating-service"]["port"];
   std::string compose_addr = config_json["compose-review-service"]["addr"];
@@ -36,8 +37,9 @@ int main(int argc, char *argv[]) {
   std::string redis_addr = config_json["rating-redis"]["addr"];
   int redis_port = config_json["rating-redis"]["port"];
 
-  ClientPool<ThriftClient<ComposeReviewServiceClient>> compose_client_pool(
-      "compose-review-client", compose_addr, compose_port, 0, 128, 1000);
+  AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+      compose_client_pool(
+          "compose-review-client", compose_addr, compose_port, 0, 128, 1000);
 
   ClientPool<RedisClient> redis_client_pool("rating-redis",
       redis_addr, redis_port, 0, 128, 1000);
@@ -48,7 +50,7 @@ int main(int argc, char *argv[]) {
               &compose_client_pool, 
               &redis_client_pool)),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
 
@@ -15,17 +15,20 @@ namespace media_service {
 
 class TextHandler : public TextServiceIf {
  public:
-  explicit TextHandler(ClientPool<ThriftClient<ComposeReviewServiceClient>> *);
+  explicit TextHandler(
+      AffinityClientPool<ThriftClient<ComposeReviewServiceClient>> *);
   ~TextHandler() override = default;
 
   void UploadText(int64_t, const std::string &,
       const std::map<std::string, std::string> &) override;
  private:
-  ClientPool<ThriftClient<ComposeReviewServiceClient>> *_compose_client_pool;
+  AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+      *_compose_client_pool;
 };
 
 TextHandler::TextHandler(
-    ClientPool<ThriftClient<ComposeReviewServiceClient>> *compose_client_pool) {
+    AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+        *compose_client_pool) {
   _compose_client_pool = compose_client_pool;
 }
 
@@ -44,7 +47,7 @@ void TextHandler::UploadText(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
-  auto compose_client_wrapper = _compose_client_pool->Pop();
+  auto compose_client_wrapper = _compose_client_pool->Pop(req_id);
   if (!compose_client_wrapper) {
     ServiceException se;
     se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
@@ -55,11 +58,11 @@ void TextHandler::UploadText(
   try {
     compose_client->UploadText(req_id, text, writer_text_map);
   } catch (...) {
-    _compose_client_pool->Push(compose_client_wrapper);
+    _compose_client_pool->Push(req_id, compose_client_wrapper);
     LOG(error) << "Failed to upload movie_id to compose-review-service";
     throw;
   }
-  _compose_client_pool->Push(compose_client_wrapper);
+  _compose_client_pool->Push(req_id, compose_client_wrapper);
 
   span->Finish();
 }
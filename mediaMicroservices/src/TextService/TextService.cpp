@@ -6,11 +6,11 @@
 #include <thrift/transport/TBufferTransports.h>
 
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "TextHandler.h"
 
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using namespace media_service;
 
@@ -26,19 +26,21 @@ int main(int argc, char *argv[]) {
 
   json config_json;
   if (load_config_file("config/service-config.json", &config_json) == 0) {
+    init_frame_compression(config_json);
 
     int port = config_json["text-service"]["port"];
     std::string compose_addr = config_json["compose-review-service"]["addr"];
     int compose_port = config_json["compose-review-service"]["port"];
 
-    ClientPool<ThriftClient<ComposeReviewServiceClient>> compose_client_pool(
-        "compose-review-client", compose_addr, compose_port, 0, 128, 1000);
+    AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+        compose_client_pool(
+            "compose-review-client", compose_addr, compose_port, 0, 128, 1000);
 
     TThreadedServer server(
         std::make_shared<TextServiceProcessor>(
             std::make_shared<TextHandler>(&compose_client_pool)),
         std::make_shared<TServerSocket>("0.0.0.0", port),
-        std::make_shared<TFramedTransportFactory>(),
+        get_transport_factory(),
         std::make_shared<TBinaryProtocolFactory>()
     );
 
@@ -12,12 +12,12 @@
 #include <thrift/stdcxx.h>
 #include "logger.h"
 #include "GenericClient.h"
+#include "utils_thrift.h"
 
 namespace media_service {
 
 using apache::thrift::protocol::TProtocol;
 using apache::thrift::protocol::TBinaryProtocol;
-using apache::thrift::transport::TFramedTransport;
 using apache::thrift::transport::TSocket;
 using apache::thrift::transport::TTransport;
 using apache::thrift::TException;
@@ -56,7 +56,8 @@ ThriftClient<TThriftClient>::ThriftClient(
   _addr = addr;
   _port = port;
   _socket = std::shared_ptr<TTransport>(new TSocket(addr, port));
-  _transport = std::shared_ptr<TTransport>(new TFramedTransport(_socket));
+  _transport = std::shared_ptr<TTransport>(
+      new PooledFramedTransport(_socket, frame_compression(), true));
   _protocol = std::shared_ptr<TProtocol>(new TBinaryProtocol(_transport));
   _client = new TThriftClient(_protocol);
 }
@@ -0,0 +1,97 @@
+#ifndef MEDIA_MICROSERVICES_SNOWFLAKEGENERATOR_H
+#define MEDIA_MICROSERVICES_SNOWFLAKEGENERATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// Custom Epoch (January 1, 2018 Midnight GMT = 2018-01-01T00:00:00Z)
+#define CUSTOM_EPOCH 1514764800000
+
+namespace media_service {
+
+// Lock-free generator of the 64-bit ids of the unique-id-service:
+//
+// |0| 11 bit machine ID |      40-bit timestamp         | 12-bit counter |
+//
+// The last timestamp and the number of counters used in it are packed into a
+// single atomic word, so concurrent callers claim ids with one CAS. When the
+// 4096 counters of a millisecond are used up, callers wait for the next
+// millisecond instead of wrapping the counter.
+class SnowflakeGenerator {
+ public:
+  static constexpr int kCounterBits = 12;
+  static constexpr int kTimestampBits = 40;
+  static constexpr int64_t kCountersPerMs = int64_t(1) << kCounterBits;
+
+  // machine_id is the 12-bit hash from GetMachineId(); its top bit is
+  // dropped by the sign bit of the id.
+  explicit SnowflakeGenerator(uint64_t machine_id)
+      : _machine_bits(
+            (machine_id << (kTimestampBits + kCounterBits)) &
+            0x7FFFFFFFFFFFFFFF),
+        _state(0) {}
+
+  int64_t Next() {
+    int64_t id;
+    Lease(1, &id);
+    return id;
+  }
+
+  // Claims up to n consecutive ids from a single millisecond. Stores the
+  // first one in *first and returns how many were claimed (at least 1).
+  int Lease(int n, int64_t *first) {
+    uint64_t state = _state.load(std::memory_order_relaxed);
+    while (true) {
+      int64_t last_timestamp = state >> kUsedBits;
+      int64_t used = state & kUsedMask;
+      int64_t timestamp = NowMs();
+      int64_t counter;
+      if (timestamp > last_timestamp) {
+        counter = 0;
+      } else if (used < kCountersPerMs) {
+        // Same millisecond, or the clock stepped back: keep counting in the
+        // last timestamp so that ids stay unique.
+        timestamp = last_timestamp;
+        counter = used;
+      } else {
+        while (NowMs() <= last_timestamp) {
+          std::this_thread::yield();
+        }
+        state = _state.load(std::memory_order_relaxed);
+        continue;
+      }
+      int count = std::min<int64_t>(n, kCountersPerMs - counter);
+      uint64_t next = (uint64_t(timestamp) << kUsedBits) | (counter + count);
+      if (_state.compare_exchange_weak(state, next,
+                                       std::memory_order_relaxed)) {
+        *first = _machine_bits |
+                 ((timestamp & kTimestampMask) << kCounterBits) | counter;
+        return count;
+      }
+    }
+  }
+
+ private:
+  // One more bit than the counter, so that "all 4096 used" is representable.
+  static constexpr int kUsedBits = kCounterBits + 1;
+  static constexpr uint64_t kUsedMask = (uint64_t(1) << kUsedBits) - 1;
+  static constexpr int64_t kTimestampMask =
+      (int64_t(1) << kTimestampBits) - 1;
+
+  static int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+               .count() -
+           CUSTOM_EPOCH;
+  }
+
+  int64_t _machine_bits;
+  std::atomic<uint64_t> _state;
+};
+
+}  // namespace media_service
+
+#endif  // MEDIA_MICROSERVICES_SNOWFLAKEGENERATOR_H
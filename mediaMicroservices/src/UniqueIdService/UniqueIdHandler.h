@@ -3,8 +3,7 @@
 
 #include <iostream>
 #include <string>
-#include <chrono>
-#include <mutex>
+#include <vector>
 #include <sstream>
 #include <iomanip>
 #include <arpa/inet.h>
@@ -19,55 +18,35 @@
 #include "../ThriftClient.h"
 #include "../logger.h"
 #include "../tracing.h"
-
-// Custom Epoch (January 1, 2018 Midnight GMT = 2018-01-01T00:00:00Z)
-#define CUSTOM_EPOCH 1514764800000
+#include "SnowflakeGenerator.h"
 
 namespace media_service {
 
-using std::chrono::milliseconds;
-using std::chrono::duration_cast;
-using std::chrono::system_clock;
-
-static int64_t current_timestamp = -1;
-static int counter = 0;
-
-static int GetCounter(int64_t timestamp) {
-  if (current_timestamp > timestamp) {
-    LOG(fatal) << "Timestamps are not incremental.";
-    exit(EXIT_FAILURE);
-  }
-  if (current_timestamp == timestamp) {
-    return counter++;
-  } else {
-    current_timestamp = timestamp;
-    counter = 0;
-    return counter++;
-  }
-}
+// Upper bound of ComposeUniqueIds, 16 milliseconds worth of ids.
+#define MAX_LEASED_IDS 65536
 
 class UniqueIdHandler : public UniqueIdServiceIf {
  public:
   ~UniqueIdHandler() override = default;
   UniqueIdHandler(
-      std::mutex *,
       const std::string &,
-      ClientPool<ThriftClient<ComposeReviewServiceClient>> *);
+      AffinityClientPool<ThriftClient<ComposeReviewServiceClient>> *);
 
   void UploadUniqueId(int64_t, const std::map<std::string, std::string> &) override;
+  void ComposeUniqueIds(std::vector<int64_t> &, int64_t, int32_t,
+                        const std::map<std::string, std::string> &) override;
 
  private:
-  std::mutex *_thread_lock;
-  std::string _machine_id;
-  ClientPool<ThriftClient<ComposeReviewServiceClient>> *_compose_client_pool;
+  SnowflakeGenerator _generator;
+  AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+      *_compose_client_pool;
 };
 
 UniqueIdHandler::UniqueIdHandler(
-    std::mutex *thread_lock,
     const std::string &machine_id,
-    ClientPool<ThriftClient<ComposeReviewServiceClient>> *compose_client_pool) {
-  _thread_lock = thread_lock;
-  _machine_id = machine_id;
+    AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+        *compose_client_pool)
+    : _generator(std::stoul(machine_id, nullptr, 16)) {
   _compose_client_pool = compose_client_pool;
 }
 
@@ -85,41 +64,11 @@ void UniqueIdHandler::UploadUniqueId(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
-  _thread_lock->lock();
-  int64_t timestamp = duration_cast<milliseconds>(
-      system_clock::now().time_since_epoch()).count() - CUSTOM_EPOCH;
-  int counter = GetCounter(timestamp);
-  _thread_lock->unlock();
-
-  std::stringstream sstream;
-  sstream << std::hex << timestamp;
-  std::string timestamp_hex(sstream.str());
-
-  if (timestamp_hex.size() > 10) {
-    timestamp_hex.erase(0, timestamp_hex.size() - 10);
-  } else if (timestamp_hex.size() < 10) {
-    timestamp_hex = std::string(10 - timestamp_hex.size(), '0') + timestamp_hex;
-  }
-
-  // Empty the sstream buffer.
-  sstream.clear();
-  sstream.str(std::string());
-
-  sstream << std::hex << counter;
-  std::string counter_hex(sstream.str());
-
-  if (counter_hex.size() > 3) {
-    counter_hex.erase(0, counter_hex.size() - 3);
-  } else if (counter_hex.size() < 3) {
-    counter_hex = std::string(3 - counter_hex.size(), '0') + counter_hex;
-  }
-
-  std::string review_id_str = _machine_id + timestamp_hex + counter_hex;
-  int64_t review_id = stoul(review_id_str, nullptr, 16) & 0x7FFFFFFFFFFFFFFF;
+  int64_t review_id = _generator.Next();
   LOG(debug) << "The review_id of the request "
       << req_id << " is " << review_id;
 
-  auto compose_client_wrapper = _compose_client_pool->Pop();
+  auto compose_client_wrapper = _compose_client_pool->Pop(req_id);
   if (!compose_client_wrapper) {
     ServiceException se;
     se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
@@ -130,11 +79,50 @@ void UniqueIdHandler::UploadUniqueId(
   try {
     compose_client->UploadUniqueId(req_id, review_id, writer_text_map);
   } catch (...) {
-    _compose_client_pool->Push(compose_client_wrapper);
+    _compose_client_pool->Push(req_id, compose_client_wrapper);
     LOG(error) << "Failed to upload movie_id to compose-review-service";
     throw;
   }
-  _compose_client_pool->Push(compose_client_wrapper);
+  _compose_client_pool->Push(req_id, compose_client_wrapper);
+
+  span->Finish();
+}
+
+void UniqueIdHandler::ComposeUniqueIds(
+    std::vector<int64_t> &_return,
+    int64_t req_id,
+    int32_t num_ids,
+    const std::map<std::string, std::string> & carrier) {
+
+  // Initialize a span
+  TextMapReader reader(carrier);
+  std::map<std::string, std::string> writer_text_map;
+  TextMapWriter writer(writer_text_map);
+  auto parent_span = opentracing::Tracer::Global()->Extract(reader);
+  auto span = opentracing::Tracer::Global()->StartSpan(
+      "ComposeUniqueIds",
+      { opentracing::ChildOf(parent_span->get()) });
+  opentracing::Tracer::Global()->Inject(span->context(), writer);
+
+  if (num_ids <= 0 || num_ids > MAX_LEASED_IDS) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+    se.message = "num_ids must be between 1 and " +
+        std::to_string(MAX_LEASED_IDS);
+    throw se;
+  }
+
+  // Ids are leased as runs of consecutive ids, one run per millisecond used.
+  _return.reserve(num_ids);
+  while (static_cast<int32_t>(_return.size()) < num_ids) {
+    int64_t first;
+    int count = _generator.Lease(num_ids - _return.size(), &first);
+    for (int i = 0; i < count; ++i) {
+      _return.emplace_back(first + i);
+    }
+  }
+  LOG(debug) << "Leased " << num_ids << " review_ids to the request "
+      << req_id;
 
   span->Finish();
 }
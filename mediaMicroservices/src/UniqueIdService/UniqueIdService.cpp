@@ -19,11 +19,11 @@
 #include <thrift/transport/TBufferTransports.h>
 
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "UniqueIdHandler.h"
 
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using namespace media_service;
 
@@ -42,6 +42,7 @@ int main(int argc, char *argv[]) {
   if (load_config_file("config/service-config.json", &config_json) != 0) {
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
 //  std::string addr = config_json["UniqueIdService"]["addr"];
   int port = config_json["unique-id-service"]["port"];
@@ -54,16 +55,16 @@ int main(int argc, char *argv[]) {
     exit(EXIT_FAILURE);
   }
 
-  std::mutex thread_lock;
-  ClientPool<ThriftClient<ComposeReviewServiceClient>> compose_client_pool(
-      "compose-review-client", compose_addr, compose_port, 0, 128, 1000);
+  AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+      compose_client_pool(
+          "compose-review-client", compose_addr, compose_port, 0, 128, 1000);
 
   TThreadedServer server (
       std::make_shared<UniqueIdServiceProcessor>(
           std::make_shared<UniqueIdHandler>(
-              &thread_lock, machine_id, &compose_client_pool)),
+              machine_id, &compose_client_pool)),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
 
@@ -11,6 +11,8 @@
 #include "../../gen-cpp/ReviewStorageService.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "../utils.h"
+#include "../utils_mongodb.h"
 #include "../ClientPool.h"
 #include "../RedisClient.h"
 #include "../ThriftClient.h"
@@ -267,32 +269,21 @@ void UserReviewHandler::ReadUserReviews(
     const bson_t *doc;
     bool found = mongoc_cursor_next(cursor, &doc);
     if (found) {
-      bson_iter_t iter_0;
-      bson_iter_t iter_1;
-      bson_iter_t review_id_child;
-      bson_iter_t timestamp_child;
-      int idx = 0;
-      bson_iter_init(&iter_0, doc);
-      bson_iter_init(&iter_1, doc);
-      while (bson_iter_find_descendant(&iter_0,
-          ("reviews." + std::to_string(idx) + ".review_id").c_str(),
-          &review_id_child)
-          && BSON_ITER_HOLDS_INT64(&review_id_child)
-          && bson_iter_find_descendant(&iter_1,
-              ("reviews." + std::to_string(idx) + ".timestamp").c_str(),
-              &timestamp_child)
-          && BSON_ITER_HOLDS_INT64(&timestamp_child)) {
-        auto curr_review_id = bson_iter_int64(&review_id_child);
-        auto curr_timestamp = bson_iter_int64(&timestamp_child);
+      ForEachArrayDocument(doc, "reviews",
+          [&](const bson_iter_t *review, int idx) {
+        int64_t curr_review_id;
+        int64_t curr_timestamp;
+        if (!GetInt64Field(review, "review_id", &curr_review_id) ||
+            !GetInt64Field(review, "timestamp", &curr_timestamp)) {
+          return false;
+        }
         if (idx >= mongo_start) {
           review_ids.emplace_back(curr_review_id);
         }
         redis_update_map.insert(
             {std::to_string(curr_timestamp), std::to_string(curr_review_id)});
-        bson_iter_init(&iter_0, doc);
-        bson_iter_init(&iter_1, doc);
-        idx++;
-      }
+        return true;
+      });
     }
     find_span->Finish();
     bson_destroy(opts);
@@ -6,11 +6,11 @@
 
 #include "UserReviewHandler.h"
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "../utils_mongodb.h"
 
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using media_service::UserReviewHandler;
 using namespace media_service;
@@ -30,6 +30,7 @@ int main(int argc, char *argv[]) {
     LOG(fatal) << "Cannot open the config file.";
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
   int port = config_json["user-review-service"]["port"];
   std::string redis_addr =
@@ -72,7 +73,7 @@ int main(int argc, char *argv[]) {
               mongodb_client_pool,
               &review_storage_client_pool)),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
   std::cout << "Starting the user-review-service server ..." << std::endl;
@@ -3,7 +3,6 @@
 
 #include <iostream>
 #include <string>
-#include <random>
 #include <mongoc.h>
 #include <bson/bson.h>
 #include <libmemcached/memcached.h>
@@ -22,8 +21,8 @@
 #include "../ClientPool.h"
 #include "../ThriftClient.h"
 #include "../../gen-cpp/ComposeReviewService.h"
-#include "../../third_party/PicoSHA2/picosha2.h"
 #include "../logger.h"
+#include "PasswordHasher.h"
 
 // Custom Epoch (January 1, 2018 Midnight GMT = 2018-01-01T00:00:00Z)
 #define CUSTOM_EPOCH 1514764800000
@@ -52,22 +51,6 @@ static int GetCounter(int64_t timestamp) {
   }
 }
 
-std::string GenRandomString(const int len) {
-  static const std::string alphanum =
-      "0123456789"
-      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-      "abcdefghijklmnopqrstuvwxyz";
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<int> dist(
-      0, static_cast<int>(alphanum.length() - 1));
-  std::string s;
-  for (int i = 0; i < len; ++i) {
-    s += alphanum[dist(gen)];
-  }
-  return s;
-}
-
 class UserHandler : public UserServiceIf {
  public:
   UserHandler(
@@ -76,7 +59,8 @@ class UserHandler : public UserServiceIf {
       const std::string &,
       memcached_pool_st *,
       mongoc_client_pool_t *,
-      ClientPool<ThriftClient<ComposeReviewServiceClient>> *);
+      AffinityClientPool<ThriftClient<ComposeReviewServiceClient>> *,
+      PasswordHasher *);
   ~UserHandler() override = default;
   void RegisterUser(
       int64_t,
@@ -109,7 +93,9 @@ class UserHandler : public UserServiceIf {
   std::mutex *_thread_lock;
   memcached_pool_st *_memcached_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
-  ClientPool<ThriftClient<ComposeReviewServiceClient>> *_compose_client_pool;
+  AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+      *_compose_client_pool;
+  PasswordHasher *_password_hasher;
 
 };
 
@@ -119,7 +105,9 @@ UserHandler::UserHandler(
     const std::string &secret,
     memcached_pool_st *memcached_client_pool,
     mongoc_client_pool_t *mongodb_client_pool,
-    ClientPool<ThriftClient<ComposeReviewServiceClient>> *compose_client_pool
+    AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+        *compose_client_pool,
+    PasswordHasher *password_hasher
     ) {
   _thread_lock = thread_lock;
   _machine_id = machine_id;
@@ -127,6 +115,7 @@ UserHandler::UserHandler(
   _mongodb_client_pool = mongodb_client_pool;
   _compose_client_pool = compose_client_pool;
   _secret = secret;
+  _password_hasher = password_hasher;
 }
 
 void UserHandler::RegisterUser(
@@ -229,7 +218,7 @@ void UserHandler::RegisterUser(
     BSON_APPEND_UTF8(new_doc, "username", username.c_str());
     std::string salt = GenRandomString(32);
     BSON_APPEND_UTF8(new_doc, "salt", salt.c_str());
-    std::string password_hashed = picosha2::hash256_hex_string(password + salt);
+    std::string password_hashed = _password_hasher->Hash(password, salt);
     BSON_APPEND_UTF8(new_doc, "password", password_hashed.c_str());
 
     bson_error_t error;
@@ -325,7 +314,7 @@ void UserHandler::RegisterUserWithId(
     BSON_APPEND_UTF8(new_doc, "username", username.c_str());
     std::string salt = GenRandomString(32);
     BSON_APPEND_UTF8(new_doc, "salt", salt.c_str());
-    std::string password_hashed = picosha2::hash256_hex_string(password + salt);
+    std::string password_hashed = _password_hasher->Hash(password, salt);
     BSON_APPEND_UTF8(new_doc, "password", password_hashed.c_str());
 
     bson_error_t error;
@@ -490,7 +479,7 @@ void UserHandler::UploadUserWithUsername(
   }
 
   if (user_id) {
-    auto compose_client_wrapper = _compose_client_pool->Pop();
+    auto compose_client_wrapper = _compose_client_pool->Pop(req_id);
     if (!compose_client_wrapper) {
       ServiceException se;
       se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
@@ -501,11 +490,11 @@ void UserHandler::UploadUserWithUsername(
     try {
       compose_client->UploadUserId(req_id, user_id, writer_text_map);
     } catch (...) {
-      _compose_client_pool->Push(compose_client_wrapper);
+      _compose_client_pool->Push(req_id, compose_client_wrapper);
       LOG(error) << "Failed to upload movie_id to compose-review-service";
       throw;
     }
-    _compose_client_pool->Push(compose_client_wrapper);
+    _compose_client_pool->Push(req_id, compose_client_wrapper);
   }
 
   memcached_client = memcached_pool_pop(
@@ -559,7 +548,7 @@ void UserHandler::UploadUserWithUserId(
       { opentracing::ChildOf(parent_span->get()) });
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
-  auto compose_client_wrapper = _compose_client_pool->Pop();
+  auto compose_client_wrapper = _compose_client_pool->Pop(req_id);
   if (!compose_client_wrapper) {
     ServiceException se;
     se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
@@ -570,11 +559,11 @@ void UserHandler::UploadUserWithUserId(
   try {
     compose_client->UploadUserId(req_id, user_id, writer_text_map);
   } catch (...) {
-    _compose_client_pool->Push(compose_client_wrapper);
+    _compose_client_pool->Push(req_id, compose_client_wrapper);
     LOG(error) << "Failed to upload movie_id to compose-review-service";
     throw;
   }
-  _compose_client_pool->Push(compose_client_wrapper);
+  _compose_client_pool->Push(req_id, compose_client_wrapper);
 
   span->Finish();
 
@@ -819,8 +808,8 @@ void UserHandler::Login(
   }
 
   if (user_id && salt_str && password_str) {
-    bool auth = picosha2::hash256_hex_string(password + std::string(salt_str))
-        == std::string(password_str);
+    bool auth = _password_hasher->Verify(password, std::string(salt_str),
+                                         std::string(password_str));
     if (auth) {
       auto user_id_str = std::to_string(user_id);
       auto timestamp_str = std::to_string(duration_cast<milliseconds>(
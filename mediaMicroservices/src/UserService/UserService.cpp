@@ -6,13 +6,13 @@
 
 
 #include "../utils.h"
+#include "../utils_thrift.h"
 #include "../utils_memcached.h"
 #include "../utils_mongodb.h"
 #include "UserHandler.h"
 
 using apache::thrift::server::TThreadedServer;
 using apache::thrift::transport::TServerSocket;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using media_service::UserHandler;
 using namespace media_service;
@@ -31,6 +31,7 @@ int main(int argc, char *argv[]) {
   if (load_config_file("config/service-config.json", &config_json) != 0) {
     exit(EXIT_FAILURE);
   }
+  init_frame_compression(config_json);
 
   std::string secret = config_json["secret"];
 
@@ -52,10 +53,21 @@ int main(int argc, char *argv[]) {
     exit(EXIT_FAILURE);
   }
 
+  std::string password_hash_backend =
+      config_json["user-service"].value("password_hash_backend", "openssl");
+  std::unique_ptr<PasswordHasher> password_hasher =
+      PasswordHasher::Create(password_hash_backend);
+  if (!password_hasher) {
+    LOG(fatal) << "Unknown password_hash_backend " << password_hash_backend;
+    exit(EXIT_FAILURE);
+  }
+  InitOpenSslLocking();
+
   std::mutex thread_lock;
 
-  ClientPool<ThriftClient<ComposeReviewServiceClient>> compose_client_pool(
-      "compose-review-client", compose_addr, compose_port, 0, 128, 1000);
+  AffinityClientPool<ThriftClient<ComposeReviewServiceClient>>
+      compose_client_pool(
+          "compose-review-client", compose_addr, compose_port, 0, 128, 1000);
 
   TThreadedServer server(
       std::make_shared<UserServiceProcessor>(
@@ -65,9 +77,10 @@ int main(int argc, char *argv[]) {
               secret,
               memcached_client_pool,
               mongodb_client_pool,
-              &compose_client_pool)),
+              &compose_client_pool,
+              password_hasher.get())),
       std::make_shared<TServerSocket>("0.0.0.0", port),
-      std::make_shared<TFramedTransportFactory>(),
+      get_transport_factory(),
       std::make_shared<TBinaryProtocolFactory>()
   );
   std::cout << "Starting the user-service server ..." << std::endl;
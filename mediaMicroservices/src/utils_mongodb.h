@@ -1,6 +1,10 @@
 #ifndef MEDIA_SERVICE_MICROSERVICES_SRC_UTILS_MONGODB_H_
 #define MEDIA_SERVICE_MICROSERVICES_SRC_UTILS_MONGODB_H_
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <mongoc.h>
 #include <bson/bson.h>
 
@@ -38,10 +42,13 @@ mongoc_client_pool_t* init_mongodb_client_pool(
   }
 }
 
+// Creates the index of keys on collection_name of db_name, each key
+// ascending (1) or descending (-1), in order
 bool CreateIndex(
     mongoc_client_t *client,
     const std::string &db_name,
-    const std::string &index,
+    const std::string &collection_name,
+    const std::vector<std::pair<std::string, int>> &index_keys,
     bool unique) {
   mongoc_database_t *db;
   bson_t keys;
@@ -53,10 +60,12 @@ bool CreateIndex(
 
   db = mongoc_client_get_database(client, db_name.c_str());
   bson_init (&keys);
-  BSON_APPEND_INT32(&keys, index.c_str(), 1);
+  for (auto &key : index_keys) {
+    BSON_APPEND_INT32(&keys, key.first.c_str(), key.second);
+  }
   index_name = mongoc_collection_keys_to_index_string(&keys);
   create_indexes = BCON_NEW (
-      "createIndexes", BCON_UTF8(db_name.c_str()),
+      "createIndexes", BCON_UTF8(collection_name.c_str()),
       "indexes", "[", "{",
           "key", BCON_DOCUMENT (&keys),
           "name", BCON_UTF8 (index_name),
@@ -68,6 +77,7 @@ bool CreateIndex(
     LOG(error) << "Error in createIndexes: " << error.message;
   }
   bson_free (index_name);
+  bson_destroy (&keys);
   bson_destroy (&reply);
   bson_destroy (create_indexes);
   mongoc_database_destroy(db);
@@ -75,6 +85,59 @@ bool CreateIndex(
   return r;
 }
 
+bool CreateIndex(
+    mongoc_client_t *client,
+    const std::string &db_name,
+    const std::string &index,
+    bool unique) {
+  return CreateIndex(client, db_name, db_name, {{index, 1}}, unique);
+}
+
+// Single-pass traversal of a BSON array of sub-documents such as
+// "reviews". visitor(&element, idx) is called with an iterator
+// positioned inside each element document, in array order, until the array
+// ends, an element is not a document, or the visitor returns false. Unlike
+// looking up "<array_key>.<idx>.<field>" with bson_iter_find_descendant for
+// every index, this is linear in the length of the array.
+template <class Visitor>
+int ForEachArrayDocument(
+    const bson_t *doc,
+    const char *array_key,
+    Visitor visitor) {
+  bson_iter_t iter;
+  bson_iter_t array_iter;
+  bson_iter_t element_iter;
+  if (!bson_iter_init_find(&iter, doc, array_key) ||
+      !BSON_ITER_HOLDS_ARRAY(&iter) ||
+      !bson_iter_recurse(&iter, &array_iter)) {
+    return 0;
+  }
+  int idx = 0;
+  while (bson_iter_next(&array_iter)) {
+    if (!BSON_ITER_HOLDS_DOCUMENT(&array_iter) ||
+        !bson_iter_recurse(&array_iter, &element_iter) ||
+        !visitor(&element_iter, idx)) {
+      break;
+    }
+    idx++;
+  }
+  return idx;
+}
+
+// Reads the int64 field `key` of the element document passed to a
+// ForEachArrayDocument visitor.
+bool GetInt64Field(
+    const bson_iter_t *element_iter,
+    const char *key,
+    int64_t *value) {
+  bson_iter_t iter = *element_iter;
+  if (!bson_iter_find(&iter, key) || !BSON_ITER_HOLDS_INT64(&iter)) {
+    return false;
+  }
+  *value = bson_iter_int64(&iter);
+  return true;
+}
+
 } // namespace media_service
 
 #endif //MEDIA_SERVICE_MICROSERVICES_SRC_UTILS_MONGODB_H_
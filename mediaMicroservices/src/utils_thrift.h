@@ -0,0 +1,85 @@
+#ifndef MEDIA_MICROSERVICES_UTILS_THRIFT_H
+#define MEDIA_MICROSERVICES_UTILS_THRIFT_H
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+#include "logger.h"
+#include "PooledFramedTransport.h"
+
+namespace media_service {
+using json = nlohmann::json;
+
+// The frame compression of the process, shared by its server and its
+// ThriftClients. nullptr until init_frame_compression() enables it.
+std::shared_ptr<FrameCompression> &frame_compression() {
+  static std::shared_ptr<FrameCompression> compression;
+  return compression;
+}
+
+// "thrift" -> "compression": frames of at least threshold_bytes are
+// compressed with codec, "lz4" or "zstd", on connections between processes
+// that both enable it. Call before creating client pools and the server.
+void init_frame_compression(const json &config_json) {
+  auto thrift = config_json.find("thrift");
+  if (thrift == config_json.end() ||
+      thrift->find("compression") == thrift->end()) {
+    return;
+  }
+  auto &config = (*thrift)["compression"];
+  std::string codec_name = config.value("codec", "none");
+  FrameCodec codec;
+  if (codec_name == "none") {
+    return;
+  } else if (codec_name == "lz4") {
+    codec = FrameCodec::LZ4;
+  } else if (codec_name == "zstd") {
+    codec = FrameCodec::ZSTD;
+  } else {
+    throw std::invalid_argument("Unknown Thrift compression codec " +
+                                codec_name);
+  }
+  auto compression = std::make_shared<FrameCompression>(
+      codec, config.value("threshold_bytes", 4096),
+      config.value("zstd_level", 1));
+  int interval_ms = config.value("metrics_interval_ms", 60000);
+  std::thread([compression, codec_name, interval_ms]() {
+    while (true) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+      auto stats = compression->GetStats();
+      if (stats.frames_compressed + stats.frames_incompressible +
+              stats.frames_decompressed == 0) {
+        continue;
+      }
+      uint64_t sent = stats.frames_compressed + stats.frames_incompressible;
+      LOG(info) << "Thrift " << codec_name << " compression: "
+                << stats.frames_compressed << " frames compressed, "
+                << stats.bytes_in << " -> " << stats.bytes_out << " bytes ("
+                << (stats.bytes_in ? 100 * stats.bytes_out / stats.bytes_in
+                                   : 0)
+                << "%), " << stats.frames_incompressible
+                << " incompressible, "
+                << (sent ? stats.compress_ns / 1000 / sent : 0)
+                << " us/frame; " << stats.frames_decompressed
+                << " frames decompressed, "
+                << (stats.frames_decompressed
+                        ? stats.decompress_ns / 1000 /
+                              stats.frames_decompressed
+                        : 0)
+                << " us/frame";
+    }
+  }).detach();
+  frame_compression() = compression;
+}
+
+// Transports of the servers
+std::shared_ptr<TTransportFactory> get_transport_factory() {
+  return std::make_shared<PooledFramedTransportFactory>(frame_compression());
+}
+
+} // namespace media_service
+
+#endif //MEDIA_MICROSERVICES_UTILS_THRIFT_H
@@ -19,7 +19,8 @@ end
 --
 function GenericObjectPool:connection(thriftClient,ip,port)
     local ssl = ngx.shared.config:get("ssl")
-    local client = RpcClientFactory:createClient(thriftClient,ip,port,self.timeout,ssl)
+    local protocol = ngx.shared.config:get("thrift_protocol")
+    local client = RpcClientFactory:createClient(thriftClient,ip,port,self.timeout,ssl,protocol)
     return client
 end
 --
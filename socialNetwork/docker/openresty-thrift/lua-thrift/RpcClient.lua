@@ -6,6 +6,7 @@ local TSocket = require "TSocket"
 local TSocketSSL = require "TSocketSSL"
 local TFramedTransport = require "TFramedTransport"
 local TBinaryProtocol = require "TBinaryProtocol"
+local TCompactProtocol = require "TCompactProtocol"
 local Object = require "Object"
 
 local RpcClient = Object:new({
@@ -13,7 +14,8 @@ local RpcClient = Object:new({
 })
 
 --初始化RPC连接
-function RpcClient:init(ip,port,timeout,ssl)
+--protocol为"binary"(默认)或"compact"
+function RpcClient:init(ip,port,timeout,ssl,protocol)
 	if (ssl == true) then
 		socket = TSocketSSL:new{
 			host = ip,
@@ -29,11 +31,18 @@ function RpcClient:init(ip,port,timeout,ssl)
 	local transport = TFramedTransport:new{
 		trans = socket
 	}
-	local protocol = TBinaryProtocol:new{
-		trans = transport
-	}
+	local prot
+	if (protocol == "compact") then
+		prot = TCompactProtocol:new{
+			trans = transport
+		}
+	else
+		prot = TBinaryProtocol:new{
+			trans = transport
+		}
+	end
 	transport:open()
-	return protocol;
+	return prot;
 end
 --创建RPC客户端
 function RpcClient:createClient(thriftClient)end
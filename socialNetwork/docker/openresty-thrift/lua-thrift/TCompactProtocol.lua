@@ -127,8 +127,8 @@ function TCompactProtocol:writeMessageEnd()
 end
 
 function TCompactProtocol:writeStructBegin(name)
-  self.lastFieldIndex = self.lastFieldIndex + 1
   self.lastField[self.lastFieldIndex] = self.lastFieldId
+  self.lastFieldIndex = self.lastFieldIndex + 1
   self.lastFieldId = 0
 end
 
@@ -185,7 +185,6 @@ function TCompactProtocol:writeBool(bool)
   if bool then
     value = TCompactType.COMPACT_BOOLEAN_TRUE
   end
-  print(value,self.booleanFieldPending,self.booleanFieldId)
   if self.booleanFieldPending then
     self:writeFieldBeginInternal(self.booleanFieldName, TType.BOOL, self.booleanFieldId, value)
     self.booleanFieldPending = false
@@ -278,6 +277,7 @@ function TCompactProtocol:readMessageBegin()
   end
   local seqid = self:readVarint32()
   local name = self:readString()
+  self:resetLastField()
   return name, ttype, seqid
 end
 
@@ -311,8 +311,8 @@ function TCompactProtocol:readFieldBegin()
     id = self.lastFieldId + modifier
   end
   if ttype == TType.BOOL then
-    boolValue = libluabitwise.band(field_and_ttype, 0x0f) == TCompactType.COMPACT_BOOLEAN_TRUE
-    boolValueIsNotNull = true
+    self.boolValue = libluabitwise.band(field_and_ttype, 0x0f) == TCompactType.COMPACT_BOOLEAN_TRUE
+    self.boolValueIsNotNull = true
   end
   self.lastFieldId = id
   return nil, ttype, id
@@ -326,6 +326,10 @@ function TCompactProtocol:readMapBegin()
   if size < 0 then
     return nil,nil,nil
   end
+  -- Empty maps are written without their key and value types.
+  if size == 0 then
+    return TType.STOP, TType.STOP, 0
+  end
   local kvtype = self:readSignByte()
   local ktype = self:getTType(libluabitwise.shiftr(kvtype, 4))
   local vtype = self:getTType(kvtype)
@@ -359,9 +363,9 @@ function TCompactProtocol:readSetEnd()
 end
 
 function TCompactProtocol:readBool()
-  if boolValueIsNotNull then
-    boolValueIsNotNull = true
-    return boolValue
+  if self.boolValueIsNotNull then
+    self.boolValueIsNotNull = false
+    return self.boolValue
   end
   local val = self:readSignByte()
   if val == TCompactType.COMPACT_BOOLEAN_TRUE then
@@ -419,7 +423,7 @@ function TCompactProtocol:readVarint32()
   local shiftl = 0
   local result = 0
   while true do
-    b = self:readByte()
+    local b = self:readByte()
     result = libluabitwise.bor(result,
              libluabitwise.shiftl(libluabitwise.band(b, 0x7f), shiftl))
     if libluabitwise.band(b, 0x80) ~= 0x80 then
@@ -435,7 +439,7 @@ function TCompactProtocol:readVarint64()
   local data = result(0)
   local shiftl = 0
   while true do
-    b = self:readByte()
+    local b = self:readByte()
     endFlag, data = libluabpack.fromVarint64(b, shiftl, data)
     shiftl = shiftl + 7
     if endFlag == 0 then
@@ -464,3 +468,5 @@ function TCompactProtocolFactory:getProtocol(trans)
     trans = trans
   }
 end
+
+return TCompactProtocol
@@ -28,6 +28,8 @@ class SocialGraphServiceIf {
   virtual void FollowWithUsername(const int64_t req_id, const std::string& user_usernmae, const std::string& followee_username, const std::map<std::string, std::string> & carrier) = 0;
   virtual void UnfollowWithUsername(const int64_t req_id, const std::string& user_usernmae, const std::string& followee_username, const std::map<std::string, std::string> & carrier) = 0;
   virtual void InsertUser(const int64_t req_id, const int64_t user_id, const std::map<std::string, std::string> & carrier) = 0;
+  virtual void FollowMany(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::vector<int64_t> & followee_ids, const std::map<std::string, std::string> & carrier) = 0;
+  virtual void InsertUsers(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier) = 0;
 };
 
 class SocialGraphServiceIfFactory {
@@ -78,6 +80,12 @@ class SocialGraphServiceNull : virtual public SocialGraphServiceIf {
   void InsertUser(const int64_t /* req_id */, const int64_t /* user_id */, const std::map<std::string, std::string> & /* carrier */) {
     return;
   }
+  void FollowMany(const int64_t /* req_id */, const std::vector<int64_t> & /* user_ids */, const std::vector<int64_t> & /* followee_ids */, const std::map<std::string, std::string> & /* carrier */) {
+    return;
+  }
+  void InsertUsers(const int64_t /* req_id */, const std::vector<int64_t> & /* user_ids */, const std::map<std::string, std::string> & /* carrier */) {
+    return;
+  }
 };
 
 typedef struct _SocialGraphService_GetFollowers_args__isset {
@@ -950,6 +958,249 @@ class SocialGraphService_InsertUser_presult {
 
 };
 
+typedef struct _SocialGraphService_FollowMany_args__isset {
+  _SocialGraphService_FollowMany_args__isset() : req_id(false), user_ids(false), followee_ids(false), carrier(false) {}
+  bool req_id :1;
+  bool user_ids :1;
+  bool followee_ids :1;
+  bool carrier :1;
+} _SocialGraphService_FollowMany_args__isset;
+
+class SocialGraphService_FollowMany_args {
+ public:
+
+  SocialGraphService_FollowMany_args(const SocialGraphService_FollowMany_args&);
+  SocialGraphService_FollowMany_args& operator=(const SocialGraphService_FollowMany_args&);
+  SocialGraphService_FollowMany_args() : req_id(0) {
+  }
+
+  virtual ~SocialGraphService_FollowMany_args() throw();
+  int64_t req_id;
+  std::vector<int64_t>  user_ids;
+  std::vector<int64_t>  followee_ids;
+  std::map<std::string, std::string>  carrier;
+
+  _SocialGraphService_FollowMany_args__isset __isset;
+
+  void __set_req_id(const int64_t val);
+
+  void __set_user_ids(const std::vector<int64_t> & val);
+
+  void __set_followee_ids(const std::vector<int64_t> & val);
+
+  void __set_carrier(const std::map<std::string, std::string> & val);
+
+  bool operator == (const SocialGraphService_FollowMany_args & rhs) const
+  {
+    if (!(req_id == rhs.req_id))
+      return false;
+    if (!(user_ids == rhs.user_ids))
+      return false;
+    if (!(followee_ids == rhs.followee_ids))
+      return false;
+    if (!(carrier == rhs.carrier))
+      return false;
+    return true;
+  }
+  bool operator != (const SocialGraphService_FollowMany_args &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const SocialGraphService_FollowMany_args & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+
+class SocialGraphService_FollowMany_pargs {
+ public:
+
+
+  virtual ~SocialGraphService_FollowMany_pargs() throw();
+  const int64_t* req_id;
+  const std::vector<int64_t> * user_ids;
+  const std::vector<int64_t> * followee_ids;
+  const std::map<std::string, std::string> * carrier;
+
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+typedef struct _SocialGraphService_FollowMany_result__isset {
+  _SocialGraphService_FollowMany_result__isset() : se(false) {}
+  bool se :1;
+} _SocialGraphService_FollowMany_result__isset;
+
+class SocialGraphService_FollowMany_result {
+ public:
+
+  SocialGraphService_FollowMany_result(const SocialGraphService_FollowMany_result&);
+  SocialGraphService_FollowMany_result& operator=(const SocialGraphService_FollowMany_result&);
+  SocialGraphService_FollowMany_result() {
+  }
+
+  virtual ~SocialGraphService_FollowMany_result() throw();
+  ServiceException se;
+
+  _SocialGraphService_FollowMany_result__isset __isset;
+
+  void __set_se(const ServiceException& val);
+
+  bool operator == (const SocialGraphService_FollowMany_result & rhs) const
+  {
+    if (!(se == rhs.se))
+      return false;
+    return true;
+  }
+  bool operator != (const SocialGraphService_FollowMany_result &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const SocialGraphService_FollowMany_result & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+typedef struct _SocialGraphService_FollowMany_presult__isset {
+  _SocialGraphService_FollowMany_presult__isset() : se(false) {}
+  bool se :1;
+} _SocialGraphService_FollowMany_presult__isset;
+
+class SocialGraphService_FollowMany_presult {
+ public:
+
+
+  virtual ~SocialGraphService_FollowMany_presult() throw();
+  ServiceException se;
+
+  _SocialGraphService_FollowMany_presult__isset __isset;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+
+};
+
+typedef struct _SocialGraphService_InsertUsers_args__isset {
+  _SocialGraphService_InsertUsers_args__isset() : req_id(false), user_ids(false), carrier(false) {}
+  bool req_id :1;
+  bool user_ids :1;
+  bool carrier :1;
+} _SocialGraphService_InsertUsers_args__isset;
+
+class SocialGraphService_InsertUsers_args {
+ public:
+
+  SocialGraphService_InsertUsers_args(const SocialGraphService_InsertUsers_args&);
+  SocialGraphService_InsertUsers_args& operator=(const SocialGraphService_InsertUsers_args&);
+  SocialGraphService_InsertUsers_args() : req_id(0) {
+  }
+
+  virtual ~SocialGraphService_InsertUsers_args() throw();
+  int64_t req_id;
+  std::vector<int64_t>  user_ids;
+  std::map<std::string, std::string>  carrier;
+
+  _SocialGraphService_InsertUsers_args__isset __isset;
+
+  void __set_req_id(const int64_t val);
+
+  void __set_user_ids(const std::vector<int64_t> & val);
+
+  void __set_carrier(const std::map<std::string, std::string> & val);
+
+  bool operator == (const SocialGraphService_InsertUsers_args & rhs) const
+  {
+    if (!(req_id == rhs.req_id))
+      return false;
+    if (!(user_ids == rhs.user_ids))
+      return false;
+    if (!(carrier == rhs.carrier))
+      return false;
+    return true;
+  }
+  bool operator != (const SocialGraphService_InsertUsers_args &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const SocialGraphService_InsertUsers_args & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+
+class SocialGraphService_InsertUsers_pargs {
+ public:
+
+
+  virtual ~SocialGraphService_InsertUsers_pargs() throw();
+  const int64_t* req_id;
+  const std::vector<int64_t> * user_ids;
+  const std::map<std::string, std::string> * carrier;
+
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+typedef struct _SocialGraphService_InsertUsers_result__isset {
+  _SocialGraphService_InsertUsers_result__isset() : se(false) {}
+  bool se :1;
+} _SocialGraphService_InsertUsers_result__isset;
+
+class SocialGraphService_InsertUsers_result {
+ public:
+
+  SocialGraphService_InsertUsers_result(const SocialGraphService_InsertUsers_result&);
+  SocialGraphService_InsertUsers_result& operator=(const SocialGraphService_InsertUsers_result&);
+  SocialGraphService_InsertUsers_result() {
+  }
+
+  virtual ~SocialGraphService_InsertUsers_result() throw();
+  ServiceException se;
+
+  _SocialGraphService_InsertUsers_result__isset __isset;
+
+  void __set_se(const ServiceException& val);
+
+  bool operator == (const SocialGraphService_InsertUsers_result & rhs) const
+  {
+    if (!(se == rhs.se))
+      return false;
+    return true;
+  }
+  bool operator != (const SocialGraphService_InsertUsers_result &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const SocialGraphService_InsertUsers_result & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+typedef struct _SocialGraphService_InsertUsers_presult__isset {
+  _SocialGraphService_InsertUsers_presult__isset() : se(false) {}
+  bool se :1;
+} _SocialGraphService_InsertUsers_presult__isset;
+
+class SocialGraphService_InsertUsers_presult {
+ public:
+
+
+  virtual ~SocialGraphService_InsertUsers_presult() throw();
+  ServiceException se;
+
+  _SocialGraphService_InsertUsers_presult__isset __isset;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+
+};
+
 class SocialGraphServiceClient : virtual public SocialGraphServiceIf {
  public:
   SocialGraphServiceClient(apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> prot) {
@@ -996,6 +1247,12 @@ class SocialGraphServiceClient : virtual public SocialGraphServiceIf {
   void InsertUser(const int64_t req_id, const int64_t user_id, const std::map<std::string, std::string> & carrier);
   void send_InsertUser(const int64_t req_id, const int64_t user_id, const std::map<std::string, std::string> & carrier);
   void recv_InsertUser();
+  void FollowMany(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::vector<int64_t> & followee_ids, const std::map<std::string, std::string> & carrier);
+  void send_FollowMany(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::vector<int64_t> & followee_ids, const std::map<std::string, std::string> & carrier);
+  void recv_FollowMany();
+  void InsertUsers(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier);
+  void send_InsertUsers(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier);
+  void recv_InsertUsers();
  protected:
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> piprot_;
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> poprot_;
@@ -1018,6 +1275,8 @@ class SocialGraphServiceProcessor : public ::apache::thrift::TDispatchProcessor
   void process_FollowWithUsername(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
   void process_UnfollowWithUsername(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
   void process_InsertUser(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
+  void process_FollowMany(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
+  void process_InsertUsers(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
  public:
   SocialGraphServiceProcessor(::apache::thrift::stdcxx::shared_ptr<SocialGraphServiceIf> iface) :
     iface_(iface) {
@@ -1028,6 +1287,8 @@ class SocialGraphServiceProcessor : public ::apache::thrift::TDispatchProcessor
     processMap_["FollowWithUsername"] = &SocialGraphServiceProcessor::process_FollowWithUsername;
     processMap_["UnfollowWithUsername"] = &SocialGraphServiceProcessor::process_UnfollowWithUsername;
     processMap_["InsertUser"] = &SocialGraphServiceProcessor::process_InsertUser;
+    processMap_["FollowMany"] = &SocialGraphServiceProcessor::process_FollowMany;
+    processMap_["InsertUsers"] = &SocialGraphServiceProcessor::process_InsertUsers;
   }
 
   virtual ~SocialGraphServiceProcessor() {}
@@ -1121,6 +1382,24 @@ class SocialGraphServiceMultiface : virtual public SocialGraphServiceIf {
     ifaces_[i]->InsertUser(req_id, user_id, carrier);
   }
 
+  void FollowMany(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::vector<int64_t> & followee_ids, const std::map<std::string, std::string> & carrier) {
+    size_t sz = ifaces_.size();
+    size_t i = 0;
+    for (; i < (sz - 1); ++i) {
+      ifaces_[i]->FollowMany(req_id, user_ids, followee_ids, carrier);
+    }
+    ifaces_[i]->FollowMany(req_id, user_ids, followee_ids, carrier);
+  }
+
+  void InsertUsers(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier) {
+    size_t sz = ifaces_.size();
+    size_t i = 0;
+    for (; i < (sz - 1); ++i) {
+      ifaces_[i]->InsertUsers(req_id, user_ids, carrier);
+    }
+    ifaces_[i]->InsertUsers(req_id, user_ids, carrier);
+  }
+
 };
 
 // The 'concurrent' client is a thread safe client that correctly handles
@@ -1172,6 +1451,12 @@ class SocialGraphServiceConcurrentClient : virtual public SocialGraphServiceIf {
   void InsertUser(const int64_t req_id, const int64_t user_id, const std::map<std::string, std::string> & carrier);
   int32_t send_InsertUser(const int64_t req_id, const int64_t user_id, const std::map<std::string, std::string> & carrier);
   void recv_InsertUser(const int32_t seqid);
+  void FollowMany(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::vector<int64_t> & followee_ids, const std::map<std::string, std::string> & carrier);
+  int32_t send_FollowMany(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::vector<int64_t> & followee_ids, const std::map<std::string, std::string> & carrier);
+  void recv_FollowMany(const int32_t seqid);
+  void InsertUsers(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier);
+  int32_t send_InsertUsers(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier);
+  void recv_InsertUsers(const int32_t seqid);
  protected:
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> piprot_;
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> poprot_;
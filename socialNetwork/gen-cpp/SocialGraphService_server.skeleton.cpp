@@ -55,6 +55,16 @@ class SocialGraphServiceHandler : virtual public SocialGraphServiceIf {
     printf("InsertUser\n");
   }
 
+  void FollowMany(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::vector<int64_t> & followee_ids, const std::map<std::string, std::string> & carrier) {
+    // Your implementation goes here
+    printf("FollowMany\n");
+  }
+
+  void InsertUsers(const int64_t req_id, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier) {
+    // Your implementation goes here
+    printf("InsertUsers\n");
+  }
+
 };
 
 int main(int argc, char **argv) {
@@ -25,6 +25,11 @@ class UniqueIdServiceHandler : virtual public UniqueIdServiceIf {
     printf("ComposeUniqueId\n");
   }
 
+  void ComposeUniqueIds(std::vector<int64_t> & _return, const int64_t req_id, const PostType::type post_type, const int32_t num_ids, const std::map<std::string, std::string> & carrier) {
+    // Your implementation goes here
+    printf("ComposeUniqueIds\n");
+  }
+
 };
 
 int main(int argc, char **argv) {
@@ -27,6 +27,7 @@ class UserServiceIf {
   virtual void ComposeCreatorWithUserId(Creator& _return, const int64_t req_id, const int64_t user_id, const std::string& username, const std::map<std::string, std::string> & carrier) = 0;
   virtual void ComposeCreatorWithUsername(Creator& _return, const int64_t req_id, const std::string& username, const std::map<std::string, std::string> & carrier) = 0;
   virtual int64_t GetUserId(const int64_t req_id, const std::string& username, const std::map<std::string, std::string> & carrier) = 0;
+  virtual void RegisterUsersWithId(const int64_t req_id, const std::vector<std::string> & first_names, const std::vector<std::string> & last_names, const std::vector<std::string> & usernames, const std::vector<std::string> & passwords, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier) = 0;
 };
 
 class UserServiceIfFactory {
@@ -75,6 +76,9 @@ class UserServiceNull : virtual public UserServiceIf {
     int64_t _return = 0;
     return _return;
   }
+  void RegisterUsersWithId(const int64_t /* req_id */, const std::vector<std::string> & /* first_names */, const std::vector<std::string> & /* last_names */, const std::vector<std::string> & /* usernames */, const std::vector<std::string> & /* passwords */, const std::vector<int64_t> & /* user_ids */, const std::map<std::string, std::string> & /* carrier */) {
+    return;
+  }
 };
 
 typedef struct _UserService_RegisterUser_args__isset {
@@ -880,6 +884,152 @@ class UserService_GetUserId_presult {
 
 };
 
+typedef struct _UserService_RegisterUsersWithId_args__isset {
+  _UserService_RegisterUsersWithId_args__isset() : req_id(false), first_names(false), last_names(false), usernames(false), passwords(false), user_ids(false), carrier(false) {}
+  bool req_id :1;
+  bool first_names :1;
+  bool last_names :1;
+  bool usernames :1;
+  bool passwords :1;
+  bool user_ids :1;
+  bool carrier :1;
+} _UserService_RegisterUsersWithId_args__isset;
+
+class UserService_RegisterUsersWithId_args {
+ public:
+
+  UserService_RegisterUsersWithId_args(const UserService_RegisterUsersWithId_args&);
+  UserService_RegisterUsersWithId_args& operator=(const UserService_RegisterUsersWithId_args&);
+  UserService_RegisterUsersWithId_args() : req_id(0) {
+  }
+
+  virtual ~UserService_RegisterUsersWithId_args() throw();
+  int64_t req_id;
+  std::vector<std::string>  first_names;
+  std::vector<std::string>  last_names;
+  std::vector<std::string>  usernames;
+  std::vector<std::string>  passwords;
+  std::vector<int64_t>  user_ids;
+  std::map<std::string, std::string>  carrier;
+
+  _UserService_RegisterUsersWithId_args__isset __isset;
+
+  void __set_req_id(const int64_t val);
+
+  void __set_first_names(const std::vector<std::string> & val);
+
+  void __set_last_names(const std::vector<std::string> & val);
+
+  void __set_usernames(const std::vector<std::string> & val);
+
+  void __set_passwords(const std::vector<std::string> & val);
+
+  void __set_user_ids(const std::vector<int64_t> & val);
+
+  void __set_carrier(const std::map<std::string, std::string> & val);
+
+  bool operator == (const UserService_RegisterUsersWithId_args & rhs) const
+  {
+    if (!(req_id == rhs.req_id))
+      return false;
+    if (!(first_names == rhs.first_names))
+      return false;
+    if (!(last_names == rhs.last_names))
+      return false;
+    if (!(usernames == rhs.usernames))
+      return false;
+    if (!(passwords == rhs.passwords))
+      return false;
+    if (!(user_ids == rhs.user_ids))
+      return false;
+    if (!(carrier == rhs.carrier))
+      return false;
+    return true;
+  }
+  bool operator != (const UserService_RegisterUsersWithId_args &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const UserService_RegisterUsersWithId_args & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+
+class UserService_RegisterUsersWithId_pargs {
+ public:
+
+
+  virtual ~UserService_RegisterUsersWithId_pargs() throw();
+  const int64_t* req_id;
+  const std::vector<std::string> * first_names;
+  const std::vector<std::string> * last_names;
+  const std::vector<std::string> * usernames;
+  const std::vector<std::string> * passwords;
+  const std::vector<int64_t> * user_ids;
+  const std::map<std::string, std::string> * carrier;
+
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+typedef struct _UserService_RegisterUsersWithId_result__isset {
+  _UserService_RegisterUsersWithId_result__isset() : se(false) {}
+  bool se :1;
+} _UserService_RegisterUsersWithId_result__isset;
+
+class UserService_RegisterUsersWithId_result {
+ public:
+
+  UserService_RegisterUsersWithId_result(const UserService_RegisterUsersWithId_result&);
+  UserService_RegisterUsersWithId_result& operator=(const UserService_RegisterUsersWithId_result&);
+  UserService_RegisterUsersWithId_result() {
+  }
+
+  virtual ~UserService_RegisterUsersWithId_result() throw();
+  ServiceException se;
+
+  _UserService_RegisterUsersWithId_result__isset __isset;
+
+  void __set_se(const ServiceException& val);
+
+  bool operator == (const UserService_RegisterUsersWithId_result & rhs) const
+  {
+    if (!(se == rhs.se))
+      return false;
+    return true;
+  }
+  bool operator != (const UserService_RegisterUsersWithId_result &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const UserService_RegisterUsersWithId_result & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+};
+
+typedef struct _UserService_RegisterUsersWithId_presult__isset {
+  _UserService_RegisterUsersWithId_presult__isset() : se(false) {}
+  bool se :1;
+} _UserService_RegisterUsersWithId_presult__isset;
+
+class UserService_RegisterUsersWithId_presult {
+ public:
+
+
+  virtual ~UserService_RegisterUsersWithId_presult() throw();
+  ServiceException se;
+
+  _UserService_RegisterUsersWithId_presult__isset __isset;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+
+};
+
 class UserServiceClient : virtual public UserServiceIf {
  public:
   UserServiceClient(apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> prot) {
@@ -923,6 +1073,9 @@ class UserServiceClient : virtual public UserServiceIf {
   int64_t GetUserId(const int64_t req_id, const std::string& username, const std::map<std::string, std::string> & carrier);
   void send_GetUserId(const int64_t req_id, const std::string& username, const std::map<std::string, std::string> & carrier);
   int64_t recv_GetUserId();
+  void RegisterUsersWithId(const int64_t req_id, const std::vector<std::string> & first_names, const std::vector<std::string> & last_names, const std::vector<std::string> & usernames, const std::vector<std::string> & passwords, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier);
+  void send_RegisterUsersWithId(const int64_t req_id, const std::vector<std::string> & first_names, const std::vector<std::string> & last_names, const std::vector<std::string> & usernames, const std::vector<std::string> & passwords, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier);
+  void recv_RegisterUsersWithId();
  protected:
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> piprot_;
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> poprot_;
@@ -944,6 +1097,7 @@ class UserServiceProcessor : public ::apache::thrift::TDispatchProcessor {
   void process_ComposeCreatorWithUserId(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
   void process_ComposeCreatorWithUsername(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
   void process_GetUserId(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
+  void process_RegisterUsersWithId(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
  public:
   UserServiceProcessor(::apache::thrift::stdcxx::shared_ptr<UserServiceIf> iface) :
     iface_(iface) {
@@ -953,6 +1107,7 @@ class UserServiceProcessor : public ::apache::thrift::TDispatchProcessor {
     processMap_["ComposeCreatorWithUserId"] = &UserServiceProcessor::process_ComposeCreatorWithUserId;
     processMap_["ComposeCreatorWithUsername"] = &UserServiceProcessor::process_ComposeCreatorWithUsername;
     processMap_["GetUserId"] = &UserServiceProcessor::process_GetUserId;
+    processMap_["RegisterUsersWithId"] = &UserServiceProcessor::process_RegisterUsersWithId;
   }
 
   virtual ~UserServiceProcessor() {}
@@ -1038,6 +1193,15 @@ class UserServiceMultiface : virtual public UserServiceIf {
     return ifaces_[i]->GetUserId(req_id, username, carrier);
   }
 
+  void RegisterUsersWithId(const int64_t req_id, const std::vector<std::string> & first_names, const std::vector<std::string> & last_names, const std::vector<std::string> & usernames, const std::vector<std::string> & passwords, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier) {
+    size_t sz = ifaces_.size();
+    size_t i = 0;
+    for (; i < (sz - 1); ++i) {
+      ifaces_[i]->RegisterUsersWithId(req_id, first_names, last_names, usernames, passwords, user_ids, carrier);
+    }
+    ifaces_[i]->RegisterUsersWithId(req_id, first_names, last_names, usernames, passwords, user_ids, carrier);
+  }
+
 };
 
 // The 'concurrent' client is a thread safe client that correctly handles
@@ -1086,6 +1250,9 @@ class UserServiceConcurrentClient : virtual public UserServiceIf {
   int64_t GetUserId(const int64_t req_id, const std::string& username, const std::map<std::string, std::string> & carrier);
   int32_t send_GetUserId(const int64_t req_id, const std::string& username, const std::map<std::string, std::string> & carrier);
   int64_t recv_GetUserId(const int32_t seqid);
+  void RegisterUsersWithId(const int64_t req_id, const std::vector<std::string> & first_names, const std::vector<std::string> & last_names, const std::vector<std::string> & usernames, const std::vector<std::string> & passwords, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier);
+  int32_t send_RegisterUsersWithId(const int64_t req_id, const std::vector<std::string> & first_names, const std::vector<std::string> & last_names, const std::vector<std::string> & usernames, const std::vector<std::string> & passwords, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier);
+  void recv_RegisterUsersWithId(const int32_t seqid);
  protected:
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> piprot_;
   apache::thrift::stdcxx::shared_ptr< ::apache::thrift::protocol::TProtocol> poprot_;
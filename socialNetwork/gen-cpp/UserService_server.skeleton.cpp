@@ -50,6 +50,11 @@ class UserServiceHandler : virtual public UserServiceIf {
     printf("GetUserId\n");
   }
 
+  void RegisterUsersWithId(const int64_t req_id, const std::vector<std::string> & first_names, const std::vector<std::string> & last_names, const std::vector<std::string> & usernames, const std::vector<std::string> & passwords, const std::vector<int64_t> & user_ids, const std::map<std::string, std::string> & carrier) {
+    // Your implementation goes here
+    printf("RegisterUsersWithId\n");
+  }
+
 };
 
 int main(int argc, char **argv) {
@@ -861,6 +861,262 @@ function InsertUser_result:write(oprot)
   oprot:writeStructEnd()
 end
 
+local FollowMany_args = __TObject:new{
+  req_id,
+  user_ids,
+  followee_ids,
+  carrier
+}
+
+function FollowMany_args:read(iprot)
+  iprot:readStructBegin()
+  while true do
+    local fname, ftype, fid = iprot:readFieldBegin()
+    if ftype == TType.STOP then
+      break
+    elseif fid == 1 then
+      if ftype == TType.I64 then
+        self.req_id = iprot:readI64()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 2 then
+      if ftype == TType.LIST then
+        self.user_ids = {}
+        local _etype271, _size268 = iprot:readListBegin()
+        for _i=1,_size268 do
+          local _elem272 = iprot:readI64()
+          table.insert(self.user_ids, _elem272)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 3 then
+      if ftype == TType.LIST then
+        self.followee_ids = {}
+        local _etype276, _size273 = iprot:readListBegin()
+        for _i=1,_size273 do
+          local _elem277 = iprot:readI64()
+          table.insert(self.followee_ids, _elem277)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 4 then
+      if ftype == TType.MAP then
+        self.carrier = {}
+        local _ktype279, _vtype280, _size278 = iprot:readMapBegin()
+        for _i=1,_size278 do
+          local _key282 = iprot:readString()
+          local _val283 = iprot:readString()
+          self.carrier[_key282] = _val283
+        end
+        iprot:readMapEnd()
+      else
+        iprot:skip(ftype)
+      end
+    else
+      iprot:skip(ftype)
+    end
+    iprot:readFieldEnd()
+  end
+  iprot:readStructEnd()
+end
+
+function FollowMany_args:write(oprot)
+  oprot:writeStructBegin('FollowMany_args')
+  if self.req_id ~= nil then
+    oprot:writeFieldBegin('req_id', TType.I64, 1)
+    oprot:writeI64(self.req_id)
+    oprot:writeFieldEnd()
+  end
+  if self.user_ids ~= nil then
+    oprot:writeFieldBegin('user_ids', TType.LIST, 2)
+    oprot:writeListBegin(TType.I64, #self.user_ids)
+    for _,iter284 in ipairs(self.user_ids) do
+      oprot:writeI64(iter284)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.followee_ids ~= nil then
+    oprot:writeFieldBegin('followee_ids', TType.LIST, 3)
+    oprot:writeListBegin(TType.I64, #self.followee_ids)
+    for _,iter285 in ipairs(self.followee_ids) do
+      oprot:writeI64(iter285)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.carrier ~= nil then
+    oprot:writeFieldBegin('carrier', TType.MAP, 4)
+    oprot:writeMapBegin(TType.STRING, TType.STRING, ttable_size(self.carrier))
+    for kiter286,viter287 in pairs(self.carrier) do
+      oprot:writeString(kiter286)
+      oprot:writeString(viter287)
+    end
+    oprot:writeMapEnd()
+    oprot:writeFieldEnd()
+  end
+  oprot:writeFieldStop()
+  oprot:writeStructEnd()
+end
+
+local FollowMany_result = __TObject:new{
+  se
+}
+
+function FollowMany_result:read(iprot)
+  iprot:readStructBegin()
+  while true do
+    local fname, ftype, fid = iprot:readFieldBegin()
+    if ftype == TType.STOP then
+      break
+    elseif fid == 1 then
+      if ftype == TType.STRUCT then
+        self.se = ServiceException:new{}
+        self.se:read(iprot)
+      else
+        iprot:skip(ftype)
+      end
+    else
+      iprot:skip(ftype)
+    end
+    iprot:readFieldEnd()
+  end
+  iprot:readStructEnd()
+end
+
+function FollowMany_result:write(oprot)
+  oprot:writeStructBegin('FollowMany_result')
+  if self.se ~= nil then
+    oprot:writeFieldBegin('se', TType.STRUCT, 1)
+    self.se:write(oprot)
+    oprot:writeFieldEnd()
+  end
+  oprot:writeFieldStop()
+  oprot:writeStructEnd()
+end
+
+local InsertUsers_args = __TObject:new{
+  req_id,
+  user_ids,
+  carrier
+}
+
+function InsertUsers_args:read(iprot)
+  iprot:readStructBegin()
+  while true do
+    local fname, ftype, fid = iprot:readFieldBegin()
+    if ftype == TType.STOP then
+      break
+    elseif fid == 1 then
+      if ftype == TType.I64 then
+        self.req_id = iprot:readI64()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 2 then
+      if ftype == TType.LIST then
+        self.user_ids = {}
+        local _etype291, _size288 = iprot:readListBegin()
+        for _i=1,_size288 do
+          local _elem292 = iprot:readI64()
+          table.insert(self.user_ids, _elem292)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 3 then
+      if ftype == TType.MAP then
+        self.carrier = {}
+        local _ktype294, _vtype295, _size293 = iprot:readMapBegin()
+        for _i=1,_size293 do
+          local _key297 = iprot:readString()
+          local _val298 = iprot:readString()
+          self.carrier[_key297] = _val298
+        end
+        iprot:readMapEnd()
+      else
+        iprot:skip(ftype)
+      end
+    else
+      iprot:skip(ftype)
+    end
+    iprot:readFieldEnd()
+  end
+  iprot:readStructEnd()
+end
+
+function InsertUsers_args:write(oprot)
+  oprot:writeStructBegin('InsertUsers_args')
+  if self.req_id ~= nil then
+    oprot:writeFieldBegin('req_id', TType.I64, 1)
+    oprot:writeI64(self.req_id)
+    oprot:writeFieldEnd()
+  end
+  if self.user_ids ~= nil then
+    oprot:writeFieldBegin('user_ids', TType.LIST, 2)
+    oprot:writeListBegin(TType.I64, #self.user_ids)
+    for _,iter299 in ipairs(self.user_ids) do
+      oprot:writeI64(iter299)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.carrier ~= nil then
+    oprot:writeFieldBegin('carrier', TType.MAP, 3)
+    oprot:writeMapBegin(TType.STRING, TType.STRING, ttable_size(self.carrier))
+    for kiter300,viter301 in pairs(self.carrier) do
+      oprot:writeString(kiter300)
+      oprot:writeString(viter301)
+    end
+    oprot:writeMapEnd()
+    oprot:writeFieldEnd()
+  end
+  oprot:writeFieldStop()
+  oprot:writeStructEnd()
+end
+
+local InsertUsers_result = __TObject:new{
+  se
+}
+
+function InsertUsers_result:read(iprot)
+  iprot:readStructBegin()
+  while true do
+    local fname, ftype, fid = iprot:readFieldBegin()
+    if ftype == TType.STOP then
+      break
+    elseif fid == 1 then
+      if ftype == TType.STRUCT then
+        self.se = ServiceException:new{}
+        self.se:read(iprot)
+      else
+        iprot:skip(ftype)
+      end
+    else
+      iprot:skip(ftype)
+    end
+    iprot:readFieldEnd()
+  end
+  iprot:readStructEnd()
+end
+
+function InsertUsers_result:write(oprot)
+  oprot:writeStructBegin('InsertUsers_result')
+  if self.se ~= nil then
+    oprot:writeFieldBegin('se', TType.STRUCT, 1)
+    self.se:write(oprot)
+    oprot:writeFieldEnd()
+  end
+  oprot:writeFieldStop()
+  oprot:writeStructEnd()
+end
+
 local SocialGraphServiceClient = __TObject.new(__TClient, {
   __type = 'SocialGraphServiceClient'
 })
@@ -1098,6 +1354,71 @@ function SocialGraphServiceClient:recv_InsertUser(req_id, user_id, carrier)
     error(result.se)
   end
 end
+
+function SocialGraphServiceClient:FollowMany(req_id, user_ids, followee_ids, carrier)
+  self:send_FollowMany(req_id, user_ids, followee_ids, carrier)
+  self:recv_FollowMany(req_id, user_ids, followee_ids, carrier)
+end
+
+function SocialGraphServiceClient:send_FollowMany(req_id, user_ids, followee_ids, carrier)
+  self.oprot:writeMessageBegin('FollowMany', TMessageType.CALL, self._seqid)
+  local args = FollowMany_args:new{}
+  args.req_id = req_id
+  args.user_ids = user_ids
+  args.followee_ids = followee_ids
+  args.carrier = carrier
+  args:write(self.oprot)
+  self.oprot:writeMessageEnd()
+  self.oprot.trans:flush()
+end
+
+function SocialGraphServiceClient:recv_FollowMany(req_id, user_ids, followee_ids, carrier)
+  local fname, mtype, rseqid = self.iprot:readMessageBegin()
+  if mtype == TMessageType.EXCEPTION then
+    local x = TApplicationException:new{}
+    x:read(self.iprot)
+    self.iprot:readMessageEnd()
+    error(x)
+  end
+  local result = FollowMany_result:new{}
+  result:read(self.iprot)
+  self.iprot:readMessageEnd()
+  if result.se then
+    error(result.se)
+  end
+end
+
+function SocialGraphServiceClient:InsertUsers(req_id, user_ids, carrier)
+  self:send_InsertUsers(req_id, user_ids, carrier)
+  self:recv_InsertUsers(req_id, user_ids, carrier)
+end
+
+function SocialGraphServiceClient:send_InsertUsers(req_id, user_ids, carrier)
+  self.oprot:writeMessageBegin('InsertUsers', TMessageType.CALL, self._seqid)
+  local args = InsertUsers_args:new{}
+  args.req_id = req_id
+  args.user_ids = user_ids
+  args.carrier = carrier
+  args:write(self.oprot)
+  self.oprot:writeMessageEnd()
+  self.oprot.trans:flush()
+end
+
+function SocialGraphServiceClient:recv_InsertUsers(req_id, user_ids, carrier)
+  local fname, mtype, rseqid = self.iprot:readMessageBegin()
+  if mtype == TMessageType.EXCEPTION then
+    local x = TApplicationException:new{}
+    x:read(self.iprot)
+    self.iprot:readMessageEnd()
+    error(x)
+  end
+  local result = InsertUsers_result:new{}
+  result:read(self.iprot)
+  self.iprot:readMessageEnd()
+  if result.se then
+    error(result.se)
+  end
+end
 local SocialGraphServiceIface = __TObject:new{
   __type = 'SocialGraphServiceIface'
 }
@@ -1273,6 +1594,48 @@ function SocialGraphServiceProcessor:process_InsertUser(seqid, iprot, oprot, ser
   oprot.trans:flush()
 end
 
+function SocialGraphServiceProcessor:process_FollowMany(seqid, iprot, oprot, server_ctx)
+  local args = FollowMany_args:new{}
+  local reply_type = TMessageType.REPLY
+  args:read(iprot)
+  iprot:readMessageEnd()
+  local result = FollowMany_result:new{}
+  local status, res = pcall(self.handler.FollowMany, self.handler, args.req_id, args.user_ids, args.followee_ids, args.carrier)
+  if not status then
+    reply_type = TMessageType.EXCEPTION
+    result = TApplicationException:new{message = res}
+  elseif ttype(res) == 'ServiceException' then
+    result.se = res
+  else
+    result.success = res
+  end
+  oprot:writeMessageBegin('FollowMany', reply_type, seqid)
+  result:write(oprot)
+  oprot:writeMessageEnd()
+  oprot.trans:flush()
+end
+
+function SocialGraphServiceProcessor:process_InsertUsers(seqid, iprot, oprot, server_ctx)
+  local args = InsertUsers_args:new{}
+  local reply_type = TMessageType.REPLY
+  args:read(iprot)
+  iprot:readMessageEnd()
+  local result = InsertUsers_result:new{}
+  local status, res = pcall(self.handler.InsertUsers, self.handler, args.req_id, args.user_ids, args.carrier)
+  if not status then
+    reply_type = TMessageType.EXCEPTION
+    result = TApplicationException:new{message = res}
+  elseif ttype(res) == 'ServiceException' then
+    result.se = res
+  else
+    result.success = res
+  end
+  oprot:writeMessageBegin('InsertUsers', reply_type, seqid)
+  result:write(oprot)
+  oprot:writeMessageEnd()
+  oprot.trans:flush()
+end
+
 return {
   SocialGraphServiceClient = SocialGraphServiceClient
 }
\ No newline at end of file
@@ -821,6 +821,211 @@ function GetUserId_result:write(oprot)
   oprot:writeStructEnd()
 end
 
+local RegisterUsersWithId_args = __TObject:new{
+  req_id,
+  first_names,
+  last_names,
+  usernames,
+  passwords,
+  user_ids,
+  carrier
+}
+
+function RegisterUsersWithId_args:read(iprot)
+  iprot:readStructBegin()
+  while true do
+    local fname, ftype, fid = iprot:readFieldBegin()
+    if ftype == TType.STOP then
+      break
+    elseif fid == 1 then
+      if ftype == TType.I64 then
+        self.req_id = iprot:readI64()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 2 then
+      if ftype == TType.LIST then
+        self.first_names = {}
+        local _etype97, _size94 = iprot:readListBegin()
+        for _i=1,_size94 do
+          local _elem98 = iprot:readString()
+          table.insert(self.first_names, _elem98)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 3 then
+      if ftype == TType.LIST then
+        self.last_names = {}
+        local _etype102, _size99 = iprot:readListBegin()
+        for _i=1,_size99 do
+          local _elem103 = iprot:readString()
+          table.insert(self.last_names, _elem103)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 4 then
+      if ftype == TType.LIST then
+        self.usernames = {}
+        local _etype107, _size104 = iprot:readListBegin()
+        for _i=1,_size104 do
+          local _elem108 = iprot:readString()
+          table.insert(self.usernames, _elem108)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 5 then
+      if ftype == TType.LIST then
+        self.passwords = {}
+        local _etype112, _size109 = iprot:readListBegin()
+        for _i=1,_size109 do
+          local _elem113 = iprot:readString()
+          table.insert(self.passwords, _elem113)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 6 then
+      if ftype == TType.LIST then
+        self.user_ids = {}
+        local _etype117, _size114 = iprot:readListBegin()
+        for _i=1,_size114 do
+          local _elem118 = iprot:readI64()
+          table.insert(self.user_ids, _elem118)
+        end
+        iprot:readListEnd()
+      else
+        iprot:skip(ftype)
+      end
+    elseif fid == 7 then
+      if ftype == TType.MAP then
+        self.carrier = {}
+        local _ktype120, _vtype121, _size119 = iprot:readMapBegin()
+        for _i=1,_size119 do
+          local _key123 = iprot:readString()
+          local _val124 = iprot:readString()
+          self.carrier[_key123] = _val124
+        end
+        iprot:readMapEnd()
+      else
+        iprot:skip(ftype)
+      end
+    else
+      iprot:skip(ftype)
+    end
+    iprot:readFieldEnd()
+  end
+  iprot:readStructEnd()
+end
+
+function RegisterUsersWithId_args:write(oprot)
+  oprot:writeStructBegin('RegisterUsersWithId_args')
+  if self.req_id ~= nil then
+    oprot:writeFieldBegin('req_id', TType.I64, 1)
+    oprot:writeI64(self.req_id)
+    oprot:writeFieldEnd()
+  end
+  if self.first_names ~= nil then
+    oprot:writeFieldBegin('first_names', TType.LIST, 2)
+    oprot:writeListBegin(TType.STRING, #self.first_names)
+    for _,iter125 in ipairs(self.first_names) do
+      oprot:writeString(iter125)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.last_names ~= nil then
+    oprot:writeFieldBegin('last_names', TType.LIST, 3)
+    oprot:writeListBegin(TType.STRING, #self.last_names)
+    for _,iter126 in ipairs(self.last_names) do
+      oprot:writeString(iter126)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.usernames ~= nil then
+    oprot:writeFieldBegin('usernames', TType.LIST, 4)
+    oprot:writeListBegin(TType.STRING, #self.usernames)
+    for _,iter127 in ipairs(self.usernames) do
+      oprot:writeString(iter127)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.passwords ~= nil then
+    oprot:writeFieldBegin('passwords', TType.LIST, 5)
+    oprot:writeListBegin(TType.STRING, #self.passwords)
+    for _,iter128 in ipairs(self.passwords) do
+      oprot:writeString(iter128)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.user_ids ~= nil then
+    oprot:writeFieldBegin('user_ids', TType.LIST, 6)
+    oprot:writeListBegin(TType.I64, #self.user_ids)
+    for _,iter129 in ipairs(self.user_ids) do
+      oprot:writeI64(iter129)
+    end
+    oprot:writeListEnd()
+    oprot:writeFieldEnd()
+  end
+  if self.carrier ~= nil then
+    oprot:writeFieldBegin('carrier', TType.MAP, 7)
+    oprot:writeMapBegin(TType.STRING, TType.STRING, ttable_size(self.carrier))
+    for kiter130,viter131 in pairs(self.carrier) do
+      oprot:writeString(kiter130)
+      oprot:writeString(viter131)
+    end
+    oprot:writeMapEnd()
+    oprot:writeFieldEnd()
+  end
+  oprot:writeFieldStop()
+  oprot:writeStructEnd()
+end
+
+local RegisterUsersWithId_result = __TObject:new{
+  se
+}
+
+function RegisterUsersWithId_result:read(iprot)
+  iprot:readStructBegin()
+  while true do
+    local fname, ftype, fid = iprot:readFieldBegin()
+    if ftype == TType.STOP then
+      break
+    elseif fid == 1 then
+      if ftype == TType.STRUCT then
+        self.se = ServiceException:new{}
+        self.se:read(iprot)
+      else
+        iprot:skip(ftype)
+      end
+    else
+      iprot:skip(ftype)
+    end
+    iprot:readFieldEnd()
+  end
+  iprot:readStructEnd()
+end
+
+function RegisterUsersWithId_result:write(oprot)
+  oprot:writeStructBegin('RegisterUsersWithId_result')
+  if self.se ~= nil then
+    oprot:writeFieldBegin('se', TType.STRUCT, 1)
+    self.se:write(oprot)
+    oprot:writeFieldEnd()
+  end
+  oprot:writeFieldStop()
+  oprot:writeStructEnd()
+end
+
 local UserServiceClient = __TObject.new(__TClient, {
   __type = 'UserServiceClient'
 })
@@ -1031,6 +1236,42 @@ function UserServiceClient:recv_GetUserId(req_id, username, carrier)
   end
   error(TApplicationException:new{errorCode = TApplicationException.MISSING_RESULT})
 end
+
+function UserServiceClient:RegisterUsersWithId(req_id, first_names, last_names, usernames, passwords, user_ids, carrier)
+  self:send_RegisterUsersWithId(req_id, first_names, last_names, usernames, passwords, user_ids, carrier)
+  self:recv_RegisterUsersWithId(req_id, first_names, last_names, usernames, passwords, user_ids, carrier)
+end
+
+function UserServiceClient:send_RegisterUsersWithId(req_id, first_names, last_names, usernames, passwords, user_ids, carrier)
+  self.oprot:writeMessageBegin('RegisterUsersWithId', TMessageType.CALL, self._seqid)
+  local args = RegisterUsersWithId_args:new{}
+  args.req_id = req_id
+  args.first_names = first_names
+  args.last_names = last_names
+  args.usernames = usernames
+  args.passwords = passwords
+  args.user_ids = user_ids
+  args.carrier = carrier
+  args:write(self.oprot)
+  self.oprot:writeMessageEnd()
+  self.oprot.trans:flush()
+end
+
+function UserServiceClient:recv_RegisterUsersWithId(req_id, first_names, last_names, usernames, passwords, user_ids, carrier)
+  local fname, mtype, rseqid = self.iprot:readMessageBegin()
+  if mtype == TMessageType.EXCEPTION then
+    local x = TApplicationException:new{}
+    x:read(self.iprot)
+    self.iprot:readMessageEnd()
+    error(x)
+  end
+  local result = RegisterUsersWithId_result:new{}
+  result:read(self.iprot)
+  self.iprot:readMessageEnd()
+  if result.se then
+    error(result.se)
+  end
+end
 local UserServiceIface = __TObject:new{
   __type = 'UserServiceIface'
 }
@@ -1185,6 +1426,27 @@ function UserServiceProcessor:process_GetUserId(seqid, iprot, oprot, server_ctx)
   oprot.trans:flush()
 end
 
+function UserServiceProcessor:process_RegisterUsersWithId(seqid, iprot, oprot, server_ctx)
+  local args = RegisterUsersWithId_args:new{}
+  local reply_type = TMessageType.REPLY
+  args:read(iprot)
+  iprot:readMessageEnd()
+  local result = RegisterUsersWithId_result:new{}
+  local status, res = pcall(self.handler.RegisterUsersWithId, self.handler, args.req_id, args.first_names, args.last_names, args.usernames, args.passwords, args.user_ids, args.carrier)
+  if not status then
+    reply_type = TMessageType.EXCEPTION
+    result = TApplicationException:new{message = res}
+  elseif ttype(res) == 'ServiceException' then
+    result.se = res
+  else
+    result.success = res
+  end
+  oprot:writeMessageBegin('RegisterUsersWithId', reply_type, seqid)
+  result:write(oprot)
+  oprot:writeMessageEnd()
+  oprot.trans:flush()
+end
+
 return {
   UserServiceClient=UserServiceClient
 }
\ No newline at end of file
@@ -89,6 +89,20 @@ class Iface(object):
         pass
 
 
+    def RegisterUsersWithId(self, req_id, first_names, last_names, usernames, passwords, user_ids, carrier):
+        """
+        Parameters:
+         - req_id
+         - first_names
+         - last_names
+         - usernames
+         - passwords
+         - user_ids
+         - carrier
+
+        """
+        pass
+
 class Client(Iface):
     def __init__(self, iprot, oprot=None):
         self._iprot = self._oprot = iprot
@@ -339,6 +353,50 @@ class Client(Iface):
         raise TApplicationException(TApplicationException.MISSING_RESULT, "GetUserId failed: unknown result")
 
 
+    def RegisterUsersWithId(self, req_id, first_names, last_names, usernames, passwords, user_ids, carrier):
+        """
+        Parameters:
+         - req_id
+         - first_names
+         - last_names
+         - usernames
+         - passwords
+         - user_ids
+         - carrier
+
+        """
+        self.send_RegisterUsersWithId(req_id, first_names, last_names, usernames, passwords, user_ids, carrier)
+        self.recv_RegisterUsersWithId()
+
+    def send_RegisterUsersWithId(self, req_id, first_names, last_names, usernames, passwords, user_ids, carrier):
+        self._oprot.writeMessageBegin('RegisterUsersWithId', TMessageType.CALL, self._seqid)
+        args = RegisterUsersWithId_args()
+        args.req_id = req_id
+        args.first_names = first_names
+        args.last_names = last_names
+        args.usernames = usernames
+        args.passwords = passwords
+        args.user_ids = user_ids
+        args.carrier = carrier
+        args.write(self._oprot)
+        self._oprot.writeMessageEnd()
+        self._oprot.trans.flush()
+
+    def recv_RegisterUsersWithId(self):
+        iprot = self._iprot
+        (fname, mtype, rseqid) = iprot.readMessageBegin()
+        if mtype == TMessageType.EXCEPTION:
+            x = TApplicationException()
+            x.read(iprot)
+            iprot.readMessageEnd()
+            raise x
+        result = RegisterUsersWithId_result()
+        result.read(iprot)
+        iprot.readMessageEnd()
+        if result.se is not None:
+            raise result.se
+        return
+
 class Processor(Iface, TProcessor):
     def __init__(self, handler):
         self._handler = handler
@@ -349,6 +407,7 @@ class Processor(Iface, TProcessor):
         self._processMap["ComposeCreatorWithUserId"] = Processor.process_ComposeCreatorWithUserId
         self._processMap["ComposeCreatorWithUsername"] = Processor.process_ComposeCreatorWithUsername
         self._processMap["GetUserId"] = Processor.process_GetUserId
+        self._processMap["RegisterUsersWithId"] = Processor.process_RegisterUsersWithId
         self._on_message_begin = None
 
     def on_message_begin(self, func):
@@ -527,6 +586,32 @@ class Processor(Iface, TProcessor):
         oprot.writeMessageEnd()
         oprot.trans.flush()
 
+    def process_RegisterUsersWithId(self, seqid, iprot, oprot):
+        args = RegisterUsersWithId_args()
+        args.read(iprot)
+        iprot.readMessageEnd()
+        result = RegisterUsersWithId_result()
+        try:
+            self._handler.RegisterUsersWithId(args.req_id, args.first_names, args.last_names, args.usernames, args.passwords, args.user_ids, args.carrier)
+            msg_type = TMessageType.REPLY
+        except TTransport.TTransportException:
+            raise
+        except ServiceException as se:
+            msg_type = TMessageType.REPLY
+            result.se = se
+        except TApplicationException as ex:
+            logging.exception('TApplication exception in handler')
+            msg_type = TMessageType.EXCEPTION
+            result = ex
+        except Exception:
+            logging.exception('Unexpected exception in handler')
+            msg_type = TMessageType.EXCEPTION
+            result = TApplicationException(TApplicationException.INTERNAL_ERROR, 'Internal error')
+        oprot.writeMessageBegin("RegisterUsersWithId", msg_type, seqid)
+        result.write(oprot)
+        oprot.writeMessageEnd()
+        oprot.trans.flush()
+
 # HELPER FUNCTIONS AND STRUCTURES
 
 
@@ -1630,5 +1715,251 @@ GetUserId_result.thrift_spec = (
     (0, TType.I64, 'success', None, None, ),  # 0
     (1, TType.STRUCT, 'se', [ServiceException, None], None, ),  # 1
 )
+
+
+class RegisterUsersWithId_args(object):
+    """
+    Attributes:
+     - req_id
+     - first_names
+     - last_names
+     - usernames
+     - passwords
+     - user_ids
+     - carrier
+
+    """
+
+
+    def __init__(self, req_id=None, first_names=None, last_names=None, usernames=None, passwords=None, user_ids=None, carrier=None,):
+        self.req_id = req_id
+        self.first_names = first_names
+        self.last_names = last_names
+        self.usernames = usernames
+        self.passwords = passwords
+        self.user_ids = user_ids
+        self.carrier = carrier
+
+    def read(self, iprot):
+        if iprot._fast_decode is not None and isinstance(iprot.trans, TTransport.CReadableTransport) and self.thrift_spec is not None:
+            iprot._fast_decode(self, iprot, [self.__class__, self.thrift_spec])
+            return
+        iprot.readStructBegin()
+        while True:
+            (fname, ftype, fid) = iprot.readFieldBegin()
+            if ftype == TType.STOP:
+                break
+            if fid == 1:
+                if ftype == TType.I64:
+                    self.req_id = iprot.readI64()
+                else:
+                    iprot.skip(ftype)
+            elif fid == 2:
+                if ftype == TType.LIST:
+                    self.first_names = []
+                    (_etype110, _size107) = iprot.readListBegin()
+                    for _i111 in range(_size107):
+                        _elem112 = iprot.readString().decode('utf-8', errors='replace') if sys.version_info[0] == 2 else iprot.readString()
+                        self.first_names.append(_elem112)
+                    iprot.readListEnd()
+                else:
+                    iprot.skip(ftype)
+            elif fid == 3:
+                if ftype == TType.LIST:
+                    self.last_names = []
+                    (_etype116, _size113) = iprot.readListBegin()
+                    for _i117 in range(_size113):
+                        _elem118 = iprot.readString().decode('utf-8', errors='replace') if sys.version_info[0] == 2 else iprot.readString()
+                        self.last_names.append(_elem118)
+                    iprot.readListEnd()
+                else:
+                    iprot.skip(ftype)
+            elif fid == 4:
+                if ftype == TType.LIST:
+                    self.usernames = []
+                    (_etype122, _size119) = iprot.readListBegin()
+                    for _i123 in range(_size119):
+                        _elem124 = iprot.readString().decode('utf-8', errors='replace') if sys.version_info[0] == 2 else iprot.readString()
+                        self.usernames.append(_elem124)
+                    iprot.readListEnd()
+                else:
+                    iprot.skip(ftype)
+            elif fid == 5:
+                if ftype == TType.LIST:
+                    self.passwords = []
+                    (_etype128, _size125) = iprot.readListBegin()
+                    for _i129 in range(_size125):
+                        _elem130 = iprot.readString().decode('utf-8', errors='replace') if sys.version_info[0] == 2 else iprot.readString()
+                        self.passwords.append(_elem130)
+                    iprot.readListEnd()
+                else:
+                    iprot.skip(ftype)
+            elif fid == 6:
+                if ftype == TType.LIST:
+                    self.user_ids = []
+                    (_etype134, _size131) = iprot.readListBegin()
+                    for _i135 in range(_size131):
+                        _elem136 = iprot.readI64()
+                        self.user_ids.append(_elem136)
+                    iprot.readListEnd()
+                else:
+                    iprot.skip(ftype)
+            elif fid == 7:
+                if ftype == TType.MAP:
+                    self.carrier = {}
+                    (_ktype138, _vtype139, _size137) = iprot.readMapBegin()
+                    for _i141 in range(_size137):
+                        _key142 = iprot.readString().decode('utf-8', errors='replace') if sys.version_info[0] == 2 else iprot.readString()
+                        _val143 = iprot.readString().decode('utf-8', errors='replace') if sys.version_info[0] == 2 else iprot.readString()
+                        self.carrier[_key142] = _val143
+                    iprot.readMapEnd()
+                else:
+                    iprot.skip(ftype)
+            else:
+                iprot.skip(ftype)
+            iprot.readFieldEnd()
+        iprot.readStructEnd()
+
+    def write(self, oprot):
+        if oprot._fast_encode is not None and self.thrift_spec is not None:
+            oprot.trans.write(oprot._fast_encode(self, [self.__class__, self.thrift_spec]))
+            return
+        oprot.writeStructBegin('RegisterUsersWithId_args')
+        if self.req_id is not None:
+            oprot.writeFieldBegin('req_id', TType.I64, 1)
+            oprot.writeI64(self.req_id)
+            oprot.writeFieldEnd()
+        if self.first_names is not None:
+            oprot.writeFieldBegin('first_names', TType.LIST, 2)
+            oprot.writeListBegin(TType.STRING, len(self.first_names))
+            for iter144 in self.first_names:
+                oprot.writeString(iter144.encode('utf-8') if sys.version_info[0] == 2 else iter144)
+            oprot.writeListEnd()
+            oprot.writeFieldEnd()
+        if self.last_names is not None:
+            oprot.writeFieldBegin('last_names', TType.LIST, 3)
+            oprot.writeListBegin(TType.STRING, len(self.last_names))
+            for iter145 in self.last_names:
+                oprot.writeString(iter145.encode('utf-8') if sys.version_info[0] == 2 else iter145)
+            oprot.writeListEnd()
+            oprot.writeFieldEnd()
+        if self.usernames is not None:
+            oprot.writeFieldBegin('usernames', TType.LIST, 4)
+            oprot.writeListBegin(TType.STRING, len(self.usernames))
+            for iter146 in self.usernames:
+                oprot.writeString(iter146.encode('utf-8') if sys.version_info[0] == 2 else iter146)
+            oprot.writeListEnd()
+            oprot.writeFieldEnd()
+        if self.passwords is not None:
+            oprot.writeFieldBegin('passwords', TType.LIST, 5)
+            oprot.writeListBegin(TType.STRING, len(self.passwords))
+            for iter147 in self.passwords:
+                oprot.writeString(iter147.encode('utf-8') if sys.version_info[0] == 2 else iter147)
+            oprot.writeListEnd()
+            oprot.writeFieldEnd()
+        if self.user_ids is not None:
+            oprot.writeFieldBegin('user_ids', TType.LIST, 6)
+            oprot.writeListBegin(TType.I64, len(self.user_ids))
+            for iter148 in self.user_ids:
+                oprot.writeI64(iter148)
+            oprot.writeListEnd()
+            oprot.writeFieldEnd()
+        if self.carrier is not None:
+            oprot.writeFieldBegin('carrier', TType.MAP, 7)
+            oprot.writeMapBegin(TType.STRING, TType.STRING, len(self.carrier))
+            for kiter149, viter150 in self.carrier.items():
+                oprot.writeString(kiter149.encode('utf-8') if sys.version_info[0] == 2 else kiter149)
+                oprot.writeString(viter150.encode('utf-8') if sys.version_info[0] == 2 else viter150)
+            oprot.writeMapEnd()
+            oprot.writeFieldEnd()
+        oprot.writeFieldStop()
+        oprot.writeStructEnd()
+
+    def validate(self):
+        return
+
+    def __repr__(self):
+        L = ['%s=%r' % (key, value)
+             for key, value in self.__dict__.items()]
+        return '%s(%s)' % (self.__class__.__name__, ', '.join(L))
+
+    def __eq__(self, other):
+        return isinstance(other, self.__class__) and self.__dict__ == other.__dict__
+
+    def __ne__(self, other):
+        return not (self == other)
+all_structs.append(RegisterUsersWithId_args)
+RegisterUsersWithId_args.thrift_spec = (
+    None,  # 0
+    (1, TType.I64, 'req_id', None, None, ),  # 1
+    (2, TType.LIST, 'first_names', (TType.STRING, 'UTF8', False), None, ),  # 2
+    (3, TType.LIST, 'last_names', (TType.STRING, 'UTF8', False), None, ),  # 3
+    (4, TType.LIST, 'usernames', (TType.STRING, 'UTF8', False), None, ),  # 4
+    (5, TType.LIST, 'passwords', (TType.STRING, 'UTF8', False), None, ),  # 5
+    (6, TType.LIST, 'user_ids', (TType.I64, None, False), None, ),  # 6
+    (7, TType.MAP, 'carrier', (TType.STRING, 'UTF8', TType.STRING, 'UTF8', False), None, ),  # 7
+)
+
+
+class RegisterUsersWithId_result(object):
+    """
+    Attributes:
+     - se
+
+    """
+
+
+    def __init__(self, se=None,):
+        self.se = se
+
+    def read(self, iprot):
+        if iprot._fast_decode is not None and isinstance(iprot.trans, TTransport.CReadableTransport) and self.thrift_spec is not None:
+            iprot._fast_decode(self, iprot, [self.__class__, self.thrift_spec])
+            return
+        iprot.readStructBegin()
+        while True:
+            (fname, ftype, fid) = iprot.readFieldBegin()
+            if ftype == TType.STOP:
+                break
+            if fid == 1:
+                if ftype == TType.STRUCT:
+                    self.se = ServiceException.read(iprot)
+                else:
+                    iprot.skip(ftype)
+            else:
+                iprot.skip(ftype)
+            iprot.readFieldEnd()
+        iprot.readStructEnd()
+
+    def write(self, oprot):
+        if oprot._fast_encode is not None and self.thrift_spec is not None:
+            oprot.trans.write(oprot._fast_encode(self, [self.__class__, self.thrift_spec]))
+            return
+        oprot.writeStructBegin('RegisterUsersWithId_result')
+        if self.se is not None:
+            oprot.writeFieldBegin('se', TType.STRUCT, 1)
+            self.se.write(oprot)
+            oprot.writeFieldEnd()
+        oprot.writeFieldStop()
+        oprot.writeStructEnd()
+
+    def validate(self):
+        return
+
+    def __repr__(self):
+        L = ['%s=%r' % (key, value)
+             for key, value in self.__dict__.items()]
+        return '%s(%s)' % (self.__class__.__name__, ', '.join(L))
+
+    def __eq__(self, other):
+        return isinstance(other, self.__class__) and self.__dict__ == other.__dict__
+
+    def __ne__(self, other):
+        return not (self == other)
+all_structs.append(RegisterUsersWithId_result)
+RegisterUsersWithId_result.thrift_spec = (
+    None,  # 0
+    (1, TType.STRUCT, 'se', [ServiceException, None], None, ),  # 1
+)
 fix_spec(all_structs)
 del all_structs
@@ -75,6 +75,7 @@ http {
     config:set("secret", "secret")
     config:set("cookie_ttl", 3600 * 24)
     config:set("ssl", false)
+    config:set("thrift_protocol", "binary")
   }
 
   server {
@@ -437,6 +438,26 @@ http {
       ';
     }
 
+    # Bulk endpoints for the dataset loader; batches are sent as JSON arrays
+    # and must fit in the body buffer for ngx.req.get_post_args.
+    location /wrk2-api/user/register-many {
+      client_max_body_size 16m;
+      client_body_buffer_size 16m;
+      content_by_lua '
+          local client = require "wrk2-api/user/register"
+          client.RegisterUsers();
+      ';
+    }
+
+    location /wrk2-api/user/follow-many {
+      client_max_body_size 16m;
+      client_body_buffer_size 16m;
+      content_by_lua '
+          local client = require "wrk2-api/user/follow"
+          client.FollowMany();
+      ';
+    }
+
     location /wrk2-api/user/unfollow {
       content_by_lua '
           local client = require "wrk2-api/user/unfollow"
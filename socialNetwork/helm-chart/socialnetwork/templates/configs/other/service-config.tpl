@@ -13,19 +13,45 @@
 {{- define "socialnetwork.templates.other.service-config.json"  }}
 {
     "secret": "secret",
+    "username-filter": {
+      "enabled": 0,
+      "error_rate": 0.01,
+      "initial_capacity": 100000,
+      "max_memory_mb": 64,
+      "refresh_interval_ms": 5000
+    },
+    "thrift": {
+      "protocol": "binary",
+      "compression": {
+        "codec": "none",
+        "threshold_bytes": 4096,
+        "zstd_level": 1,
+        "metrics_interval_ms": 60000
+      }
+    },
+    "load-balancing": {
+      "dns_refresh_ms": 5000,
+      "eject_failures": 5,
+      "eject_ms": 10000,
+      "metrics_interval_ms": 60000
+    },
     "social-graph-service": {
       "addr": "social-graph-service",
       "port": 9090,
       "connections": 512,
       "timeout_ms": 10000,
-      "keepalive_ms": 10000
+      "keepalive_ms": 10000,
+      "use_graph_index": 0
     },
     "social-graph-mongodb": {
       "addr": {{ ternary (include "mongodb-sharded.connection" . | trim) "social-graph-mongodb" .Values.global.mongodb.sharding.enabled | quote}},
       "port": {{ ternary .Values.global.mongodb.sharding.svc.port 27017 .Values.global.mongodb.sharding.enabled}},
       "connections": 512,
       "timeout_ms": 10000,
-      "keepalive_ms": 10000
+      "keepalive_ms": 10000,
+      "use_edge_collection": 0,
+      "read_preference": "primary",
+      "max_staleness_s": -1
     },
     "social-graph-redis": {
       "addr": {{ ternary (include "redis-cluster.connection" . | trim) "social-graph-redis" .Values.global.redis.cluster.enabled | quote}},
@@ -65,7 +91,8 @@
       "port": 9090,
       "connections": 512,
       "timeout_ms": 10000,
-      "keepalive_ms": 10000
+      "keepalive_ms": 10000,
+      "in_process": []
     },
     "compose-post-redis": {
       "addr": {{ ternary (include "redis-cluster.connection" . | trim) "compose-post-redis" .Values.global.redis.cluster.enabled | quote}},
@@ -88,7 +115,9 @@
       "port": {{ ternary .Values.global.mongodb.sharding.svc.port 27017 .Values.global.mongodb.sharding.enabled}},
       "connections": 512,
       "timeout_ms": 10000,
-      "keepalive_ms": 10000
+      "keepalive_ms": 10000,
+      "read_preference": "primary",
+      "max_staleness_s": -1
     },
     "user-timeline-redis": {
       "addr": {{ ternary (include "redis-cluster.connection" . | trim) "user-timeline-redis" .Values.global.redis.cluster.enabled | quote}},
@@ -111,7 +140,9 @@
       "port": {{ ternary .Values.global.mongodb.sharding.svc.port 27017 .Values.global.mongodb.sharding.enabled}},
       "connections": 512,
       "timeout_ms": 10000,
-      "keepalive_ms": 10000
+      "keepalive_ms": 10000,
+      "read_preference": "primary",
+      "max_staleness_s": -1
     },
     "post-storage-memcached": {
       "addr": {{ ternary (include "memcached-cluster.connection" . | trim) "post-storage-memcached" .Values.global.memcached.cluster.enabled | quote}},
@@ -119,7 +150,9 @@
       "connections": 512,
       "timeout_ms": 10000,
       "keepalive_ms": 10000,
-      "binary_protocol": {{ ternary 0 1 .Values.global.memcached.cluster.enabled}}
+      "binary_protocol": {{ ternary 0 1 .Values.global.memcached.cluster.enabled}},
+      "failure_limit": 2,
+      "retry_timeout_s": 5
     },
     "unique-id-service": {
       "addr": "unique-id-service",
@@ -149,7 +182,9 @@
       "connections": 512,
       "timeout_ms": 10000,
       "keepalive_ms": 10000,
-      "binary_protocol": {{ ternary 0 1 .Values.global.memcached.cluster.enabled}}
+      "binary_protocol": {{ ternary 0 1 .Values.global.memcached.cluster.enabled}},
+      "failure_limit": 2,
+      "retry_timeout_s": 5
     },
     "media-frontend": {
       "addr": "media-frontend",
@@ -177,7 +212,8 @@
       "port": 9090,
       "connections": 512,
       "timeout_ms": 10000,
-      "keepalive_ms": 10000
+      "keepalive_ms": 10000,
+      "use_content_hash": 0
     },
     "url-shorten-memcached": {
       "addr": {{ ternary (include "memcached-cluster.connection" . | trim) "url-shorten-memcached" .Values.global.memcached.cluster.enabled | quote}},
@@ -185,7 +221,9 @@
       "connections": 512,
       "timeout_ms": 10000,
       "keepalive_ms": 10000,
-      "binary_protocol": {{ ternary 0 1 .Values.global.memcached.cluster.enabled}}
+      "binary_protocol": {{ ternary 0 1 .Values.global.memcached.cluster.enabled}},
+      "failure_limit": 2,
+      "retry_timeout_s": 5
     },
     "url-shorten-mongodb": {
       "addr": {{ ternary (include "mongodb-sharded.connection" . | trim) "url-shorten-mongodb" .Values.global.mongodb.sharding.enabled | quote}},
@@ -200,7 +238,8 @@
       "connections": 512,
       "timeout_ms": 10000,
       "keepalive_ms": 10000,
-      "netif": "eth0"
+      "netif": "eth0",
+      "password_hash_backend": "openssl"
     },
     "user-memcached": {
       "addr": {{ ternary (include "memcached-cluster.connection" . | trim) "user-memcached" .Values.global.memcached.cluster.enabled | quote}},
@@ -208,7 +247,9 @@
       "connections": 512,
       "timeout_ms": 10000,
       "keepalive_ms": 10000,
-      "binary_protocol": {{ ternary 0 1 .Values.global.memcached.cluster.enabled}}
+      "binary_protocol": {{ ternary 0 1 .Values.global.memcached.cluster.enabled}},
+      "failure_limit": 2,
+      "retry_timeout_s": 5
     },
     "user-mongodb": {
       "addr": {{ ternary (include "mongodb-sharded.connection" . | trim) "user-mongodb" .Values.global.mongodb.sharding.enabled | quote}},
@@ -229,7 +270,11 @@
       "caPath": "/keys/CA.pem",
       "ciphers": "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH",
       "serverKeyPath": "/keys/server.key",
-      "serverCertPath": "/keys/server.crt"
+      "serverCertPath": "/keys/server.crt",
+      "sessionResumption": true,
+      "sessionTimeoutS": 300,
+      "sessionTicketKeyPath": "",
+      "statsIntervalMs": 60000
     },
     "redis-primary": {
       "keepalive_ms": 10000,
@@ -64,4 +64,57 @@ function _M.Follow()
 
 end
 
+-- Bulk follow used by the dataset loader: user_ids and followee_ids are JSON
+-- arrays and user_ids[i] follows followee_ids[i].
+function _M.FollowMany()
+  local bridge_tracer = require "opentracing_bridge_tracer"
+  local ngx = ngx
+  local cjson = require "cjson"
+  local GenericObjectPool = require "GenericObjectPool"
+  local social_network_SocialGraphService = require "social_network_SocialGraphService"
+  local SocialGraphServiceClient = social_network_SocialGraphService.SocialGraphServiceClient
+
+  local req_id = tonumber(string.sub(ngx.var.request_id, 0, 15), 16)
+  local tracer = bridge_tracer.new_from_global()
+  local parent_span_context = tracer:binary_extract(
+      ngx.var.opentracing_binary_context)
+  local span = tracer:start_span("follow_many_client",
+      {["references"] = {{"child_of", parent_span_context}}})
+  local carrier = {}
+  tracer:text_map_inject(span:context(), carrier)
+
+  ngx.req.read_body()
+  local post = ngx.req.get_post_args()
+
+  if (_StrIsEmpty(post.user_ids) or _StrIsEmpty(post.followee_ids)) then
+    ngx.status = ngx.HTTP_BAD_REQUEST
+    ngx.say("Incomplete arguments")
+    ngx.log(ngx.ERR, "Incomplete arguments")
+    ngx.exit(ngx.HTTP_BAD_REQUEST)
+  end
+
+  local client = GenericObjectPool:connection(
+      SocialGraphServiceClient, "social-graph-service" .. k8s_suffix, 9090)
+
+  local status, err = pcall(client.FollowMany, client, req_id,
+      cjson.decode(post.user_ids), cjson.decode(post.followee_ids), carrier)
+
+  if not status then
+    ngx.status = ngx.HTTP_INTERNAL_SERVER_ERROR
+    if (err.message) then
+      ngx.say("Follow Failed: " .. err.message)
+      ngx.log(ngx.ERR, "Follow Failed: " .. err.message)
+    else
+      ngx.say("Follow Failed: " .. err)
+      ngx.log(ngx.ERR, "Follow Failed: " .. err)
+    end
+    client.iprot.trans:close()
+    ngx.exit(ngx.HTTP_INTERNAL_SERVER_ERROR)
+  else
+    ngx.say("Success!")
+    GenericObjectPool:returnConnection(client)
+  end
+  span:finish()
+end
+
 return _M
\ No newline at end of file
@@ -59,4 +59,60 @@ function _M.RegisterUser()
   span:finish()
 end
 
+-- Bulk registration used by the dataset loader. Every field is a JSON array
+-- and the i-th element of each array describes one user.
+function _M.RegisterUsers()
+  local bridge_tracer = require "opentracing_bridge_tracer"
+  local ngx = ngx
+  local cjson = require "cjson"
+  local GenericObjectPool = require "GenericObjectPool"
+  local social_network_UserService = require "social_network_UserService"
+  local UserServiceClient = social_network_UserService.UserServiceClient
+
+  local req_id = tonumber(string.sub(ngx.var.request_id, 0, 15), 16)
+  local tracer = bridge_tracer.new_from_global()
+  local parent_span_context = tracer:binary_extract(
+      ngx.var.opentracing_binary_context)
+  local span = tracer:start_span("register_many_client",
+      {["references"] = {{"child_of", parent_span_context}}})
+  local carrier = {}
+  tracer:text_map_inject(span:context(), carrier)
+
+  ngx.req.read_body()
+  local post = ngx.req.get_post_args()
+
+  if (_StrIsEmpty(post.first_names) or _StrIsEmpty(post.last_names) or
+      _StrIsEmpty(post.usernames) or _StrIsEmpty(post.passwords) or
+      _StrIsEmpty(post.user_ids)) then
+    ngx.status = ngx.HTTP_BAD_REQUEST
+    ngx.say("Incomplete arguments")
+    ngx.log(ngx.ERR, "Incomplete arguments")
+    ngx.exit(ngx.HTTP_BAD_REQUEST)
+  end
+
+  local client = GenericObjectPool:connection(UserServiceClient, "user-service" .. k8s_suffix, 9090)
+
+  local status, err = pcall(client.RegisterUsersWithId, client, req_id,
+      cjson.decode(post.first_names), cjson.decode(post.last_names),
+      cjson.decode(post.usernames), cjson.decode(post.passwords),
+      cjson.decode(post.user_ids), carrier)
+
+  if not status then
+    ngx.status = ngx.HTTP_INTERNAL_SERVER_ERROR
+    if (err.message) then
+      ngx.say("User registration failure: " .. err.message)
+      ngx.log(ngx.ERR, "User registration failure: " .. err.message)
+    else
+      ngx.say("User registration failure: " .. err)
+      ngx.log(ngx.ERR, "User registration failure: " .. err)
+    end
+    client.iprot.trans:close()
+    ngx.exit(ngx.HTTP_INTERNAL_SERVER_ERROR)
+  end
+
+  ngx.say("Success!")
+  GenericObjectPool:returnConnection(client)
+  span:finish()
+end
+
 return _M
\ No newline at end of file
@@ -4,6 +4,7 @@ import os
 import string
 import random
 import argparse
+import json
 
 
 async def upload_follow(session, addr, user_0, user_1):
@@ -20,6 +21,23 @@ async def upload_register(session, addr, user):
     return await resp.text()
 
 
+async def upload_register_many(session, addr, users):
+  payload = {'first_names': json.dumps(['first_name_' + u for u in users]),
+             'last_names': json.dumps(['last_name_' + u for u in users]),
+             'usernames': json.dumps(['username_' + u for u in users]),
+             'passwords': json.dumps(['password_' + u for u in users]),
+             'user_ids': json.dumps([int(u) for u in users])}
+  async with session.post(addr + '/wrk2-api/user/register-many', data=payload) as resp:
+    return await resp.text()
+
+
+async def upload_follow_many(session, addr, edges):
+  payload = {'user_ids': json.dumps([int(e[0]) for e in edges]),
+             'followee_ids': json.dumps([int(e[1]) for e in edges])}
+  async with session.post(addr + '/wrk2-api/user/follow-many', data=payload) as resp:
+    return await resp.text()
+
+
 async def upload_compose(session, addr, user_id, num_users):
   text = ''.join(random.choices(string.ascii_letters + string.digits, k=256))
   # user mentions
@@ -109,6 +127,33 @@ async def follow(addr, edges, limit=200):
     printResults(results)
 
 
+async def register_many(addr, nodes, batch_size, limit=200):
+  conn = aiohttp.TCPConnector(limit=limit)
+  async with aiohttp.ClientSession(connector=conn) as session:
+    print('Registering Users in batches of', batch_size, '...')
+    tasks = [asyncio.ensure_future(upload_register_many(
+        session, addr, [str(i) for i in range(start, min(start + batch_size, nodes))]))
+        for start in range(0, nodes, batch_size)]
+    results = await asyncio.gather(*tasks)
+    printResults(results)
+
+
+async def follow_many(addr, edges, batch_size, limit=200):
+  conn = aiohttp.TCPConnector(limit=limit)
+  async with aiohttp.ClientSession(connector=conn) as session:
+    print('Adding follows in batches of', batch_size, '...')
+    # Every dataset edge is followed in both directions, as in follow().
+    directed = []
+    for edge in edges:
+      directed.append((edge[0], edge[1]))
+      directed.append((edge[1], edge[0]))
+    tasks = [asyncio.ensure_future(upload_follow_many(
+        session, addr, directed[start:start + batch_size]))
+        for start in range(0, len(directed), batch_size)]
+    results = await asyncio.gather(*tasks)
+    printResults(results)
+
+
 async def compose(addr, nodes, limit=200):
   idx = 0
   tasks = []
@@ -139,6 +184,8 @@ if __name__ == '__main__':
   parser.add_argument('--compose', action='store_true',
                       help='intialize with up to 20 posts per user', default=False)
   parser.add_argument('--limit', type=int, help='total number simultaneous connections', default=200)
+  parser.add_argument('--batch-size', type=int,
+                      help='users/edges per bulk register-many/follow-many request; 0 sends one request each', default=1000)
   args = parser.parse_args()
 
   with open(os.path.join('datasets/social-graph', args.graph, f'{args.graph}.nodes'), 'r') as f:
@@ -151,10 +198,18 @@ if __name__ == '__main__':
   addr = 'http://{}:{}'.format(args.ip, args.port)
   limit = args.limit
   loop = asyncio.new_event_loop()
-  future = asyncio.ensure_future(register(addr, nodes, limit), loop=loop)
-  loop.run_until_complete(future)
-  future = asyncio.ensure_future(follow(addr, edges, limit), loop=loop)
-  loop.run_until_complete(future)
+  if args.batch_size > 0:
+    future = asyncio.ensure_future(
+        register_many(addr, nodes, args.batch_size, limit), loop=loop)
+    loop.run_until_complete(future)
+    future = asyncio.ensure_future(
+        follow_many(addr, edges, args.batch_size, limit), loop=loop)
+    loop.run_until_complete(future)
+  else:
+    future = asyncio.ensure_future(register(addr, nodes, limit), loop=loop)
+    loop.run_until_complete(future)
+    future = asyncio.ensure_future(follow(addr, edges, limit), loop=loop)
+    loop.run_until_complete(future)
   if args.compose:
     future = asyncio.ensure_future(compose(addr, nodes, limit), loop=loop)
     loop.run_until_complete(future)
@@ -78,6 +78,13 @@ service UniqueIdService {
       2: PostType post_type,
       3: map<string, string> carrier
   ) throws (1: ServiceException se)
+
+  list<i64> ComposeUniqueIds (
+      1: i64 req_id,
+      2: PostType post_type,
+      3: i32 num_ids,
+      4: map<string, string> carrier
+  ) throws (1: ServiceException se)
 }
 
 service TextService {
@@ -108,6 +115,18 @@ service UserService {
       7: map<string, string> carrier
   ) throws (1: ServiceException se)
 
+  // Bulk variant of RegisterUserWithId; the i-th element of each list
+  // describes one user. Existing user_ids are left untouched.
+  void RegisterUsersWithId (
+      1: i64 req_id,
+      2: list<string> first_names,
+      3: list<string> last_names,
+      4: list<string> usernames,
+      5: list<string> passwords,
+      6: list<i64> user_ids,
+      7: map<string, string> carrier
+  ) throws (1: ServiceException se)
+
   string Login(
       1: i64 req_id,
       2: string username,
@@ -251,6 +270,21 @@ service SocialGraphService{
       2: i64 user_id,
       3: map<string, string> carrier
   ) throws (1: ServiceException se)
+
+  // Bulk variants for loading datasets: user_ids[i] follows followee_ids[i].
+  // Both are idempotent, so an interrupted load can be re-run.
+  void FollowMany(
+      1: i64 req_id,
+      2: list<i64> user_ids,
+      3: list<i64> followee_ids,
+      4: map<string, string> carrier
+  ) throws (1: ServiceException se)
+
+  void InsertUsers(
+      1: i64 req_id,
+      2: list<i64> user_ids,
+      3: map<string, string> carrier
+  ) throws (1: ServiceException se)
 }
 
 service UserMentionService {
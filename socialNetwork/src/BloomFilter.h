@@ -0,0 +1,216 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_BLOOMFILTER_H
+#define SOCIAL_NETWORK_MICROSERVICES_BLOOMFILTER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace social_network {
+
+// Scalable Bloom filter (Almeida et al., 2007) over strings. It starts with
+// one filter sized for initial_capacity keys; each time the last filter is
+// full a new one with twice the capacity and half the false-positive rate is
+// added, so that the overall false-positive rate stays below error_rate
+// however many keys are added. Once max_memory_bytes would be exceeded no
+// filter is added any more and the false-positive rate grows instead.
+//
+// MayContain() never returns false for a key that was added. Add() and
+// MayContain() are thread-safe; bits are set with atomic ORs so that lookups
+// only share a reader lock with each other.
+class ScalableBloomFilter {
+ public:
+  ScalableBloomFilter(double error_rate, size_t initial_capacity,
+                      size_t max_memory_bytes)
+      : _error_rate(error_rate),
+        _initial_capacity(initial_capacity ? initial_capacity : 1),
+        _max_memory_bytes(max_memory_bytes),
+        _memory_bytes(0),
+        _size(0),
+        _full(false) {
+    // The error rates of the filters form a geometric series with ratio
+    // kTightening, whose sum is error_rate.
+    AddFilter();
+  }
+
+  void Add(const std::string &key) {
+    uint64_t h1, h2;
+    Hash(key, &h1, &h2);
+    {
+      std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+      if (ContainsLocked(h1, h2)) {
+        return;
+      }
+      Filter &last = *_filters.back();
+      if (_full || last.count.load(std::memory_order_relaxed) <
+                       last.capacity) {
+        last.Set(h1, h2);
+        last.count.fetch_add(1, std::memory_order_relaxed);
+        _size.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(_mtx);
+    if (ContainsLocked(h1, h2)) {
+      return;
+    }
+    if (!_full &&
+        _filters.back()->count.load(std::memory_order_relaxed) >=
+            _filters.back()->capacity) {
+      AddFilter();
+    }
+    Filter &last = *_filters.back();
+    last.Set(h1, h2);
+    last.count.fetch_add(1, std::memory_order_relaxed);
+    _size.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  bool MayContain(const std::string &key) const {
+    uint64_t h1, h2;
+    Hash(key, &h1, &h2);
+    std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+    return ContainsLocked(h1, h2);
+  }
+
+  // Number of distinct keys added, give or take false positives.
+  size_t Size() const { return _size.load(std::memory_order_relaxed); }
+
+  size_t MemoryBytes() const {
+    std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+    return _memory_bytes;
+  }
+
+  size_t NumFilters() const {
+    std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+    return _filters.size();
+  }
+
+  // False-positive rate the filter was sized for; 0 if it hit
+  // max_memory_bytes and the rate is no longer bounded.
+  double ExpectedErrorRate() const {
+    std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+    if (_full && _filters.back()->count.load(std::memory_order_relaxed) >
+                     _filters.back()->capacity) {
+      return 0;
+    }
+    return _error_rate;
+  }
+
+ private:
+  static constexpr double kTightening = 0.5;
+  static constexpr size_t kGrowth = 2;
+
+  struct Filter {
+    Filter(size_t capacity, double error_rate)
+        : capacity(capacity),
+          count(0),
+          num_words(NumWords(capacity, error_rate)),
+          num_bits(num_words * 64) {
+      num_hashes = std::max(1, static_cast<int>(std::round(
+                                   num_bits * std::log(2.0) / capacity)));
+      words.reset(new std::atomic<uint64_t>[num_words]);
+      for (size_t i = 0; i < num_words; ++i) {
+        words[i].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    // Optimal size m = -n ln(p) / ln(2)^2 bits, in 64-bit words.
+    static size_t NumWords(size_t capacity, double error_rate) {
+      double ln2 = std::log(2.0);
+      double bits = -static_cast<double>(capacity) * std::log(error_rate) /
+                    (ln2 * ln2);
+      return static_cast<size_t>(bits / 64) + 1;
+    }
+
+    // Kirsch-Mitzenmacher double hashing: the i-th bit is h1 + i * h2.
+    void Set(uint64_t h1, uint64_t h2) {
+      for (int i = 0; i < num_hashes; ++i) {
+        uint64_t bit = (h1 + i * h2) % num_bits;
+        words[bit / 64].fetch_or(uint64_t(1) << (bit % 64),
+                                 std::memory_order_relaxed);
+      }
+    }
+
+    bool Test(uint64_t h1, uint64_t h2) const {
+      for (int i = 0; i < num_hashes; ++i) {
+        uint64_t bit = (h1 + i * h2) % num_bits;
+        if (!(words[bit / 64].load(std::memory_order_relaxed) &
+              (uint64_t(1) << (bit % 64)))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    size_t capacity;
+    std::atomic<size_t> count;
+    size_t num_words;
+    uint64_t num_bits;
+    int num_hashes;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+  };
+
+  static uint64_t Mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+  }
+
+  static void Hash(const std::string &key, uint64_t *h1, uint64_t *h2) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key) {
+      hash = (hash ^ c) * 0x100000001b3ULL;
+    }
+    *h1 = Mix(hash);
+    *h2 = Mix(hash ^ 0x9e3779b97f4a7c15ULL) | 1;
+  }
+
+  bool ContainsLocked(uint64_t h1, uint64_t h2) const {
+    // Most keys live in the last, largest filters.
+    for (auto it = _filters.rbegin(); it != _filters.rend(); ++it) {
+      if ((*it)->Test(h1, h2)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Called from the constructor or with _mtx held exclusively.
+  void AddFilter() {
+    size_t n = _filters.size();
+    size_t capacity = _initial_capacity;
+    double error_rate = _error_rate * (1 - kTightening);
+    for (size_t i = 0; i < n; ++i) {
+      capacity *= kGrowth;
+      error_rate *= kTightening;
+    }
+    size_t bytes = Filter::NumWords(capacity, error_rate) * sizeof(uint64_t);
+    if (n > 0 && _memory_bytes + bytes > _max_memory_bytes) {
+      _full = true;
+      return;
+    }
+    _memory_bytes += bytes;
+    _filters.emplace_back(new Filter(capacity, error_rate));
+  }
+
+  double _error_rate;
+  size_t _initial_capacity;
+  size_t _max_memory_bytes;
+  size_t _memory_bytes;
+  std::atomic<size_t> _size;
+  bool _full;
+  std::vector<std::unique_ptr<Filter>> _filters;
+  mutable std::shared_timed_mutex _mtx;
+};
+
+}  // namespace social_network
+
+#endif  // SOCIAL_NETWORK_MICROSERVICES_BLOOMFILTER_H
@@ -1,25 +1,71 @@
 #ifndef SOCIAL_NETWORK_MICROSERVICES_CLIENTPOOL_H
 #define SOCIAL_NETWORK_MICROSERVICES_CLIENTPOOL_H
 
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <algorithm>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
+#include <cstring>
 #include <deque>
+#include <functional>
 #include <chrono>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 #include "logger.h"
 
+// Addresses starting with this prefix are re-resolved periodically and every
+// address the name resolves to becomes an endpoint, e.g. the pod IPs of a
+// headless Kubernetes service.
+#define CLIENT_POOL_DNS_PREFIX "dns:///"
+// Weight of the latest call in the per-endpoint EWMA latency
+#define CLIENT_POOL_EWMA_ALPHA 0.2
+
 namespace social_network {
 using json = nlohmann::json;
 
+// Load of one endpoint of a ClientPool, as reported by GetEndpointStats().
+struct ClientPoolEndpointStats {
+  std::string addr;
+  int port;
+  int in_flight;
+  int idle;
+  double ewma_latency_ms;
+  uint64_t calls;
+  uint64_t failures;
+  uint64_t ejections;
+  bool ejected;
+};
+
+// Pool of clients of one downstream service, which may run on several
+// endpoints. addr is either one host, a comma-separated list of
+// "host[:port]" endpoints, or CLIENT_POOL_DNS_PREFIX followed by a host name
+// that is re-resolved every "load-balancing" -> "dns_refresh_ms".
+//
+// Pop() hands out a client of the less loaded of two endpoints picked at
+// random (power of two choices). The load of an endpoint is its number of
+// calls in flight weighted by its EWMA call latency, i.e. the time between
+// Pop() and Keepalive(). An endpoint whose calls fail "eject_failures" times
+// in a row, i.e. whose clients are returned with Remove(), is skipped for
+// "eject_ms", unless every endpoint is ejected.
 template<class TClient>
 class ClientPool {
  public:
   ClientPool(const std::string &client_type, const std::string &addr,
       int port, int min_size, int max_size, int timeout_ms, int keepalive_ms,
       const json &config_json);
+  // Pool of clients built by factory, e.g. in-process clients.
+  ClientPool(const std::string &client_type,
+      std::function<TClient *()> factory, int max_size, int timeout_ms);
   ~ClientPool();
 
   ClientPool(const ClientPool&) = delete;
@@ -32,20 +78,67 @@ class ClientPool {
   void Keepalive(TClient *);
   void Remove(TClient *);
 
+  std::vector<ClientPoolEndpointStats> GetEndpointStats();
+
  private:
-  std::deque<TClient *> _pool;
+  struct Endpoint {
+    Endpoint(const std::string &addr, int port) : addr(addr), port(port) {}
+
+    std::string addr;
+    int port;
+    std::deque<TClient *> idle;
+    int in_flight = 0;
+    double ewma_latency_us = 0;
+    int consecutive_failures = 0;
+    long ejected_until_ms = 0;
+    uint64_t calls = 0;
+    uint64_t failures = 0;
+    uint64_t ejections = 0;
+    // Dropped by a DNS refresh; its clients are deleted when returned.
+    bool removed = false;
+  };
+
+  struct Call {
+    std::shared_ptr<Endpoint> endpoint;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  static long NowMs();
+  void ParseEndpoints(const std::string &addr, int port);
+  std::vector<std::pair<std::string, int>> Resolve();
+  void MaybeRefreshEndpoints(long now_ms);
+  std::shared_ptr<Endpoint> ChooseLocked(long now_ms);
+  TClient *TakeIdleLocked(long now_ms, std::vector<TClient *> *evicted);
+  void Release(TClient *client, bool success, bool keep);
+  void MaybeLogStatsLocked(long now_ms);
+  std::vector<ClientPoolEndpointStats> GetEndpointStatsLocked(long now_ms);
+
+  std::vector<std::shared_ptr<Endpoint>> _endpoints;
+  std::unordered_map<TClient *, Call> _calls;
   std::string _addr;
   std::string _client_type;
   int _port;
   int _min_pool_size{};
   int _max_pool_size{};
   int _curr_pool_size{};
+  int _num_idle{};
   int _timeout_ms;
   int _keepalive_ms;
   std::mutex _mtx;
   std::condition_variable _cv;
   const json *_config_json;
+  std::function<TClient *(const std::string &, int)> _factory;
 
+  // Host names to re-resolve, with their ports; empty unless addr has
+  // CLIENT_POOL_DNS_PREFIX.
+  std::vector<std::pair<std::string, int>> _dns_names;
+  int _dns_refresh_ms = 5000;
+  long _next_dns_refresh_ms = 0;
+  bool _dns_refreshing = false;
+  int _eject_failures = 5;
+  int _eject_ms = 10000;
+  int _metrics_interval_ms = 60000;
+  long _next_metrics_ms = 0;
 };
 
 template<class TClient>
@@ -61,51 +154,306 @@ ClientPool<TClient>::ClientPool(const std::string &client_type,
   _client_type = client_type;
   _keepalive_ms = keepalive_ms;
   _config_json = &config_json;
+  _factory = [keepalive_ms, &config_json](const std::string &addr, int port) {
+    return new TClient(addr, port, keepalive_ms, config_json);
+  };
+
+  auto lb = config_json.find("load-balancing");
+  if (lb != config_json.end()) {
+    _dns_refresh_ms = lb->value("dns_refresh_ms", _dns_refresh_ms);
+    _eject_failures = lb->value("eject_failures", _eject_failures);
+    _eject_ms = lb->value("eject_ms", _eject_ms);
+    _metrics_interval_ms =
+        lb->value("metrics_interval_ms", _metrics_interval_ms);
+  }
+  ParseEndpoints(addr, port);
+  _next_metrics_ms = NowMs() + _metrics_interval_ms;
 
   for (int i = 0; i < min_pool_size; ++i) {
-    TClient *client = new TClient(addr, port, keepalive_ms, config_json);
-    _pool.emplace_back(client);
+    auto &endpoint = _endpoints[i % _endpoints.size()];
+    endpoint->idle.emplace_back(_factory(endpoint->addr, endpoint->port));
   }
   _curr_pool_size = min_pool_size;
+  _num_idle = min_pool_size;
+}
+
+template<class TClient>
+ClientPool<TClient>::ClientPool(const std::string &client_type,
+    std::function<TClient *()> factory, int max_pool_size, int timeout_ms) {
+  _addr = "in-process";
+  _port = 0;
+  _min_pool_size = 0;
+  _max_pool_size = max_pool_size;
+  _curr_pool_size = 0;
+  _timeout_ms = timeout_ms;
+  _keepalive_ms = 0;
+  _client_type = client_type;
+  _config_json = nullptr;
+  _factory = [factory](const std::string &, int) { return factory(); };
+  _endpoints.emplace_back(std::make_shared<Endpoint>(_addr, _port));
+  // Nothing to balance or eject
+  _eject_failures = 0;
+  _metrics_interval_ms = 0;
 }
 
 template<class TClient>
 ClientPool<TClient>::~ClientPool() {
-  while (!_pool.empty()) {
-    delete _pool.front();
-    _pool.pop_front();
+  for (auto &endpoint : _endpoints) {
+    while (!endpoint->idle.empty()) {
+      delete endpoint->idle.front();
+      endpoint->idle.pop_front();
+    }
+  }
+}
+
+template<class TClient>
+long ClientPool<TClient>::NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<class TClient>
+void ClientPool<TClient>::ParseEndpoints(const std::string &addr, int port) {
+  std::string host;
+  std::istringstream hosts(addr);
+  while (std::getline(hosts, host, ',')) {
+    host.erase(0, host.find_first_not_of(" \t"));
+    host.erase(host.find_last_not_of(" \t") + 1);
+    if (host.empty()) {
+      continue;
+    }
+    bool dns = host.compare(0, strlen(CLIENT_POOL_DNS_PREFIX),
+                            CLIENT_POOL_DNS_PREFIX) == 0;
+    if (dns) {
+      host.erase(0, strlen(CLIENT_POOL_DNS_PREFIX));
+    }
+    int host_port = port;
+    auto colon = host.rfind(':');
+    if (colon != std::string::npos) {
+      host_port = std::stoi(host.substr(colon + 1));
+      host.erase(colon);
+    }
+    if (dns) {
+      _dns_names.emplace_back(host, host_port);
+    } else {
+      _endpoints.emplace_back(std::make_shared<Endpoint>(host, host_port));
+    }
+  }
+
+  if (!_dns_names.empty()) {
+    bool ssl_enabled = _config_json && (*_config_json)["ssl"]["enabled"];
+    if (ssl_enabled) {
+      // Server certificates name the service, not the addresses of its pods.
+      LOG(warning) << _client_type << ": TLS is enabled, " << addr
+                   << " is not re-resolved";
+      for (auto &name : _dns_names) {
+        _endpoints.emplace_back(
+            std::make_shared<Endpoint>(name.first, name.second));
+      }
+      _dns_names.clear();
+    } else {
+      auto addrs = Resolve();
+      if (addrs.empty()) {
+        // Let the clients resolve the names until a refresh succeeds.
+        addrs = _dns_names;
+      }
+      for (auto &a : addrs) {
+        _endpoints.emplace_back(std::make_shared<Endpoint>(a.first, a.second));
+      }
+      _next_dns_refresh_ms = NowMs() + _dns_refresh_ms;
+    }
+  }
+  if (_endpoints.empty()) {
+    _endpoints.emplace_back(std::make_shared<Endpoint>(addr, port));
+  }
+}
+
+// Addresses of all _dns_names, or nothing if any of them fails to resolve.
+template<class TClient>
+std::vector<std::pair<std::string, int>> ClientPool<TClient>::Resolve() {
+  std::set<std::pair<std::string, int>> addrs;
+  for (auto &name : _dns_names) {
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *result = nullptr;
+    int rc = getaddrinfo(name.first.c_str(), nullptr, &hints, &result);
+    if (rc != 0) {
+      LOG(warning) << _client_type << ": failed to resolve " << name.first
+                   << ": " << gai_strerror(rc);
+      return {};
+    }
+    for (auto *ai = result; ai; ai = ai->ai_next) {
+      char buf[INET6_ADDRSTRLEN];
+      const void *src = ai->ai_family == AF_INET6
+          ? static_cast<const void *>(
+                &reinterpret_cast<sockaddr_in6 *>(ai->ai_addr)->sin6_addr)
+          : static_cast<const void *>(
+                &reinterpret_cast<sockaddr_in *>(ai->ai_addr)->sin_addr);
+      if (inet_ntop(ai->ai_family, src, buf, sizeof(buf))) {
+        addrs.emplace(buf, name.second);
+      }
+    }
+    freeaddrinfo(result);
   }
+  return {addrs.begin(), addrs.end()};
+}
+
+// Resolves _dns_names again once they are dns_refresh_ms old. Endpoints that
+// went away are dropped along with their idle clients; new ones are added.
+template<class TClient>
+void ClientPool<TClient>::MaybeRefreshEndpoints(long now_ms) {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_dns_names.empty() || _dns_refreshing ||
+        now_ms < _next_dns_refresh_ms) {
+      return;
+    }
+    _dns_refreshing = true;
+  }
+  // getaddrinfo() may block, so other callers keep using the old endpoints.
+  auto addrs = Resolve();
+  std::vector<TClient *> dropped;
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _dns_refreshing = false;
+    _next_dns_refresh_ms = now_ms + _dns_refresh_ms;
+    if (addrs.empty()) {
+      return;
+    }
+    std::set<std::pair<std::string, int>> wanted(addrs.begin(), addrs.end());
+    std::vector<std::shared_ptr<Endpoint>> endpoints;
+    for (auto &endpoint : _endpoints) {
+      if (wanted.erase({endpoint->addr, endpoint->port})) {
+        endpoints.emplace_back(endpoint);
+        continue;
+      }
+      LOG(info) << _client_type << ": removed endpoint " << endpoint->addr
+                << ":" << endpoint->port;
+      endpoint->removed = true;
+      for (auto client : endpoint->idle) {
+        dropped.emplace_back(client);
+      }
+      _num_idle -= endpoint->idle.size();
+      _curr_pool_size -= endpoint->idle.size();
+      endpoint->idle.clear();
+    }
+    for (auto &a : wanted) {
+      LOG(info) << _client_type << ": added endpoint " << a.first << ":"
+                << a.second;
+      endpoints.emplace_back(std::make_shared<Endpoint>(a.first, a.second));
+    }
+    _endpoints.swap(endpoints);
+  }
+  for (auto client : dropped) {
+    delete client;
+  }
+  if (!dropped.empty()) {
+    _cv.notify_all();
+  }
+}
+
+// Power of two choices over the endpoints that are not ejected, or over all
+// of them if every endpoint is.
+template<class TClient>
+std::shared_ptr<typename ClientPool<TClient>::Endpoint>
+ClientPool<TClient>::ChooseLocked(long now_ms) {
+  size_t n = _endpoints.size();
+  if (n == 1) {
+    return _endpoints[0];
+  }
+  thread_local std::mt19937 gen(std::random_device{}());
+  std::vector<size_t> healthy;
+  healthy.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    if (_endpoints[i]->ejected_until_ms <= now_ms) {
+      healthy.push_back(i);
+    }
+  }
+  if (healthy.empty()) {
+    for (size_t i = 0; i < n; ++i) {
+      healthy.push_back(i);
+    }
+  }
+  if (healthy.size() == 1) {
+    return _endpoints[healthy[0]];
+  }
+  std::uniform_int_distribution<size_t> dist(0, healthy.size() - 1);
+  size_t a = dist(gen);
+  size_t b = dist(gen);
+  while (b == a) {
+    b = dist(gen);
+  }
+  auto cost = [](const Endpoint &e) {
+    // Endpoints without latency samples yet compete on in-flight calls.
+    return (e.in_flight + 1) * (e.ewma_latency_us + 1);
+  };
+  auto &first = _endpoints[healthy[a]];
+  auto &second = _endpoints[healthy[b]];
+  return cost(*second) < cost(*first) ? second : first;
+}
+
+template<class TClient>
+TClient *ClientPool<TClient>::TakeIdleLocked(
+    long now_ms, std::vector<TClient *> *evicted) {
+  auto endpoint = ChooseLocked(now_ms);
+  TClient *client = nullptr;
+  if (!endpoint->idle.empty()) {
+    client = endpoint->idle.front();
+    endpoint->idle.pop_front();
+    _num_idle--;
+  } else if (_curr_pool_size < _max_pool_size) {
+    client = _factory(endpoint->addr, endpoint->port);
+    _curr_pool_size++;
+  } else if (_num_idle > 0) {
+    // The pool is full of idle clients of other endpoints: close the oldest
+    // idle client of the first endpoint that has one, to connect to the
+    // chosen endpoint.
+    for (auto &other : _endpoints) {
+      if (!other->idle.empty()) {
+        evicted->emplace_back(other->idle.front());
+        other->idle.pop_front();
+        break;
+      }
+    }
+    _num_idle--;
+    client = _factory(endpoint->addr, endpoint->port);
+  } else {
+    return nullptr;
+  }
+  endpoint->in_flight++;
+  _calls[client] = Call{endpoint, std::chrono::steady_clock::now()};
+  return client;
 }
 
 template<class TClient>
 TClient * ClientPool<TClient>::Pop() {
   TClient * client = nullptr;
+  std::vector<TClient *> evicted;
+  MaybeRefreshEndpoints(NowMs());
   {
     std::unique_lock<std::mutex> cv_lock(_mtx);
-    while (_pool.size() == 0 && _curr_pool_size == _max_pool_size) {
+    while (_num_idle == 0 && _curr_pool_size == _max_pool_size) {
       // Create a new a client if current pool size is less than
       // the max pool size.
       auto wait_time = std::chrono::system_clock::now() +
           std::chrono::milliseconds(_timeout_ms);
       bool wait_success = _cv.wait_until(cv_lock, wait_time,
-            [this] { return _pool.size() > 0 || _curr_pool_size < _max_pool_size; });
+            [this] { return _num_idle > 0 || _curr_pool_size < _max_pool_size; });
       if (!wait_success) {
         LOG(warning) << "ClientPool pop timeout";
-        LOG(info) << _pool.size() << " " << _curr_pool_size;
+        LOG(info) << _num_idle << " " << _curr_pool_size;
         cv_lock.unlock();
         return nullptr;
       }
     }
-    if (_pool.size() > 0) {
-      client = _pool.front();
-      _pool.pop_front();
-    } else {
-      client = new TClient(_addr, _port, _keepalive_ms, *_config_json);
-      _curr_pool_size++;
-    }
+    client = TakeIdleLocked(NowMs(), &evicted);
   cv_lock.unlock();
   } // cv_lock(_mtx)
 
+  for (auto idle : evicted) {
+    delete idle;
+  }
 
   if (client) {
     try {
@@ -119,36 +467,123 @@ TClient * ClientPool<TClient>::Pop() {
   return client;
 }
 
+// Ends the call of client; keep returns it to its endpoint, otherwise it is
+// deleted. A failed call counts toward the ejection of the endpoint.
 template<class TClient>
-void ClientPool<TClient>::Push(TClient *client) {
+void ClientPool<TClient>::Release(TClient *client, bool success, bool keep) {
+  long now_ms = NowMs();
   std::unique_lock<std::mutex> cv_lock(_mtx);
-  _pool.push_back(client);
+  std::shared_ptr<Endpoint> endpoint;
+  auto call = _calls.find(client);
+  if (call != _calls.end()) {
+    endpoint = call->second.endpoint;
+    double latency_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - call->second.start).count();
+    _calls.erase(call);
+    endpoint->in_flight--;
+    endpoint->calls++;
+    if (success) {
+      endpoint->consecutive_failures = 0;
+      endpoint->ewma_latency_us = endpoint->ewma_latency_us == 0
+          ? latency_us
+          : endpoint->ewma_latency_us +
+                CLIENT_POOL_EWMA_ALPHA *
+                    (latency_us - endpoint->ewma_latency_us);
+    } else {
+      endpoint->failures++;
+      if (_eject_failures > 0 &&
+          ++endpoint->consecutive_failures >= _eject_failures &&
+          _endpoints.size() > 1 && !endpoint->removed) {
+        endpoint->consecutive_failures = 0;
+        endpoint->ejected_until_ms = now_ms + _eject_ms;
+        endpoint->ejections++;
+        LOG(warning) << _client_type << ": ejected endpoint "
+                     << endpoint->addr << ":" << endpoint->port << " for "
+                     << _eject_ms << " ms after " << _eject_failures
+                     << " failures in a row";
+      }
+    }
+  }
+  if (keep && endpoint && !endpoint->removed) {
+    endpoint->idle.push_back(client);
+    _num_idle++;
+    client = nullptr;
+  } else if (keep && !endpoint) {
+    // Not popped from this pool
+    _endpoints[0]->idle.push_back(client);
+    _num_idle++;
+    client = nullptr;
+  } else {
+    _curr_pool_size--;
+  }
+  MaybeLogStatsLocked(now_ms);
   cv_lock.unlock();
+  // No need to delete it from the idle clients because it has been popped
+  delete client;
   _cv.notify_one();
 }
 
+template<class TClient>
+void ClientPool<TClient>::Push(TClient *client) {
+  Release(client, true, true);
+}
+
 template<class TClient>
 void ClientPool<TClient>::Remove(TClient *client) {
-  // No need to delete it from _pool because the *client has been poped out
-  delete client;
-  std::unique_lock<std::mutex> cv_lock(_mtx);
-  _curr_pool_size--;
-  cv_lock.unlock();
-  _cv.notify_one();
+  Release(client, false, false);
 }
 
 template<class TClient>
 void ClientPool<TClient>::Keepalive(TClient *client) {
   long curr_timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
           std::chrono::system_clock::now().time_since_epoch()).count();
-  if (curr_timestamp - client->_connect_timestamp > client->_keepalive_ms) {
-    Remove(client);
-  } else {
-    Push(client);
+  bool keep = curr_timestamp - client->_connect_timestamp <=
+              client->_keepalive_ms;
+  Release(client, true, keep);
+}
+
+template<class TClient>
+std::vector<ClientPoolEndpointStats>
+ClientPool<TClient>::GetEndpointStatsLocked(long now_ms) {
+  std::vector<ClientPoolEndpointStats> stats;
+  for (auto &endpoint : _endpoints) {
+    stats.push_back({endpoint->addr, endpoint->port, endpoint->in_flight,
+                     static_cast<int>(endpoint->idle.size()),
+                     endpoint->ewma_latency_us / 1000, endpoint->calls,
+                     endpoint->failures, endpoint->ejections,
+                     endpoint->ejected_until_ms > now_ms});
+  }
+  return stats;
+}
+
+template<class TClient>
+std::vector<ClientPoolEndpointStats> ClientPool<TClient>::GetEndpointStats() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return GetEndpointStatsLocked(NowMs());
+}
+
+// Logs the load of every endpoint each metrics_interval_ms, if the pool has
+// more than one.
+template<class TClient>
+void ClientPool<TClient>::MaybeLogStatsLocked(long now_ms) {
+  if (_metrics_interval_ms <= 0 || now_ms < _next_metrics_ms) {
+    return;
+  }
+  _next_metrics_ms = now_ms + _metrics_interval_ms;
+  if (_endpoints.size() < 2) {
+    return;
+  }
+  for (auto &s : GetEndpointStatsLocked(now_ms)) {
+    LOG(info) << "ClientPool " << _client_type << " endpoint " << s.addr
+              << ":" << s.port << " in_flight=" << s.in_flight
+              << " idle=" << s.idle << " ewma_latency_ms="
+              << s.ewma_latency_ms << " calls=" << s.calls
+              << " failures=" << s.failures << " ejections=" << s.ejections
+              << (s.ejected ? " ejected" : "");
   }
 }
 
 } // namespace social_network
 
 
-#endif //SOCIAL_NETWORK_MICROSERVICES_CLIENTPOOL_H
\ No newline at end of file
+#endif //SOCIAL_NETWORK_MICROSERVICES_CLIENTPOOL_H
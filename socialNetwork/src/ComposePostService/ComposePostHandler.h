@@ -30,13 +30,14 @@ using std::chrono::system_clock;
 
 class ComposePostHandler : public ComposePostServiceIf {
  public:
-  ComposePostHandler(ClientPool<ThriftClient<PostStorageServiceClient>> *,
-                     ClientPool<ThriftClient<UserTimelineServiceClient>> *,
-                     ClientPool<ThriftClient<UserServiceClient>> *,
-                     ClientPool<ThriftClient<UniqueIdServiceClient>> *,
-                     ClientPool<ThriftClient<MediaServiceClient>> *,
-                     ClientPool<ThriftClient<TextServiceClient>> *,
-                     ClientPool<ThriftClient<HomeTimelineServiceClient>> *);
+  ComposePostHandler(
+      ClientPool<ThriftClient<PostStorageServiceClient>> *,
+      ClientPool<ThriftClient<UserTimelineServiceClient>> *,
+      ClientPool<ThriftClient<UserServiceClient, UserServiceIf>> *,
+      ClientPool<ThriftClient<UniqueIdServiceClient, UniqueIdServiceIf>> *,
+      ClientPool<ThriftClient<MediaServiceClient, MediaServiceIf>> *,
+      ClientPool<ThriftClient<TextServiceClient>> *,
+      ClientPool<ThriftClient<HomeTimelineServiceClient>> *);
   ~ComposePostHandler() override = default;
 
   void ComposePost(int64_t req_id, const std::string &username, int64_t user_id,
@@ -51,10 +52,14 @@ class ComposePostHandler : public ComposePostServiceIf {
   ClientPool<ThriftClient<UserTimelineServiceClient>>
       *_user_timeline_client_pool;
 
-  ClientPool<ThriftClient<UserServiceClient>> *_user_service_client_pool;
-  ClientPool<ThriftClient<UniqueIdServiceClient>>
+  // User, unique-id and media calls may be served in-process (see
+  // "in_process" in ComposePostService.cpp), so they go through the *If.
+  ClientPool<ThriftClient<UserServiceClient, UserServiceIf>>
+      *_user_service_client_pool;
+  ClientPool<ThriftClient<UniqueIdServiceClient, UniqueIdServiceIf>>
       *_unique_id_service_client_pool;
-  ClientPool<ThriftClient<MediaServiceClient>> *_media_service_client_pool;
+  ClientPool<ThriftClient<MediaServiceClient, MediaServiceIf>>
+      *_media_service_client_pool;
   ClientPool<ThriftClient<TextServiceClient>> *_text_service_client_pool;
   ClientPool<ThriftClient<HomeTimelineServiceClient>>
       *_home_timeline_client_pool;
@@ -91,10 +96,12 @@ ComposePostHandler::ComposePostHandler(
         *post_storage_client_pool,
     ClientPool<social_network::ThriftClient<UserTimelineServiceClient>>
         *user_timeline_client_pool,
-    ClientPool<ThriftClient<UserServiceClient>> *user_service_client_pool,
-    ClientPool<ThriftClient<UniqueIdServiceClient>>
+    ClientPool<ThriftClient<UserServiceClient, UserServiceIf>>
+        *user_service_client_pool,
+    ClientPool<ThriftClient<UniqueIdServiceClient, UniqueIdServiceIf>>
         *unique_id_service_client_pool,
-    ClientPool<ThriftClient<MediaServiceClient>> *media_service_client_pool,
+    ClientPool<ThriftClient<MediaServiceClient, MediaServiceIf>>
+        *media_service_client_pool,
     ClientPool<ThriftClient<TextServiceClient>> *text_service_client_pool,
     ClientPool<ThriftClient<HomeTimelineServiceClient>>
         *home_timeline_client_pool) {
@@ -4,18 +4,50 @@
 #include <thrift/transport/TBufferTransports.h>
 #include <thrift/transport/TServerSocket.h>
 
+#include <set>
+
 #include "../utils.h"
 #include "../utils_thrift.h"
 #include "ComposePostHandler.h"
+#ifdef SOCIAL_NETWORK_MONOLITH
+#include "../MediaService/MediaHandler.h"
+#include "../UniqueIdService/UniqueIdHandler.h"
+#include "../UserService/UserHandler.h"
+#include "../utils_memcached.h"
+#include "../utils_mongodb.h"
+#endif
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
 void sigintHandler(int sig) { exit(EXIT_SUCCESS); }
 
+// Returns the client pool of service. With a local_handler, the pool hands out
+// clients that call it directly, without serialization or a network hop.
+template <class TThriftClient, class TIf>
+ClientPool<ThriftClient<TThriftClient, TIf>> *NewClientPool(
+    const json &config_json, const std::string &service,
+    const std::string &client_type, TIf *local_handler) {
+  int conns = config_json[service]["connections"];
+  int timeout = config_json[service]["timeout_ms"];
+  if (local_handler) {
+    LOG(info) << service << " is served in-process";
+    return new ClientPool<ThriftClient<TThriftClient, TIf>>(
+        client_type,
+        [local_handler]() {
+          return new ThriftClient<TThriftClient, TIf>(local_handler);
+        },
+        conns, timeout);
+  }
+  int port = config_json[service]["port"];
+  std::string addr = config_json[service]["addr"];
+  int keepalive = config_json[service]["keepalive_ms"];
+  return new ClientPool<ThriftClient<TThriftClient, TIf>>(
+      client_type, addr, port, 0, conns, timeout, keepalive, config_json);
+}
+
 int main(int argc, char *argv[]) {
   signal(SIGINT, sigintHandler);
   init_logger();
@@ -49,18 +81,6 @@ int main(int argc, char *argv[]) {
   int text_timeout = config_json["text-service"]["timeout_ms"];
   int text_keepalive = config_json["text-service"]["keepalive_ms"];
 
-  int user_port = config_json["user-service"]["port"];
-  std::string user_addr = config_json["user-service"]["addr"];
-  int user_conns = config_json["user-service"]["connections"];
-  int user_timeout = config_json["user-service"]["timeout_ms"];
-  int user_keepalive = config_json["user-service"]["keepalive_ms"];
-
-  int media_port = config_json["media-service"]["port"];
-  std::string media_addr = config_json["media-service"]["addr"];
-  int media_conns = config_json["media-service"]["connections"];
-  int media_timeout = config_json["media-service"]["timeout_ms"];
-  int media_keepalive = config_json["media-service"]["keepalive_ms"];
-
   int home_timeline_port = config_json["home-timeline-service"]["port"];
   std::string home_timeline_addr = config_json["home-timeline-service"]["addr"];
   int home_timeline_conns = config_json["home-timeline-service"]["connections"];
@@ -69,12 +89,6 @@ int main(int argc, char *argv[]) {
   int home_timeline_keepalive =
       config_json["home-timeline-service"]["keepalive_ms"];
 
-  int unique_id_port = config_json["unique-id-service"]["port"];
-  std::string unique_id_addr = config_json["unique-id-service"]["addr"];
-  int unique_id_conns = config_json["unique-id-service"]["connections"];
-  int unique_id_timeout = config_json["unique-id-service"]["timeout_ms"];
-  int unique_id_keepalive = config_json["unique-id-service"]["keepalive_ms"];
-
   ClientPool<ThriftClient<PostStorageServiceClient>> post_storage_client_pool(
       "post-storage-client", post_storage_addr, post_storage_port, 0,
       post_storage_conns, post_storage_timeout, post_storage_keepalive, config_json);
@@ -84,29 +98,99 @@ int main(int argc, char *argv[]) {
   ClientPool<ThriftClient<TextServiceClient>> text_client_pool(
       "text-service-client", text_addr, text_port, 0, text_conns, text_timeout,
       text_keepalive, config_json);
-  ClientPool<ThriftClient<UserServiceClient>> user_client_pool(
-      "user-service-client", user_addr, user_port, 0, user_conns, user_timeout,
-      user_keepalive, config_json);
-  ClientPool<ThriftClient<MediaServiceClient>> media_client_pool(
-      "media-service-client", media_addr, media_port, 0, media_conns,
-      media_timeout, media_keepalive, config_json);
   ClientPool<ThriftClient<HomeTimelineServiceClient>> home_timeline_client_pool(
       "home-timeline-service-client", home_timeline_addr, home_timeline_port, 0,
       home_timeline_conns, home_timeline_timeout, home_timeline_keepalive, config_json);
-  ClientPool<ThriftClient<UniqueIdServiceClient>> unique_id_client_pool(
-      "unique-id-service-client", unique_id_addr, unique_id_port, 0,
-      unique_id_conns, unique_id_timeout, unique_id_keepalive, config_json);
+
+  // Services listed in "in_process" are linked into this process by the
+  // ComposePostMonolith build and called directly.
+  std::set<std::string> in_process;
+  for (auto &service : config_json["compose-post-service"]["in_process"]) {
+    in_process.insert(service.get<std::string>());
+  }
+  std::shared_ptr<UserServiceIf> user_handler;
+  std::shared_ptr<UniqueIdServiceIf> unique_id_handler;
+  std::shared_ptr<MediaServiceIf> media_handler;
+#ifdef SOCIAL_NETWORK_MONOLITH
+  std::mutex user_thread_lock;
+  std::unique_ptr<ClientPool<ThriftClient<SocialGraphServiceClient>>>
+      social_graph_client_pool;
+  std::unique_ptr<PasswordHasher> password_hasher;
+  if (in_process.count("user-service")) {
+    std::string secret = config_json["secret"];
+    std::string netif = config_json["user-service"]["netif"];
+    std::string machine_id = GetMachineId(netif);
+    int mongodb_conns = config_json["user-mongodb"]["connections"];
+    int memcached_conns = config_json["user-memcached"]["connections"];
+    memcached_pool_st *memcached_client_pool =
+        init_memcached_client_pool(config_json, "user", 32, memcached_conns);
+    mongoc_client_pool_t *mongodb_client_pool =
+        init_mongodb_client_pool(config_json, "user", mongodb_conns);
+    std::string password_hash_backend =
+        config_json["user-service"].value("password_hash_backend", "openssl");
+    password_hasher = PasswordHasher::Create(password_hash_backend);
+    if (machine_id == "" || memcached_client_pool == nullptr ||
+        mongodb_client_pool == nullptr || !password_hasher) {
+      exit(EXIT_FAILURE);
+    }
+    InitOpenSslLocking();
+    social_graph_client_pool.reset(
+        new ClientPool<ThriftClient<SocialGraphServiceClient>>(
+            "social-graph", config_json["social-graph-service"]["addr"],
+            config_json["social-graph-service"]["port"], 0,
+            config_json["social-graph-service"]["connections"],
+            config_json["social-graph-service"]["timeout_ms"],
+            config_json["social-graph-service"]["keepalive_ms"],
+            config_json));
+    // ComposePost only looks users up by id, so the username filter is not
+    // needed here.
+    user_handler = std::make_shared<UserHandler>(
+        &user_thread_lock, machine_id, secret, memcached_client_pool,
+        mongodb_client_pool, social_graph_client_pool.get(), nullptr,
+        password_hasher.get());
+  }
+  if (in_process.count("unique-id-service")) {
+    std::string netif = config_json["unique-id-service"]["netif"];
+    std::string machine_id = GetMachineId(netif);
+    if (machine_id == "") {
+      exit(EXIT_FAILURE);
+    }
+    unique_id_handler = std::make_shared<UniqueIdHandler>(machine_id);
+  }
+  if (in_process.count("media-service")) {
+    media_handler = std::make_shared<MediaHandler>();
+  }
+#else
+  if (!in_process.empty()) {
+    LOG(warning) << "in_process is ignored: in-process services need the "
+                    "ComposePostMonolith build";
+  }
+#endif
+  std::unique_ptr<ClientPool<ThriftClient<UserServiceClient, UserServiceIf>>>
+      user_client_pool(NewClientPool<UserServiceClient>(
+          config_json, "user-service", "user-service-client",
+          user_handler.get()));
+  std::unique_ptr<
+      ClientPool<ThriftClient<UniqueIdServiceClient, UniqueIdServiceIf>>>
+      unique_id_client_pool(NewClientPool<UniqueIdServiceClient>(
+          config_json, "unique-id-service", "unique-id-service-client",
+          unique_id_handler.get()));
+  std::unique_ptr<ClientPool<ThriftClient<MediaServiceClient, MediaServiceIf>>>
+      media_client_pool(NewClientPool<MediaServiceClient>(
+          config_json, "media-service", "media-service-client",
+          media_handler.get()));
 
   std::shared_ptr<TServerSocket> server_socket = get_server_socket(config_json, "0.0.0.0", port);
   TThreadedServer server(
       std::make_shared<ComposePostServiceProcessor>(
           std::make_shared<ComposePostHandler>(
               &post_storage_client_pool, &user_timeline_client_pool,
-              &user_client_pool, &unique_id_client_pool, &media_client_pool,
-              &text_client_pool, &home_timeline_client_pool)),
+              user_client_pool.get(), unique_id_client_pool.get(),
+              media_client_pool.get(), &text_client_pool,
+              &home_timeline_client_pool)),
       server_socket,
-      std::make_shared<TFramedTransportFactory>(),
-      std::make_shared<TBinaryProtocolFactory>());
+      get_transport_factory(config_json),
+      get_protocol_factory(config_json));
   LOG(info) << "Starting the compose-post-service server ...";
   server.serve();
 }
\ No newline at end of file
@@ -0,0 +1,459 @@
+// Loads a social-graph dataset straight into the MongoDB and Redis stores of
+// user-service, social-graph-service and user-timeline-service, producing the
+// same documents and ZSETs as registering every user and following every edge
+// through the nginx API (scripts/init_social_graph.py), without the RPCs.
+
+#include <signal.h>
+#include <sys/stat.h>
+
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <random>
+
+#include "../../third_party/PicoSHA2/picosha2.h"
+#include "../logger.h"
+#include "../utils.h"
+#include "../utils_mongodb.h"
+#include "../utils_redis.h"
+#include "../SocialGraphService/SocialGraphEdges.h"
+#include "EdgeList.h"
+
+using json = nlohmann::json;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::chrono::system_clock;
+using namespace social_network;
+
+namespace {
+
+struct LoaderOptions {
+  int64_t num_users;
+  int64_t batch_size;
+  int64_t timestamp;
+  bool use_edge_collection;
+};
+
+struct RedisStores {
+  Redis *redis = nullptr;
+  RedisCluster *redis_cluster = nullptr;
+};
+
+// Same alphabet and length as UserHandler, so loaded users can log in.
+std::string GenSalt(std::mt19937 *gen) {
+  static const std::string alphanum =
+      "0123456789"
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+      "abcdefghijklmnopqrstuvwxyz";
+  std::uniform_int_distribution<int> dist(
+      0, static_cast<int>(alphanum.length() - 1));
+  std::string s(32, ' ');
+  for (auto &c : s) {
+    c = alphanum[dist(*gen)];
+  }
+  return s;
+}
+
+bool ExecuteBulk(mongoc_bulk_operation_t *bulk, const char *what) {
+  bson_error_t error;
+  bson_t reply;
+  bool success = mongoc_bulk_operation_execute(bulk, &reply, &error);
+  if (!success) {
+    LOG(error) << "Failed to load " << what << ": " << error.message;
+  }
+  bson_destroy(&reply);
+  mongoc_bulk_operation_destroy(bulk);
+  return success;
+}
+
+mongoc_bulk_operation_t *NewBulk(mongoc_client_t *client, const char *db) {
+  auto collection = mongoc_client_get_collection(client, db, db);
+  bson_t *bulk_opts = BCON_NEW("ordered", BCON_BOOL(false));
+  mongoc_bulk_operation_t *bulk =
+      mongoc_collection_create_bulk_operation_with_opts(collection, bulk_opts);
+  bson_destroy(bulk_opts);
+  mongoc_collection_destroy(collection);
+  return bulk;
+}
+
+// Appends {user_id: [{user_id, timestamp}, ...]} entries of one direction.
+void AppendEdgeArray(bson_t *doc, const char *field, const int64_t *first,
+                     const int64_t *last, int64_t timestamp) {
+  bson_t array;
+  bson_append_array_begin(doc, field, -1, &array);
+  char key_buf[16];
+  const char *key;
+  uint32_t idx = 0;
+  for (const int64_t *it = first; it != last; ++it, ++idx) {
+    bson_uint32_to_string(idx, &key, key_buf, sizeof(key_buf));
+    bson_t edge;
+    bson_append_document_begin(&array, key, -1, &edge);
+    BSON_APPEND_INT64(&edge, "user_id", *it);
+    BSON_APPEND_INT64(&edge, "timestamp", timestamp);
+    bson_append_document_end(&array, &edge);
+  }
+  bson_append_array_end(doc, &array);
+}
+
+// Writes users [first_user, last_user). Every write is an upsert keyed on the
+// services' unique indexes, so a load can be interrupted and re-run.
+bool LoadUsers(int64_t first_user, int64_t last_user,
+               const LoaderOptions &options, const Adjacency &followees,
+               const Adjacency &followers, mongoc_client_t *user_client,
+               mongoc_client_t *social_graph_client,
+               mongoc_client_t *user_timeline_client,
+               const RedisStores &redis, std::mt19937 *gen) {
+  bson_t *upsert_opts = BCON_NEW("upsert", BCON_BOOL(true));
+  mongoc_bulk_operation_t *user_bulk = NewBulk(user_client, "user");
+  mongoc_bulk_operation_t *graph_bulk =
+      NewBulk(social_graph_client, "social-graph");
+  mongoc_bulk_operation_t *timeline_bulk =
+      NewBulk(user_timeline_client, "user-timeline");
+  mongoc_bulk_operation_t *edge_bulk = nullptr;
+  if (options.use_edge_collection) {
+    auto collection = mongoc_client_get_collection(
+        social_graph_client, "social-graph", SOCIAL_GRAPH_EDGE_COLLECTION);
+    bson_t *bulk_opts = BCON_NEW("ordered", BCON_BOOL(false));
+    edge_bulk =
+        mongoc_collection_create_bulk_operation_with_opts(collection, bulk_opts);
+    bson_destroy(bulk_opts);
+    mongoc_collection_destroy(collection);
+  }
+
+  bool success = true;
+  int64_t num_edge_ops = 0;
+  for (int64_t user_id = first_user; success && user_id < last_user;
+       ++user_id) {
+    // Same naming scheme as scripts/init_social_graph.py.
+    std::string id_str = std::to_string(user_id);
+    std::string salt = GenSalt(gen);
+    std::string password_hashed =
+        picosha2::hash256_hex_string("password_" + id_str + salt);
+    std::string first_name = "first_name_" + id_str;
+    std::string last_name = "last_name_" + id_str;
+    std::string username = "username_" + id_str;
+    bson_t *selector = BCON_NEW("user_id", BCON_INT64(user_id));
+    bson_t *user_update = BCON_NEW(
+        "$setOnInsert", "{", "first_name", BCON_UTF8(first_name.c_str()),
+        "last_name", BCON_UTF8(last_name.c_str()), "username",
+        BCON_UTF8(username.c_str()), "salt", BCON_UTF8(salt.c_str()),
+        "password", BCON_UTF8(password_hashed.c_str()), "}");
+    bson_t *timeline_update =
+        BCON_NEW("$setOnInsert", "{", "posts", "[", "]", "}");
+    success = mongoc_bulk_operation_update_one_with_opts(
+                  user_bulk, selector, user_update, upsert_opts, nullptr) &&
+              mongoc_bulk_operation_update_one_with_opts(
+                  timeline_bulk, selector, timeline_update, upsert_opts,
+                  nullptr);
+    bson_destroy(timeline_update);
+    bson_destroy(user_update);
+
+    if (success && options.use_edge_collection) {
+      bson_t *graph_update = BCON_NEW("$setOnInsert", "{", "user_id",
+                                      BCON_INT64(user_id), "}");
+      success = mongoc_bulk_operation_update_one_with_opts(
+          graph_bulk, selector, graph_update, upsert_opts, nullptr);
+      bson_destroy(graph_update);
+      for (auto it = followees.begin(user_id);
+           success && it != followees.end(user_id); ++it) {
+        success =
+            AppendEdgeUpsert(edge_bulk, user_id, *it, options.timestamp);
+        num_edge_ops++;
+      }
+    } else if (success) {
+      // Merged into the edges of users that already exist, such as follows
+      // made through the API since an earlier load.
+      bson_t *graph_update = BCON_NEW("$setOnInsert", "{", "user_id",
+                                      BCON_INT64(user_id), "}");
+      bson_t add_to_set;
+      bson_t each;
+      BSON_APPEND_DOCUMENT_BEGIN(graph_update, "$addToSet", &add_to_set);
+      BSON_APPEND_DOCUMENT_BEGIN(&add_to_set, "followers", &each);
+      AppendEdgeArray(&each, "$each", followers.begin(user_id),
+                      followers.end(user_id), options.timestamp);
+      bson_append_document_end(&add_to_set, &each);
+      BSON_APPEND_DOCUMENT_BEGIN(&add_to_set, "followees", &each);
+      AppendEdgeArray(&each, "$each", followees.begin(user_id),
+                      followees.end(user_id), options.timestamp);
+      bson_append_document_end(&add_to_set, &each);
+      bson_append_document_end(graph_update, &add_to_set);
+      success = mongoc_bulk_operation_update_one_with_opts(
+          graph_bulk, selector, graph_update, upsert_opts, nullptr);
+      bson_destroy(graph_update);
+    }
+    bson_destroy(selector);
+  }
+  bson_destroy(upsert_opts);
+
+  success = ExecuteBulk(user_bulk, "users") && success;
+  success = ExecuteBulk(timeline_bulk, "user timelines") && success;
+  success = ExecuteBulk(graph_bulk, "social graph") && success;
+  if (edge_bulk && num_edge_ops > 0) {
+    success = ExecuteBulk(edge_bulk, "social graph edges") && success;
+  } else if (edge_bulk) {
+    // Users without followees leave the bulk empty, which MongoDB rejects.
+    mongoc_bulk_operation_destroy(edge_bulk);
+  }
+  if (!success) {
+    return false;
+  }
+
+  // The "<user_id>:followers" and "<user_id>:followees" ZSETs read by
+  // SocialGraphHandler, scored by the follow timestamp.
+  try {
+    const std::pair<const char *, const Adjacency *> directions[] = {
+        {":followers", &followers}, {":followees", &followees}};
+    std::vector<std::pair<std::string, double>> members;
+    auto zadd = [&](auto *client, const std::string &key, int64_t user_id,
+                    const Adjacency &adj) {
+      members.clear();
+      for (auto it = adj.begin(user_id); it != adj.end(user_id); ++it) {
+        members.emplace_back(std::to_string(*it), options.timestamp);
+      }
+      client->zadd(key, members.begin(), members.end());
+    };
+    if (redis.redis) {
+      auto pipe = redis.redis->pipeline(false);
+      for (int64_t user_id = first_user; user_id < last_user; ++user_id) {
+        for (auto &direction : directions) {
+          if (direction.second->degrees[user_id] > 0) {
+            zadd(&pipe, std::to_string(user_id) + direction.first, user_id,
+                 *direction.second);
+          }
+        }
+      }
+      pipe.exec();
+    } else {
+      ClusterPipeline pipe(redis.redis_cluster);
+      for (int64_t user_id = first_user; user_id < last_user; ++user_id) {
+        for (auto &direction : directions) {
+          if (direction.second->degrees[user_id] > 0) {
+            std::string key = std::to_string(user_id) + direction.first;
+            pipe.Add(key, [&](Pipeline &node_pipe) {
+              zadd(&node_pipe, key, user_id, *direction.second);
+            });
+          }
+        }
+      }
+      pipe.Exec();
+    }
+  } catch (const Error &err) {
+    LOG(error) << "Failed to load social graph to Redis: " << err.what();
+    return false;
+  }
+  return true;
+}
+
+bool CreateIndexes(mongoc_client_pool_t *user_pool,
+                   mongoc_client_pool_t *social_graph_pool,
+                   mongoc_client_pool_t *user_timeline_pool,
+                   bool use_edge_collection) {
+  mongoc_client_t *user_client = mongoc_client_pool_pop(user_pool);
+  mongoc_client_t *social_graph_client =
+      mongoc_client_pool_pop(social_graph_pool);
+  mongoc_client_t *user_timeline_client =
+      mongoc_client_pool_pop(user_timeline_pool);
+  bool success =
+      CreateIndex(user_client, "user", "user_id", true) &&
+      CreateIndex(user_client, "user", "username", true) &&
+      CreateIndex(social_graph_client, "social-graph", "user_id", true) &&
+      CreateIndex(user_timeline_client, "user-timeline", "user_id", true) &&
+      (!use_edge_collection || CreateEdgeIndexes(social_graph_client));
+  mongoc_client_pool_push(user_timeline_pool, user_timeline_client);
+  mongoc_client_pool_push(social_graph_pool, social_graph_client);
+  mongoc_client_pool_push(user_pool, user_client);
+  return success;
+}
+
+}  // namespace
+
+void sigintHandler(int sig) { exit(EXIT_SUCCESS); }
+
+int main(int argc, char *argv[]) {
+  signal(SIGINT, sigintHandler);
+  init_logger();
+
+  // Command line options
+  namespace po = boost::program_options;
+  po::options_description desc("Options");
+  desc.add_options()("help", "produce help message")(
+      "graph", po::value<std::string>()->default_value("socfb-Reed98"),
+      "Graph name (socfb-Reed98, ego-twitter, or soc-twitter-follows-mun)")(
+      "dataset-dir",
+      po::value<std::string>()->default_value("datasets/social-graph"),
+      "Directory holding <graph>/<graph>.nodes and <graph>/<graph>.edges")(
+      "threads",
+      po::value<int>()->default_value(
+          static_cast<int>(std::thread::hardware_concurrency())),
+      "Number of parsing and loading threads")(
+      "batch-size", po::value<int64_t>()->default_value(1000),
+      "Users per MongoDB bulk write and Redis pipeline")(
+      "bidirectional",
+      po::value<bool>()->default_value(true),
+      "Follow every edge in both directions, like init_social_graph.py")(
+      "redis-cluster",
+      po::value<bool>()->default_value(false)->implicit_value(true),
+      "Enable redis cluster mode");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (vm.count("help")) {
+    std::cout << desc << "\n";
+    return 0;
+  }
+
+  std::string graph = vm["graph"].as<std::string>();
+  std::string graph_prefix =
+      vm["dataset-dir"].as<std::string>() + "/" + graph + "/" + graph;
+  int num_threads = std::max(1, vm["threads"].as<int>());
+  bool bidirectional = vm["bidirectional"].as<bool>();
+
+  json config_json;
+  if (load_config_file("config/service-config.json", &config_json) != 0) {
+    exit(EXIT_FAILURE);
+  }
+
+  LoaderOptions options;
+  options.batch_size = std::max<int64_t>(1, vm["batch-size"].as<int64_t>());
+  options.use_edge_collection =
+      config_json["social-graph-mongodb"].value("use_edge_collection", 0);
+  int redis_cluster_config_flag =
+      config_json["social-graph-redis"]["use_cluster"];
+  int redis_replica_config_flag =
+      config_json["social-graph-redis"]["use_replica"];
+
+  auto start = steady_clock::now();
+
+  std::ifstream nodes_file(graph_prefix + ".nodes");
+  int64_t num_nodes = 0;
+  if (!(nodes_file >> num_nodes)) {
+    LOG(fatal) << "Failed to read " << graph_prefix << ".nodes";
+    return EXIT_FAILURE;
+  }
+  MappedFile edges_file;
+  if (!edges_file.Open(graph_prefix + ".edges")) {
+    LOG(fatal) << "Failed to map " << graph_prefix << ".edges";
+    return EXIT_FAILURE;
+  }
+  // Edges are followed at the time the dataset was written, so that loading
+  // it again produces the same edge documents, which $addToSet skips.
+  struct stat edges_stat;
+  if (stat((graph_prefix + ".edges").c_str(), &edges_stat) == 0) {
+    options.timestamp = static_cast<int64_t>(edges_stat.st_mtime) * 1000;
+  } else {
+    options.timestamp =
+        duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+            .count();
+  }
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> edges;
+  ParseEdgeList(edges_file, num_threads, &edges);
+
+  // Users are 0 .. nodes - 1, grown to cover ids that only appear as edges.
+  options.num_users = num_nodes;
+  for (auto &chunk : edges) {
+    for (auto &edge : chunk) {
+      options.num_users = std::max(
+          options.num_users, std::max(edge.first, edge.second) + 1);
+    }
+  }
+  Adjacency followees;
+  Adjacency followers;
+  BuildAdjacency(edges, options.num_users, bidirectional, &followees,
+                 &followers);
+  edges.clear();
+  edges.shrink_to_fit();
+  int64_t num_edges = 0;
+  for (int64_t user_id = 0; user_id < options.num_users; ++user_id) {
+    num_edges += followees.degrees[user_id];
+  }
+  auto parsed = steady_clock::now();
+  LOG(info) << "Parsed " << graph << ": " << options.num_users << " users, "
+            << num_edges << " edges in "
+            << duration_cast<milliseconds>(parsed - start).count() << " ms";
+
+  mongoc_client_pool_t *user_pool =
+      init_mongodb_client_pool(config_json, "user", num_threads);
+  mongoc_client_pool_t *social_graph_pool =
+      init_mongodb_client_pool(config_json, "social-graph", num_threads);
+  mongoc_client_pool_t *user_timeline_pool =
+      init_mongodb_client_pool(config_json, "user-timeline", num_threads);
+  if (!user_pool || !social_graph_pool || !user_timeline_pool) {
+    return EXIT_FAILURE;
+  }
+  if (!CreateIndexes(user_pool, social_graph_pool, user_timeline_pool,
+                     options.use_edge_collection)) {
+    LOG(fatal) << "Failed to create mongodb indexes";
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<Redis> redis_client_pool;
+  std::unique_ptr<RedisCluster> redis_cluster_client_pool;
+  RedisStores redis;
+  if (vm["redis-cluster"].as<bool>() || redis_cluster_config_flag) {
+    redis_cluster_client_pool.reset(new RedisCluster(
+        init_redis_cluster_client_pool(config_json, "social-graph")));
+    redis.redis_cluster = redis_cluster_client_pool.get();
+  } else if (redis_replica_config_flag) {
+    redis_client_pool.reset(new Redis(
+        init_redis_replica_client_pool(config_json, "redis-primary")));
+    redis.redis = redis_client_pool.get();
+  } else {
+    redis_client_pool.reset(
+        new Redis(init_redis_client_pool(config_json, "social-graph")));
+    redis.redis = redis_client_pool.get();
+  }
+
+  // Threads claim batches of consecutive users until all are loaded.
+  std::atomic<int64_t> next_user(0);
+  std::atomic<bool> failed(false);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      std::mt19937 gen(std::random_device{}());
+      mongoc_client_t *user_client = mongoc_client_pool_pop(user_pool);
+      mongoc_client_t *social_graph_client =
+          mongoc_client_pool_pop(social_graph_pool);
+      mongoc_client_t *user_timeline_client =
+          mongoc_client_pool_pop(user_timeline_pool);
+      while (!failed) {
+        int64_t first_user = next_user.fetch_add(options.batch_size);
+        if (first_user >= options.num_users) {
+          break;
+        }
+        int64_t last_user =
+            std::min(first_user + options.batch_size, options.num_users);
+        if (!LoadUsers(first_user, last_user, options, followees, followers,
+                       user_client, social_graph_client,
+                       user_timeline_client, redis, &gen)) {
+          failed = true;
+        }
+      }
+      mongoc_client_pool_push(user_timeline_pool, user_timeline_client);
+      mongoc_client_pool_push(social_graph_pool, social_graph_client);
+      mongoc_client_pool_push(user_pool, user_client);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  mongoc_client_pool_destroy(user_timeline_pool);
+  mongoc_client_pool_destroy(social_graph_pool);
+  mongoc_client_pool_destroy(user_pool);
+  mongoc_cleanup();
+
+  if (failed) {
+    LOG(fatal) << "Failed to load " << graph;
+    return EXIT_FAILURE;
+  }
+  auto loaded = steady_clock::now();
+  double seconds =
+      duration_cast<milliseconds>(loaded - start).count() / 1000.0;
+  LOG(info) << "Loaded " << graph << ": " << options.num_users << " users, "
+            << num_edges << " edges in " << seconds << " s ("
+            << static_cast<int64_t>(num_edges / std::max(seconds, 0.001))
+            << " edges/s)";
+  return 0;
+}
@@ -0,0 +1,229 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_SRC_DATASETLOADER_EDGELIST_H_
+#define SOCIAL_NETWORK_MICROSERVICES_SRC_DATASETLOADER_EDGELIST_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace social_network {
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile() {
+    if (_data && _size > 0) {
+      munmap(const_cast<char *>(_data), _size);
+    }
+  }
+
+  bool Open(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      return false;
+    }
+    _size = st.st_size;
+    if (_size > 0) {
+      void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        return false;
+      }
+      // The file is parsed front to back by every thread.
+      madvise(data, _size, MADV_SEQUENTIAL);
+      _data = static_cast<const char *>(data);
+    }
+    close(fd);
+    return true;
+  }
+
+  const char *data() const { return _data; }
+  size_t size() const { return _size; }
+
+ private:
+  const char *_data = nullptr;
+  size_t _size = 0;
+};
+
+// Parses the "<src> <dst>" lines of [begin, end). Lines starting with '%' or
+// '#' (the comment markers of the network repository files) and extra columns
+// such as weights are skipped.
+inline void ParseEdgeLines(const char *begin, const char *end,
+                           std::vector<std::pair<int64_t, int64_t>> *edges) {
+  const char *p = begin;
+  while (p < end) {
+    if (*p == '%' || *p == '#') {
+      p = static_cast<const char *>(memchr(p, '\n', end - p));
+      p = p ? p + 1 : end;
+      continue;
+    }
+    int64_t ids[2];
+    int num_ids = 0;
+    while (p < end && *p != '\n' && num_ids < 2) {
+      while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')) {
+        ++p;
+      }
+      if (p >= end || *p < '0' || *p > '9') {
+        break;
+      }
+      int64_t id = 0;
+      while (p < end && *p >= '0' && *p <= '9') {
+        id = id * 10 + (*p - '0');
+        ++p;
+      }
+      ids[num_ids++] = id;
+    }
+    if (num_ids == 2) {
+      edges->emplace_back(ids[0], ids[1]);
+    }
+    p = static_cast<const char *>(memchr(p, '\n', end - p));
+    p = p ? p + 1 : end;
+  }
+}
+
+// Splits the file into num_threads chunks on line boundaries and parses them
+// concurrently; (*edges)[i] holds the edges of the i-th chunk.
+inline void ParseEdgeList(
+    const MappedFile &file, int num_threads,
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> *edges) {
+  const char *data = file.data();
+  size_t size = file.size();
+  std::vector<const char *> bounds(num_threads + 1, data + size);
+  bounds[0] = data;
+  for (int i = 1; i < num_threads; ++i) {
+    const char *p = std::max(data + size * i / num_threads, bounds[i - 1]);
+    const char *nl = static_cast<const char *>(memchr(p, '\n', data + size - p));
+    bounds[i] = nl ? nl + 1 : data + size;
+  }
+  edges->assign(num_threads, {});
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      // About 8 bytes per line in the bundled datasets.
+      (*edges)[i].reserve((bounds[i + 1] - bounds[i]) / 8);
+      ParseEdgeLines(bounds[i], bounds[i + 1], &(*edges)[i]);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// Compressed sparse row adjacency of one direction of the graph: the
+// neighbors of user u are neighbors[offsets[u], offsets[u] + degrees[u]).
+struct Adjacency {
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> degrees;
+  std::unique_ptr<int64_t[]> neighbors;
+
+  const int64_t *begin(int64_t user_id) const {
+    return neighbors.get() + offsets[user_id];
+  }
+  const int64_t *end(int64_t user_id) const {
+    return begin(user_id) + degrees[user_id];
+  }
+};
+
+// Builds the followee (src -> dst) and follower (dst -> src) adjacency of
+// num_users users with a parallel counting sort. Duplicate edges are dropped,
+// so a list that contains both directions of an undirected edge can be loaded
+// with bidirectional set.
+inline void BuildAdjacency(
+    const std::vector<std::vector<std::pair<int64_t, int64_t>>> &edges,
+    int64_t num_users, bool bidirectional, Adjacency *followees,
+    Adjacency *followers) {
+  int num_threads = edges.size();
+  auto for_each_chunk = [&](const std::function<void(int)> &fn) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.emplace_back(fn, i);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+  auto for_each_directed = [&](int chunk, const std::function<void(
+                                              int64_t, int64_t)> &fn) {
+    for (auto &edge : edges[chunk]) {
+      fn(edge.first, edge.second);
+      if (bidirectional) {
+        fn(edge.second, edge.first);
+      }
+    }
+  };
+
+  std::unique_ptr<std::atomic<uint64_t>[]> out_cursor(
+      new std::atomic<uint64_t>[num_users + 1]);
+  std::unique_ptr<std::atomic<uint64_t>[]> in_cursor(
+      new std::atomic<uint64_t>[num_users + 1]);
+  for (int64_t u = 0; u <= num_users; ++u) {
+    out_cursor[u].store(0, std::memory_order_relaxed);
+    in_cursor[u].store(0, std::memory_order_relaxed);
+  }
+  for_each_chunk([&](int chunk) {
+    for_each_directed(chunk, [&](int64_t src, int64_t dst) {
+      out_cursor[src].fetch_add(1, std::memory_order_relaxed);
+      in_cursor[dst].fetch_add(1, std::memory_order_relaxed);
+    });
+  });
+
+  // Exclusive prefix sums turn the degrees into start offsets, which then
+  // serve as per-user insertion cursors.
+  auto init = [&](std::atomic<uint64_t> *cursor, Adjacency *adj) {
+    adj->offsets.resize(num_users + 1);
+    adj->degrees.assign(num_users, 0);
+    uint64_t total = 0;
+    for (int64_t u = 0; u <= num_users; ++u) {
+      adj->offsets[u] = total;
+      total += cursor[u].load(std::memory_order_relaxed);
+      cursor[u].store(adj->offsets[u], std::memory_order_relaxed);
+    }
+    adj->neighbors.reset(new int64_t[total]);
+  };
+  init(out_cursor.get(), followees);
+  init(in_cursor.get(), followers);
+
+  for_each_chunk([&](int chunk) {
+    for_each_directed(chunk, [&](int64_t src, int64_t dst) {
+      followees->neighbors[out_cursor[src].fetch_add(
+          1, std::memory_order_relaxed)] = dst;
+      followers->neighbors[in_cursor[dst].fetch_add(
+          1, std::memory_order_relaxed)] = src;
+    });
+  });
+
+  // Sort and deduplicate every list; users are striped across the threads.
+  for_each_chunk([&](int chunk) {
+    for (int64_t u = chunk; u < num_users; u += num_threads) {
+      for (Adjacency *adj : {followees, followers}) {
+        int64_t *first = adj->neighbors.get() + adj->offsets[u];
+        int64_t *last = adj->neighbors.get() + adj->offsets[u + 1];
+        std::sort(first, last);
+        adj->degrees[u] = std::unique(first, last) - first;
+      }
+    }
+  });
+}
+
+}  // namespace social_network
+
+#endif  // SOCIAL_NETWORK_MICROSERVICES_SRC_DATASETLOADER_EDGELIST_H_
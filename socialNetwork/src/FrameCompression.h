@@ -0,0 +1,145 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_SRC_FRAMECOMPRESSION_H_
+#define SOCIAL_NETWORK_MICROSERVICES_SRC_FRAMECOMPRESSION_H_
+
+#include <lz4.h>
+#include <zstd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thrift/transport/TTransportException.h>
+
+namespace social_network {
+using apache::thrift::transport::TTransportException;
+
+// Codecs of compressed Thrift frames, numbered as in the frame header (see
+// PooledFramedTransport).
+enum class FrameCodec : uint32_t { NONE = 0, LZ4 = 1, ZSTD = 2 };
+
+struct FrameCompressionStats {
+  uint64_t frames_compressed;
+  uint64_t frames_incompressible;  // sent as they were
+  uint64_t bytes_in;               // of the compressed frames
+  uint64_t bytes_out;
+  uint64_t compress_ns;
+  uint64_t frames_decompressed;
+  uint64_t decompress_ns;
+};
+
+// The compression settings of a process and its counters. Frames of at
+// least threshold bytes are compressed, on connections where both ends
+// have compression enabled.
+class FrameCompression {
+ public:
+  FrameCompression(FrameCodec codec, uint32_t threshold, int zstd_level)
+      : _codec(codec),
+        _threshold(threshold),
+        _zstd_level(zstd_level),
+        _frames_compressed(0),
+        _frames_incompressible(0),
+        _bytes_in(0),
+        _bytes_out(0),
+        _compress_ns(0),
+        _frames_decompressed(0),
+        _decompress_ns(0) {}
+
+  FrameCodec codec() const { return _codec; }
+  uint32_t threshold() const { return _threshold; }
+
+  // Compresses src into dst. Returns the compressed size, or 0 when it
+  // would not be smaller than dst_len.
+  uint32_t Compress(FrameCodec codec, const uint8_t *src, uint32_t src_len,
+                    uint8_t *dst, uint32_t dst_len) {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t size = 0;
+    if (codec == FrameCodec::LZ4) {
+      int n = LZ4_compress_default(reinterpret_cast<const char *>(src),
+                                   reinterpret_cast<char *>(dst), src_len,
+                                   dst_len);
+      size = n > 0 ? n : 0;
+    } else if (codec == FrameCodec::ZSTD) {
+      size_t n = ZSTD_compressCCtx(ZstdCCtx(), dst, dst_len, src, src_len,
+                                   _zstd_level);
+      size = ZSTD_isError(n) ? 0 : n;
+    }
+    _compress_ns.fetch_add(ElapsedNs(start), std::memory_order_relaxed);
+    if (size == 0) {
+      _frames_incompressible.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+    _frames_compressed.fetch_add(1, std::memory_order_relaxed);
+    _bytes_in.fetch_add(src_len, std::memory_order_relaxed);
+    _bytes_out.fetch_add(size, std::memory_order_relaxed);
+    return size;
+  }
+
+  // Decompresses src into exactly dst_len bytes of dst.
+  void Decompress(FrameCodec codec, const uint8_t *src, uint32_t src_len,
+                  uint8_t *dst, uint32_t dst_len) {
+    auto start = std::chrono::steady_clock::now();
+    bool ok = false;
+    if (codec == FrameCodec::LZ4) {
+      int n = LZ4_decompress_safe(reinterpret_cast<const char *>(src),
+                                  reinterpret_cast<char *>(dst), src_len,
+                                  dst_len);
+      ok = n >= 0 && static_cast<uint32_t>(n) == dst_len;
+    } else if (codec == FrameCodec::ZSTD) {
+      size_t n = ZSTD_decompressDCtx(ZstdDCtx(), dst, dst_len, src, src_len);
+      ok = !ZSTD_isError(n) && n == dst_len;
+    }
+    if (!ok) {
+      throw TTransportException(TTransportException::CORRUPTED_DATA,
+                                "Failed to decompress a frame");
+    }
+    _frames_decompressed.fetch_add(1, std::memory_order_relaxed);
+    _decompress_ns.fetch_add(ElapsedNs(start), std::memory_order_relaxed);
+  }
+
+  FrameCompressionStats GetStats() const {
+    FrameCompressionStats stats;
+    stats.frames_compressed = _frames_compressed.load();
+    stats.frames_incompressible = _frames_incompressible.load();
+    stats.bytes_in = _bytes_in.load();
+    stats.bytes_out = _bytes_out.load();
+    stats.compress_ns = _compress_ns.load();
+    stats.frames_decompressed = _frames_decompressed.load();
+    stats.decompress_ns = _decompress_ns.load();
+    return stats;
+  }
+
+ private:
+  static uint64_t ElapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  // zstd contexts hold their tables across frames. One per thread, freed
+  // when the thread exits.
+  static ZSTD_CCtx *ZstdCCtx() {
+    thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx *)> ctx(
+        ZSTD_createCCtx(), ZSTD_freeCCtx);
+    return ctx.get();
+  }
+
+  static ZSTD_DCtx *ZstdDCtx() {
+    thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx *)> ctx(
+        ZSTD_createDCtx(), ZSTD_freeDCtx);
+    return ctx.get();
+  }
+
+  FrameCodec _codec;
+  uint32_t _threshold;
+  int _zstd_level;
+  std::atomic<uint64_t> _frames_compressed;
+  std::atomic<uint64_t> _frames_incompressible;
+  std::atomic<uint64_t> _bytes_in;
+  std::atomic<uint64_t> _bytes_out;
+  std::atomic<uint64_t> _compress_ns;
+  std::atomic<uint64_t> _frames_decompressed;
+  std::atomic<uint64_t> _decompress_ns;
+};
+
+} // namespace social_network
+
+#endif //SOCIAL_NETWORK_MICROSERVICES_SRC_FRAMECOMPRESSION_H_
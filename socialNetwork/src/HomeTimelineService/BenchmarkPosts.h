@@ -0,0 +1,72 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_SRC_HOMETIMELINESERVICE_BENCHMARKPOSTS_H_
+#define SOCIAL_NETWORK_MICROSERVICES_SRC_HOMETIMELINESERVICE_BENCHMARKPOSTS_H_
+
+#include <random>
+#include <string>
+
+#include "../../gen-cpp/social_network_types.h"
+
+namespace social_network {
+
+// Posts of the benchmarks, made the way
+// wrk2/scripts/social-network/compose-post.lua and compose-post-service do:
+// 256 characters of text with 0-5 mentions and 0-5 shortened URLs, 0-4
+// media, snowflake IDs.
+
+static const std::string kCharset =
+    "qwertyuiopasdfghjklzxcvbnmQWERTYUIOPASDFGHJKLZXCVBNM1234567890";
+
+static std::string RandomString(std::mt19937_64 *gen, int length) {
+  std::uniform_int_distribution<int> dist(0, kCharset.size() - 1);
+  std::string s;
+  for (int i = 0; i < length; ++i) {
+    s += kCharset[dist(*gen)];
+  }
+  return s;
+}
+
+// IDs as SnowflakeGenerator makes them: a 41-bit millisecond timestamp
+// above 22 bits of machine ID and sequence.
+static int64_t RandomId(std::mt19937_64 *gen, int64_t timestamp) {
+  return (timestamp << 22) | static_cast<int64_t>((*gen)() & 0x3fffff);
+}
+
+static Post RandomPost(std::mt19937_64 *gen) {
+  std::uniform_int_distribution<int> count(0, 5);
+  std::uniform_int_distribution<int> user(0, 961);
+  int64_t timestamp = 1600000000000LL + (*gen)() % 100000000000LL;
+  Post post;
+  post.post_id = RandomId(gen, timestamp);
+  post.req_id = static_cast<int64_t>((*gen)() >> 1);
+  post.timestamp = timestamp;
+  post.post_type = PostType::POST;
+  int creator = user(*gen);
+  post.creator.user_id = creator;
+  post.creator.username = "username_" + std::to_string(creator);
+  post.text = RandomString(gen, 256);
+  for (int i = count(*gen); i > 0; --i) {
+    UserMention mention;
+    mention.user_id = user(*gen);
+    mention.username = "username_" + std::to_string(mention.user_id);
+    post.text += " @" + mention.username;
+    post.user_mentions.emplace_back(mention);
+  }
+  for (int i = count(*gen); i > 0; --i) {
+    Url url;
+    url.expanded_url = "http://" + RandomString(gen, 64);
+    url.shortened_url = "http://short-url.com/" + RandomString(gen, 10);
+    post.text += " " + url.shortened_url;
+    post.urls.emplace_back(url);
+  }
+  for (int i = count(*gen) % 5; i > 0; --i) {
+    Media media;
+    media.media_id = RandomId(gen, timestamp);
+    media.media_type = "png";
+    post.media.emplace_back(media);
+  }
+  return post;
+}
+
+} // namespace social_network
+
+#endif //SOCIAL_NETWORK_MICROSERVICES_SRC_HOMETIMELINESERVICE_BENCHMARKPOSTS_H_
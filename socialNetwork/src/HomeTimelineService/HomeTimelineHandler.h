@@ -14,6 +14,8 @@
 #include "../ThriftClient.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "../utils.h"
+#include "../utils_redis.h"
 
 using namespace sw::redis;
 namespace social_network {
@@ -24,7 +26,7 @@ class HomeTimelineHandler : public HomeTimelineServiceIf {
                       ClientPool<ThriftClient<SocialGraphServiceClient>> *);
 
 
-  HomeTimelineHandler(Redis *,Redis *,
+  HomeTimelineHandler(RedisReplicas *,Redis *,
       ClientPool<ThriftClient<PostStorageServiceClient>>*,
       ClientPool<ThriftClient<SocialGraphServiceClient>>*);
 
@@ -44,7 +46,7 @@ class HomeTimelineHandler : public HomeTimelineServiceIf {
                          const std::map<std::string, std::string> &) override;
 
  private:
-     Redis *_redis_replica_pool;
+     RedisReplicas *_redis_replica_pool;
      Redis *_redis_primary_pool;
      Redis *_redis_client_pool;
      RedisCluster *_redis_cluster_client_pool;
@@ -79,7 +81,7 @@ HomeTimelineHandler::HomeTimelineHandler(
 }
 
 HomeTimelineHandler::HomeTimelineHandler(
-    Redis *redis_replica_pool,
+    RedisReplicas *redis_replica_pool,
     Redis *redis_primary_pool,
     ClientPool<ThriftClient<PostStorageServiceClient>>* post_client_pool,
     ClientPool<ThriftClient<SocialGraphServiceClient>>
@@ -174,33 +176,17 @@ void HomeTimelineHandler::WriteHomeTimeline(
     }
     
     else {
-      // Create multi-pipeline that match with shards pool
-      std::map<std::shared_ptr<ConnectionPool>, std::shared_ptr<Pipeline>> pipe_map;
-      auto *shards_pool = _redis_cluster_client_pool->get_shards_pool();
-
+      // One pipeline per cluster node, executed concurrently
+      ClusterPipeline pipe(_redis_cluster_client_pool);
       for (auto &follower_id : followers_id_set) {
-        auto conn = shards_pool->fetch(std::to_string(follower_id));
-        auto pipe = pipe_map.find(conn);
-        if(pipe == pipe_map.end()) {//Not found, create new pipeline and insert
-          auto new_pipe = std::make_shared<Pipeline>(_redis_cluster_client_pool->pipeline(std::to_string(follower_id), false));
-          pipe_map.insert(make_pair(conn, new_pipe));
-          auto *_pipe = new_pipe.get();
-          _pipe->zadd(std::to_string(follower_id), post_id_str, timestamp,
-                  UpdateType::NOT_EXIST);
-        }else{//Found, use exist pipeline
-          std::pair<std::shared_ptr<ConnectionPool>, std::shared_ptr<Pipeline>> found = *pipe;
-          auto *_pipe = found.second.get();
-          _pipe->zadd(std::to_string(follower_id), post_id_str, timestamp,
-                  UpdateType::NOT_EXIST);
-        }
+        std::string follower_id_str = std::to_string(follower_id);
+        pipe.Add(follower_id_str, [&](Pipeline &node_pipe) {
+          node_pipe.zadd(follower_id_str, post_id_str, timestamp,
+                         UpdateType::NOT_EXIST);
+        });
       }
-      // LOG(info) <<"followers_id_set items:" << followers_id_set.size()<<"; pipeline items:" << pipe_map.size();
       try {
-        for(auto const &it : pipe_map) {
-          auto _pipe = it.second.get();
-          _pipe->exec();
-        }
-
+        auto replies = pipe.Exec();
       } catch (const Error &err) {
         LOG(error) << err.what();
         throw err;
@@ -239,9 +225,9 @@ void HomeTimelineHandler::ReadHomeTimeline(
                                     std::back_inserter(post_ids_str));
     }
     else if (IsRedisReplicationEnabled()) {
-        _redis_replica_pool->zrevrange(std::to_string(user_id), start_idx,
-                                       stop_idx - 1,
-                                       std::back_inserter(post_ids_str));
+        _redis_replica_pool->Acquire()->zrevrange(
+            std::to_string(user_id), start_idx, stop_idx - 1,
+            std::back_inserter(post_ids_str));
     }
     
     else {
@@ -16,7 +16,6 @@
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -96,7 +95,8 @@ int main(int argc, char *argv[]) {
 
 
   if (redis_replica_config_flag) {
-          Redis redis_replica_client_pool = init_redis_replica_client_pool(config_json, "redis-replica");
+          RedisReplicas redis_replica_client_pool(
+              init_redis_replica_client_pools(config_json, "redis-replica"));
           Redis redis_primary_client_pool = init_redis_replica_client_pool(config_json, "redis-primary");
 
           TThreadedServer server(
@@ -105,8 +105,8 @@ int main(int argc, char *argv[]) {
                       &redis_primary_client_pool,
                       &post_storage_client_pool,
                       &social_graph_client_pool)),
-              server_socket, std::make_shared<TFramedTransportFactory>(),
-              std::make_shared<TBinaryProtocolFactory>());
+              server_socket, get_transport_factory(config_json),
+              get_protocol_factory(config_json));
 
           LOG(info) << "Starting the home-timeline-service server with replicated Redis support...";
           server.serve();
@@ -122,8 +122,8 @@ int main(int argc, char *argv[]) {
             std::make_shared<HomeTimelineHandler>(&redis_cluster_client_pool,
                                                   &post_storage_client_pool,
                                                   &social_graph_client_pool)),
-        server_socket, std::make_shared<TFramedTransportFactory>(),
-        std::make_shared<TBinaryProtocolFactory>());
+        server_socket, get_transport_factory(config_json),
+        get_protocol_factory(config_json));
 
     LOG(info) << "Starting the home-timeline-service server with Redis Cluster support...";
     server.serve();
@@ -135,8 +135,8 @@ int main(int argc, char *argv[]) {
             std::make_shared<HomeTimelineHandler>(&redis_client_pool,
                                                   &post_storage_client_pool,
                                                   &social_graph_client_pool)),
-        server_socket, std::make_shared<TFramedTransportFactory>(),
-        std::make_shared<TBinaryProtocolFactory>());
+        server_socket, get_transport_factory(config_json),
+        get_protocol_factory(config_json));
 
     LOG(info) << "Starting the home-timeline-service server...";
     server.serve();
@@ -0,0 +1,124 @@
+/*
+ * Size and serialization cost of ReadHomeTimeline responses in the binary
+ * and compact Thrift protocols.
+ *
+ * Usage: ProtocolBenchmark [posts per response] [iterations]
+ *
+ * Writes posts like those of compose-post (see BenchmarkPosts.h) as the
+ * list<Post> of a ReadHomeTimeline reply with each protocol, checks that they
+ * read back unchanged, and reports bytes per response and the time to write
+ * and read one.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+#include <thrift/transport/TBufferTransports.h>
+
+#include "BenchmarkPosts.h"
+
+using namespace social_network;
+using apache::thrift::protocol::T_REPLY;
+using apache::thrift::protocol::T_STRUCT;
+using apache::thrift::protocol::TBinaryProtocol;
+using apache::thrift::protocol::TCompactProtocol;
+using apache::thrift::protocol::TProtocol;
+using apache::thrift::transport::TMemoryBuffer;
+
+// The reply part of HomeTimelineService_ReadHomeTimeline_result: field 0,
+// the list of posts.
+static void WriteReply(TProtocol *prot, const std::vector<Post> &posts) {
+  prot->writeMessageBegin("ReadHomeTimeline", T_REPLY, 1);
+  prot->writeStructBegin("HomeTimelineService_ReadHomeTimeline_result");
+  prot->writeFieldBegin("success", apache::thrift::protocol::T_LIST, 0);
+  prot->writeListBegin(T_STRUCT, static_cast<uint32_t>(posts.size()));
+  for (auto &post : posts) {
+    post.write(prot);
+  }
+  prot->writeListEnd();
+  prot->writeFieldEnd();
+  prot->writeFieldStop();
+  prot->writeStructEnd();
+  prot->writeMessageEnd();
+}
+
+static std::vector<Post> ReadReply(TProtocol *prot) {
+  std::string name;
+  apache::thrift::protocol::TMessageType type;
+  int32_t seqid;
+  std::string struct_name;
+  apache::thrift::protocol::TType field_type;
+  int16_t field_id;
+  apache::thrift::protocol::TType elem_type;
+  uint32_t size;
+  std::vector<Post> posts;
+  prot->readMessageBegin(name, type, seqid);
+  prot->readStructBegin(struct_name);
+  prot->readFieldBegin(name, field_type, field_id);
+  prot->readListBegin(elem_type, size);
+  posts.resize(size);
+  for (auto &post : posts) {
+    post.read(prot);
+  }
+  prot->readListEnd();
+  prot->readFieldEnd();
+  prot->readFieldBegin(name, field_type, field_id);
+  prot->readStructEnd();
+  prot->readMessageEnd();
+  return posts;
+}
+
+template <class TProt>
+static void Run(const char *name, const std::vector<std::vector<Post>> &replies,
+                int iterations) {
+  auto buffer = std::make_shared<TMemoryBuffer>();
+  TProt prot(buffer);
+  size_t bytes = 0;
+  for (auto &posts : replies) {
+    buffer->resetBuffer();
+    WriteReply(&prot, posts);
+    bytes += buffer->available_read();
+    if (!(ReadReply(&prot) == posts)) {
+      std::cerr << name << ": posts differ after a round trip" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  double write_s = 0, read_s = 0;
+  for (int i = 0; i < iterations; ++i) {
+    for (auto &posts : replies) {
+      buffer->resetBuffer();
+      auto start = std::chrono::steady_clock::now();
+      WriteReply(&prot, posts);
+      auto written = std::chrono::steady_clock::now();
+      ReadReply(&prot);
+      auto end = std::chrono::steady_clock::now();
+      write_s += std::chrono::duration<double>(written - start).count();
+      read_s += std::chrono::duration<double>(end - written).count();
+    }
+  }
+  double n = static_cast<double>(replies.size()) * iterations;
+  std::cout << name << ": " << bytes / replies.size() << " bytes/response, "
+            << 1e6 * write_s / n << " us write, " << 1e6 * read_s / n
+            << " us read" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  int posts_per_reply = argc > 1 ? std::atoi(argv[1]) : 10;
+  int iterations = argc > 2 ? std::atoi(argv[2]) : 100;
+  std::mt19937_64 gen(42);
+  std::vector<std::vector<Post>> replies(1000);
+  for (auto &posts : replies) {
+    for (int i = 0; i < posts_per_reply; ++i) {
+      posts.emplace_back(RandomPost(&gen));
+    }
+  }
+  Run<TBinaryProtocol>("binary ", replies, iterations);
+  Run<TCompactProtocol>("compact", replies, iterations);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,190 @@
+/*
+ * Memory allocations and latency of ReadPosts calls over TFramedTransport
+ * and over PooledFramedTransport, without and with frame compression.
+ *
+ * Usage: TransportBenchmark [posts per call] [calls] [port]
+ *
+ * Serves PostStorageService on 127.0.0.1 from posts like those of
+ * compose-post (see BenchmarkPosts.h) and calls ReadPosts the way
+ * home-timeline-service does, with the binary protocol, over one connection
+ * and then over a new connection every 10 calls, as when ClientPool
+ * connections expire. Reports the operator new calls and bytes of client
+ * and server together, and the time, per call. With compression, also
+ * reports the compression ratio and the time to compress and decompress a
+ * frame.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/server/TThreadedServer.h>
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/transport/TServerSocket.h>
+#include <thrift/transport/TSocket.h>
+
+#include "../../gen-cpp/PostStorageService.h"
+#include "../PooledFramedTransport.h"
+#include "BenchmarkPosts.h"
+
+using namespace social_network;
+using apache::thrift::protocol::TBinaryProtocolFactory;
+using apache::thrift::protocol::TBinaryProtocolFactoryT;
+using apache::thrift::protocol::TProtocolFactory;
+using apache::thrift::server::TThreadedServer;
+using apache::thrift::transport::TFramedTransportFactory;
+using apache::thrift::transport::TServerSocket;
+
+static std::atomic<uint64_t> allocations(0);
+static std::atomic<uint64_t> allocated_bytes(0);
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  void *p = std::malloc(size);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+class PostsHandler : public PostStorageServiceIf {
+ public:
+  explicit PostsHandler(const std::vector<Post> *posts) : _posts(posts) {}
+
+  void StorePost(int64_t req_id, const Post &post,
+                 const std::map<std::string, std::string> &carrier) override {}
+
+  void ReadPost(Post &_return, int64_t req_id, int64_t post_id,
+                const std::map<std::string, std::string> &carrier) override {
+    _return = (*_posts)[post_id % _posts->size()];
+  }
+
+  void ReadPosts(std::vector<Post> &_return, int64_t req_id,
+                 const std::vector<int64_t> &post_ids,
+                 const std::map<std::string, std::string> &carrier) override {
+    for (auto post_id : post_ids) {
+      _return.emplace_back((*_posts)[post_id % _posts->size()]);
+    }
+  }
+
+ private:
+  const std::vector<Post> *_posts;
+};
+
+static void Run(const char *name,
+                std::shared_ptr<TTransportFactory> server_transport_factory,
+                std::shared_ptr<TTransportFactory> client_transport_factory,
+                std::shared_ptr<TProtocolFactory> protocol_factory,
+                const std::vector<Post> &posts, int posts_per_call,
+                int num_calls, int port) {
+  TThreadedServer server(
+      std::make_shared<PostStorageServiceProcessor>(
+          std::make_shared<PostsHandler>(&posts)),
+      std::make_shared<TServerSocket>("127.0.0.1", port),
+      server_transport_factory, protocol_factory);
+  std::thread serve([&server]() { server.serve(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::map<std::string, std::string> carrier;
+  for (int calls_per_connection : {num_calls, 10}) {
+    uint64_t allocations_start = allocations.load();
+    uint64_t bytes_start = allocated_bytes.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_calls;) {
+      auto socket = std::make_shared<TSocket>("127.0.0.1", port);
+      auto transport = client_transport_factory->getTransport(socket);
+      PostStorageServiceClient client(
+          protocol_factory->getProtocol(transport));
+      transport->open();
+      for (int j = 0; j < calls_per_connection && i < num_calls; ++j, ++i) {
+        std::vector<int64_t> post_ids;
+        for (int k = 0; k < posts_per_call; ++k) {
+          post_ids.emplace_back(i * posts_per_call + k);
+        }
+        std::vector<Post> result;
+        client.ReadPosts(result, i, post_ids, carrier);
+      }
+      transport->close();
+    }
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    double calls = num_calls;
+    std::cout << name << ", "
+              << (calls_per_connection == num_calls ? "one connection: "
+                                                    : "10 calls/connection: ")
+              << (allocations.load() - allocations_start) / calls
+              << " allocations/call, "
+              << (allocated_bytes.load() - bytes_start) / calls
+              << " bytes/call, " << 1e6 * elapsed / calls << " us/call"
+              << std::endl;
+  }
+  server.stop();
+  serve.join();
+}
+
+int main(int argc, char *argv[]) {
+  int posts_per_call = argc > 1 ? std::atoi(argv[1]) : 10;
+  int num_calls = argc > 2 ? std::atoi(argv[2]) : 10000;
+  int port = argc > 3 ? std::atoi(argv[3]) : 19091;
+  std::mt19937_64 gen(42);
+  std::vector<Post> posts;
+  for (int i = 0; i < 1000; ++i) {
+    posts.emplace_back(RandomPost(&gen));
+  }
+
+  auto framed_factory = std::make_shared<TFramedTransportFactory>();
+  Run("TFramedTransport", framed_factory, framed_factory,
+      std::make_shared<TBinaryProtocolFactory>(), posts, posts_per_call,
+      num_calls, port++);
+  auto protocol_factory =
+      std::make_shared<TBinaryProtocolFactoryT<PooledFramedTransport>>();
+  Run("PooledFramedTransport",
+      std::make_shared<PooledFramedTransportFactory>(),
+      std::make_shared<PooledFramedTransportFactory>(), protocol_factory,
+      posts, posts_per_call, num_calls, port++);
+  auto pool_stats = FrameBufferPool::Instance().GetStats();
+  std::cout << "FrameBufferPool: " << pool_stats.acquires << " acquires, "
+            << pool_stats.allocations << " allocations, "
+            << pool_stats.idle_bytes << " idle bytes" << std::endl;
+
+  for (auto codec : {FrameCodec::LZ4, FrameCodec::ZSTD}) {
+    const char *name = codec == FrameCodec::LZ4 ? "PooledFramedTransport, lz4"
+                                                : "PooledFramedTransport, zstd";
+    // One for each end, so as to tell compression from decompression
+    auto server_compression =
+        std::make_shared<FrameCompression>(codec, 4096, 1);
+    auto client_compression =
+        std::make_shared<FrameCompression>(codec, 4096, 1);
+    Run(name,
+        std::make_shared<PooledFramedTransportFactory>(server_compression),
+        std::make_shared<PooledFramedTransportFactory>(client_compression,
+                                                       true),
+        protocol_factory, posts, posts_per_call, num_calls, port++);
+    auto compressed = server_compression->GetStats();
+    auto decompressed = client_compression->GetStats();
+    std::cout << name << ": " << compressed.frames_compressed
+              << " responses compressed to "
+              << 100.0 * compressed.bytes_out / compressed.bytes_in << "%, "
+              << compressed.frames_incompressible << " incompressible, "
+              << compressed.compress_ns / 1000.0 /
+                     (compressed.frames_compressed +
+                      compressed.frames_incompressible)
+              << " us to compress, "
+              << decompressed.decompress_ns / 1000.0 /
+                     decompressed.frames_decompressed
+              << " us to decompress" << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
@@ -10,7 +10,6 @@
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -31,8 +30,8 @@ int main(int argc, char *argv[]) {
   TThreadedServer server(
       std::make_shared<MediaServiceProcessor>(std::make_shared<MediaHandler>()),
       server_socket,
-      std::make_shared<TFramedTransportFactory>(),
-      std::make_shared<TBinaryProtocolFactory>());
+      get_transport_factory(config_json),
+      get_protocol_factory(config_json));
 
   LOG(info) << "Starting the media-service server...";
   server.serve();
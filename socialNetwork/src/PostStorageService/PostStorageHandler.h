@@ -6,12 +6,14 @@
 #include <libmemcached/util.h>
 #include <mongoc.h>
 
+#include <algorithm>
 #include <future>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include <string>
 
 #include "../../gen-cpp/PostStorageService.h"
+#include "../SingleFlight.h"
 #include "../logger.h"
 #include "../tracing.h"
 
@@ -36,11 +38,13 @@ class PostStorageHandler : public PostStorageServiceIf {
  private:
   memcached_pool_st *_memcached_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
+  SingleFlight<Post> _post_flight;
 };
 
 PostStorageHandler::PostStorageHandler(
     memcached_pool_st *memcached_client_pool,
-    mongoc_client_pool_t *mongodb_client_pool) {
+    mongoc_client_pool_t *mongodb_client_pool)
+    : _post_flight("post-storage-read-post") {
   _memcached_client_pool = memcached_client_pool;
   _mongodb_client_pool = mongodb_client_pool;
 }
@@ -233,119 +237,136 @@ void PostStorageHandler::ReadPost(
     }
     free(post_mmc);
   } else {
-    // If not cached in memcached
-    mongoc_client_t *mongodb_client =
-        mongoc_client_pool_pop(_mongodb_client_pool);
-    if (!mongodb_client) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to pop a client from MongoDB pool";
-      throw se;
-    }
-
-    auto collection =
-        mongoc_client_get_collection(mongodb_client, "post", "post");
-    if (!collection) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to create collection user from DB user";
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-      throw se;
-    }
-
-    bson_t *query = bson_new();
-    BSON_APPEND_INT64(query, "post_id", post_id);
-    auto find_span = opentracing::Tracer::Global()->StartSpan(
-        "post_storage_mongo_find_client",
-        {opentracing::ChildOf(&span->context())});
-    mongoc_cursor_t *cursor =
-        mongoc_collection_find_with_opts(collection, query, nullptr, nullptr);
-    const bson_t *doc;
-    bool found = mongoc_cursor_next(cursor, &doc);
-    find_span->Finish();
-    if (!found) {
-      bson_error_t error;
-      if (mongoc_cursor_error(cursor, &error)) {
-        LOG(warning) << error.message;
-        bson_destroy(query);
-        mongoc_cursor_destroy(cursor);
-        mongoc_collection_destroy(collection);
-        mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+    // If not cached in memcached. Concurrent misses on the same post wait
+    // for a single MongoDB read and memcached refill.
+    bool coalesced = false;
+    _return = _post_flight.Do(post_id_str, [&]() {
+      Post post;
+      mongoc_client_t *mongodb_client =
+          mongoc_client_pool_pop(_mongodb_client_pool);
+      if (!mongodb_client) {
         ServiceException se;
         se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-        se.message = error.message;
+        se.message = "Failed to pop a client from MongoDB pool";
         throw se;
-      } else {
-        LOG(warning) << "Post_id: " << post_id << " doesn't exist in MongoDB";
-        bson_destroy(query);
-        mongoc_cursor_destroy(cursor);
-        mongoc_collection_destroy(collection);
-        mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-        ServiceException se;
-        se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
-        se.message =
-            "Post_id: " + std::to_string(post_id) + " doesn't exist in MongoDB";
-        throw se;
-      }
-    } else {
-      LOG(debug) << "Post_id: " << post_id << " found in MongoDB";
-      auto post_json_char = bson_as_json(doc, nullptr);
-      json post_json = json::parse(post_json_char);
-      _return.req_id = post_json["req_id"];
-      _return.timestamp = post_json["timestamp"];
-      _return.post_id = post_json["post_id"];
-      _return.creator.user_id = post_json["creator"]["user_id"];
-      _return.creator.username = post_json["creator"]["username"];
-      _return.post_type = post_json["post_type"];
-      _return.text = post_json["text"];
-      for (auto &item : post_json["media"]) {
-        Media media;
-        media.media_id = item["media_id"];
-        media.media_type = item["media_type"];
-        _return.media.emplace_back(media);
       }
-      for (auto &item : post_json["user_mentions"]) {
-        UserMention user_mention;
-        user_mention.username = item["username"];
-        user_mention.user_id = item["user_id"];
-        _return.user_mentions.emplace_back(user_mention);
-      }
-      for (auto &item : post_json["urls"]) {
-        Url url;
-        url.shortened_url = item["shortened_url"];
-        url.expanded_url = item["expanded_url"];
-        _return.urls.emplace_back(url);
-      }
-      bson_destroy(query);
-      mongoc_cursor_destroy(cursor);
-      mongoc_collection_destroy(collection);
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
 
-      // upload post to memcached
-      memcached_client =
-          memcached_pool_pop(_memcached_client_pool, true, &memcached_rc);
-      if (!memcached_client) {
+      auto collection =
+          mongoc_client_get_collection(mongodb_client, "post", "post");
+      if (!collection) {
         ServiceException se;
-        se.errorCode = ErrorCode::SE_MEMCACHED_ERROR;
-        se.message = "Failed to pop a client from memcached pool";
+        se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+        se.message = "Failed to create collection user from DB user";
+        mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
         throw se;
       }
-      auto set_span = opentracing::Tracer::Global()->StartSpan(
-          "post_storage_mmc_set_client",
+
+      bson_t *query = bson_new();
+      BSON_APPEND_INT64(query, "post_id", post_id);
+      auto find_span = opentracing::Tracer::Global()->StartSpan(
+          "post_storage_mongo_find_client",
           {opentracing::ChildOf(&span->context())});
+      const mongoc_read_prefs_t *read_prefs =
+          get_stale_read_prefs(_mongodb_client_pool);
+      mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
+          collection, query, nullptr, read_prefs);
+      const bson_t *doc;
+      bool found = mongoc_cursor_next(cursor, &doc);
+      bson_error_t error;
+      if (!found && read_prefs && !mongoc_cursor_error(cursor, &error)) {
+        // StorePost does not fill memcached, so the first read of a new post
+        // may reach a secondary that has not replicated it yet.
+        mongoc_cursor_destroy(cursor);
+        cursor = mongoc_collection_find_with_opts(collection, query, nullptr,
+                                                  nullptr);
+        found = mongoc_cursor_next(cursor, &doc);
+      }
+      find_span->Finish();
+      if (!found) {
+        if (mongoc_cursor_error(cursor, &error)) {
+          LOG(warning) << error.message;
+          bson_destroy(query);
+          mongoc_cursor_destroy(cursor);
+          mongoc_collection_destroy(collection);
+          mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+          ServiceException se;
+          se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+          se.message = error.message;
+          throw se;
+        } else {
+          LOG(warning) << "Post_id: " << post_id << " doesn't exist in MongoDB";
+          bson_destroy(query);
+          mongoc_cursor_destroy(cursor);
+          mongoc_collection_destroy(collection);
+          mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+          ServiceException se;
+          se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+          se.message = "Post_id: " + std::to_string(post_id) +
+                       " doesn't exist in MongoDB";
+          throw se;
+        }
+      } else {
+        LOG(debug) << "Post_id: " << post_id << " found in MongoDB";
+        auto post_json_char = bson_as_json(doc, nullptr);
+        json post_json = json::parse(post_json_char);
+        post.req_id = post_json["req_id"];
+        post.timestamp = post_json["timestamp"];
+        post.post_id = post_json["post_id"];
+        post.creator.user_id = post_json["creator"]["user_id"];
+        post.creator.username = post_json["creator"]["username"];
+        post.post_type = post_json["post_type"];
+        post.text = post_json["text"];
+        for (auto &item : post_json["media"]) {
+          Media media;
+          media.media_id = item["media_id"];
+          media.media_type = item["media_type"];
+          post.media.emplace_back(media);
+        }
+        for (auto &item : post_json["user_mentions"]) {
+          UserMention user_mention;
+          user_mention.username = item["username"];
+          user_mention.user_id = item["user_id"];
+          post.user_mentions.emplace_back(user_mention);
+        }
+        for (auto &item : post_json["urls"]) {
+          Url url;
+          url.shortened_url = item["shortened_url"];
+          url.expanded_url = item["expanded_url"];
+          post.urls.emplace_back(url);
+        }
+        bson_destroy(query);
+        mongoc_cursor_destroy(cursor);
+        mongoc_collection_destroy(collection);
+        mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
 
-      memcached_rc = memcached_set(
-          memcached_client, post_id_str.c_str(), post_id_str.length(),
-          post_json_char, std::strlen(post_json_char), static_cast<time_t>(0),
-          static_cast<uint32_t>(0));
-      if (memcached_rc != MEMCACHED_SUCCESS) {
-        LOG(warning) << "Failed to set post to Memcached: "
-                     << memcached_strerror(memcached_client, memcached_rc);
+        // upload post to memcached
+        memcached_client =
+            memcached_pool_pop(_memcached_client_pool, true, &memcached_rc);
+        if (!memcached_client) {
+          ServiceException se;
+          se.errorCode = ErrorCode::SE_MEMCACHED_ERROR;
+          se.message = "Failed to pop a client from memcached pool";
+          throw se;
+        }
+        auto set_span = opentracing::Tracer::Global()->StartSpan(
+            "post_storage_mmc_set_client",
+            {opentracing::ChildOf(&span->context())});
+
+        memcached_rc = memcached_set(
+            memcached_client, post_id_str.c_str(), post_id_str.length(),
+            post_json_char, std::strlen(post_json_char),
+            static_cast<time_t>(0), static_cast<uint32_t>(0));
+        if (memcached_rc != MEMCACHED_SUCCESS) {
+          LOG(warning) << "Failed to set post to Memcached: "
+                       << memcached_strerror(memcached_client, memcached_rc);
+        }
+        set_span->Finish();
+        bson_free(post_json_char);
+        memcached_pool_push(_memcached_client_pool, memcached_client);
       }
-      set_span->Finish();
-      bson_free(post_json_char);
-      memcached_pool_push(_memcached_client_pool, memcached_client);
-    }
+      return post;
+    }, &coalesced);
+    span->SetTag("cache_miss_coalesced", coalesced);
   }
 
   span->Finish();
@@ -401,7 +422,9 @@ void PostStorageHandler::ReadPosts(
   }
   memcached_rc =
       memcached_mget(memcached_client, keys, key_sizes, post_ids.size());
-  if (memcached_rc != MEMCACHED_SUCCESS) {
+  // Keys of unreachable servers read as misses
+  if (memcached_rc != MEMCACHED_SUCCESS &&
+      memcached_rc != MEMCACHED_SOME_ERRORS) {
     LOG(error) << "Cannot get post_ids of request " << req_id << ": "
                << memcached_strerror(memcached_client, memcached_rc);
     ServiceException se;
@@ -478,6 +501,23 @@ void PostStorageHandler::ReadPosts(
   delete[] keys;
   delete[] key_sizes;
 
+  // Misses that another request is already reading from MongoDB are waited
+  // for instead of being read again; this request reads the rest.
+  SingleFlight<Post>::Leader post_leader(&_post_flight);
+  std::map<int64_t, std::shared_future<Post>> post_flights;
+  for (auto it = post_ids_not_cached.begin();
+       it != post_ids_not_cached.end();) {
+    std::shared_future<Post> in_flight;
+    if (_post_flight.Join(std::to_string(*it), &post_leader, &in_flight)) {
+      post_flights.emplace(*it, in_flight);
+      it = post_ids_not_cached.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  span->SetTag("cache_misses_coalesced",
+               static_cast<int64_t>(post_flights.size()));
+
   std::vector<std::future<void>> set_futures;
   std::map<int64_t, std::string> post_json_map;
 
@@ -500,83 +540,118 @@ void PostStorageHandler::ReadPosts(
       mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
       throw se;
     }
-    bson_t *query = bson_new();
-    bson_t query_child;
-    bson_t query_post_id_list;
-    const char *key;
-    idx = 0;
-    char buf[16];
-
-    BSON_APPEND_DOCUMENT_BEGIN(query, "post_id", &query_child);
-    BSON_APPEND_ARRAY_BEGIN(&query_child, "$in", &query_post_id_list);
-    for (auto &item : post_ids_not_cached) {
-      bson_uint32_to_string(idx, &key, buf, sizeof buf);
-      BSON_APPEND_INT64(&query_post_id_list, key, item);
-      idx++;
-    }
-    bson_append_array_end(&query_child, &query_post_id_list);
-    bson_append_document_end(query, &query_child);
-    mongoc_cursor_t *cursor =
-        mongoc_collection_find_with_opts(collection, query, nullptr, nullptr);
-    const bson_t *doc;
-
+    // StorePost does not fill memcached, so a secondary may not have
+    // replicated a post read for the first time yet: look for the posts it
+    // misses again on the primary.
+    const mongoc_read_prefs_t *read_prefs =
+        get_stale_read_prefs(_mongodb_client_pool);
+    std::vector<int64_t> post_ids_to_find(post_ids_not_cached.begin(),
+                                          post_ids_not_cached.end());
     auto find_span = opentracing::Tracer::Global()->StartSpan(
         "mongo_find_client", {opentracing::ChildOf(&span->context())});
-    while (true) {
-      bool found = mongoc_cursor_next(cursor, &doc);
-      if (!found) {
-        break;
+    while (!post_ids_to_find.empty()) {
+      bson_t *query = bson_new();
+      bson_t query_child;
+      bson_t query_post_id_list;
+      const char *key;
+      idx = 0;
+      char buf[16];
+
+      BSON_APPEND_DOCUMENT_BEGIN(query, "post_id", &query_child);
+      BSON_APPEND_ARRAY_BEGIN(&query_child, "$in", &query_post_id_list);
+      for (auto &item : post_ids_to_find) {
+        bson_uint32_to_string(idx, &key, buf, sizeof buf);
+        BSON_APPEND_INT64(&query_post_id_list, key, item);
+        idx++;
       }
-      Post new_post;
-      char *post_json_char = bson_as_json(doc, nullptr);
-      json post_json = json::parse(post_json_char);
-      new_post.req_id = post_json["req_id"];
-      new_post.timestamp = post_json["timestamp"];
-      new_post.post_id = post_json["post_id"];
-      new_post.creator.user_id = post_json["creator"]["user_id"];
-      new_post.creator.username = post_json["creator"]["username"];
-      new_post.post_type = post_json["post_type"];
-      new_post.text = post_json["text"];
-      for (auto &item : post_json["media"]) {
-        Media media;
-        media.media_id = item["media_id"];
-        media.media_type = item["media_type"];
-        new_post.media.emplace_back(media);
+      bson_append_array_end(&query_child, &query_post_id_list);
+      bson_append_document_end(query, &query_child);
+      mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
+          collection, query, nullptr, read_prefs);
+      const bson_t *doc;
+
+      while (true) {
+        bool found = mongoc_cursor_next(cursor, &doc);
+        if (!found) {
+          break;
+        }
+        Post new_post;
+        char *post_json_char = bson_as_json(doc, nullptr);
+        json post_json = json::parse(post_json_char);
+        new_post.req_id = post_json["req_id"];
+        new_post.timestamp = post_json["timestamp"];
+        new_post.post_id = post_json["post_id"];
+        new_post.creator.user_id = post_json["creator"]["user_id"];
+        new_post.creator.username = post_json["creator"]["username"];
+        new_post.post_type = post_json["post_type"];
+        new_post.text = post_json["text"];
+        for (auto &item : post_json["media"]) {
+          Media media;
+          media.media_id = item["media_id"];
+          media.media_type = item["media_type"];
+          new_post.media.emplace_back(media);
+        }
+        for (auto &item : post_json["user_mentions"]) {
+          UserMention user_mention;
+          user_mention.username = item["username"];
+          user_mention.user_id = item["user_id"];
+          new_post.user_mentions.emplace_back(user_mention);
+        }
+        for (auto &item : post_json["urls"]) {
+          Url url;
+          url.shortened_url = item["shortened_url"];
+          url.expanded_url = item["expanded_url"];
+          new_post.urls.emplace_back(url);
+        }
+        post_json_map.insert({new_post.post_id, std::string(post_json_char)});
+        return_map.insert({new_post.post_id, new_post});
+        bson_free(post_json_char);
       }
-      for (auto &item : post_json["user_mentions"]) {
-        UserMention user_mention;
-        user_mention.username = item["username"];
-        user_mention.user_id = item["user_id"];
-        new_post.user_mentions.emplace_back(user_mention);
-      }
-      for (auto &item : post_json["urls"]) {
-        Url url;
-        url.shortened_url = item["shortened_url"];
-        url.expanded_url = item["expanded_url"];
-        new_post.urls.emplace_back(url);
+      bson_error_t error;
+      if (mongoc_cursor_error(cursor, &error)) {
+        LOG(warning) << error.message;
+        bson_destroy(query);
+        mongoc_cursor_destroy(cursor);
+        mongoc_collection_destroy(collection);
+        mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+        ServiceException se;
+        se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+        se.message = error.message;
+        throw se;
       }
-      post_json_map.insert({new_post.post_id, std::string(post_json_char)});
-      return_map.insert({new_post.post_id, new_post});
-      bson_free(post_json_char);
-    }
-    find_span->Finish();
-    bson_error_t error;
-    if (mongoc_cursor_error(cursor, &error)) {
-      LOG(warning) << error.message;
       bson_destroy(query);
       mongoc_cursor_destroy(cursor);
-      mongoc_collection_destroy(collection);
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = error.message;
-      throw se;
+      if (!read_prefs) {
+        break;
+      }
+      read_prefs = nullptr;
+      post_ids_to_find.erase(
+          std::remove_if(post_ids_to_find.begin(), post_ids_to_find.end(),
+                         [&](int64_t post_id) {
+                           return post_json_map.count(post_id) > 0;
+                         }),
+          post_ids_to_find.end());
     }
-    bson_destroy(query);
-    mongoc_cursor_destroy(cursor);
+    find_span->Finish();
     mongoc_collection_destroy(collection);
     mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
 
+    // Hand the posts to requests waiting for them, and fail the ones missing
+    // from MongoDB now: a request waiting below on a flight of ours must not
+    // be left waiting while we wait on one of its flights.
+    for (auto &post_id : post_ids_not_cached) {
+      if (post_json_map.find(post_id) != post_json_map.end()) {
+        post_leader.Complete(std::to_string(post_id), return_map[post_id]);
+      } else {
+        ServiceException se;
+        se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+        se.message = "Post_id: " + std::to_string(post_id) +
+                     " doesn't exist in MongoDB";
+        post_leader.Fail(std::to_string(post_id),
+                         std::make_exception_ptr(se));
+      }
+    }
+
     // upload posts to memcached
     set_futures.emplace_back(std::async(std::launch::async, [&]() {
       memcached_return_t _rc;
@@ -602,6 +677,14 @@ void PostStorageHandler::ReadPosts(
     }));
   }
 
+  for (auto &flight : post_flights) {
+    try {
+      return_map.emplace(flight.first, _post_flight.Wait(flight.second));
+    } catch (...) {
+      // Reported as an incomplete return set below.
+    }
+  }
+
   if (return_map.size() != post_ids.size()) {
     try {
       for (auto &it : set_futures) {
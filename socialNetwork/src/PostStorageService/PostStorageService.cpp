@@ -12,7 +12,6 @@
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -75,8 +74,8 @@ int main(int argc, char* argv[]) {
                              std::make_shared<PostStorageHandler>(
                                  memcached_client_pool, mongodb_client_pool)),
                          server_socket,
-                         std::make_shared<TFramedTransportFactory>(),
-                         std::make_shared<TBinaryProtocolFactory>());
+                         get_transport_factory(config_json),
+                         get_protocol_factory(config_json));
 
   LOG(info) << "Starting the post-storage-service server...";
   server.serve();
@@ -0,0 +1,248 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_RESUMABLESSLSOCKET_H
+#define SOCIAL_NETWORK_MICROSERVICES_RESUMABLESSLSOCKET_H
+
+#include <openssl/ssl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <thrift/transport/TSSLSocket.h>
+#include <nlohmann/json.hpp>
+
+#include "logger.h"
+
+namespace social_network {
+using json = nlohmann::json;
+using apache::thrift::transport::AccessManager;
+using apache::thrift::transport::DefaultClientAccessManager;
+using apache::thrift::transport::SSLContext;
+using apache::thrift::transport::TSSLSocket;
+using apache::thrift::transport::TSSLSocketFactory;
+
+// The latest TLS session of every "host:port" a process connects to.
+class SslSessionCache {
+ public:
+  SslSessionCache() = default;
+  SslSessionCache(const SslSessionCache &) = delete;
+  SslSessionCache &operator=(const SslSessionCache &) = delete;
+  ~SslSessionCache() {
+    for (auto &session : _sessions) {
+      SSL_SESSION_free(session.second);
+    }
+  }
+
+  // Offers the session of target, if any, in the handshake of ssl. Returns
+  // whether there was one.
+  bool SetSession(const std::string &target, SSL *ssl) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto it = _sessions.find(target);
+    // SSL_set_session() takes its own reference.
+    return it != _sessions.end() && SSL_set_session(ssl, it->second) == 1;
+  }
+
+  // Takes over the reference to session.
+  void Put(const std::string &target, SSL_SESSION *session) {
+    SSL_SESSION *old = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      auto &entry = _sessions[target];
+      old = entry;
+      entry = session;
+    }
+    if (old) {
+      SSL_SESSION_free(old);
+    }
+  }
+
+ private:
+  std::mutex _mtx;
+  std::unordered_map<std::string, SSL_SESSION *> _sessions;
+};
+
+// Client socket that offers the previous session of its target in the
+// ClientHello, so that the server can skip the certificate exchange and key
+// agreement, and saves the session it ends up with for the next connection.
+class ResumableSSLSocket : public TSSLSocket {
+ public:
+  ResumableSSLSocket(std::shared_ptr<SSLContext> ctx, const std::string &host,
+                     int port, SslSessionCache *sessions,
+                     std::atomic<uint64_t> *full_handshakes,
+                     std::atomic<uint64_t> *resumed_handshakes)
+      : TSSLSocket(ctx, host, port),
+        _target(host + ":" + std::to_string(port)),
+        _sessions(sessions),
+        _full_handshakes(full_handshakes),
+        _resumed_handshakes(resumed_handshakes) {}
+
+  void open() override {
+    TSSLSocket::open();
+    if (!_sessions) {
+      return;
+    }
+    // The session has to be in place before the first SSL_connect(). The
+    // handshake then finds ssl_ set up and leaves it alone.
+    if (!ssl_) {
+      initializeHandshakeParams();
+    }
+    _sessions->SetSession(_target, ssl_);
+  }
+
+  void close() override {
+    // TLS 1.3 servers send their tickets after the handshake.
+    SaveSession();
+    TSSLSocket::close();
+  }
+
+ protected:
+  // Called once the handshake has completed.
+  void authorize() override {
+    TSSLSocket::authorize();
+    if (SSL_session_reused(ssl_)) {
+      _resumed_handshakes->fetch_add(1, std::memory_order_relaxed);
+    } else {
+      _full_handshakes->fetch_add(1, std::memory_order_relaxed);
+    }
+    SaveSession();
+  }
+
+ private:
+  void SaveSession() {
+    if (!_sessions || !ssl_ || !SSL_is_init_finished(ssl_)) {
+      return;
+    }
+    SSL_SESSION *session = SSL_get1_session(ssl_);
+    if (session) {
+      _sessions->Put(_target, session);
+    }
+  }
+
+  std::string _target;
+  SslSessionCache *_sessions;
+  std::atomic<uint64_t> *_full_handshakes;
+  std::atomic<uint64_t> *_resumed_handshakes;
+};
+
+// TSSLSocketFactory whose client sockets resume the sessions of their
+// targets, and whose server sockets accept resumption by session ID and by
+// session ticket. A process has one client factory, from
+// GetClientSSLSocketFactory(), and a separate one with its own SSL_CTX for
+// its server socket.
+class ResumableSSLSocketFactory : public TSSLSocketFactory {
+ public:
+  ResumableSSLSocketFactory() : _full_handshakes(0), _resumed_handshakes(0) {}
+
+  using TSSLSocketFactory::createSocket;
+  std::shared_ptr<TSSLSocket> createSocket(const std::string &host,
+                                           int port) override {
+    auto socket = std::make_shared<ResumableSSLSocket>(
+        ctx_, host, port, _resume ? &_sessions : nullptr, &_full_handshakes,
+        &_resumed_handshakes);
+    // As TSSLSocketFactory does for client sockets
+    socket->access(_access);
+    return socket;
+  }
+
+  void EnableClientResumption() { _resume = true; }
+
+  uint64_t FullHandshakes() const { return _full_handshakes.load(); }
+  uint64_t ResumedHandshakes() const { return _resumed_handshakes.load(); }
+
+  // Sessions stay resumable for timeout_s. Ticket keys shared by all
+  // replicas of a service let a session made with one resume on another;
+  // without ticket_key_path every process draws its own.
+  bool EnableServerResumption(const std::string &session_id_context,
+                              long timeout_s,
+                              const std::string &ticket_key_path) {
+    SSL_CTX *ctx = ctx_->get();
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_set_session_id_context(
+        ctx, reinterpret_cast<const unsigned char *>(session_id_context.data()),
+        std::min<size_t>(session_id_context.size(),
+                         SSL_MAX_SID_CTX_LENGTH));
+    SSL_CTX_set_timeout(ctx, timeout_s);
+    SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+    if (ticket_key_path.empty()) {
+      return true;
+    }
+    // Key name, HMAC secret and AES key of the tickets: 48 bytes with
+    // OpenSSL 1.0.2, 80 bytes from 1.1.0 on.
+    long length = SSL_CTX_set_tlsext_ticket_keys(ctx, nullptr, 0);
+    std::vector<char> keys(length);
+    std::ifstream file(ticket_key_path, std::ios::binary);
+    if (!file.read(keys.data(), keys.size()) ||
+        SSL_CTX_set_tlsext_ticket_keys(ctx, keys.data(), keys.size()) != 1) {
+      LOG(error) << "Failed to load " << length
+                 << " bytes of session ticket keys from " << ticket_key_path;
+      return false;
+    }
+    return true;
+  }
+
+  // Logs the full and resumed handshakes of factory every interval_ms.
+  // Client handshakes are counted by the sockets, server handshakes by
+  // OpenSSL in the SSL_CTX of factory, so each factory reports only its own
+  // side.
+  static void StartStatsLogger(
+      std::shared_ptr<ResumableSSLSocketFactory> factory, int interval_ms) {
+    std::thread([factory, interval_ms]() {
+      while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        SSL_CTX *ctx = factory->ctx_->get();
+        long accepted = SSL_CTX_sess_accept_good(ctx);
+        long resumed = SSL_CTX_sess_hits(ctx);
+        if (accepted > 0) {
+          LOG(info) << "TLS server handshakes: " << accepted - resumed
+                    << " full, " << resumed << " resumed";
+        }
+        uint64_t full = factory->FullHandshakes();
+        uint64_t client_resumed = factory->ResumedHandshakes();
+        if (full + client_resumed > 0) {
+          LOG(info) << "TLS client handshakes: " << full << " full, "
+                    << client_resumed << " resumed";
+        }
+      }
+    }).detach();
+  }
+
+ private:
+  bool _resume = false;
+  SslSessionCache _sessions;
+  std::shared_ptr<AccessManager> _access =
+      std::make_shared<DefaultClientAccessManager>();
+  std::atomic<uint64_t> _full_handshakes;
+  std::atomic<uint64_t> _resumed_handshakes;
+};
+
+// The factory of every TLS client of the process, built from the "ssl"
+// section on first use. Loading the CA and creating an SSL_CTX per
+// connection used to cost as much as the handshake itself.
+std::shared_ptr<TSSLSocketFactory> GetClientSSLSocketFactory(
+    const json &config_json) {
+  static std::shared_ptr<ResumableSSLSocketFactory> factory = [&config_json]() {
+    std::string ca_path = config_json["ssl"]["caPath"];
+    std::string ciphers = config_json["ssl"]["ciphers"];
+    auto ssl_factory = std::make_shared<ResumableSSLSocketFactory>();
+    ssl_factory->ciphers(ciphers);
+    ssl_factory->loadTrustedCertificates(ca_path.c_str());
+    // Need verify server
+    ssl_factory->authenticate(true);
+    if (config_json["ssl"].value("sessionResumption", true)) {
+      ssl_factory->EnableClientResumption();
+    }
+    ResumableSSLSocketFactory::StartStatsLogger(
+        ssl_factory, config_json["ssl"].value("statsIntervalMs", 60000));
+    return ssl_factory;
+  }();
+  return factory;
+}
+
+} // namespace social_network
+
+#endif //SOCIAL_NETWORK_MICROSERVICES_RESUMABLESSLSOCKET_H
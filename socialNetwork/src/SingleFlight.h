@@ -0,0 +1,197 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_SRC_SINGLEFLIGHT_H_
+#define SOCIAL_NETWORK_MICROSERVICES_SRC_SINGLEFLIGHT_H_
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "logger.h"
+
+namespace social_network {
+
+// Coalesces concurrent cache misses on the same key: the first caller (the
+// leader) runs the fetch, which reads the database and refills the cache, and
+// callers that miss on the same key while it runs wait for its result instead
+// of issuing their own fetch. Exceptions thrown by the fetch are rethrown to
+// every waiter.
+//
+// Per-instance counters are available through GetStats() and are logged at
+// most once per report interval while there is coalescing activity.
+template <typename T>
+class SingleFlight {
+ private:
+  struct Call {
+    std::promise<T> promise;
+    std::shared_future<T> result;
+  };
+
+ public:
+  struct Stats {
+    uint64_t fetches;    // misses that ran a fetch
+    uint64_t coalesced;  // misses that waited for another caller's fetch
+    uint64_t wait_us;    // total time spent waiting by coalesced misses
+  };
+
+  // Owns the keys a caller leads, for callers that fetch several keys at once
+  // (e.g. with one $in query). Keys that are neither completed nor failed
+  // when the Leader goes out of scope are failed, so waiters never hang.
+  class Leader {
+   public:
+    explicit Leader(SingleFlight *flight) : _flight(flight) {}
+    Leader(const Leader &) = delete;
+    Leader &operator=(const Leader &) = delete;
+    ~Leader() {
+      for (auto &call : _calls) {
+        _flight->Finish(call.first, call.second, [&](Call *c) {
+          c->promise.set_exception(std::make_exception_ptr(std::runtime_error(
+              "Fetch of " + call.first + " was abandoned")));
+        });
+      }
+    }
+
+    bool empty() const { return _calls.empty(); }
+
+    void Complete(const std::string &key, const T &value) {
+      Release(key, [&](Call *c) { c->promise.set_value(value); });
+    }
+
+    void Fail(const std::string &key, std::exception_ptr error) {
+      Release(key, [&](Call *c) { c->promise.set_exception(error); });
+    }
+
+   private:
+    friend class SingleFlight;
+
+    void Release(const std::string &key, const std::function<void(Call *)> &fn) {
+      auto it = _calls.find(key);
+      if (it != _calls.end()) {
+        _flight->Finish(key, it->second, fn);
+        _calls.erase(it);
+      }
+    }
+
+    SingleFlight *_flight;
+    std::map<std::string, std::shared_ptr<Call>> _calls;
+  };
+
+  explicit SingleFlight(const std::string &name,
+                        std::chrono::seconds report_interval =
+                            std::chrono::seconds(60))
+      : _name(name), _report_interval(report_interval) {
+    _fetches = 0;
+    _coalesced = 0;
+    _wait_us = 0;
+    _last_report_s = NowSeconds();
+  }
+
+  // Returns false and makes leader the owner of key if nobody is fetching
+  // key; the caller must then fetch it and Complete() or Fail() it through
+  // leader. Returns true with the in-flight result if somebody is.
+  bool Join(const std::string &key, Leader *leader,
+            std::shared_future<T> *in_flight) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _calls.find(key);
+    if (it != _calls.end()) {
+      *in_flight = it->second->result;
+      return true;
+    }
+    auto call = std::make_shared<Call>();
+    call->result = call->promise.get_future().share();
+    _calls.emplace(key, call);
+    leader->_calls.emplace(key, call);
+    _fetches++;
+    return false;
+  }
+
+  // Waits for a result returned by Join().
+  T Wait(const std::shared_future<T> &in_flight) {
+    auto start = std::chrono::steady_clock::now();
+    in_flight.wait();
+    _coalesced++;
+    _wait_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    MaybeReport();
+    return in_flight.get();
+  }
+
+  // Runs fetch for key, or waits for the fetch already running for key.
+  T Do(const std::string &key, const std::function<T()> &fetch,
+       bool *coalesced = nullptr) {
+    Leader leader(this);
+    std::shared_future<T> in_flight;
+    bool joined = Join(key, &leader, &in_flight);
+    if (coalesced) {
+      *coalesced = joined;
+    }
+    if (joined) {
+      return Wait(in_flight);
+    }
+    try {
+      T value = fetch();
+      leader.Complete(key, value);
+      return value;
+    } catch (...) {
+      leader.Fail(key, std::current_exception());
+      throw;
+    }
+  }
+
+  Stats GetStats() const {
+    return Stats{_fetches.load(), _coalesced.load(), _wait_us.load()};
+  }
+
+ private:
+  static int64_t NowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // Publishes the result of call and then retires it, so callers that join
+  // in between still get the result without fetching.
+  void Finish(const std::string &key, const std::shared_ptr<Call> &call,
+              const std::function<void(Call *)> &fn) {
+    fn(call.get());
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _calls.find(key);
+    if (it != _calls.end() && it->second == call) {
+      _calls.erase(it);
+    }
+  }
+
+  void MaybeReport() {
+    int64_t now = NowSeconds();
+    int64_t last = _last_report_s.load();
+    if (now - last < _report_interval.count() ||
+        !_last_report_s.compare_exchange_strong(last, now)) {
+      return;
+    }
+    auto stats = GetStats();
+    LOG(info) << "Cache miss coalescing (" << _name << "): " << stats.fetches
+              << " fetches, " << stats.coalesced << " coalesced misses, "
+              << (stats.coalesced ? stats.wait_us / stats.coalesced : 0)
+              << " us average wait";
+  }
+
+  std::string _name;
+  std::chrono::seconds _report_interval;
+  std::mutex _mutex;
+  std::unordered_map<std::string, std::shared_ptr<Call>> _calls;
+  std::atomic<uint64_t> _fetches;
+  std::atomic<uint64_t> _coalesced;
+  std::atomic<uint64_t> _wait_us;
+  std::atomic<int64_t> _last_report_s;
+};
+
+}  // namespace social_network
+
+#endif  // SOCIAL_NETWORK_MICROSERVICES_SRC_SINGLEFLIGHT_H_
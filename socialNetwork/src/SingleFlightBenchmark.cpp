@@ -0,0 +1,141 @@
+/*
+ * Counters of SingleFlight after controlled runs, and coalescing under a
+ * herd of cache misses.
+ *
+ * Usage: SingleFlightBenchmark [threads] [rounds] [fetch ms]
+ *
+ * First makes threads - 1 callers wait on the fetch of one leader per round,
+ * completing half of the rounds and failing the other half, and fails unless
+ * GetStats() counts exactly one fetch per round, every waiter as coalesced,
+ * and at least the time the leader held the fetch as wait time. Then has all
+ * threads call Do() on one key per round with a fetch of [fetch ms], as
+ * concurrent misses on a hot post do, and reports the fetches, coalesced
+ * misses and average wait.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "SingleFlight.h"
+
+using namespace social_network;
+
+int main(int argc, char *argv[]) {
+  int num_threads = argc > 1 ? std::atoi(argv[1]) : 16;
+  int num_rounds = argc > 2 ? std::atoi(argv[2]) : 100;
+  int fetch_ms = argc > 3 ? std::atoi(argv[3]) : 2;
+  if (num_threads < 2 || num_rounds <= 0 || fetch_ms < 0) {
+    std::cerr << "Usage: " << argv[0] << " [threads] [rounds] [fetch ms]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  init_logger();
+
+  SingleFlight<int> flight("controlled");
+  uint64_t min_wait_us = 0;
+  for (int round = 0; round < num_rounds; ++round) {
+    std::string key = "key-" + std::to_string(round);
+    SingleFlight<int>::Leader leader(&flight);
+    std::shared_future<int> in_flight;
+    if (flight.Join(key, &leader, &in_flight)) {
+      std::cerr << "Nobody was fetching " << key << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::atomic<int> joined(0);
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> waiters;
+    for (int i = 1; i < num_threads; ++i) {
+      waiters.emplace_back([&]() {
+        std::shared_future<int> result;
+        SingleFlight<int>::Leader unused(&flight);
+        if (!flight.Join(key, &unused, &result)) {
+          wrong++;
+          joined++;
+          return;
+        }
+        joined++;
+        try {
+          if (flight.Wait(result) != round || round % 2 == 1) {
+            wrong++;
+          }
+        } catch (const std::runtime_error &) {
+          if (round % 2 == 0) {
+            wrong++;
+          }
+        }
+      });
+    }
+    while (joined.load() < num_threads - 1) {
+      std::this_thread::yield();
+    }
+    auto held = std::chrono::milliseconds(1);
+    std::this_thread::sleep_for(held);
+    if (round % 2 == 0) {
+      leader.Complete(key, round);
+    } else {
+      leader.Fail(key, std::make_exception_ptr(std::runtime_error("failed")));
+    }
+    for (auto &waiter : waiters) {
+      waiter.join();
+    }
+    if (wrong.load() > 0) {
+      std::cerr << wrong.load() << " waiters of " << key
+                << " got a wrong result" << std::endl;
+      return EXIT_FAILURE;
+    }
+    min_wait_us += (num_threads - 1) * 1000 * held.count();
+  }
+  auto stats = flight.GetStats();
+  uint64_t expected_coalesced =
+      static_cast<uint64_t>(num_rounds) * (num_threads - 1);
+  if (stats.fetches != static_cast<uint64_t>(num_rounds) ||
+      stats.coalesced != expected_coalesced || stats.wait_us < min_wait_us) {
+    std::cerr << "Counted " << stats.fetches << " fetches, "
+              << stats.coalesced << " coalesced and " << stats.wait_us
+              << " us of waiting, expected " << num_rounds << ", "
+              << expected_coalesced << " and at least " << min_wait_us
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "controlled: " << stats.fetches << " fetches, "
+            << stats.coalesced << " coalesced misses, as expected"
+            << std::endl;
+
+  SingleFlight<int> herd("herd");
+  std::atomic<uint64_t> fetches(0);
+  for (int round = 0; round < num_rounds; ++round) {
+    std::string key = "key-" + std::to_string(round);
+    std::vector<std::thread> callers;
+    for (int i = 0; i < num_threads; ++i) {
+      callers.emplace_back([&]() {
+        herd.Do(key, [&]() {
+          fetches++;
+          std::this_thread::sleep_for(std::chrono::milliseconds(fetch_ms));
+          return round;
+        });
+      });
+    }
+    for (auto &caller : callers) {
+      caller.join();
+    }
+  }
+  stats = herd.GetStats();
+  if (stats.fetches != fetches.load() ||
+      stats.fetches + stats.coalesced !=
+          static_cast<uint64_t>(num_rounds) * num_threads) {
+    std::cerr << "Counted " << stats.fetches << " fetches and "
+              << stats.coalesced << " coalesced misses for "
+              << fetches.load() << " fetches of "
+              << num_rounds * num_threads << " calls" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "herd of " << num_threads << ": " << stats.fetches
+            << " fetches, " << stats.coalesced << " coalesced misses, "
+            << (stats.coalesced ? stats.wait_us / stats.coalesced : 0)
+            << " us average wait" << std::endl;
+  return EXIT_SUCCESS;
+}
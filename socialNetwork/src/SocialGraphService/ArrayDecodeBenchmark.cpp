@@ -0,0 +1,131 @@
+/*
+ * Cost of rebuilding a follower list from its social-graph document, as
+ * GetFollowers does on a Redis miss.
+ *
+ * Usage: ArrayDecodeBenchmark [list length]...
+ *
+ * Builds a document with a "followers" array of {user_id, timestamp} of each
+ * length (10000 and 100000 by default) and decodes it with one
+ * bson_iter_find_descendant("followers.<idx>.<field>") lookup per field, as
+ * the handlers did, and with a single ForEachArrayDocument pass. Reports the
+ * time per rebuild of both.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../utils.h"
+#include "../utils_mongodb.h"
+
+using namespace social_network;
+
+static bson_t *NewGraphDoc(int64_t length) {
+  bson_t *doc = bson_new();
+  BSON_APPEND_INT64(doc, "user_id", 0);
+  bson_t array;
+  BSON_APPEND_ARRAY_BEGIN(doc, "followers", &array);
+  char key_buf[16];
+  const char *key;
+  for (int64_t i = 0; i < length; ++i) {
+    bson_uint32_to_string(i, &key, key_buf, sizeof(key_buf));
+    bson_t edge;
+    bson_append_document_begin(&array, key, -1, &edge);
+    BSON_APPEND_INT64(&edge, "user_id", i + 1);
+    BSON_APPEND_INT64(&edge, "timestamp", 1600000000000 + i);
+    bson_append_document_end(&array, &edge);
+  }
+  bson_append_array_end(doc, &array);
+  return doc;
+}
+
+// The loop GetFollowers ran before ForEachArrayDocument
+static void DecodeByPath(const bson_t *doc, std::vector<int64_t> *user_ids,
+                         std::vector<int64_t> *timestamps) {
+  bson_iter_t iter_0;
+  bson_iter_t iter_1;
+  bson_iter_t user_id_child;
+  bson_iter_t timestamp_child;
+  int index = 0;
+  bson_iter_init(&iter_0, doc);
+  bson_iter_init(&iter_1, doc);
+  while (bson_iter_find_descendant(
+             &iter_0,
+             ("followers." + std::to_string(index) + ".user_id").c_str(),
+             &user_id_child) &&
+         BSON_ITER_HOLDS_INT64(&user_id_child) &&
+         bson_iter_find_descendant(
+             &iter_1,
+             ("followers." + std::to_string(index) + ".timestamp").c_str(),
+             &timestamp_child) &&
+         BSON_ITER_HOLDS_INT64(&timestamp_child)) {
+    user_ids->emplace_back(bson_iter_int64(&user_id_child));
+    timestamps->emplace_back(bson_iter_int64(&timestamp_child));
+    bson_iter_init(&iter_0, doc);
+    bson_iter_init(&iter_1, doc);
+    index++;
+  }
+}
+
+static void DecodeInOnePass(const bson_t *doc, std::vector<int64_t> *user_ids,
+                            std::vector<int64_t> *timestamps) {
+  ForEachArrayDocument(doc, "followers",
+      [&](const bson_iter_t *follower, int idx) {
+    int64_t user_id;
+    int64_t timestamp;
+    if (!GetInt64Field(follower, "user_id", &user_id) ||
+        !GetInt64Field(follower, "timestamp", &timestamp)) {
+      return false;
+    }
+    user_ids->emplace_back(user_id);
+    timestamps->emplace_back(timestamp);
+    return true;
+  });
+}
+
+// Seconds per call of decode, repeated for at least half a second
+template <class F>
+static double SecondsPerRebuild(const bson_t *doc, int64_t length, F decode) {
+  int64_t rebuilds = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    std::vector<int64_t> user_ids;
+    std::vector<int64_t> timestamps;
+    decode(doc, &user_ids, &timestamps);
+    if (static_cast<int64_t>(user_ids.size()) != length ||
+        static_cast<int64_t>(timestamps.size()) != length) {
+      std::cerr << "Decoded " << user_ids.size() << " of " << length
+                << " followers" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    rebuilds++;
+    elapsed = std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  } while (elapsed < 0.5);
+  return elapsed / rebuilds;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<int64_t> lengths;
+  for (int i = 1; i < argc; ++i) {
+    lengths.emplace_back(std::atoll(argv[i]));
+  }
+  if (lengths.empty()) {
+    lengths = {10000, 100000};
+  }
+
+  for (int64_t length : lengths) {
+    bson_t *doc = NewGraphDoc(length);
+    double by_path = SecondsPerRebuild(doc, length, DecodeByPath);
+    double one_pass = SecondsPerRebuild(doc, length, DecodeInOnePass);
+    std::cout << length << " followers: find_descendant " << 1e3 * by_path
+              << " ms, ForEachArrayDocument " << 1e3 * one_pass
+              << " ms per rebuild" << std::endl;
+    bson_destroy(doc);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_SOCIALGRAPHEDGES_H
+#define SOCIAL_NETWORK_MICROSERVICES_SOCIALGRAPHEDGES_H
+
+#include <bson/bson.h>
+#include <mongoc.h>
+
+#include <string>
+
+#include "../logger.h"
+#include "../utils.h"
+#include "../utils_mongodb.h"
+
+// Edge-collection layout of the social graph: one document
+// {follower_id, followee_id, timestamp} per follow relationship, stored next
+// to the embedded-array "social-graph" collection in the same database.
+#define SOCIAL_GRAPH_EDGE_COLLECTION "social-graph-edges"
+#define SOCIAL_GRAPH_MIGRATION_BATCH_SIZE 1000
+
+namespace social_network {
+
+bool CreateEdgeIndexes(mongoc_client_t *mongodb_client) {
+  // Both directions are unique so either index can serve as the identity of
+  // an edge; each one turns a follower/followee listing into a range scan.
+  return CreateCompoundIndex(mongodb_client, "social-graph",
+                             SOCIAL_GRAPH_EDGE_COLLECTION,
+                             {"follower_id", "followee_id"}, true) &&
+         CreateCompoundIndex(mongodb_client, "social-graph",
+                             SOCIAL_GRAPH_EDGE_COLLECTION,
+                             {"followee_id", "follower_id"}, true);
+}
+
+static bool AppendEdgeUpsert(mongoc_bulk_operation_t *bulk,
+                             int64_t follower_id, int64_t followee_id,
+                             int64_t timestamp) {
+  bson_t *selector = BCON_NEW("follower_id", BCON_INT64(follower_id),
+                              "followee_id", BCON_INT64(followee_id));
+  bson_t *update = BCON_NEW("$setOnInsert", "{", "timestamp",
+                            BCON_INT64(timestamp), "}");
+  bson_t *opts = BCON_NEW("upsert", BCON_BOOL(true));
+  bson_error_t error;
+  bool ret = mongoc_bulk_operation_update_one_with_opts(bulk, selector, update,
+                                                        opts, &error);
+  if (!ret) {
+    LOG(error) << "Failed to queue edge upsert: " << error.message;
+  }
+  bson_destroy(opts);
+  bson_destroy(update);
+  bson_destroy(selector);
+  return ret;
+}
+
+static bool AppendEmbeddedEdges(mongoc_bulk_operation_t *bulk,
+                                const bson_t *doc, int64_t user_id,
+                                const char *field, bool is_followees,
+                                int *num_ops) {
+  bool success = true;
+  ForEachArrayDocument(doc, field, [&](const bson_iter_t *edge, int idx) {
+    int64_t neighbor_id;
+    int64_t timestamp = 0;
+    if (!GetInt64Field(edge, "user_id", &neighbor_id)) {
+      return true;
+    }
+    GetInt64Field(edge, "timestamp", &timestamp);
+    success = is_followees
+                  ? AppendEdgeUpsert(bulk, user_id, neighbor_id, timestamp)
+                  : AppendEdgeUpsert(bulk, neighbor_id, user_id, timestamp);
+    if (success) {
+      (*num_ops)++;
+    }
+    return success;
+  });
+  return success;
+}
+
+// Copies every edge found in the embedded followers/followees arrays into
+// the edge collection. Edges are upserted with $setOnInsert, so the
+// migration can be interrupted and re-run, and it can run while the service
+// is already writing to the edge collection.
+bool MigrateEmbeddedEdges(mongoc_client_pool_t *mongodb_client_pool) {
+  mongoc_client_t *mongodb_client = mongoc_client_pool_pop(mongodb_client_pool);
+  if (!mongodb_client) {
+    LOG(error) << "Failed to pop a client from MongoDB pool";
+    return false;
+  }
+  auto collection = mongoc_client_get_collection(
+      mongodb_client, "social-graph", "social-graph");
+  auto edge_collection = mongoc_client_get_collection(
+      mongodb_client, "social-graph", SOCIAL_GRAPH_EDGE_COLLECTION);
+  if (!collection || !edge_collection) {
+    LOG(error) << "Failed to create collection social_graph from MongoDB";
+    if (collection) {
+      mongoc_collection_destroy(collection);
+    }
+    if (edge_collection) {
+      mongoc_collection_destroy(edge_collection);
+    }
+    mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
+    return false;
+  }
+
+  bson_t *query = bson_new();
+  bson_t *find_opts = BCON_NEW("projection", "{", "_id", BCON_BOOL(false), "}");
+  bson_t *bulk_opts = BCON_NEW("ordered", BCON_BOOL(false));
+  mongoc_cursor_t *cursor =
+      mongoc_collection_find_with_opts(collection, query, find_opts, nullptr);
+
+  bool success = true;
+  int64_t num_users = 0;
+  int64_t num_edges = 0;
+  int num_ops = 0;
+  bson_error_t error;
+  bson_t reply;
+  mongoc_bulk_operation_t *bulk =
+      mongoc_collection_create_bulk_operation_with_opts(edge_collection,
+                                                        bulk_opts);
+  const bson_t *doc;
+  bson_iter_t iter;
+  while (success && mongoc_cursor_next(cursor, &doc)) {
+    if (!bson_iter_init_find(&iter, doc, "user_id") ||
+        !BSON_ITER_HOLDS_INT64(&iter)) {
+      continue;
+    }
+    int64_t user_id = bson_iter_int64(&iter);
+    success = AppendEmbeddedEdges(bulk, doc, user_id, "followees", true,
+                                  &num_ops) &&
+              AppendEmbeddedEdges(bulk, doc, user_id, "followers", false,
+                                  &num_ops);
+    num_users++;
+    if (success && num_ops >= SOCIAL_GRAPH_MIGRATION_BATCH_SIZE) {
+      success = mongoc_bulk_operation_execute(bulk, &reply, &error);
+      if (!success) {
+        LOG(error) << "Failed to migrate social graph edges: "
+                   << error.message;
+      }
+      bson_destroy(&reply);
+      mongoc_bulk_operation_destroy(bulk);
+      bulk = mongoc_collection_create_bulk_operation_with_opts(
+          edge_collection, bulk_opts);
+      num_edges += num_ops;
+      num_ops = 0;
+    }
+  }
+  if (success && mongoc_cursor_error(cursor, &error)) {
+    LOG(error) << "Failed to read social graph from MongoDB: "
+               << error.message;
+    success = false;
+  }
+  if (success && num_ops > 0) {
+    success = mongoc_bulk_operation_execute(bulk, &reply, &error);
+    if (!success) {
+      LOG(error) << "Failed to migrate social graph edges: " << error.message;
+    }
+    bson_destroy(&reply);
+    num_edges += num_ops;
+  }
+
+  mongoc_bulk_operation_destroy(bulk);
+  bson_destroy(bulk_opts);
+  bson_destroy(find_opts);
+  bson_destroy(query);
+  mongoc_cursor_destroy(cursor);
+  mongoc_collection_destroy(edge_collection);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
+
+  if (success) {
+    LOG(info) << "Migrated " << num_edges << " embedded edge entries of "
+              << num_users << " users to " << SOCIAL_GRAPH_EDGE_COLLECTION;
+  }
+  return success;
+}
+
+}  // namespace social_network
+
+#endif  // SOCIAL_NETWORK_MICROSERVICES_SOCIALGRAPHEDGES_H
@@ -6,6 +6,7 @@
 #include <sw/redis++/redis++.h>
 
 #include <chrono>
+#include <functional>
 #include <future>
 #include <iostream>
 #include <string>
@@ -15,9 +16,15 @@
 #include "../../gen-cpp/SocialGraphService.h"
 #include "../../gen-cpp/UserService.h"
 #include "../ClientPool.h"
+#include "../SingleFlight.h"
 #include "../ThriftClient.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "../utils.h"
+#include "../utils_mongodb.h"
+#include "../utils_redis.h"
+#include "SocialGraphEdges.h"
+#include "SocialGraphIndex.h"
 
 using namespace sw::redis;
 
@@ -30,11 +37,14 @@ using std::chrono::system_clock;
 class SocialGraphHandler : public SocialGraphServiceIf {
  public:
   SocialGraphHandler(mongoc_client_pool_t *, Redis *,
-                     ClientPool<ThriftClient<UserServiceClient>> *);
-  SocialGraphHandler(mongoc_client_pool_t *, Redis *, Redis *,
-      ClientPool<ThriftClient<UserServiceClient>>*);
+                     ClientPool<ThriftClient<UserServiceClient>> *,
+                     SocialGraphIndex * = nullptr, bool = false);
+  SocialGraphHandler(mongoc_client_pool_t *, RedisReplicas *, Redis *,
+      ClientPool<ThriftClient<UserServiceClient>>*,
+      SocialGraphIndex * = nullptr, bool = false);
   SocialGraphHandler(mongoc_client_pool_t *, RedisCluster *,
-                     ClientPool<ThriftClient<UserServiceClient>> *);
+                     ClientPool<ThriftClient<UserServiceClient>> *,
+                     SocialGraphIndex * = nullptr, bool = false);
   ~SocialGraphHandler() override = default;
   bool IsRedisReplicationEnabled();
   void GetFollowers(std::vector<int64_t> &, int64_t, int64_t,
@@ -52,54 +62,217 @@ class SocialGraphHandler : public SocialGraphServiceIf {
       const std::map<std::string, std::string> &) override;
   void InsertUser(int64_t, int64_t,
                   const std::map<std::string, std::string> &) override;
+  void FollowMany(int64_t, const std::vector<int64_t> &,
+                  const std::vector<int64_t> &,
+                  const std::map<std::string, std::string> &) override;
+  void InsertUsers(int64_t, const std::vector<int64_t> &,
+                   const std::map<std::string, std::string> &) override;
 
  private:
   mongoc_client_pool_t *_mongodb_client_pool;
   Redis *_redis_client_pool;
-  Redis *_redis_replica_client_pool;
+  RedisReplicas *_redis_replica_client_pool;
   Redis *_redis_primary_client_pool;
   RedisCluster *_redis_cluster_client_pool;
   ClientPool<ThriftClient<UserServiceClient>> *_user_service_client_pool;
+  SocialGraphIndex *_graph_index;
+  bool _use_edge_collection;
+  // Follower and followee misses, keyed by their Redis key.
+  SingleFlight<std::vector<int64_t>> _neighbors_flight;
+
+  void UpdateEdge(int64_t, int64_t, int64_t, bool,
+                  const opentracing::SpanContext &);
+  void FindEdges(int64_t, bool, std::vector<int64_t> *,
+                 std::multimap<std::string, double> *,
+                 const opentracing::SpanContext &);
+  void ExecuteBulk(const char *, const std::function<bool(
+                                     mongoc_bulk_operation_t *)> &,
+                   const opentracing::SpanContext &);
 };
 
 SocialGraphHandler::SocialGraphHandler(
     mongoc_client_pool_t *mongodb_client_pool, Redis *redis_client_pool,
-    ClientPool<ThriftClient<UserServiceClient>> *user_service_client_pool) {
+    ClientPool<ThriftClient<UserServiceClient>> *user_service_client_pool,
+    SocialGraphIndex *graph_index, bool use_edge_collection)
+    : _neighbors_flight("social-graph-neighbors") {
   _mongodb_client_pool = mongodb_client_pool;
   _redis_client_pool = redis_client_pool;
   _redis_replica_client_pool = nullptr;
   _redis_primary_client_pool = nullptr;
   _redis_cluster_client_pool = nullptr;
   _user_service_client_pool = user_service_client_pool;
+  _graph_index = graph_index;
+  _use_edge_collection = use_edge_collection;
 }
 
 SocialGraphHandler::SocialGraphHandler(
-    mongoc_client_pool_t* mongodb_client_pool, Redis* redis_replica_client_pool, Redis* redis_primary_client_pool,
-    ClientPool<ThriftClient<UserServiceClient>>* user_service_client_pool) {
+    mongoc_client_pool_t* mongodb_client_pool, RedisReplicas* redis_replica_client_pool, Redis* redis_primary_client_pool,
+    ClientPool<ThriftClient<UserServiceClient>>* user_service_client_pool,
+    SocialGraphIndex* graph_index, bool use_edge_collection)
+    : _neighbors_flight("social-graph-neighbors") {
     _mongodb_client_pool = mongodb_client_pool;
     _redis_client_pool = nullptr;
     _redis_replica_client_pool = redis_replica_client_pool;
     _redis_primary_client_pool = redis_primary_client_pool;
     _redis_cluster_client_pool = nullptr;
     _user_service_client_pool = user_service_client_pool;
+    _graph_index = graph_index;
+    _use_edge_collection = use_edge_collection;
 }
 
 SocialGraphHandler::SocialGraphHandler(
     mongoc_client_pool_t *mongodb_client_pool,
     RedisCluster *redis_cluster_client_pool,
-    ClientPool<ThriftClient<UserServiceClient>> *user_service_client_pool) {
+    ClientPool<ThriftClient<UserServiceClient>> *user_service_client_pool,
+    SocialGraphIndex *graph_index, bool use_edge_collection)
+    : _neighbors_flight("social-graph-neighbors") {
   _mongodb_client_pool = mongodb_client_pool;
   _redis_client_pool = nullptr;
   _redis_replica_client_pool = nullptr;
   _redis_primary_client_pool = nullptr;
   _redis_cluster_client_pool = redis_cluster_client_pool;
   _user_service_client_pool = user_service_client_pool;
+  _graph_index = graph_index;
+  _use_edge_collection = use_edge_collection;
 }
 
 bool SocialGraphHandler::IsRedisReplicationEnabled() {
     return (_redis_primary_client_pool || _redis_replica_client_pool);
 }
 
+// Upserts (follow) or deletes (unfollow) a single document of the edge
+// collection. Both are point operations on the unique
+// (follower_id, followee_id) index.
+void SocialGraphHandler::UpdateEdge(
+    int64_t user_id, int64_t followee_id, int64_t timestamp, bool follow,
+    const opentracing::SpanContext &parent_context) {
+  mongoc_client_t *mongodb_client =
+      mongoc_client_pool_pop(_mongodb_client_pool);
+  if (!mongodb_client) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to pop a client from MongoDB pool";
+    throw se;
+  }
+  auto collection = mongoc_client_get_collection(
+      mongodb_client, "social-graph", SOCIAL_GRAPH_EDGE_COLLECTION);
+  if (!collection) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to create collection social_graph from MongoDB";
+    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+    throw se;
+  }
+
+  bson_t *selector = BCON_NEW("follower_id", BCON_INT64(user_id),
+                              "followee_id", BCON_INT64(followee_id));
+  bson_error_t error;
+  bool updated;
+  auto update_span = opentracing::Tracer::Global()->StartSpan(
+      follow ? "social_graph_mongo_update_client"
+             : "social_graph_mongo_delete_client",
+      {opentracing::ChildOf(&parent_context)});
+  if (follow) {
+    bson_t *update = BCON_NEW("$setOnInsert", "{", "timestamp",
+                              BCON_INT64(timestamp), "}");
+    bson_t *opts = BCON_NEW("upsert", BCON_BOOL(true));
+    updated = mongoc_collection_update_one(collection, selector, update, opts,
+                                           nullptr, &error);
+    bson_destroy(opts);
+    bson_destroy(update);
+  } else {
+    updated = mongoc_collection_delete_one(collection, selector, nullptr,
+                                           nullptr, &error);
+  }
+  update_span->Finish();
+  if (!updated) {
+    LOG(error) << "Failed to update social graph edge " << user_id << " -> "
+               << followee_id << " to MongoDB: " << error.message;
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = error.message;
+    bson_destroy(selector);
+    mongoc_collection_destroy(collection);
+    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+    throw se;
+  }
+  bson_destroy(selector);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+}
+
+// Lists the followers (or followees) of user_id with a range scan over the
+// (followee_id, follower_id) (or (follower_id, followee_id)) index.
+void SocialGraphHandler::FindEdges(
+    int64_t user_id, bool followers, std::vector<int64_t> *neighbors,
+    std::multimap<std::string, double> *redis_zset,
+    const opentracing::SpanContext &parent_context) {
+  mongoc_client_t *mongodb_client =
+      mongoc_client_pool_pop(_mongodb_client_pool);
+  if (!mongodb_client) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to pop a client from MongoDB pool";
+    throw se;
+  }
+  auto collection = mongoc_client_get_collection(
+      mongodb_client, "social-graph", SOCIAL_GRAPH_EDGE_COLLECTION);
+  if (!collection) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to create collection social_graph from MongoDB";
+    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+    throw se;
+  }
+
+  const char *key_field = followers ? "followee_id" : "follower_id";
+  const char *neighbor_field = followers ? "follower_id" : "followee_id";
+  bson_t *query = BCON_NEW(key_field, BCON_INT64(user_id));
+  bson_t *opts = BCON_NEW("projection", "{", "_id", BCON_BOOL(false),
+                          neighbor_field, BCON_BOOL(true), "timestamp",
+                          BCON_BOOL(true), "}");
+  auto find_span = opentracing::Tracer::Global()->StartSpan(
+      "social_graph_mongo_find_client",
+      {opentracing::ChildOf(&parent_context)});
+  mongoc_cursor_t *cursor =
+      mongoc_collection_find_with_opts(collection, query, opts, nullptr);
+  const bson_t *doc;
+  bson_iter_t iter;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    int64_t neighbor_id = -1;
+    int64_t timestamp = 0;
+    if (bson_iter_init_find(&iter, doc, neighbor_field) &&
+        BSON_ITER_HOLDS_INT64(&iter)) {
+      neighbor_id = bson_iter_int64(&iter);
+    }
+    if (bson_iter_init_find(&iter, doc, "timestamp") &&
+        BSON_ITER_HOLDS_INT64(&iter)) {
+      timestamp = bson_iter_int64(&iter);
+    }
+    if (neighbor_id >= 0) {
+      neighbors->emplace_back(neighbor_id);
+      redis_zset->emplace(std::to_string(neighbor_id), (double)timestamp);
+    }
+  }
+  find_span->Finish();
+
+  bson_error_t error;
+  bool failed = mongoc_cursor_error(cursor, &error);
+  bson_destroy(opts);
+  bson_destroy(query);
+  mongoc_cursor_destroy(cursor);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  if (failed) {
+    LOG(error) << "Failed to read social graph edges of user " << user_id
+               << " from MongoDB: " << error.message;
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = error.message;
+    throw se;
+  }
+}
+
 void SocialGraphHandler::Follow(
     int64_t req_id, int64_t user_id, int64_t followee_id,
     const std::map<std::string, std::string> &carrier) {
@@ -118,6 +291,10 @@ void SocialGraphHandler::Follow(
 
   std::future<void> mongo_update_follower_future =
       std::async(std::launch::async, [&]() {
+        if (_use_edge_collection) {
+          UpdateEdge(user_id, followee_id, timestamp, true, span->context());
+          return;
+        }
         mongoc_client_t *mongodb_client =
             mongoc_client_pool_pop(_mongodb_client_pool);
         if (!mongodb_client) {
@@ -175,6 +352,10 @@ void SocialGraphHandler::Follow(
 
   std::future<void> mongo_update_followee_future =
       std::async(std::launch::async, [&]() {
+        // The edge collection stores each follow once, see above.
+        if (_use_edge_collection) {
+          return;
+        }
         mongoc_client_t *mongodb_client =
             mongoc_client_pool_pop(_mongodb_client_pool);
         if (!mongodb_client) {
@@ -264,19 +445,21 @@ void SocialGraphHandler::Follow(
           }
       }
       else {
-        // TODO: Redis++ currently does not support pipeline with multiple
-        //       hashtags in cluster mode.
-        //       Currently, we send one request for each follower, which may
-        //       incur some performance overhead. We are following the updates
-        //       of Redis++ clients:
-        //       https://github.com/sewenew/redis-plus-plus/issues/212
+        // The two keys usually hash to different slots; group them by node
+        // so that each node gets a single round trip.
+        std::string followee_key = std::to_string(user_id) + ":followees";
+        std::string follower_key = std::to_string(followee_id) + ":followers";
+        ClusterPipeline pipe(_redis_cluster_client_pool);
+        pipe.Add(followee_key, [&](Pipeline &node_pipe) {
+          node_pipe.zadd(followee_key, std::to_string(followee_id), timestamp,
+                         UpdateType::NOT_EXIST);
+        });
+        pipe.Add(follower_key, [&](Pipeline &node_pipe) {
+          node_pipe.zadd(follower_key, std::to_string(user_id), timestamp,
+                         UpdateType::NOT_EXIST);
+        });
         try {
-          _redis_cluster_client_pool->zadd(
-              std::to_string(user_id) + ":followees",
-              std::to_string(followee_id), timestamp, UpdateType::NOT_EXIST);
-          _redis_cluster_client_pool->zadd(
-              std::to_string(followee_id) + ":followers",
-              std::to_string(user_id), timestamp, UpdateType::NOT_EXIST);
+          auto replies = pipe.Exec();
         } catch (const Error &err) {
           LOG(error) << err.what();
           throw err;
@@ -297,6 +480,9 @@ void SocialGraphHandler::Follow(
     throw;
   }
 
+  if (_graph_index) {
+    _graph_index->Follow(user_id, followee_id);
+  }
   span->Finish();
 }
 
@@ -314,6 +500,10 @@ void SocialGraphHandler::Unfollow(
 
   std::future<void> mongo_update_follower_future =
       std::async(std::launch::async, [&]() {
+        if (_use_edge_collection) {
+          UpdateEdge(user_id, followee_id, 0, false, span->context());
+          return;
+        }
         mongoc_client_t *mongodb_client =
             mongoc_client_pool_pop(_mongodb_client_pool);
         if (!mongodb_client) {
@@ -368,6 +558,10 @@ void SocialGraphHandler::Unfollow(
 
   std::future<void> mongo_update_followee_future =
       std::async(std::launch::async, [&]() {
+        // The edge collection stores each follow once, see above.
+        if (_use_edge_collection) {
+          return;
+        }
         mongoc_client_t *mongodb_client =
             mongoc_client_pool_pop(_mongodb_client_pool);
         if (!mongodb_client) {
@@ -457,11 +651,15 @@ void SocialGraphHandler::Unfollow(
       else {
         std::string followee_key = std::to_string(user_id) + ":followees";
         std::string follower_key = std::to_string(followee_id) + ":followers";
+        ClusterPipeline pipe(_redis_cluster_client_pool);
+        pipe.Add(followee_key, [&](Pipeline &node_pipe) {
+          node_pipe.zrem(followee_key, std::to_string(followee_id));
+        });
+        pipe.Add(follower_key, [&](Pipeline &node_pipe) {
+          node_pipe.zrem(follower_key, std::to_string(user_id));
+        });
         try {
-          _redis_cluster_client_pool->zrem(followee_key,
-                                           std::to_string(followee_id));
-          _redis_cluster_client_pool->zrem(follower_key,
-                                           std::to_string(user_id));
+          auto replies = pipe.Exec();
         } catch (const Error &err) {
           LOG(error) << err.what();
           throw err;
@@ -479,6 +677,9 @@ void SocialGraphHandler::Unfollow(
     throw;
   }
 
+  if (_graph_index) {
+    _graph_index->Unfollow(user_id, followee_id);
+  }
   span->Finish();
 }
 
@@ -494,6 +695,20 @@ void SocialGraphHandler::GetFollowers(
       "get_followers_server", {opentracing::ChildOf(parent_span->get())});
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  // Serve from the in-process graph index when enabled. Users unknown to the
+  // index fall through to the Redis/MongoDB path below.
+  if (_graph_index) {
+    auto index_span = opentracing::Tracer::Global()->StartSpan(
+        "social_graph_index_get_client",
+        {opentracing::ChildOf(&span->context())});
+    bool found = _graph_index->GetFollowers(user_id, &_return);
+    index_span->Finish();
+    if (found) {
+      span->Finish();
+      return;
+    }
+  }
+
   auto redis_span = opentracing::Tracer::Global()->StartSpan(
       "social_graph_redis_get_client",
       {opentracing::ChildOf(&span->context())});
@@ -505,7 +720,8 @@ void SocialGraphHandler::GetFollowers(
       _redis_client_pool->zrange(key, 0, -1, std::back_inserter(followers_str));
     } 
     else if (IsRedisReplicationEnabled()) {
-        _redis_replica_client_pool->zrange(key, 0, -1, std::back_inserter(followers_str));
+        _redis_replica_client_pool->Acquire()->zrange(
+            key, 0, -1, std::back_inserter(followers_str));
     }
     else {
       _redis_cluster_client_pool->zrange(key, 0, -1,
@@ -523,99 +739,123 @@ void SocialGraphHandler::GetFollowers(
       _return.emplace_back(std::stoul(follower_str));
     }
   }
-  // If user_id in the sodical graph Redis server, read from MongoDB and
-  // update Redis.
+  // On a miss, concurrent requests for the same user wait for a single
+  // database read and Redis refill.
   else {
-    mongoc_client_t *mongodb_client =
-        mongoc_client_pool_pop(_mongodb_client_pool);
-    if (!mongodb_client) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to pop a client from MongoDB pool";
-      throw se;
-    }
-    auto collection = mongoc_client_get_collection(
-        mongodb_client, "social-graph", "social-graph");
-    if (!collection) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to create collection social_graph from MongoDB";
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-      throw se;
-    }
-    bson_t *query = bson_new();
-    BSON_APPEND_INT64(query, "user_id", user_id);
-    auto find_span = opentracing::Tracer::Global()->StartSpan(
-        "social_graph_mongo_find_client",
-        {opentracing::ChildOf(&span->context())});
-    mongoc_cursor_t *cursor =
-        mongoc_collection_find_with_opts(collection, query, nullptr, nullptr);
-    const bson_t *doc;
-    bool found = mongoc_cursor_next(cursor, &doc);
-    if (found) {
-      bson_iter_t iter_0;
-      bson_iter_t iter_1;
-      bson_iter_t user_id_child;
-      bson_iter_t timestamp_child;
-      int index = 0;
-      std::unordered_map<std::string, double> redis_zset;
-      bson_iter_init(&iter_0, doc);
-      bson_iter_init(&iter_1, doc);
-
-      while (bson_iter_find_descendant(
-                 &iter_0,
-                 ("followers." + std::to_string(index) + ".user_id").c_str(),
-                 &user_id_child) &&
-             BSON_ITER_HOLDS_INT64(&user_id_child) &&
-             bson_iter_find_descendant(
-                 &iter_1,
-                 ("followers." + std::to_string(index) + ".timestamp").c_str(),
-                 &timestamp_child) &&
-             BSON_ITER_HOLDS_INT64(&timestamp_child)) {
-        auto iter_user_id = bson_iter_int64(&user_id_child);
-        auto iter_timestamp = bson_iter_int64(&timestamp_child);
-        _return.emplace_back(iter_user_id);
-        redis_zset.emplace(std::pair<std::string, double>(
-            std::to_string(iter_user_id), (double)iter_timestamp));
-        bson_iter_init(&iter_0, doc);
-        bson_iter_init(&iter_1, doc);
-        index++;
+    bool coalesced = false;
+    _return = _neighbors_flight.Do(key, [&]() {
+      std::vector<int64_t> followers;
+      // With the edge collection, list the edges of user_id with an index range
+      // scan and update Redis.
+      if (_use_edge_collection) {
+        std::multimap<std::string, double> redis_zset;
+        FindEdges(user_id, true, &followers, &redis_zset, span->context());
+        if (!redis_zset.empty()) {
+          auto redis_insert_span = opentracing::Tracer::Global()->StartSpan(
+              "social_graph_redis_insert_client",
+              {opentracing::ChildOf(&span->context())});
+          try {
+            if (_redis_client_pool) {
+              _redis_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
+            }
+            else if (IsRedisReplicationEnabled()) {
+                _redis_primary_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
+            }
+            else {
+              _redis_cluster_client_pool->zadd(key, redis_zset.begin(),
+                                               redis_zset.end());
+            }
+          } catch (const Error &err) {
+            LOG(error) << err.what();
+            throw err;
+          }
+          redis_insert_span->Finish();
+        }
       }
-      find_span->Finish();
-      bson_destroy(query);
-      mongoc_cursor_destroy(cursor);
-      mongoc_collection_destroy(collection);
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-
-      // Update Redis
-      std::string key = std::to_string(user_id) + ":followers";
-      auto redis_insert_span = opentracing::Tracer::Global()->StartSpan(
-          "social_graph_redis_insert_client",
-          {opentracing::ChildOf(&span->context())});
-      try {
-        if (_redis_client_pool) {
-          _redis_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
-        } 
-        else if (IsRedisReplicationEnabled()) {
-            _redis_primary_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
-        }
-        else {
-          _redis_cluster_client_pool->zadd(key, redis_zset.begin(),
-                                           redis_zset.end());
-        }
-      } catch (const Error &err) {
-        LOG(error) << err.what();
-        throw err;
+      // If user_id in the sodical graph Redis server, read from MongoDB and
+      // update Redis.
+      else {
+        mongoc_client_t *mongodb_client =
+            mongoc_client_pool_pop(_mongodb_client_pool);
+        if (!mongodb_client) {
+          ServiceException se;
+          se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+          se.message = "Failed to pop a client from MongoDB pool";
+          throw se;
+        }
+        auto collection = mongoc_client_get_collection(
+            mongodb_client, "social-graph", "social-graph");
+        if (!collection) {
+          ServiceException se;
+          se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+          se.message = "Failed to create collection social_graph from MongoDB";
+          mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+          throw se;
+        }
+        bson_t *query = bson_new();
+        BSON_APPEND_INT64(query, "user_id", user_id);
+        auto find_span = opentracing::Tracer::Global()->StartSpan(
+            "social_graph_mongo_find_client",
+            {opentracing::ChildOf(&span->context())});
+        mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
+            collection, query, nullptr,
+            get_stale_read_prefs(_mongodb_client_pool));
+        const bson_t *doc;
+        bool found = mongoc_cursor_next(cursor, &doc);
+        if (found) {
+          std::unordered_map<std::string, double> redis_zset;
+          ForEachArrayDocument(doc, "followers",
+              [&](const bson_iter_t *follower, int idx) {
+            int64_t iter_user_id;
+            int64_t iter_timestamp;
+            if (!GetInt64Field(follower, "user_id", &iter_user_id) ||
+                !GetInt64Field(follower, "timestamp", &iter_timestamp)) {
+              return false;
+            }
+            followers.emplace_back(iter_user_id);
+            redis_zset.emplace(std::pair<std::string, double>(
+                std::to_string(iter_user_id), (double)iter_timestamp));
+            return true;
+          });
+          find_span->Finish();
+          bson_destroy(query);
+          mongoc_cursor_destroy(cursor);
+          mongoc_collection_destroy(collection);
+          mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+
+          // Update Redis
+          std::string key = std::to_string(user_id) + ":followers";
+          auto redis_insert_span = opentracing::Tracer::Global()->StartSpan(
+              "social_graph_redis_insert_client",
+              {opentracing::ChildOf(&span->context())});
+          try {
+            if (_redis_client_pool) {
+              _redis_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
+            } 
+            else if (IsRedisReplicationEnabled()) {
+                _redis_primary_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
+            }
+            else {
+              _redis_cluster_client_pool->zadd(key, redis_zset.begin(),
+                                               redis_zset.end());
+            }
+          } catch (const Error &err) {
+            LOG(error) << err.what();
+            throw err;
+          }
+          redis_span->Finish();
+        } else {
+          LOG(warning) << "user_id: " << user_id << " not found";
+          find_span->Finish();
+          bson_destroy(query);
+          mongoc_cursor_destroy(cursor);
+          mongoc_collection_destroy(collection);
+          mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+        }
       }
-      redis_span->Finish();
-    } else {
-      LOG(warning) << "user_id: " << user_id << " not found";
-      find_span->Finish();
-      bson_destroy(query);
-      mongoc_cursor_destroy(cursor);
-      mongoc_collection_destroy(collection);
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-    }
+      return followers;
+    }, &coalesced);
+    span->SetTag("cache_miss_coalesced", coalesced);
   }
   span->Finish();
 }
@@ -632,6 +872,20 @@ void SocialGraphHandler::GetFollowees(
       "get_followees_server", {opentracing::ChildOf(parent_span->get())});
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  // Serve from the in-process graph index when enabled. Users unknown to the
+  // index fall through to the Redis/MongoDB path below.
+  if (_graph_index) {
+    auto index_span = opentracing::Tracer::Global()->StartSpan(
+        "social_graph_index_get_client",
+        {opentracing::ChildOf(&span->context())});
+    bool found = _graph_index->GetFollowees(user_id, &_return);
+    index_span->Finish();
+    if (found) {
+      span->Finish();
+      return;
+    }
+  }
+
   auto redis_span = opentracing::Tracer::Global()->StartSpan(
       "social_graph_redis_get_client",
       {opentracing::ChildOf(&span->context())});
@@ -643,7 +897,8 @@ void SocialGraphHandler::GetFollowees(
       _redis_client_pool->zrange(key, 0, -1, std::back_inserter(followees_str));
     }
     else if (IsRedisReplicationEnabled()) {
-        _redis_replica_client_pool->zrange(key, 0, -1, std::back_inserter(followees_str));
+        _redis_replica_client_pool->Acquire()->zrange(
+            key, 0, -1, std::back_inserter(followees_str));
     }
     else {
       _redis_cluster_client_pool->zrange(key, 0, -1,
@@ -661,106 +916,127 @@ void SocialGraphHandler::GetFollowees(
       _return.emplace_back(std::stoul(followee_str));
     }
   }
-  // If user_id in the sodical graph Redis server, read from MongoDB and
-  // update Redis.
+  // On a miss, concurrent requests for the same user wait for a single
+  // database read and Redis refill.
   else {
-    redis_span->Finish();
-    mongoc_client_t *mongodb_client =
-        mongoc_client_pool_pop(_mongodb_client_pool);
-    if (!mongodb_client) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to pop a client from MongoDB pool";
-      throw se;
-    }
-    auto collection = mongoc_client_get_collection(
-        mongodb_client, "social-graph", "social-graph");
-    if (!collection) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to create collection social_graph from MongoDB";
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-      throw se;
-    }
-    bson_t *query = bson_new();
-    BSON_APPEND_INT64(query, "user_id", user_id);
-    auto find_span = opentracing::Tracer::Global()->StartSpan(
-        "social_graph_mongo_find_client",
-        {opentracing::ChildOf(&span->context())});
-    mongoc_cursor_t *cursor =
-        mongoc_collection_find_with_opts(collection, query, nullptr, nullptr);
-    const bson_t *doc;
-    bool found = mongoc_cursor_next(cursor, &doc);
-    if (!found) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
-      se.message = "Cannot find user_id in MongoDB.";
-      bson_destroy(query);
-      mongoc_cursor_destroy(cursor);
-      mongoc_collection_destroy(collection);
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-      throw se;
-    } else {
-      bson_iter_t iter_0;
-      bson_iter_t iter_1;
-      bson_iter_t user_id_child;
-      bson_iter_t timestamp_child;
-      int index = 0;
-
-      bson_iter_init(&iter_0, doc);
-      bson_iter_init(&iter_1, doc);
-
-      std::multimap<std::string, double> redis_zset;
-
-      while (bson_iter_find_descendant(
-                 &iter_0,
-                 ("followees." + std::to_string(index) + ".user_id").c_str(),
-                 &user_id_child) &&
-             BSON_ITER_HOLDS_INT64(&user_id_child) &&
-             bson_iter_find_descendant(
-                 &iter_1,
-                 ("followees." + std::to_string(index) + ".timestamp").c_str(),
-                 &timestamp_child) &&
-             BSON_ITER_HOLDS_INT64(&timestamp_child)) {
-        auto iter_user_id = bson_iter_int64(&user_id_child);
-        auto iter_timestamp = bson_iter_int64(&timestamp_child);
-        _return.emplace_back(iter_user_id);
-
-        redis_zset.emplace(std::pair<std::string, double>(
-            std::to_string(iter_user_id), (double)iter_timestamp));
-        bson_iter_init(&iter_0, doc);
-        bson_iter_init(&iter_1, doc);
-        index++;
+    bool coalesced = false;
+    _return = _neighbors_flight.Do(key, [&]() {
+      std::vector<int64_t> followees;
+      // With the edge collection, list the edges of user_id with an index range
+      // scan and update Redis.
+      if (_use_edge_collection) {
+        std::multimap<std::string, double> redis_zset;
+        FindEdges(user_id, false, &followees, &redis_zset, span->context());
+        if (!redis_zset.empty()) {
+          auto redis_insert_span = opentracing::Tracer::Global()->StartSpan(
+              "social_graph_redis_insert_client",
+              {opentracing::ChildOf(&span->context())});
+          try {
+            if (_redis_client_pool) {
+              _redis_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
+            }
+            else if (IsRedisReplicationEnabled()) {
+                _redis_primary_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
+            }
+            else {
+              _redis_cluster_client_pool->zadd(key, redis_zset.begin(),
+                                               redis_zset.end());
+            }
+          } catch (const Error &err) {
+            LOG(error) << err.what();
+            throw err;
+          }
+          redis_insert_span->Finish();
+        }
       }
+      // If user_id in the sodical graph Redis server, read from MongoDB and
+      // update Redis.
+      else {
+        redis_span->Finish();
+        mongoc_client_t *mongodb_client =
+            mongoc_client_pool_pop(_mongodb_client_pool);
+        if (!mongodb_client) {
+          ServiceException se;
+          se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+          se.message = "Failed to pop a client from MongoDB pool";
+          throw se;
+        }
+        auto collection = mongoc_client_get_collection(
+            mongodb_client, "social-graph", "social-graph");
+        if (!collection) {
+          ServiceException se;
+          se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+          se.message = "Failed to create collection social_graph from MongoDB";
+          mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+          throw se;
+        }
+        bson_t *query = bson_new();
+        BSON_APPEND_INT64(query, "user_id", user_id);
+        auto find_span = opentracing::Tracer::Global()->StartSpan(
+            "social_graph_mongo_find_client",
+            {opentracing::ChildOf(&span->context())});
+        mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
+            collection, query, nullptr,
+            get_stale_read_prefs(_mongodb_client_pool));
+        const bson_t *doc;
+        bool found = mongoc_cursor_next(cursor, &doc);
+        if (!found) {
+          ServiceException se;
+          se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+          se.message = "Cannot find user_id in MongoDB.";
+          bson_destroy(query);
+          mongoc_cursor_destroy(cursor);
+          mongoc_collection_destroy(collection);
+          mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+          throw se;
+        } else {
+          std::multimap<std::string, double> redis_zset;
+          ForEachArrayDocument(doc, "followees",
+              [&](const bson_iter_t *followee, int idx) {
+            int64_t iter_user_id;
+            int64_t iter_timestamp;
+            if (!GetInt64Field(followee, "user_id", &iter_user_id) ||
+                !GetInt64Field(followee, "timestamp", &iter_timestamp)) {
+              return false;
+            }
+            followees.emplace_back(iter_user_id);
+            redis_zset.emplace(std::pair<std::string, double>(
+                std::to_string(iter_user_id), (double)iter_timestamp));
+            return true;
+          });
+
+          find_span->Finish();
+          bson_destroy(query);
+          mongoc_cursor_destroy(cursor);
+          mongoc_collection_destroy(collection);
+          mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
 
-      find_span->Finish();
-      bson_destroy(query);
-      mongoc_cursor_destroy(cursor);
-      mongoc_collection_destroy(collection);
-      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
-
-      // Update redis
-      std::string key = std::to_string(user_id) + ":followees";
-      auto redis_insert_span = opentracing::Tracer::Global()->StartSpan(
-          "social_graph_redis_insert_client",
-          {opentracing::ChildOf(&span->context())});
-      try {
-        if (_redis_client_pool) {
-          _redis_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
-        } 
-        else if (IsRedisReplicationEnabled()) {
-            _redis_primary_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
-        }
-        else {
-          _redis_cluster_client_pool->zadd(key, redis_zset.begin(),
-                                           redis_zset.end());
-        }
-      } catch (const Error &err) {
-        LOG(error) << err.what();
-        throw err;
+          // Update redis
+          std::string key = std::to_string(user_id) + ":followees";
+          auto redis_insert_span = opentracing::Tracer::Global()->StartSpan(
+              "social_graph_redis_insert_client",
+              {opentracing::ChildOf(&span->context())});
+          try {
+            if (_redis_client_pool) {
+              _redis_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
+            } 
+            else if (IsRedisReplicationEnabled()) {
+                _redis_primary_client_pool->zadd(key, redis_zset.begin(), redis_zset.end());
+            }
+            else {
+              _redis_cluster_client_pool->zadd(key, redis_zset.begin(),
+                                               redis_zset.end());
+            }
+          } catch (const Error &err) {
+            LOG(error) << err.what();
+            throw err;
+          }
+          redis_span->Finish();
+        }
       }
-      redis_span->Finish();
-    }
+      return followees;
+    }, &coalesced);
+    span->SetTag("cache_miss_coalesced", coalesced);
   }
   span->Finish();
 }
@@ -795,8 +1071,11 @@ void SocialGraphHandler::InsertUser(
     throw se;
   }
 
-  bson_t *new_doc = BCON_NEW("user_id", BCON_INT64(user_id), "followers", "[",
-                             "]", "followees", "[", "]");
+  bson_t *new_doc =
+      _use_edge_collection
+          ? BCON_NEW("user_id", BCON_INT64(user_id))
+          : BCON_NEW("user_id", BCON_INT64(user_id), "followers", "[", "]",
+                     "followees", "[", "]");
   bson_error_t error;
   auto insert_span = opentracing::Tracer::Global()->StartSpan(
       "social_graph_mongo_insert_client",
@@ -818,6 +1097,243 @@ void SocialGraphHandler::InsertUser(
   bson_destroy(new_doc);
   mongoc_collection_destroy(collection);
   mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  if (_graph_index) {
+    _graph_index->InsertUser(user_id);
+  }
+  span->Finish();
+}
+
+// Runs one unordered bulk write against the collection; append_ops queues
+// the operations and returns false if one of them could not be queued.
+void SocialGraphHandler::ExecuteBulk(
+    const char *collection_name,
+    const std::function<bool(mongoc_bulk_operation_t *)> &append_ops,
+    const opentracing::SpanContext &parent_context) {
+  mongoc_client_t *mongodb_client =
+      mongoc_client_pool_pop(_mongodb_client_pool);
+  if (!mongodb_client) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to pop a client from MongoDB pool";
+    throw se;
+  }
+  auto collection = mongoc_client_get_collection(
+      mongodb_client, "social-graph", collection_name);
+  if (!collection) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to create collection social_graph from MongoDB";
+    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+    throw se;
+  }
+
+  bson_t *bulk_opts = BCON_NEW("ordered", BCON_BOOL(false));
+  mongoc_bulk_operation_t *bulk =
+      mongoc_collection_create_bulk_operation_with_opts(collection, bulk_opts);
+  bson_error_t error;
+  bson_t reply;
+  auto bulk_span = opentracing::Tracer::Global()->StartSpan(
+      "social_graph_mongo_bulk_client", {opentracing::ChildOf(&parent_context)});
+  bool success = append_ops(bulk);
+  if (success) {
+    success = mongoc_bulk_operation_execute(bulk, &reply, &error);
+    bson_destroy(&reply);
+  } else {
+    bson_set_error(&error, MONGOC_ERROR_COMMAND,
+                   MONGOC_ERROR_COMMAND_INVALID_ARG,
+                   "Failed to queue bulk operation");
+  }
+  bulk_span->Finish();
+  mongoc_bulk_operation_destroy(bulk);
+  bson_destroy(bulk_opts);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  if (!success) {
+    LOG(error) << "Failed to bulk write social graph to MongoDB: "
+               << error.message;
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = error.message;
+    throw se;
+  }
+}
+
+// Bulk variant of InsertUser. Users are upserted, so users that already exist
+// keep their edges and a batch can be sent again after a failure.
+void SocialGraphHandler::InsertUsers(
+    int64_t req_id, const std::vector<int64_t> &user_ids,
+    const std::map<std::string, std::string> &carrier) {
+  // Initialize a span
+  TextMapReader reader(carrier);
+  std::map<std::string, std::string> writer_text_map;
+  TextMapWriter writer(writer_text_map);
+  auto parent_span = opentracing::Tracer::Global()->Extract(reader);
+  auto span = opentracing::Tracer::Global()->StartSpan(
+      "insert_users_server", {opentracing::ChildOf(parent_span->get())});
+  opentracing::Tracer::Global()->Inject(span->context(), writer);
+
+  if (user_ids.empty()) {
+    span->Finish();
+    return;
+  }
+
+  ExecuteBulk("social-graph", [&](mongoc_bulk_operation_t *bulk) {
+    bson_t *opts = BCON_NEW("upsert", BCON_BOOL(true));
+    bool success = true;
+    for (auto user_id : user_ids) {
+      bson_t *selector = BCON_NEW("user_id", BCON_INT64(user_id));
+      bson_t *update =
+          _use_edge_collection
+              ? BCON_NEW("$setOnInsert", "{", "user_id", BCON_INT64(user_id),
+                         "}")
+              : BCON_NEW("$setOnInsert", "{", "followers", "[", "]",
+                         "followees", "[", "]", "}");
+      success = mongoc_bulk_operation_update_one_with_opts(
+          bulk, selector, update, opts, nullptr);
+      bson_destroy(update);
+      bson_destroy(selector);
+      if (!success) {
+        break;
+      }
+    }
+    bson_destroy(opts);
+    return success;
+  }, span->context());
+
+  if (_graph_index) {
+    for (auto user_id : user_ids) {
+      _graph_index->InsertUser(user_id);
+    }
+  }
+  span->Finish();
+}
+
+// Bulk variant of Follow: user_ids[i] follows followee_ids[i]. All edges of a
+// batch share one timestamp. MongoDB is updated with a single unordered bulk
+// write and Redis with one ZADD per key, and both keep Follow's "add only if
+// absent" semantics, so a batch can be sent again after a failure.
+void SocialGraphHandler::FollowMany(
+    int64_t req_id, const std::vector<int64_t> &user_ids,
+    const std::vector<int64_t> &followee_ids,
+    const std::map<std::string, std::string> &carrier) {
+  // Initialize a span
+  TextMapReader reader(carrier);
+  std::map<std::string, std::string> writer_text_map;
+  TextMapWriter writer(writer_text_map);
+  auto parent_span = opentracing::Tracer::Global()->Extract(reader);
+  auto span = opentracing::Tracer::Global()->StartSpan(
+      "follow_many_server", {opentracing::ChildOf(parent_span->get())});
+  opentracing::Tracer::Global()->Inject(span->context(), writer);
+
+  if (user_ids.size() != followee_ids.size()) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+    se.message = "user_ids and followee_ids must have the same length";
+    throw se;
+  }
+  if (user_ids.empty()) {
+    span->Finish();
+    return;
+  }
+
+  int64_t timestamp =
+      duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+          .count();
+
+  std::future<void> mongo_update_future =
+      std::async(std::launch::async, [&]() {
+        if (_use_edge_collection) {
+          ExecuteBulk(SOCIAL_GRAPH_EDGE_COLLECTION,
+                      [&](mongoc_bulk_operation_t *bulk) {
+            for (size_t i = 0; i < user_ids.size(); ++i) {
+              if (!AppendEdgeUpsert(bulk, user_ids[i], followee_ids[i],
+                                    timestamp)) {
+                return false;
+              }
+            }
+            return true;
+          }, span->context());
+          return;
+        }
+        ExecuteBulk("social-graph", [&](mongoc_bulk_operation_t *bulk) {
+          // Same guarded $push as Follow, once per direction.
+          auto append_push = [&](int64_t user_id, const char *field,
+                                 int64_t neighbor_id) {
+            bson_t *search_not_exist = BCON_NEW(
+                "user_id", BCON_INT64(user_id), field, "{", "$not", "{",
+                "$elemMatch", "{", "user_id", BCON_INT64(neighbor_id), "}",
+                "}", "}");
+            bson_t *update = BCON_NEW("$push", "{", field, "{", "user_id",
+                                      BCON_INT64(neighbor_id), "timestamp",
+                                      BCON_INT64(timestamp), "}", "}");
+            bool appended = mongoc_bulk_operation_update_one_with_opts(
+                bulk, search_not_exist, update, nullptr, nullptr);
+            bson_destroy(update);
+            bson_destroy(search_not_exist);
+            return appended;
+          };
+          for (size_t i = 0; i < user_ids.size(); ++i) {
+            if (!append_push(user_ids[i], "followees", followee_ids[i]) ||
+                !append_push(followee_ids[i], "followers", user_ids[i])) {
+              return false;
+            }
+          }
+          return true;
+        }, span->context());
+      });
+
+  std::future<void> redis_update_future = std::async(std::launch::async, [&]() {
+    std::map<std::string, std::multimap<std::string, double>> redis_zsets;
+    for (size_t i = 0; i < user_ids.size(); ++i) {
+      redis_zsets[std::to_string(user_ids[i]) + ":followees"].emplace(
+          std::to_string(followee_ids[i]), (double)timestamp);
+      redis_zsets[std::to_string(followee_ids[i]) + ":followers"].emplace(
+          std::to_string(user_ids[i]), (double)timestamp);
+    }
+
+    auto redis_span = opentracing::Tracer::Global()->StartSpan(
+        "social_graph_redis_update_client",
+        {opentracing::ChildOf(&span->context())});
+    try {
+      if (_redis_client_pool || IsRedisReplicationEnabled()) {
+        Redis *redis = _redis_client_pool ? _redis_client_pool
+                                          : _redis_primary_client_pool;
+        auto pipe = redis->pipeline(false);
+        for (auto &zset : redis_zsets) {
+          pipe.zadd(zset.first, zset.second.begin(), zset.second.end(),
+                    UpdateType::NOT_EXIST);
+        }
+        auto replies = pipe.exec();
+      } else {
+        ClusterPipeline pipe(_redis_cluster_client_pool);
+        for (auto &zset : redis_zsets) {
+          pipe.Add(zset.first, [&](Pipeline &node_pipe) {
+            node_pipe.zadd(zset.first, zset.second.begin(), zset.second.end(),
+                           UpdateType::NOT_EXIST);
+          });
+        }
+        auto replies = pipe.Exec();
+      }
+    } catch (const Error &err) {
+      LOG(error) << err.what();
+      throw err;
+    }
+    redis_span->Finish();
+  });
+
+  try {
+    redis_update_future.get();
+    mongo_update_future.get();
+  } catch (const std::exception &e) {
+    LOG(warning) << e.what();
+    throw;
+  }
+
+  if (_graph_index) {
+    for (size_t i = 0; i < user_ids.size(); ++i) {
+      _graph_index->Follow(user_ids[i], followee_ids[i]);
+    }
+  }
   span->Finish();
 }
 
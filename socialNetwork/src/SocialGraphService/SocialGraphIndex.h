@@ -0,0 +1,498 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_SOCIALGRAPHINDEX_H
+#define SOCIAL_NETWORK_MICROSERVICES_SOCIALGRAPHINDEX_H
+
+#include <bson/bson.h>
+#include <mongoc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../logger.h"
+#include "SocialGraphEdges.h"
+
+namespace social_network {
+
+// One direction (followers or followees) of the social graph, stored in a
+// CSR-style layout: the neighbor list of row r lives in
+// _data[_offsets[r], _offsets[r + 1]) as a sorted list encoded as varint
+// deltas (the first element is stored as-is). Rows modified after the last
+// compaction are re-encoded into _dirty and shadow their CSR slice until the
+// next Compact().
+class CompressedAdjacency {
+ public:
+  CompressedAdjacency() : _num_edges(0), _dirty_bytes(0) {
+    _offsets.emplace_back(0);
+  }
+
+  void AppendRow(const std::vector<int64_t> &sorted_neighbors);
+  void AddRow();
+  size_t NumRows() const { return _degrees.size(); }
+  size_t NumEdges() const { return _num_edges; }
+  size_t MemoryBytes() const;
+
+  void Decode(uint32_t row, std::vector<int64_t> *out) const;
+  bool Insert(uint32_t row, int64_t neighbor);
+  bool Erase(uint32_t row, int64_t neighbor);
+  bool NeedsCompaction() const;
+  void Compact();
+
+ private:
+  static void EncodeRow(const std::vector<int64_t> &sorted_neighbors,
+                        std::vector<uint8_t> *out);
+  static void DecodeRow(const uint8_t *begin, const uint8_t *end,
+                        uint32_t degree, std::vector<int64_t> *out);
+  void ReplaceRow(uint32_t row, const std::vector<int64_t> &neighbors);
+
+  std::vector<uint64_t> _offsets;
+  std::vector<uint8_t> _data;
+  std::vector<uint32_t> _degrees;
+  std::unordered_map<uint32_t, std::vector<uint8_t>> _dirty;
+  size_t _num_edges;
+  size_t _dirty_bytes;
+};
+
+void CompressedAdjacency::EncodeRow(
+    const std::vector<int64_t> &sorted_neighbors, std::vector<uint8_t> *out) {
+  uint64_t prev = 0;
+  for (auto neighbor : sorted_neighbors) {
+    uint64_t delta = static_cast<uint64_t>(neighbor) - prev;
+    prev = static_cast<uint64_t>(neighbor);
+    while (delta >= 0x80) {
+      out->emplace_back(static_cast<uint8_t>(delta | 0x80));
+      delta >>= 7;
+    }
+    out->emplace_back(static_cast<uint8_t>(delta));
+  }
+}
+
+void CompressedAdjacency::DecodeRow(const uint8_t *begin, const uint8_t *end,
+                                    uint32_t degree,
+                                    std::vector<int64_t> *out) {
+  out->reserve(out->size() + degree);
+  uint64_t prev = 0;
+  const uint8_t *p = begin;
+  while (p < end) {
+    uint64_t delta = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+      delta |= static_cast<uint64_t>(*p & 0x7f) << shift;
+      shift += 7;
+      p++;
+    }
+    delta |= static_cast<uint64_t>(*p) << shift;
+    p++;
+    prev += delta;
+    out->emplace_back(static_cast<int64_t>(prev));
+  }
+}
+
+void CompressedAdjacency::AppendRow(
+    const std::vector<int64_t> &sorted_neighbors) {
+  EncodeRow(sorted_neighbors, &_data);
+  _offsets.emplace_back(_data.size());
+  _degrees.emplace_back(sorted_neighbors.size());
+  _num_edges += sorted_neighbors.size();
+}
+
+void CompressedAdjacency::AddRow() {
+  // New rows are empty, so they share the end of the CSR data.
+  _offsets.emplace_back(_data.size());
+  _degrees.emplace_back(0);
+}
+
+size_t CompressedAdjacency::MemoryBytes() const {
+  size_t bytes = _offsets.capacity() * sizeof(uint64_t) +
+                 _data.capacity() + _degrees.capacity() * sizeof(uint32_t);
+  bytes += _dirty_bytes +
+           _dirty.size() * (sizeof(uint32_t) + sizeof(std::vector<uint8_t>));
+  return bytes;
+}
+
+void CompressedAdjacency::Decode(uint32_t row,
+                                 std::vector<int64_t> *out) const {
+  auto dirty_it = _dirty.find(row);
+  if (dirty_it != _dirty.end()) {
+    DecodeRow(dirty_it->second.data(),
+              dirty_it->second.data() + dirty_it->second.size(),
+              _degrees[row], out);
+  } else {
+    DecodeRow(_data.data() + _offsets[row], _data.data() + _offsets[row + 1],
+              _degrees[row], out);
+  }
+}
+
+void CompressedAdjacency::ReplaceRow(uint32_t row,
+                                     const std::vector<int64_t> &neighbors) {
+  auto &encoded = _dirty[row];
+  _dirty_bytes -= encoded.capacity();
+  encoded.clear();
+  EncodeRow(neighbors, &encoded);
+  encoded.shrink_to_fit();
+  _dirty_bytes += encoded.capacity();
+  _degrees[row] = neighbors.size();
+}
+
+bool CompressedAdjacency::Insert(uint32_t row, int64_t neighbor) {
+  std::vector<int64_t> neighbors;
+  Decode(row, &neighbors);
+  auto it = std::lower_bound(neighbors.begin(), neighbors.end(), neighbor);
+  if (it != neighbors.end() && *it == neighbor) {
+    return false;
+  }
+  neighbors.insert(it, neighbor);
+  ReplaceRow(row, neighbors);
+  _num_edges++;
+  return true;
+}
+
+bool CompressedAdjacency::Erase(uint32_t row, int64_t neighbor) {
+  std::vector<int64_t> neighbors;
+  Decode(row, &neighbors);
+  auto it = std::lower_bound(neighbors.begin(), neighbors.end(), neighbor);
+  if (it == neighbors.end() || *it != neighbor) {
+    return false;
+  }
+  neighbors.erase(it);
+  ReplaceRow(row, neighbors);
+  _num_edges--;
+  return true;
+}
+
+bool CompressedAdjacency::NeedsCompaction() const {
+  // Fold the overlay back into the CSR arrays once it costs more than a
+  // quarter of the base data, so a long-running service does not drift into
+  // one heap allocation per user.
+  return _dirty_bytes > (1 << 20) && _dirty_bytes > _data.size() / 4;
+}
+
+void CompressedAdjacency::Compact() {
+  std::vector<uint64_t> offsets;
+  std::vector<uint8_t> data;
+  offsets.reserve(_offsets.size());
+  data.reserve(_data.size() + _dirty_bytes);
+  offsets.emplace_back(0);
+  for (uint32_t row = 0; row < _degrees.size(); row++) {
+    auto dirty_it = _dirty.find(row);
+    if (dirty_it != _dirty.end()) {
+      data.insert(data.end(), dirty_it->second.begin(),
+                  dirty_it->second.end());
+    } else {
+      data.insert(data.end(), _data.begin() + _offsets[row],
+                  _data.begin() + _offsets[row + 1]);
+    }
+    offsets.emplace_back(data.size());
+  }
+  data.shrink_to_fit();
+  _offsets.swap(offsets);
+  _data.swap(data);
+  _dirty.clear();
+  _dirty_bytes = 0;
+}
+
+// In-process copy of the social graph used by SocialGraphHandler to answer
+// GetFollowers/GetFollowees without a Redis or MongoDB round trip. The index
+// is warmed from the social-graph collection at startup and kept current by
+// Follow/Unfollow/InsertUser, so it is only consistent when a single
+// social-graph-service instance owns all graph writes.
+class SocialGraphIndex {
+ public:
+  SocialGraphIndex() = default;
+  ~SocialGraphIndex() = default;
+
+  SocialGraphIndex(const SocialGraphIndex &) = delete;
+  SocialGraphIndex &operator=(const SocialGraphIndex &) = delete;
+
+  bool Warmup(mongoc_client_pool_t *, bool = false);
+  bool GetFollowers(int64_t, std::vector<int64_t> *);
+  bool GetFollowees(int64_t, std::vector<int64_t> *);
+  void InsertUser(int64_t);
+  void Follow(int64_t, int64_t);
+  void Unfollow(int64_t, int64_t);
+  // Adds a user with sorted neighbor lists, as the warm-up does for every
+  // user it reads. Ignored if the user is already in.
+  void LoadUser(int64_t, const std::vector<int64_t> &,
+                const std::vector<int64_t> &);
+
+  size_t NumUsers();
+  size_t NumEdges();
+  // Including the map from user ids to rows
+  size_t MemoryBytes();
+
+ private:
+  bool LoadFromDocuments(mongoc_collection_t *);
+  bool LoadFromEdges(mongoc_collection_t *);
+  void AppendUser(int64_t, const std::vector<int64_t> &,
+                  const std::vector<int64_t> &);
+  size_t MemoryBytesLocked() const;
+  uint32_t GetOrAddRow(int64_t);
+  void MaybeCompact();
+
+  std::unordered_map<int64_t, uint32_t> _rows;
+  CompressedAdjacency _followers;
+  CompressedAdjacency _followees;
+  std::shared_timed_mutex _mtx;
+};
+
+static void ParseNeighbors(const bson_t *doc, const char *field,
+                           std::vector<int64_t> *out) {
+  ForEachArrayDocument(doc, field, [&](const bson_iter_t *edge, int idx) {
+    int64_t neighbor_id;
+    if (GetInt64Field(edge, "user_id", &neighbor_id)) {
+      out->emplace_back(neighbor_id);
+    }
+    return true;
+  });
+  std::sort(out->begin(), out->end());
+  out->erase(std::unique(out->begin(), out->end()), out->end());
+}
+
+bool SocialGraphIndex::Warmup(mongoc_client_pool_t *mongodb_client_pool,
+                              bool use_edge_collection) {
+  auto start = std::chrono::steady_clock::now();
+  mongoc_client_t *mongodb_client = mongoc_client_pool_pop(mongodb_client_pool);
+  if (!mongodb_client) {
+    LOG(error) << "Failed to pop a client from MongoDB pool";
+    return false;
+  }
+  auto collection = mongoc_client_get_collection(
+      mongodb_client, "social-graph",
+      use_edge_collection ? SOCIAL_GRAPH_EDGE_COLLECTION : "social-graph");
+  if (!collection) {
+    LOG(error) << "Failed to create collection social_graph from MongoDB";
+    mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
+    return false;
+  }
+
+  std::unique_lock<std::shared_timed_mutex> lock(_mtx);
+  bool success = use_edge_collection ? LoadFromEdges(collection)
+                                     : LoadFromDocuments(collection);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
+  if (!success) {
+    return false;
+  }
+
+  size_t num_edges = _followees.NumEdges();
+  size_t bytes = MemoryBytesLocked();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  LOG(info) << "Social graph index warmed up in " << elapsed.count()
+            << " ms: " << _rows.size() << " users, " << num_edges
+            << " edges, " << bytes << " bytes ("
+            << (num_edges ? static_cast<double>(bytes) / num_edges : 0.0)
+            << " bytes/edge)";
+  return true;
+}
+
+bool SocialGraphIndex::LoadFromDocuments(mongoc_collection_t *collection) {
+  bson_t *query = bson_new();
+  bson_t *opts = BCON_NEW("projection", "{", "_id", BCON_BOOL(false),
+                          "user_id", BCON_BOOL(true), "followers.user_id",
+                          BCON_BOOL(true), "followees.user_id",
+                          BCON_BOOL(true), "}");
+  mongoc_cursor_t *cursor =
+      mongoc_collection_find_with_opts(collection, query, opts, nullptr);
+
+  const bson_t *doc;
+  std::vector<int64_t> followers;
+  std::vector<int64_t> followees;
+  bson_iter_t iter;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    if (!bson_iter_init_find(&iter, doc, "user_id") ||
+        !BSON_ITER_HOLDS_INT64(&iter)) {
+      continue;
+    }
+    int64_t user_id = bson_iter_int64(&iter);
+    if (_rows.count(user_id)) {
+      continue;
+    }
+    followers.clear();
+    ParseNeighbors(doc, "followers", &followers);
+    followees.clear();
+    ParseNeighbors(doc, "followees", &followees);
+    AppendUser(user_id, followers, followees);
+  }
+
+  bson_error_t error;
+  bool success = !mongoc_cursor_error(cursor, &error);
+  if (!success) {
+    LOG(error) << "Failed to warm up social graph index from MongoDB: "
+               << error.message;
+  }
+  bson_destroy(opts);
+  bson_destroy(query);
+  mongoc_cursor_destroy(cursor);
+  return success;
+}
+
+bool SocialGraphIndex::LoadFromEdges(mongoc_collection_t *collection) {
+  bson_t *query = bson_new();
+  bson_t *opts = BCON_NEW("projection", "{", "_id", BCON_BOOL(false),
+                          "follower_id", BCON_BOOL(true), "followee_id",
+                          BCON_BOOL(true), "}");
+  mongoc_cursor_t *cursor =
+      mongoc_collection_find_with_opts(collection, query, opts, nullptr);
+
+  // Edges arrive in no particular order, so gather the neighbor lists of
+  // every user before encoding them row by row.
+  std::unordered_map<int64_t, std::vector<int64_t>> followers;
+  std::unordered_map<int64_t, std::vector<int64_t>> followees;
+  const bson_t *doc;
+  bson_iter_t iter;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    int64_t follower_id;
+    int64_t followee_id;
+    if (!bson_iter_init_find(&iter, doc, "follower_id") ||
+        !BSON_ITER_HOLDS_INT64(&iter)) {
+      continue;
+    }
+    follower_id = bson_iter_int64(&iter);
+    if (!bson_iter_init_find(&iter, doc, "followee_id") ||
+        !BSON_ITER_HOLDS_INT64(&iter)) {
+      continue;
+    }
+    followee_id = bson_iter_int64(&iter);
+    followees[follower_id].emplace_back(followee_id);
+    followers[followee_id].emplace_back(follower_id);
+  }
+
+  bson_error_t error;
+  bool success = !mongoc_cursor_error(cursor, &error);
+  if (!success) {
+    LOG(error) << "Failed to warm up social graph index from MongoDB: "
+               << error.message;
+  }
+  bson_destroy(opts);
+  bson_destroy(query);
+  mongoc_cursor_destroy(cursor);
+  if (!success) {
+    return false;
+  }
+
+  for (auto &user : followees) {
+    followers[user.first];
+  }
+  std::vector<int64_t> empty;
+  for (auto &user : followers) {
+    auto &user_followers = user.second;
+    auto followees_it = followees.find(user.first);
+    auto &user_followees =
+        followees_it != followees.end() ? followees_it->second : empty;
+    std::sort(user_followers.begin(), user_followers.end());
+    std::sort(user_followees.begin(), user_followees.end());
+    AppendUser(user.first, user_followers, user_followees);
+    std::vector<int64_t>().swap(user_followers);
+    std::vector<int64_t>().swap(user_followees);
+  }
+  return true;
+}
+
+void SocialGraphIndex::AppendUser(int64_t user_id,
+                                  const std::vector<int64_t> &followers,
+                                  const std::vector<int64_t> &followees) {
+  if (_rows.emplace(user_id, _followers.NumRows()).second) {
+    _followers.AppendRow(followers);
+    _followees.AppendRow(followees);
+  }
+}
+
+uint32_t SocialGraphIndex::GetOrAddRow(int64_t user_id) {
+  auto it = _rows.find(user_id);
+  if (it != _rows.end()) {
+    return it->second;
+  }
+  uint32_t row = _followers.NumRows();
+  _rows.emplace(user_id, row);
+  _followers.AddRow();
+  _followees.AddRow();
+  return row;
+}
+
+void SocialGraphIndex::MaybeCompact() {
+  if (_followers.NeedsCompaction()) {
+    _followers.Compact();
+  }
+  if (_followees.NeedsCompaction()) {
+    _followees.Compact();
+  }
+}
+
+bool SocialGraphIndex::GetFollowers(int64_t user_id,
+                                    std::vector<int64_t> *out) {
+  std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+  auto it = _rows.find(user_id);
+  if (it == _rows.end()) {
+    return false;
+  }
+  _followers.Decode(it->second, out);
+  return true;
+}
+
+bool SocialGraphIndex::GetFollowees(int64_t user_id,
+                                    std::vector<int64_t> *out) {
+  std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+  auto it = _rows.find(user_id);
+  if (it == _rows.end()) {
+    return false;
+  }
+  _followees.Decode(it->second, out);
+  return true;
+}
+
+void SocialGraphIndex::InsertUser(int64_t user_id) {
+  std::unique_lock<std::shared_timed_mutex> lock(_mtx);
+  GetOrAddRow(user_id);
+}
+
+void SocialGraphIndex::Follow(int64_t user_id, int64_t followee_id) {
+  std::unique_lock<std::shared_timed_mutex> lock(_mtx);
+  _followees.Insert(GetOrAddRow(user_id), followee_id);
+  _followers.Insert(GetOrAddRow(followee_id), user_id);
+  MaybeCompact();
+}
+
+void SocialGraphIndex::Unfollow(int64_t user_id, int64_t followee_id) {
+  std::unique_lock<std::shared_timed_mutex> lock(_mtx);
+  _followees.Erase(GetOrAddRow(user_id), followee_id);
+  _followers.Erase(GetOrAddRow(followee_id), user_id);
+  MaybeCompact();
+}
+
+void SocialGraphIndex::LoadUser(int64_t user_id,
+                                const std::vector<int64_t> &followers,
+                                const std::vector<int64_t> &followees) {
+  std::unique_lock<std::shared_timed_mutex> lock(_mtx);
+  AppendUser(user_id, followers, followees);
+}
+
+size_t SocialGraphIndex::NumUsers() {
+  std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+  return _rows.size();
+}
+
+size_t SocialGraphIndex::NumEdges() {
+  std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+  return _followees.NumEdges();
+}
+
+size_t SocialGraphIndex::MemoryBytes() {
+  std::shared_lock<std::shared_timed_mutex> lock(_mtx);
+  return MemoryBytesLocked();
+}
+
+size_t SocialGraphIndex::MemoryBytesLocked() const {
+  return _followers.MemoryBytes() + _followees.MemoryBytes() +
+         _rows.size() * (sizeof(int64_t) + sizeof(uint32_t) +
+                         sizeof(void *)) +
+         _rows.bucket_count() * sizeof(void *);
+}
+
+}  // namespace social_network
+
+#endif  // SOCIAL_NETWORK_MICROSERVICES_SOCIALGRAPHINDEX_H
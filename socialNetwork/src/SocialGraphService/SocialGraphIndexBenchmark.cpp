@@ -0,0 +1,82 @@
+/*
+ * Memory per edge and lookup latency of SocialGraphIndex.
+ *
+ * Usage: SocialGraphIndexBenchmark [edges file] [lookups]
+ *
+ * Loads the graph of an edge list into the index, following every edge in
+ * both directions like scripts/init_social_graph.py, and reports the memory
+ * per directed edge the warm-up logs. Then looks up the followers and the
+ * followees of random users, as GetFollowers and GetFollowees do, and
+ * reports the time per lookup.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../utils.h"
+#include "../utils_mongodb.h"
+#include "../DatasetLoader/EdgeList.h"
+#include "SocialGraphIndex.h"
+
+using namespace social_network;
+
+int main(int argc, char *argv[]) {
+  std::string edges_path =
+      argc > 1 ? argv[1]
+               : "datasets/social-graph/socfb-Reed98/socfb-Reed98.edges";
+  int64_t num_lookups = argc > 2 ? std::atoll(argv[2]) : 10000000;
+
+  MappedFile edges_file;
+  if (!edges_file.Open(edges_path)) {
+    std::cerr << "Failed to map " << edges_path << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> edges;
+  ParseEdgeList(edges_file, 1, &edges);
+  int64_t num_users = 0;
+  for (auto &edge : edges[0]) {
+    num_users = std::max(num_users, std::max(edge.first, edge.second) + 1);
+  }
+  Adjacency followees;
+  Adjacency followers;
+  BuildAdjacency(edges, num_users, true, &followees, &followers);
+
+  SocialGraphIndex index;
+  for (int64_t user_id = 0; user_id < num_users; ++user_id) {
+    index.LoadUser(
+        user_id,
+        std::vector<int64_t>(followers.begin(user_id), followers.end(user_id)),
+        std::vector<int64_t>(followees.begin(user_id),
+                             followees.end(user_id)));
+  }
+  size_t num_edges = index.NumEdges();
+  std::cout << index.NumUsers() << " users, " << num_edges << " edges, "
+            << static_cast<double>(index.MemoryBytes()) / num_edges
+            << " bytes/edge" << std::endl;
+
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<int64_t> user(0, num_users - 1);
+  std::vector<int64_t> neighbors;
+  int64_t num_neighbors = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < num_lookups; ++i) {
+    neighbors.clear();
+    if (i % 2 == 0) {
+      index.GetFollowers(user(gen), &neighbors);
+    } else {
+      index.GetFollowees(user(gen), &neighbors);
+    }
+    num_neighbors += neighbors.size();
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  std::cout << 1e6 * elapsed / num_lookups << " us/lookup, "
+            << static_cast<double>(num_neighbors) / num_lookups
+            << " neighbors/lookup" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -15,7 +15,6 @@
 using json = nlohmann::json;
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -31,7 +30,11 @@ int main(int argc, char *argv[]) {
   desc.add_options()("help", "produce help message")(
       "redis-cluster",
       po::value<bool>()->default_value(false)->implicit_value(true),
-      "Enable redis cluster mode");
+      "Enable redis cluster mode")(
+      "migrate-edges",
+      po::value<bool>()->default_value(false)->implicit_value(true),
+      "Copy the embedded followers/followees arrays into the edge collection "
+      "before serving");
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -49,6 +52,13 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  bool migrate_edges_flag = false;
+  if (vm.count("migrate-edges")) {
+    if (vm["migrate-edges"].as<bool>()) {
+      migrate_edges_flag = true;
+    }
+  }
+
   SetUpTracer("config/jaeger-config.yml", "social-graph-service");
 
   json config_json;
@@ -67,6 +77,11 @@ int main(int argc, char *argv[]) {
   int user_timeout = config_json["user-service"]["timeout_ms"];
   int user_keepalive = config_json["user-service"]["keepalive_ms"];
 
+  int edge_collection_config_flag =
+      config_json["social-graph-mongodb"].value("use_edge_collection", 0);
+  int graph_index_config_flag =
+      config_json["social-graph-service"].value("use_graph_index", 0);
+
   int redis_cluster_config_flag = config_json["social-graph-redis"]["use_cluster"];
   int redis_replica_config_flag = config_json["social-graph-redis"]["use_replica"];
   mongoc_client_pool_t *mongodb_client_pool =
@@ -98,8 +113,36 @@ int main(int argc, char *argv[]) {
       sleep(1);
     }
   }
+  if (edge_collection_config_flag || migrate_edges_flag) {
+    r = false;
+    while (!r) {
+      r = CreateEdgeIndexes(mongodb_client);
+      if (!r) {
+        LOG(error) << "Failed to create mongodb index, try again";
+        sleep(1);
+      }
+    }
+  }
   mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
 
+  if (migrate_edges_flag) {
+    if (!MigrateEmbeddedEdges(mongodb_client_pool)) {
+      LOG(fatal) << "Failed to migrate social graph edges";
+      return EXIT_FAILURE;
+    }
+  }
+
+  SocialGraphIndex graph_index;
+  SocialGraphIndex *graph_index_ptr = nullptr;
+  if (graph_index_config_flag) {
+    if (!graph_index.Warmup(mongodb_client_pool,
+                            edge_collection_config_flag)) {
+      LOG(fatal) << "Failed to warm up the social graph index";
+      return EXIT_FAILURE;
+    }
+    graph_index_ptr = &graph_index;
+  }
+
   std::shared_ptr<TServerSocket> server_socket =
       get_server_socket(config_json, "0.0.0.0", port);
 
@@ -110,23 +153,27 @@ int main(int argc, char *argv[]) {
         std::make_shared<SocialGraphServiceProcessor>(
             std::make_shared<SocialGraphHandler>(mongodb_client_pool,
                                                  &redis_cluster_client_pool,
-                                                 &user_client_pool)),
-        server_socket, std::make_shared<TFramedTransportFactory>(),
-        std::make_shared<TBinaryProtocolFactory>());
+                                                 &user_client_pool,
+                                                 graph_index_ptr,
+                                                 edge_collection_config_flag)),
+        server_socket, get_transport_factory(config_json),
+        get_protocol_factory(config_json));
     LOG(info) << "Starting the social-graph-service server with Redis Cluster support...";
     server.serve();
   }
   
   else if (redis_replica_config_flag) {
-      Redis redis_replica_client_pool = init_redis_replica_client_pool(config_json, "redis-replica");
+      RedisReplicas redis_replica_client_pool(
+          init_redis_replica_client_pools(config_json, "redis-replica"));
       Redis redis_primary_client_pool = init_redis_replica_client_pool(config_json, "redis-primary");
 
       TThreadedServer server(
           std::make_shared<SocialGraphServiceProcessor>(
               std::make_shared<SocialGraphHandler>(
-                  mongodb_client_pool, &redis_replica_client_pool, &redis_primary_client_pool, &user_client_pool)),
-          server_socket, std::make_shared<TFramedTransportFactory>(),
-          std::make_shared<TBinaryProtocolFactory>());
+                  mongodb_client_pool, &redis_replica_client_pool, &redis_primary_client_pool, &user_client_pool,
+                  graph_index_ptr, edge_collection_config_flag)),
+          server_socket, get_transport_factory(config_json),
+          get_protocol_factory(config_json));
       LOG(info) << "Starting the social-graph-service server with Redis replica support";
       server.serve();
   }
@@ -137,9 +184,10 @@ int main(int argc, char *argv[]) {
     TThreadedServer server(
         std::make_shared<SocialGraphServiceProcessor>(
             std::make_shared<SocialGraphHandler>(
-                mongodb_client_pool, &redis_client_pool, &user_client_pool)),
-        server_socket, std::make_shared<TFramedTransportFactory>(),
-        std::make_shared<TBinaryProtocolFactory>());
+                mongodb_client_pool, &redis_client_pool, &user_client_pool,
+                graph_index_ptr, edge_collection_config_flag)),
+        server_socket, get_transport_factory(config_json),
+        get_protocol_factory(config_json));
     LOG(info) << "Starting the social-graph-service server ...";
     server.serve();
   }
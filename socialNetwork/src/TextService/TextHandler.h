@@ -3,7 +3,6 @@
 
 #include <future>
 #include <iostream>
-#include <regex>
 #include <string>
 
 #include "../../gen-cpp/TextService.h"
@@ -13,6 +12,7 @@
 #include "../ThriftClient.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "TextScanner.h"
 
 namespace social_network {
 
@@ -50,120 +50,130 @@ void TextHandler::ComposeText(
       "compose_text_server", {opentracing::ChildOf(parent_span->get())});
   opentracing::Tracer::Global()->Inject(span->context(), writer);
 
+  // Find the mentions and the URLs in one pass; their offsets are kept to
+  // splice the shortened URLs in afterwards.
+  std::vector<TextSpan> mention_spans;
+  std::vector<TextSpan> url_spans;
+  TextScanner::Scan(text, &mention_spans, &url_spans);
+
   std::vector<std::string> mention_usernames;
-  std::smatch m;
-  std::regex e("@[a-zA-Z0-9-_]+");
-  auto s = text;
-  while (std::regex_search(s, m, e)) {
-    auto user_mention = m.str();
-    user_mention = user_mention.substr(1, user_mention.length());
-    mention_usernames.emplace_back(user_mention);
-    s = m.suffix().str();
+  mention_usernames.reserve(mention_spans.size());
+  for (auto &mention : mention_spans) {
+    mention_usernames.emplace_back(text, mention.begin,
+                                   mention.end - mention.begin);
   }
 
   std::vector<std::string> urls;
-  e = "(http://|https://)([a-zA-Z0-9_!~*'().&=+$%-]+)";
-  s = text;
-  while (std::regex_search(s, m, e)) {
-    auto url = m.str();
-    urls.emplace_back(url);
-    s = m.suffix().str();
+  urls.reserve(url_spans.size());
+  for (auto &url : url_spans) {
+    urls.emplace_back(text, url.begin, url.end - url.begin);
   }
 
-  auto shortened_urls_future = std::async(std::launch::async, [&]() {
-    auto url_span = opentracing::Tracer::Global()->StartSpan(
-        "compose_urls_client", {opentracing::ChildOf(&span->context())});
+  // Posts without URLs or mentions skip the corresponding RPC.
+  std::future<std::vector<Url>> shortened_urls_future;
+  if (!urls.empty()) {
+    shortened_urls_future = std::async(std::launch::async, [&]() {
+      auto url_span = opentracing::Tracer::Global()->StartSpan(
+          "compose_urls_client", {opentracing::ChildOf(&span->context())});
+
+      std::map<std::string, std::string> url_writer_text_map;
+      TextMapWriter url_writer(url_writer_text_map);
+      opentracing::Tracer::Global()->Inject(url_span->context(), url_writer);
+
+      auto url_client_wrapper = _url_client_pool->Pop();
+      if (!url_client_wrapper) {
+        ServiceException se;
+        se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
+        se.message = "Failed to connect to url-shorten-service";
+        throw se;
+      }
+      std::vector<Url> _return_urls;
+      auto url_client = url_client_wrapper->GetClient();
+      try {
+        url_client->ComposeUrls(_return_urls, req_id, urls,
+                                url_writer_text_map);
+      } catch (...) {
+        LOG(error) << "Failed to upload urls to url-shorten-service";
+        _url_client_pool->Remove(url_client_wrapper);
+        throw;
+      }
+      _url_client_pool->Keepalive(url_client_wrapper);
+      return _return_urls;
+    });
+  }
 
-    std::map<std::string, std::string> url_writer_text_map;
-    TextMapWriter url_writer(url_writer_text_map);
-    opentracing::Tracer::Global()->Inject(url_span->context(), url_writer);
+  std::future<std::vector<UserMention>> user_mention_future;
+  if (!mention_usernames.empty()) {
+    user_mention_future = std::async(std::launch::async, [&]() {
+      auto user_mention_span = opentracing::Tracer::Global()->StartSpan(
+          "compose_user_mentions_client",
+          {opentracing::ChildOf(&span->context())});
+
+      std::map<std::string, std::string> user_mention_writer_text_map;
+      TextMapWriter user_mention_writer(user_mention_writer_text_map);
+      opentracing::Tracer::Global()->Inject(user_mention_span->context(),
+                                            user_mention_writer);
+
+      auto user_mention_client_wrapper = _user_mention_client_pool->Pop();
+      if (!user_mention_client_wrapper) {
+        ServiceException se;
+        se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
+        se.message = "Failed to connect to user-mention-service";
+        throw se;
+      }
+      std::vector<UserMention> _return_user_mentions;
+      auto user_mention_client = user_mention_client_wrapper->GetClient();
+      try {
+        user_mention_client->ComposeUserMentions(_return_user_mentions, req_id,
+                                                 mention_usernames,
+                                                 user_mention_writer_text_map);
+      } catch (...) {
+        LOG(error) << "Failed to upload user_mentions to user-mention-service";
+        _user_mention_client_pool->Remove(user_mention_client_wrapper);
+        throw;
+      }
+
+      _user_mention_client_pool->Keepalive(user_mention_client_wrapper);
+      return _return_user_mentions;
+    });
+  }
 
-    auto url_client_wrapper = _url_client_pool->Pop();
-    if (!url_client_wrapper) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
-      se.message = "Failed to connect to url-shorten-service";
-      throw se;
-    }
-    std::vector<Url> _return_urls;
-    auto url_client = url_client_wrapper->GetClient();
+  std::vector<Url> target_urls;
+  if (shortened_urls_future.valid()) {
     try {
-      url_client->ComposeUrls(_return_urls, req_id, urls, url_writer_text_map);
+      target_urls = shortened_urls_future.get();
     } catch (...) {
-      LOG(error) << "Failed to upload urls to url-shorten-service";
-      _url_client_pool->Remove(url_client_wrapper);
+      LOG(error) << "Failed to get shortened urls from url-shorten-service";
       throw;
     }
-    _url_client_pool->Keepalive(url_client_wrapper);
-    return _return_urls;
-  });
-
-  auto user_mention_future = std::async(std::launch::async, [&]() {
-    auto user_mention_span = opentracing::Tracer::Global()->StartSpan(
-        "compose_user_mentions_client",
-        {opentracing::ChildOf(&span->context())});
-
-    std::map<std::string, std::string> user_mention_writer_text_map;
-    TextMapWriter user_mention_writer(user_mention_writer_text_map);
-    opentracing::Tracer::Global()->Inject(user_mention_span->context(),
-                                          user_mention_writer);
-
-    auto user_mention_client_wrapper = _user_mention_client_pool->Pop();
-    if (!user_mention_client_wrapper) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
-      se.message = "Failed to connect to user-mention-service";
-      throw se;
-    }
-    std::vector<UserMention> _return_user_mentions;
-    auto user_mention_client = user_mention_client_wrapper->GetClient();
+  }
+
+  std::vector<UserMention> user_mentions;
+  if (user_mention_future.valid()) {
     try {
-      user_mention_client->ComposeUserMentions(_return_user_mentions, req_id,
-                                               mention_usernames,
-                                               user_mention_writer_text_map);
+      user_mentions = user_mention_future.get();
     } catch (...) {
-      LOG(error) << "Failed to upload user_mentions to user-mention-service";
-      _user_mention_client_pool->Remove(user_mention_client_wrapper);
+      LOG(error) << "Failed to upload user mentions to user-mention-service";
       throw;
     }
-
-    _user_mention_client_pool->Keepalive(user_mention_client_wrapper);
-    return _return_user_mentions;
-  });
-
-  std::vector<Url> target_urls;
-  try {
-    target_urls = shortened_urls_future.get();
-  } catch (...) {
-    LOG(error) << "Failed to get shortened urls from url-shorten-service";
-    throw;
   }
 
-  std::vector<UserMention> user_mentions;
-  try {
-    user_mentions = user_mention_future.get();
-  } catch (...) {
-    LOG(error) << "Failed to upload user mentions to user-mention-service";
-    throw;
+  if (target_urls.size() != url_spans.size()) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+    se.message = "url-shorten-service returned " +
+                 std::to_string(target_urls.size()) + " urls for " +
+                 std::to_string(url_spans.size());
+    throw se;
   }
-
-  std::string updated_text;
-  if (!urls.empty()) {
-    s = text;
-    int idx = 0;
-    while (std::regex_search(s, m, e)) {
-      auto url = m.str();
-      urls.emplace_back(url);
-      updated_text += m.prefix().str() + target_urls[idx].shortened_url;
-      s = m.suffix().str();
-      idx++;
-    }
-  } else {
-    updated_text = text;
+  std::vector<std::string> shortened_urls;
+  shortened_urls.reserve(target_urls.size());
+  for (auto &target_url : target_urls) {
+    shortened_urls.emplace_back(target_url.shortened_url);
   }
 
   _return.user_mentions = user_mentions;
-  _return.text = updated_text;
+  _return.text = TextScanner::Splice(text, url_spans, shortened_urls);
   _return.urls = target_urls;
   span->Finish();
 }
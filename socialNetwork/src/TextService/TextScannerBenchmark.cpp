@@ -0,0 +1,138 @@
+/*
+ * Microbenchmark of the mention and URL extraction of the text service.
+ *
+ * Usage: TextScannerBenchmark [posts] [iterations]
+ *
+ * Builds post texts the way wrk2/scripts/social-network/compose-post.lua
+ * does (256 random characters, then 1-6 " @username_<n>" mentions and 1-6
+ * " http://<64 random characters>" URLs), checks that TextScanner finds the
+ * same mentions and URLs as the regexes it replaced, also on randomized
+ * texts, and reports the posts/s of both.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "TextScanner.h"
+
+using namespace social_network;
+
+static const std::string kCharset =
+    "qwertyuiopasdfghjklzxcvbnmQWERTYUIOPASDFGHJKLZXCVBNM1234567890";
+
+static std::string RandomString(std::mt19937 *gen, int length,
+                                const std::string &charset) {
+  std::uniform_int_distribution<int> dist(0, charset.size() - 1);
+  std::string s;
+  for (int i = 0; i < length; ++i) {
+    s += charset[dist(*gen)];
+  }
+  return s;
+}
+
+static std::string ComposePostText(std::mt19937 *gen) {
+  std::uniform_int_distribution<int> count(0, 5);
+  std::uniform_int_distribution<int> user(0, 961);
+  std::string text = RandomString(gen, 256, kCharset);
+  for (int i = count(*gen); i >= 0; --i) {
+    text += " @username_" + std::to_string(user(*gen));
+  }
+  for (int i = count(*gen); i >= 0; --i) {
+    text += " http://" + RandomString(gen, 64, kCharset);
+  }
+  return text;
+}
+
+// The extraction ComposeText did before TextScanner.
+static void RegexScan(const std::string &text,
+                      std::vector<std::string> *mentions,
+                      std::vector<std::string> *urls) {
+  std::smatch m;
+  std::regex e("@[a-zA-Z0-9-_]+");
+  auto s = text;
+  while (std::regex_search(s, m, e)) {
+    mentions->emplace_back(m.str().substr(1));
+    s = m.suffix().str();
+  }
+  e = "(http://|https://)([a-zA-Z0-9_!~*'().&=+$%-]+)";
+  s = text;
+  while (std::regex_search(s, m, e)) {
+    urls->emplace_back(m.str());
+    s = m.suffix().str();
+  }
+}
+
+static void Scan(const std::string &text, std::vector<std::string> *mentions,
+                 std::vector<std::string> *urls) {
+  std::vector<TextSpan> mention_spans;
+  std::vector<TextSpan> url_spans;
+  TextScanner::Scan(text, &mention_spans, &url_spans);
+  for (auto &span : mention_spans) {
+    mentions->emplace_back(text, span.begin, span.end - span.begin);
+  }
+  for (auto &span : url_spans) {
+    urls->emplace_back(text, span.begin, span.end - span.begin);
+  }
+}
+
+template <class F>
+static double PostsPerSecond(const std::vector<std::string> &texts,
+                             int iterations, F scan) {
+  size_t matches = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    for (auto &text : texts) {
+      std::vector<std::string> mentions;
+      std::vector<std::string> urls;
+      scan(text, &mentions, &urls);
+      matches += mentions.size() + urls.size();
+    }
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  if (matches == 0) {
+    std::cerr << "no matches" << std::endl;
+  }
+  return texts.size() * iterations / elapsed;
+}
+
+int main(int argc, char *argv[]) {
+  int num_posts = argc > 1 ? std::atoi(argv[1]) : 1000;
+  int iterations = argc > 2 ? std::atoi(argv[2]) : 10;
+  std::mt19937 gen(42);
+
+  // Randomized texts over the characters that matter to the two patterns.
+  std::vector<std::string> checks;
+  std::uniform_int_distribution<int> length(0, 64);
+  for (int i = 0; i < 100000; ++i) {
+    checks.emplace_back(RandomString(&gen, length(gen), "@:/htps-_.a?"));
+  }
+  std::vector<std::string> texts;
+  for (int i = 0; i < num_posts; ++i) {
+    texts.emplace_back(ComposePostText(&gen));
+  }
+  checks.insert(checks.end(), texts.begin(), texts.end());
+  for (auto &text : checks) {
+    std::vector<std::string> regex_mentions, regex_urls, mentions, urls;
+    RegexScan(text, &regex_mentions, &regex_urls);
+    Scan(text, &mentions, &urls);
+    if (mentions != regex_mentions || urls != regex_urls) {
+      std::cerr << "Mismatch on \"" << text << "\"" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  double regex_rate = PostsPerSecond(texts, iterations, RegexScan);
+  double scanner_rate = PostsPerSecond(texts, iterations, Scan);
+  std::cout << "regex:   " << static_cast<int64_t>(regex_rate) << " posts/s"
+            << std::endl;
+  std::cout << "scanner: " << static_cast<int64_t>(scanner_rate)
+            << " posts/s (" << scanner_rate / regex_rate << "x)" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -10,7 +10,6 @@
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -52,8 +51,8 @@ int main(int argc, char *argv[]) {
         std::make_shared<TextServiceProcessor>(std::make_shared<TextHandler>(
             &url_client_pool, &user_mention_pool)),
         server_socket,
-        std::make_shared<TFramedTransportFactory>(),
-        std::make_shared<TBinaryProtocolFactory>());
+        get_transport_factory(config_json),
+        get_protocol_factory(config_json));
 
     LOG(info) << "Starting the text-service server...";
     server.serve();
@@ -5,6 +5,7 @@
 #include <thread>
 #include <iostream>
 #include <chrono>
+#include <limits>
 #include <boost/log/trivial.hpp>
 
 #include <thrift/protocol/TBinaryProtocol.h>
@@ -15,91 +16,83 @@
 #include <nlohmann/json.hpp>
 #include "logger.h"
 #include "GenericClient.h"
+#include "ResumableSSLSocket.h"
+#include "utils_thrift.h"
 
 
 namespace social_network {
 
 using apache::thrift::protocol::TProtocol;
 using apache::thrift::protocol::TBinaryProtocol;
-using apache::thrift::transport::TFramedTransport;
 using apache::thrift::transport::TSocket;
-using apache::thrift::transport::TSSLSocketFactory;
 using apache::thrift::transport::TTransport;
 using apache::thrift::TException;
 using json = nlohmann::json;
 
-template<class TThriftClient>
+// TIf is the service interface handed out by GetClient(). It defaults to the
+// generated client class; call sites that may be served by an in-process
+// handler (see the monolith build of ComposePostService) use the *If class.
+template<class TThriftClient, class TIf = TThriftClient>
 class ThriftClient : public GenericClient {
  public:
   ThriftClient(const std::string &addr, int port);
   ThriftClient(const std::string &addr, int port, int keepalive_ms, const json &config_json);
+  // In-process client: GetClient() returns local_handler, which is not owned,
+  // and no connection is ever opened.
+  explicit ThriftClient(TIf *local_handler);
 
   ThriftClient(const ThriftClient &) = delete;
   ThriftClient &operator=(const ThriftClient &) = delete;
-  ThriftClient(ThriftClient<TThriftClient> &&) = default;
+  ThriftClient(ThriftClient<TThriftClient, TIf> &&) = default;
   ThriftClient &operator=(ThriftClient &&) = default;
 
   ~ThriftClient() override;
 
-  TThriftClient *GetClient() const;
+  TIf *GetClient() const;
 
   void Connect() override;
   void Disconnect() override;
   bool IsConnected() override;
 
  private:
-  TThriftClient *_client;
+  TThriftClient *_client = nullptr;
+  TIf *_local_handler = nullptr;
 
   std::shared_ptr<TSocket> _socket;
   std::shared_ptr<TTransport> _transport;
   std::shared_ptr<TProtocol> _protocol;
 };
 
-template<class TThriftClient>
-ThriftClient<TThriftClient>::ThriftClient(
+template<class TThriftClient, class TIf>
+ThriftClient<TThriftClient, TIf>::ThriftClient(
     const std::string &addr, int port) {
   _addr = addr;
   _port = port;
   _socket = std::shared_ptr<TSocket>(new TSocket(addr, port));
   _socket->setKeepAlive(true);
-  _transport = std::shared_ptr<TTransport>(new TFramedTransport(_socket));
+  _transport = std::shared_ptr<TTransport>(new PooledFramedTransport(_socket));
   _protocol = std::shared_ptr<TProtocol>(new TBinaryProtocol(_transport));
   _client = new TThriftClient(_protocol);
   _connect_timestamp = 0;
   _keepalive_ms = 0;
 }
 
-template <class TThriftClient>
-ThriftClient<TThriftClient>::ThriftClient(
+template<class TThriftClient, class TIf>
+ThriftClient<TThriftClient, TIf>::ThriftClient(
     const std::string &addr, int port, int keepalive_ms, const json &config_json) {
   _addr = addr;
   _port = port;
   bool ssl_enabled = config_json["ssl"]["enabled"];
 
   if (ssl_enabled) {
-    std::string ca_path = config_json["ssl"]["caPath"];
-    std::string ciphers = config_json["ssl"]["ciphers"];
-
-    std::shared_ptr<TSSLSocketFactory> factory;
-    factory = std::make_shared<TSSLSocketFactory>();
-    factory->ciphers(ciphers);
-    factory->loadTrustedCertificates(ca_path.c_str());
-
-    // if (config_json["ssl"]["verifyClient"]) {
-    //   std::string cert_path = config_json["ssl"]["clientCertPath"];
-    //   std::string key_path = config_json["ssl"]["clientKeyPath"];
-    //   factory->loadCertificate(cert_path.c_str());
-    //   factory->loadPrivateKey(key_path.c_str());
-    // }
-    // Need verify server
-    factory->authenticate(true);
-    _socket = factory->createSocket(addr, port);
+    // Shared by all clients, which resume each other's TLS sessions
+    _socket = GetClientSSLSocketFactory(config_json)->createSocket(addr, port);
   } else {
     _socket = std::shared_ptr<TSocket>(new TSocket(addr, port));
   }
   _socket->setKeepAlive(true);
-  _transport = std::shared_ptr<TTransport>(new TFramedTransport(_socket));
-  _protocol = std::shared_ptr<TProtocol>(new TBinaryProtocol(_transport));
+  _transport = get_client_transport(config_json, _socket);
+  _protocol = get_protocol(config_json, _transport);
   _client = new TThriftClient(_protocol);
   _connect_timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
                            std::chrono::system_clock::now().time_since_epoch())
@@ -107,24 +100,37 @@ ThriftClient<TThriftClient>::ThriftClient(
   _keepalive_ms = keepalive_ms;
 }
 
-template<class TThriftClient>
-ThriftClient<TThriftClient>::~ThriftClient() {
+template<class TThriftClient, class TIf>
+ThriftClient<TThriftClient, TIf>::ThriftClient(TIf *local_handler) {
+  _addr = "in-process";
+  _port = 0;
+  _local_handler = local_handler;
+  _connect_timestamp = 0;
+  // Never expires in ClientPool::Keepalive().
+  _keepalive_ms = std::numeric_limits<long>::max();
+}
+
+template<class TThriftClient, class TIf>
+ThriftClient<TThriftClient, TIf>::~ThriftClient() {
   Disconnect();
   delete _client;
 }
 
-template<class TThriftClient>
-TThriftClient *ThriftClient<TThriftClient>::GetClient() const {
+template<class TThriftClient, class TIf>
+TIf *ThriftClient<TThriftClient, TIf>::GetClient() const {
+  if (_local_handler) {
+    return _local_handler;
+  }
   return _client;
 }
 
-template<class TThriftClient>
-bool ThriftClient<TThriftClient>::IsConnected() {
-  return _transport->isOpen();
+template<class TThriftClient, class TIf>
+bool ThriftClient<TThriftClient, TIf>::IsConnected() {
+  return _local_handler || _transport->isOpen();
 }
 
-template<class TThriftClient>
-void ThriftClient<TThriftClient>::Connect() {
+template<class TThriftClient, class TIf>
+void ThriftClient<TThriftClient, TIf>::Connect() {
   if (!IsConnected()) {
     try {
       _transport->open();
@@ -134,9 +140,9 @@ void ThriftClient<TThriftClient>::Connect() {
   }
 }
 
-template<class TThriftClient>
-void ThriftClient<TThriftClient>::Disconnect() {
-  if (IsConnected()) {
+template<class TThriftClient, class TIf>
+void ThriftClient<TThriftClient, TIf>::Disconnect() {
+  if (!_local_handler && IsConnected()) {
     try {
       _transport->close();
     } catch (TException &tx) {
@@ -0,0 +1,133 @@
+/*
+ * Cost of TLS connection setup between services, with and without session
+ * resumption.
+ *
+ * Usage: TlsHandshakeBenchmark [keys directory] [connections] [port]
+ *
+ * Serves TLS on 127.0.0.1 with the server socket of the services and opens
+ * connections to it the way ThriftClient does, one at a time, each exchanging
+ * one byte. Reports connections/s and the CPU time per connection of client
+ * and server together, first with full handshakes only, then resuming
+ * sessions.
+ *
+ * Fails if any but the first connection of the second run did not resume,
+ * or if SSL objects are left over once all connections are closed.
+ */
+
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "utils_thrift.h"
+
+using namespace social_network;
+using apache::thrift::transport::TTransport;
+
+// SSL objects created and not yet freed, by client and server
+static std::atomic<int64_t> live_ssl(0);
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+static int CountNewSsl(void *, void *, CRYPTO_EX_DATA *, int, long, void *) {
+  live_ssl.fetch_add(1);
+  return 1;
+}
+#else
+static void CountNewSsl(void *, void *, CRYPTO_EX_DATA *, int, long, void *) {
+  live_ssl.fetch_add(1);
+}
+#endif
+
+static void CountFreedSsl(void *, void *, CRYPTO_EX_DATA *, int, long,
+                          void *) {
+  live_ssl.fetch_sub(1);
+}
+
+static double CpuSeconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+  std::string keys = argc > 1 ? argv[1] : "../keys";
+  int num_connections = argc > 2 ? std::atoi(argv[2]) : 1000;
+  int port = argc > 3 ? std::atoi(argv[3]) : 19090;
+  init_logger();
+  SSL_get_ex_new_index(0, nullptr, CountNewSsl, nullptr, CountFreedSsl);
+
+  json config_json;
+  config_json["ssl"] = {{"enabled", true},
+                        {"caPath", keys + "/CA.pem"},
+                        {"serverCertPath", keys + "/server.crt"},
+                        {"serverKeyPath", keys + "/server.key"},
+                        {"ciphers", "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH"},
+                        {"sessionResumption", true},
+                        {"statsIntervalMs", 3600000}};
+  auto server_socket = get_server_socket(config_json, "127.0.0.1", port);
+  server_socket->listen();
+  std::thread([server_socket]() {
+    while (true) {
+      std::shared_ptr<TTransport> transport = server_socket->accept();
+      uint8_t byte;
+      transport->read(&byte, 1);
+      transport->write(&byte, 1);
+      transport->flush();
+      transport->close();
+    }
+  }).detach();
+
+  for (bool resume : {false, true}) {
+    // As GetClientSSLSocketFactory() builds it
+    auto factory = std::make_shared<ResumableSSLSocketFactory>();
+    factory->ciphers(config_json["ssl"]["ciphers"].get<std::string>());
+    factory->loadTrustedCertificates(
+        config_json["ssl"]["caPath"].get<std::string>().c_str());
+    factory->authenticate(true);
+    if (resume) {
+      factory->EnableClientResumption();
+    }
+    double cpu_start = CpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_connections; ++i) {
+      auto socket = factory->createSocket("127.0.0.1", port);
+      socket->open();
+      uint8_t byte = 0;
+      socket->write(&byte, 1);
+      socket->flush();
+      socket->read(&byte, 1);
+      socket->close();
+    }
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    double cpu = CpuSeconds() - cpu_start;
+    std::cout << (resume ? "resumed: " : "full:    ")
+              << static_cast<int64_t>(num_connections / elapsed)
+              << " connections/s, " << 1e6 * cpu / num_connections
+              << " us CPU/connection" << std::endl;
+
+    uint64_t expected_resumed = resume ? num_connections - 1 : 0;
+    if (factory->ResumedHandshakes() != expected_resumed ||
+        factory->FullHandshakes() + expected_resumed != num_connections) {
+      std::cerr << factory->FullHandshakes() << " full and "
+                << factory->ResumedHandshakes()
+                << " resumed handshakes, expected " << expected_resumed
+                << " resumed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    // The server may still be closing the last connection.
+    for (int i = 0; i < 100 && live_ssl.load() > 0; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (live_ssl.load() != 0) {
+      std::cerr << live_ssl.load() << " SSL objects leaked" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
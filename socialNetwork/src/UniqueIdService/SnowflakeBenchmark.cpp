@@ -0,0 +1,74 @@
+/*
+ * Multithreaded throughput benchmark of the unique-id generator.
+ *
+ * Usage: SnowflakeBenchmark [threads] [seconds] [lease size]
+ *
+ * Every thread draws ids from one shared SnowflakeGenerator, leasing
+ * <lease size> ids per call (1 = ComposeUniqueId, more = ComposeUniqueIds),
+ * and the ids are checked for duplicates at the end. The generator is bound
+ * to 4096 ids per millisecond, so the best possible result is ~4.1M IDs/s.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "SnowflakeGenerator.h"
+
+using namespace social_network;
+
+int main(int argc, char *argv[]) {
+  int num_threads = argc > 1 ? std::atoi(argv[1])
+                             : std::max(1u, std::thread::hardware_concurrency());
+  double seconds = argc > 2 ? std::atof(argv[2]) : 2;
+  int lease_size = argc > 3 ? std::atoi(argv[3]) : 1;
+  if (num_threads <= 0 || seconds <= 0 || lease_size <= 0) {
+    std::cerr << "Usage: " << argv[0] << " [threads] [seconds] [lease size]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  SnowflakeGenerator generator(0xabc);
+  std::atomic<bool> stop(false);
+  std::vector<std::vector<int64_t>> ids(num_threads);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      auto &thread_ids = ids[i];
+      while (!stop.load(std::memory_order_relaxed)) {
+        int64_t first;
+        int count = generator.Lease(lease_size, &first);
+        for (int j = 0; j < count; ++j) {
+          thread_ids.emplace_back(first + j);
+        }
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  std::vector<int64_t> all_ids;
+  for (auto &thread_ids : ids) {
+    all_ids.insert(all_ids.end(), thread_ids.begin(), thread_ids.end());
+  }
+  std::sort(all_ids.begin(), all_ids.end());
+  bool unique =
+      std::adjacent_find(all_ids.begin(), all_ids.end()) == all_ids.end();
+
+  std::cout << num_threads << " threads, lease size " << lease_size << ": "
+            << all_ids.size() << " ids in " << elapsed << " s, "
+            << static_cast<int64_t>(all_ids.size() / elapsed) << " IDs/s, "
+            << (unique ? "no duplicates" : "DUPLICATE IDS") << std::endl;
+  return unique ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -2,8 +2,14 @@
 #define SOCIAL_NETWORK_MICROSERVICES_SRC_URLSHORTENSERVICE_URLSHORTENHANDLER_H_
 
 #include <random>
+#include <atomic>
 #include <chrono>
+#include <cstring>
 #include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 
 #include <mongoc.h>
 #include <libmemcached/memcached.h>
@@ -16,12 +22,19 @@
 #include "../tracing.h"
 
 #define HOSTNAME "http://short-url/"
+#define SHORT_CODE_LENGTH 10
+// Attempts at a content hash that is not taken by another url
+#define MAX_HASH_ATTEMPTS 8
+#define CODE_CACHE_SIZE 65536
+#define CODE_CACHE_TTL_MS 60000
+#define MONGODB_DUPLICATE_KEY 11000
 
 namespace social_network {
 
 class UrlShortenHandler : public UrlShortenServiceIf {
  public:
-  UrlShortenHandler(memcached_pool_st *, mongoc_client_pool_t *, std::mutex *);
+  UrlShortenHandler(memcached_pool_st *, mongoc_client_pool_t *,
+                    bool use_content_hash);
   ~UrlShortenHandler() override = default;
 
   void ComposeUrls(std::vector<Url> &, int64_t,
@@ -35,36 +48,334 @@ class UrlShortenHandler : public UrlShortenServiceIf {
  private:
   memcached_pool_st *_memcached_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
-  static std::mt19937 _generator;
-  std::uniform_int_distribution<int> _distribution;
+  bool _use_content_hash;
+  // expanded url -> short code, of urls shortened in the last
+  // CODE_CACHE_TTL_MS
+  std::unordered_map<std::string,
+                     std::pair<std::string, std::chrono::steady_clock::time_point>>
+      _code_cache;
+  std::mutex _code_cache_lock;
+  std::atomic<int64_t> _urls_composed;
+  std::atomic<int64_t> _urls_inserted;
+
   std::string _GenRandomStr(int length);
-  std::mutex *_thread_lock;
+  void _SetCachedUrls(const std::map<std::string, std::string> &);
+  void _ComposeHashedUrls(std::vector<Url> &,
+                          const opentracing::SpanContext &);
+  bool _GetCachedCode(const std::string &, std::string *);
+  void _SetCachedCode(const std::string &, const std::string &);
+  void _CountUrls(int64_t composed, int64_t inserted);
 };
 
-std::mt19937 UrlShortenHandler::_generator = std::mt19937(std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::system_clock::now().time_since_epoch()).count() % 0xffffffff);
+// Memcached text-protocol keys cannot hold whitespace or control characters.
+static bool IsCacheableUrl(const std::string &shortened_url) {
+  if (shortened_url.empty() || shortened_url.length() >= MEMCACHED_MAX_KEY) {
+    return false;
+  }
+  for (unsigned char c : shortened_url) {
+    if (c <= ' ' || c == 0x7f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Short code of attempt-th content hash of url: FNV-1a 64 of the url and the
+// attempt number, finalized with the splitmix64 mixer and written in base 62.
+static std::string HashShortCode(const std::string &url, int attempt) {
+  const char char_map[] = "abcdefghijklmnopqrstuvwxyzABCDEF"
+                    "GHIJKLMNOPQRSTUVWXYZ0123456789";
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : url) {
+    hash = (hash ^ c) * 0x100000001b3ULL;
+  }
+  hash = (hash ^ static_cast<uint64_t>(attempt)) * 0x100000001b3ULL;
+  hash ^= hash >> 30;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  std::string code;
+  for (int i = 0; i < SHORT_CODE_LENGTH; ++i) {
+    code.append(1, char_map[hash % 62]);
+    hash /= 62;
+  }
+  return code;
+}
 
 UrlShortenHandler::UrlShortenHandler(
     memcached_pool_st *memcached_client_pool,
     mongoc_client_pool_t *mongodb_client_pool,
-    std::mutex *thread_lock) {
+    bool use_content_hash) {
   _memcached_client_pool = memcached_client_pool;
   _mongodb_client_pool = mongodb_client_pool;
-  _thread_lock = thread_lock;
-  _distribution = std::uniform_int_distribution<int>(0, 61);
+  _use_content_hash = use_content_hash;
+  _urls_composed = 0;
+  _urls_inserted = 0;
 }
 
 std::string UrlShortenHandler::_GenRandomStr(int length) {
   const char char_map[] = "abcdefghijklmnopqrstuvwxyzABCDEF"
                     "GHIJKLMNOPQRSTUVWXYZ0123456789";
+  // One generator per server thread, so that requests do not contend on it
+  thread_local std::mt19937 generator(std::random_device{}());
+  std::uniform_int_distribution<int> distribution(0, 61);
   std::string return_str;
-  _thread_lock->lock();
   for (int i = 0; i < length; ++i) {
-    return_str.append(1, char_map[_distribution(_generator)]);
+    return_str.append(1, char_map[distribution(generator)]);
   }
-  _thread_lock->unlock();
   return return_str;
 }
+
+bool UrlShortenHandler::_GetCachedCode(const std::string &expanded_url,
+                                       std::string *code) {
+  std::lock_guard<std::mutex> lock(_code_cache_lock);
+  auto it = _code_cache.find(expanded_url);
+  if (it == _code_cache.end()) {
+    return false;
+  }
+  if (std::chrono::steady_clock::now() - it->second.second >
+      std::chrono::milliseconds(CODE_CACHE_TTL_MS)) {
+    _code_cache.erase(it);
+    return false;
+  }
+  *code = it->second.first;
+  return true;
+}
+
+void UrlShortenHandler::_SetCachedCode(const std::string &expanded_url,
+                                       const std::string &code) {
+  auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(_code_cache_lock);
+  if (_code_cache.size() >= CODE_CACHE_SIZE) {
+    for (auto it = _code_cache.begin(); it != _code_cache.end();) {
+      if (now - it->second.second >
+          std::chrono::milliseconds(CODE_CACHE_TTL_MS)) {
+        it = _code_cache.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (_code_cache.size() >= CODE_CACHE_SIZE) {
+      _code_cache.clear();
+    }
+  }
+  _code_cache[expanded_url] = std::make_pair(code, now);
+}
+
+void UrlShortenHandler::_CountUrls(int64_t composed, int64_t inserted) {
+  int64_t before = _urls_composed.fetch_add(composed);
+  int64_t total_inserted = _urls_inserted.fetch_add(inserted) + inserted;
+  if ((before + composed) / 100000 != before / 100000) {
+    int64_t total = before + composed;
+    LOG(info) << "Shortened " << total << " urls with " << total_inserted
+              << " MongoDB inserts ("
+              << 100.0 * (total - total_inserted) / total
+              << "% of the writes avoided)";
+  }
+}
+
+// Shortens each url to a code derived from the url itself, so a url that was
+// shortened before gets its old code back. The local code cache and memcached
+// answer repeated urls without touching MongoDB; the rest are upserted, which
+// writes nothing for urls that are already stored.
+void UrlShortenHandler::_ComposeHashedUrls(
+    std::vector<Url> &target_urls,
+    const opentracing::SpanContext &parent_context) {
+  std::map<std::string, std::string> codes;
+  for (auto &url : target_urls) {
+    std::string code;
+    if (!_GetCachedCode(url.expanded_url, &code)) {
+      codes.emplace(url.expanded_url, HashShortCode(url.expanded_url, 0));
+    } else {
+      url.shortened_url = HOSTNAME + code;
+    }
+  }
+
+  // Codes whose url memcached confirms are not written again
+  std::map<std::string, std::string> urls_to_store;
+  if (!codes.empty()) {
+    memcached_return_t rc;
+    auto client = memcached_pool_pop(_memcached_client_pool, true, &rc);
+    if (!client) {
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MEMCACHED_ERROR;
+      se.message = "Failed to pop a client from memcached pool";
+      throw se;
+    }
+    std::map<std::string, std::string> expanded_by_key;
+    std::vector<std::string> key_strs;
+    for (auto &it : codes) {
+      key_strs.emplace_back(HOSTNAME + it.second);
+      expanded_by_key.emplace(key_strs.back(), it.first);
+    }
+    std::vector<const char *> keys;
+    std::vector<size_t> key_sizes;
+    for (auto &key : key_strs) {
+      keys.emplace_back(key.c_str());
+      key_sizes.emplace_back(key.length());
+    }
+    auto get_span = opentracing::Tracer::Global()->StartSpan(
+        "url_mmc_mget_client", { opentracing::ChildOf(&parent_context) });
+    rc = memcached_mget(client, keys.data(), key_sizes.data(), keys.size());
+    // Keys of unreachable servers read as misses
+    if (rc != MEMCACHED_SUCCESS && rc != MEMCACHED_SOME_ERRORS) {
+      LOG(error) << "Cannot get shortened urls: "
+                 << memcached_strerror(client, rc);
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MEMCACHED_ERROR;
+      se.message = memcached_strerror(client, rc);
+      memcached_pool_push(_memcached_client_pool, client);
+      get_span->Finish();
+      throw se;
+    }
+    urls_to_store = codes;
+    char return_key[MEMCACHED_MAX_KEY];
+    size_t return_key_length;
+    char *return_value;
+    size_t return_value_length;
+    uint32_t flags;
+    while (true) {
+      return_value = memcached_fetch(client, return_key, &return_key_length,
+                                     &return_value_length, &flags, &rc);
+      if (return_value == nullptr) {
+        break;
+      }
+      if (rc == MEMCACHED_SUCCESS) {
+        auto it = expanded_by_key.find(
+            std::string(return_key, return_key + return_key_length));
+        if (it != expanded_by_key.end() &&
+            it->second == std::string(return_value,
+                                      return_value + return_value_length)) {
+          _SetCachedCode(it->second, codes[it->second]);
+          urls_to_store.erase(it->second);
+        }
+      }
+      free(return_value);
+    }
+    get_span->Finish();
+    memcached_quit(client);
+    memcached_pool_push(_memcached_client_pool, client);
+  }
+
+  int64_t inserted = 0;
+  std::map<std::string, std::string> urls_to_cache;
+  if (!urls_to_store.empty()) {
+    mongoc_client_t *mongodb_client = mongoc_client_pool_pop(
+        _mongodb_client_pool);
+    if (!mongodb_client) {
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+      se.message = "Failed to pop a client from MongoDB pool";
+      throw se;
+    }
+    auto collection = mongoc_client_get_collection(
+        mongodb_client, "url-shorten", "url-shorten");
+    if (!collection) {
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+      se.message = "Failed to create collection url-shorten from DB url-shorten";
+      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+      throw se;
+    }
+    auto mongo_span = opentracing::Tracer::Global()->StartSpan(
+        "url_mongo_upsert_client", { opentracing::ChildOf(&parent_context) });
+    bson_t *opts = BCON_NEW("upsert", BCON_BOOL(true));
+    for (auto &it : urls_to_store) {
+      const std::string &expanded_url = it.first;
+      std::string code = it.second;
+      bool stored = false;
+      for (int attempt = 0; attempt < MAX_HASH_ATTEMPTS && !stored;) {
+        std::string shortened_url = HOSTNAME + code;
+        // Matches only if this url already owns the code; otherwise the
+        // upsert runs into the unique index on shortened_url.
+        bson_t *selector = BCON_NEW(
+            "shortened_url", BCON_UTF8(shortened_url.c_str()),
+            "expanded_url", BCON_UTF8(expanded_url.c_str()));
+        bson_t *update = BCON_NEW(
+            "$setOnInsert", "{",
+            "shortened_url", BCON_UTF8(shortened_url.c_str()),
+            "expanded_url", BCON_UTF8(expanded_url.c_str()), "}");
+        bson_t reply;
+        bson_error_t error;
+        bool ret = mongoc_collection_update_one(
+            collection, selector, update, opts, &reply, &error);
+        if (ret) {
+          bson_iter_t iter;
+          if (bson_iter_init_find(&iter, &reply, "upsertedCount") &&
+              bson_iter_int32(&iter) > 0) {
+            inserted++;
+          }
+          stored = true;
+        } else if (error.code == MONGODB_DUPLICATE_KEY) {
+          // Either another url owns the code, or a concurrent request has
+          // just stored this url under it.
+          bson_t *query = BCON_NEW(
+              "shortened_url", BCON_UTF8(shortened_url.c_str()));
+          mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
+              collection, query, nullptr, nullptr);
+          const bson_t *doc;
+          bson_iter_t iter;
+          if (mongoc_cursor_next(cursor, &doc) &&
+              bson_iter_init_find(&iter, doc, "expanded_url") &&
+              expanded_url == bson_iter_utf8(&iter, nullptr)) {
+            stored = true;
+          } else {
+            LOG(warning) << "Short code " << code << " of " << expanded_url
+                         << " is taken by another url";
+            code = HashShortCode(expanded_url, ++attempt);
+          }
+          mongoc_cursor_destroy(cursor);
+          bson_destroy(query);
+        } else {
+          LOG(error) << "MongoDB error: " << error.message;
+        }
+        bson_destroy(&reply);
+        bson_destroy(update);
+        bson_destroy(selector);
+        if (!stored && error.code != MONGODB_DUPLICATE_KEY) {
+          break;
+        }
+      }
+      if (!stored) {
+        ServiceException se;
+        se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+        se.message = "Failed to store the short code of " + expanded_url;
+        bson_destroy(opts);
+        mongoc_collection_destroy(collection);
+        mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+        mongo_span->Finish();
+        throw se;
+      }
+      codes[expanded_url] = code;
+      urls_to_cache.emplace(HOSTNAME + code, expanded_url);
+      _SetCachedCode(expanded_url, code);
+    }
+    bson_destroy(opts);
+    mongoc_collection_destroy(collection);
+    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+    mongo_span->Finish();
+  }
+
+  for (auto &url : target_urls) {
+    auto it = codes.find(url.expanded_url);
+    if (it != codes.end()) {
+      url.shortened_url = HOSTNAME + it->second;
+    }
+  }
+
+  if (!urls_to_cache.empty()) {
+    auto set_span = opentracing::Tracer::Global()->StartSpan(
+        "url_mmc_set_client", { opentracing::ChildOf(&parent_context) });
+    try {
+      _SetCachedUrls(urls_to_cache);
+    } catch (...) {
+      LOG(warning) << "Failed to set shortened urls to memcached";
+    }
+    set_span->Finish();
+  }
+  _CountUrls(target_urls.size(), inserted);
+}
 void UrlShortenHandler::ComposeUrls(
     std::vector<Url> &_return,
     int64_t req_id,
@@ -83,13 +394,26 @@ void UrlShortenHandler::ComposeUrls(
 
   std::vector<Url> target_urls;
   std::future<void> mongo_future;
+  std::future<void> set_future;
+
+  if (!urls.empty() && _use_content_hash) {
+    for (auto &url : urls) {
+      Url new_target_url;
+      new_target_url.expanded_url = url;
+      target_urls.emplace_back(new_target_url);
+    }
+    _ComposeHashedUrls(target_urls, span->context());
+    _return = target_urls;
+    span->Finish();
+    return;
+  }
 
   if (!urls.empty()) {
     for (auto &url : urls) {
       Url new_target_url;
       new_target_url.expanded_url = url;
       new_target_url.shortened_url = HOSTNAME +
-          _GenRandomStr(10);
+          _GenRandomStr(SHORT_CODE_LENGTH);
       target_urls.emplace_back(new_target_url);
     }
 
@@ -150,6 +474,17 @@ void UrlShortenHandler::ComposeUrls(
           mongo_span->Finish();
         });
 
+    // Cache the new urls so that the first redirects do not miss
+    set_future = std::async(std::launch::async, [&]() {
+      std::map<std::string, std::string> url_map;
+      for (auto &url : target_urls) {
+        url_map.emplace(url.shortened_url, url.expanded_url);
+      }
+      auto set_span = opentracing::Tracer::Global()->StartSpan(
+          "url_mmc_set_client", {opentracing::ChildOf(&span->context())});
+      _SetCachedUrls(url_map);
+      set_span->Finish();
+    });
   }
 
   if (!urls.empty()) {
@@ -157,8 +492,18 @@ void UrlShortenHandler::ComposeUrls(
       mongo_future.get();
     } catch (...) {
       LOG(error) << "Failed to upload shortened urls from MongoDB";
+      try {
+        set_future.get();
+      } catch (...) {
+      }
       throw;
     }
+    try {
+      set_future.get();
+    } catch (...) {
+      LOG(warning) << "Failed to set shortened urls to memcached";
+    }
+    _CountUrls(target_urls.size(), target_urls.size());
   }
 
   _return = target_urls;
@@ -166,13 +511,238 @@ void UrlShortenHandler::ComposeUrls(
 
 }
 
+void UrlShortenHandler::_SetCachedUrls(
+    const std::map<std::string, std::string> &url_map) {
+  memcached_return_t rc;
+  auto client = memcached_pool_pop(_memcached_client_pool, true, &rc);
+  if (!client) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MEMCACHED_ERROR;
+    se.message = "Failed to pop a client from memcached pool";
+    throw se;
+  }
+  for (auto &it : url_map) {
+    if (!IsCacheableUrl(it.first)) {
+      continue;
+    }
+    rc = memcached_set(client, it.first.c_str(), it.first.length(),
+                       it.second.c_str(), it.second.length(),
+                       static_cast<time_t>(0), static_cast<uint32_t>(0));
+    if (rc != MEMCACHED_SUCCESS) {
+      LOG(warning) << "Failed to set " << it.first << " to memcached: "
+                   << memcached_strerror(client, rc);
+    }
+  }
+  memcached_pool_push(_memcached_client_pool, client);
+}
+
+// Resolves shortened urls to the urls they were created for, in order.
+// Unknown shortened urls resolve to an empty string.
 void UrlShortenHandler::GetExtendedUrls(
     std::vector<std::string> &_return,
     int64_t req_id,
-    const std::vector<std::string> &shortened_id,
+    const std::vector<std::string> &shortened_urls,
     const std::map<std::string, std::string> &carrier) {
 
-  // TODO: Implement GetExtendedUrls
+  // Initialize a span
+  TextMapReader reader(carrier);
+  std::map<std::string, std::string> writer_text_map;
+  TextMapWriter writer(writer_text_map);
+  auto parent_span = opentracing::Tracer::Global()->Extract(reader);
+  auto span = opentracing::Tracer::Global()->StartSpan(
+      "get_extended_urls_server",
+      { opentracing::ChildOf(parent_span->get()) });
+  opentracing::Tracer::Global()->Inject(span->context(), writer);
+
+  if (shortened_urls.empty()) {
+    span->Finish();
+    return;
+  }
+
+  std::set<std::string> urls_not_cached(
+      shortened_urls.begin(), shortened_urls.end());
+  std::vector<std::string> cache_keys;
+  for (auto &shortened_url : urls_not_cached) {
+    if (IsCacheableUrl(shortened_url)) {
+      cache_keys.emplace_back(shortened_url);
+    }
+  }
+  std::map<std::string, std::string> expanded_url_map;
+
+  // Find in Memcached with a single multi-get
+  if (!cache_keys.empty()) {
+    memcached_return_t rc;
+    auto client = memcached_pool_pop(_memcached_client_pool, true, &rc);
+    if (!client) {
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MEMCACHED_ERROR;
+      se.message = "Failed to pop a client from memcached pool";
+      throw se;
+    }
+
+    std::vector<const char *> keys;
+    std::vector<size_t> key_sizes;
+    for (auto &key : cache_keys) {
+      keys.emplace_back(key.c_str());
+      key_sizes.emplace_back(key.length());
+    }
+
+    auto get_span = opentracing::Tracer::Global()->StartSpan(
+        "url_mmc_mget_client", { opentracing::ChildOf(&span->context()) });
+    rc = memcached_mget(client, keys.data(), key_sizes.data(), keys.size());
+    // Keys of unreachable servers read as misses
+    if (rc != MEMCACHED_SUCCESS && rc != MEMCACHED_SOME_ERRORS) {
+      LOG(error) << "Cannot get shortened urls of request " << req_id << ": "
+                 << memcached_strerror(client, rc);
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MEMCACHED_ERROR;
+      se.message = memcached_strerror(client, rc);
+      memcached_pool_push(_memcached_client_pool, client);
+      get_span->Finish();
+      throw se;
+    }
+
+    char return_key[MEMCACHED_MAX_KEY];
+    size_t return_key_length;
+    char *return_value;
+    size_t return_value_length;
+    uint32_t flags;
+
+    while (true) {
+      return_value = memcached_fetch(client, return_key, &return_key_length,
+                                     &return_value_length, &flags, &rc);
+      if (return_value == nullptr) {
+        LOG(debug) << "Memcached mget finished "
+                   << memcached_strerror(client, rc);
+        break;
+      }
+      if (rc != MEMCACHED_SUCCESS) {
+        free(return_value);
+        memcached_quit(client);
+        memcached_pool_push(_memcached_client_pool, client);
+        LOG(error) << "Cannot get shortened urls of request " << req_id;
+        ServiceException se;
+        se.errorCode = ErrorCode::SE_MEMCACHED_ERROR;
+        se.message =
+            "Cannot get shortened urls of request " + std::to_string(req_id);
+        get_span->Finish();
+        throw se;
+      }
+      std::string shortened_url(return_key, return_key + return_key_length);
+      expanded_url_map[shortened_url] =
+          std::string(return_value, return_value + return_value_length);
+      urls_not_cached.erase(shortened_url);
+      free(return_value);
+    }
+    get_span->Finish();
+    memcached_quit(client);
+    memcached_pool_push(_memcached_client_pool, client);
+  }
+  span->SetTag("cache_misses", static_cast<int64_t>(urls_not_cached.size()));
+
+  // Find the rest in MongoDB with one query on the shortened_url index
+  std::map<std::string, std::string> urls_to_cache;
+  if (!urls_not_cached.empty()) {
+    mongoc_client_t *mongodb_client = mongoc_client_pool_pop(
+        _mongodb_client_pool);
+    if (!mongodb_client) {
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+      se.message = "Failed to pop a client from MongoDB pool";
+      throw se;
+    }
+    auto collection = mongoc_client_get_collection(
+        mongodb_client, "url-shorten", "url-shorten");
+    if (!collection) {
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+      se.message = "Failed to create collection url-shorten from DB url-shorten";
+      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+      throw se;
+    }
+
+    bson_t *query = bson_new();
+    bson_t query_child;
+    bson_t query_url_list;
+    const char *key;
+    int idx = 0;
+    char buf[16];
+
+    BSON_APPEND_DOCUMENT_BEGIN(query, "shortened_url", &query_child);
+    BSON_APPEND_ARRAY_BEGIN(&query_child, "$in", &query_url_list);
+    for (auto &item : urls_not_cached) {
+      bson_uint32_to_string(idx, &key, buf, sizeof buf);
+      BSON_APPEND_UTF8(&query_url_list, key, item.c_str());
+      idx++;
+    }
+    bson_append_array_end(&query_child, &query_url_list);
+    bson_append_document_end(query, &query_child);
+    bson_t *opts = BCON_NEW(
+        "projection", "{", "_id", BCON_BOOL(false), "}");
+
+    auto find_span = opentracing::Tracer::Global()->StartSpan(
+        "url_mongo_find_client", { opentracing::ChildOf(&span->context()) });
+    mongoc_cursor_t *cursor =
+        mongoc_collection_find_with_opts(collection, query, opts, nullptr);
+    const bson_t *doc;
+    while (mongoc_cursor_next(cursor, &doc)) {
+      bson_iter_t shortened_iter;
+      bson_iter_t expanded_iter;
+      if (bson_iter_init_find(&shortened_iter, doc, "shortened_url") &&
+          bson_iter_init_find(&expanded_iter, doc, "expanded_url")) {
+        std::string shortened_url = bson_iter_utf8(&shortened_iter, nullptr);
+        std::string expanded_url = bson_iter_utf8(&expanded_iter, nullptr);
+        expanded_url_map[shortened_url] = expanded_url;
+        urls_to_cache.emplace(shortened_url, expanded_url);
+      }
+    }
+    find_span->Finish();
+    bson_error_t error;
+    if (mongoc_cursor_error(cursor, &error)) {
+      LOG(error) << error.message;
+      bson_destroy(opts);
+      bson_destroy(query);
+      mongoc_cursor_destroy(cursor);
+      mongoc_collection_destroy(collection);
+      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+      se.message = error.message;
+      throw se;
+    }
+    bson_destroy(opts);
+    bson_destroy(query);
+    mongoc_cursor_destroy(cursor);
+    mongoc_collection_destroy(collection);
+    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  }
+
+  // Write the misses back to memcached while the reply is assembled
+  std::future<void> set_future;
+  if (!urls_to_cache.empty()) {
+    set_future = std::async(std::launch::async, [&]() {
+      auto set_span = opentracing::Tracer::Global()->StartSpan(
+          "url_mmc_set_client", { opentracing::ChildOf(&span->context()) });
+      _SetCachedUrls(urls_to_cache);
+      set_span->Finish();
+    });
+  }
+
+  _return.reserve(shortened_urls.size());
+  for (auto &shortened_url : shortened_urls) {
+    auto it = expanded_url_map.find(shortened_url);
+    _return.emplace_back(
+        it == expanded_url_map.end() ? std::string() : it->second);
+  }
+
+  if (set_future.valid()) {
+    try {
+      set_future.get();
+    } catch (...) {
+      LOG(warning) << "Failed to set extended urls to memcached";
+    }
+  }
+  span->Finish();
 }
 
 }
@@ -13,7 +13,6 @@
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -42,6 +41,9 @@ int main(int argc, char* argv[]) {
   int mongodb_conns = config_json["url-shorten-mongodb"]["connections"];
   int mongodb_timeout = config_json["url-shorten-mongodb"]["timeout_ms"];
 
+  int content_hash_config_flag =
+      config_json["url-shorten-service"].value("use_content_hash", 0);
+
   int memcached_conns = config_json["url-shorten-memcached"]["connections"];
   int memcached_timeout = config_json["url-shorten-memcached"]["timeout_ms"];
 
@@ -68,15 +70,15 @@ int main(int argc, char* argv[]) {
   }
   mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
 
-  std::mutex thread_lock;
   std::shared_ptr<TServerSocket> server_socket = get_server_socket(config_json, "0.0.0.0", port);
   TThreadedServer server(
       std::make_shared<UrlShortenServiceProcessor>(
           std::make_shared<UrlShortenHandler>(
-              memcached_client_pool, mongodb_client_pool, &thread_lock)),
+              memcached_client_pool, mongodb_client_pool,
+              content_hash_config_flag == 1)),
       server_socket,
-      std::make_shared<TFramedTransportFactory>(),
-      std::make_shared<TBinaryProtocolFactory>());
+      get_transport_factory(config_json),
+      get_protocol_factory(config_json));
 
   LOG(info) << "Starting the url-shorten-service server...";
   server.serve();
@@ -9,6 +9,7 @@
 #include "../../gen-cpp/UserMentionService.h"
 #include "../../gen-cpp/social_network_types.h"
 #include "../ClientPool.h"
+#include "../UsernameFilter.h"
 #include "../logger.h"
 #include "../tracing.h"
 #include "../utils.h"
@@ -17,7 +18,8 @@ namespace social_network {
 
 class UserMentionHandler : public UserMentionServiceIf {
  public:
-  UserMentionHandler(memcached_pool_st *, mongoc_client_pool_t *);
+  UserMentionHandler(memcached_pool_st *, mongoc_client_pool_t *,
+                     UsernameFilter *);
   ~UserMentionHandler() override = default;
 
   void ComposeUserMentions(std::vector<UserMention> &_return, int64_t,
@@ -27,13 +29,17 @@ class UserMentionHandler : public UserMentionServiceIf {
  private:
   memcached_pool_st *_memcached_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
+  // nullptr unless the username filter is enabled
+  UsernameFilter *_username_filter;
 };
 
 UserMentionHandler::UserMentionHandler(
     memcached_pool_st *memcached_client_pool,
-    mongoc_client_pool_t *mongodb_client_pool) {
+    mongoc_client_pool_t *mongodb_client_pool,
+    UsernameFilter *username_filter) {
   _memcached_client_pool = memcached_client_pool;
   _mongodb_client_pool = mongodb_client_pool;
+  _username_filter = username_filter;
 }
 
 void UserMentionHandler::ComposeUserMentions(
@@ -85,7 +91,8 @@ void UserMentionHandler::ComposeUserMentions(
         "compose_user_mentions_memcached_get_client",
         {opentracing::ChildOf(&span->context())});
     rc = memcached_mget(client, keys, key_sizes, usernames.size());
-    if (rc != MEMCACHED_SUCCESS) {
+    // Keys of unreachable servers read as misses
+    if (rc != MEMCACHED_SUCCESS && rc != MEMCACHED_SOME_ERRORS) {
       LOG(error) << "Cannot get usernames of request " << req_id << ": "
                  << memcached_strerror(client, rc);
       ServiceException se;
@@ -142,6 +149,21 @@ void UserMentionHandler::ComposeUserMentions(
     delete[] keys;
     delete[] key_sizes;
 
+    // Usernames the filter does not know are not registered
+    if (_username_filter) {
+      int64_t num_filtered = 0;
+      for (auto it = usernames_not_cached.begin();
+           it != usernames_not_cached.end();) {
+        if (!_username_filter->MayExist(it->first)) {
+          it = usernames_not_cached.erase(it);
+          num_filtered++;
+        } else {
+          ++it;
+        }
+      }
+      span->SetTag("username_filter_negatives", num_filtered);
+    }
+
     // Find the rest in MongoDB
     if (!usernames_not_cached.empty()) {
       mongoc_client_t *mongodb_client =
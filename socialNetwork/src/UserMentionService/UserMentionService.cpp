@@ -13,7 +13,6 @@
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -56,14 +55,32 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
+  std::unique_ptr<UsernameFilter> username_filter;
+  if (config_json["username-filter"]["enabled"] == 1) {
+    double error_rate = config_json["username-filter"]["error_rate"];
+    size_t initial_capacity =
+        config_json["username-filter"]["initial_capacity"];
+    size_t max_memory_mb = config_json["username-filter"]["max_memory_mb"];
+    int refresh_interval_ms =
+        config_json["username-filter"]["refresh_interval_ms"];
+    username_filter.reset(new UsernameFilter(error_rate, initial_capacity,
+                                             max_memory_mb << 20));
+    if (!username_filter->Warmup(mongodb_client_pool)) {
+      LOG(fatal) << "Failed to warm up the username filter";
+      return EXIT_FAILURE;
+    }
+    username_filter->StartRefresh(mongodb_client_pool, refresh_interval_ms);
+  }
+
   std::shared_ptr<TServerSocket> server_socket = get_server_socket(config_json, "0.0.0.0", port);
 
   TThreadedServer server(std::make_shared<UserMentionServiceProcessor>(
                              std::make_shared<UserMentionHandler>(
-                                 memcached_client_pool, mongodb_client_pool)),
+                                 memcached_client_pool, mongodb_client_pool,
+                                 username_filter.get())),
                          server_socket,
-                         std::make_shared<TFramedTransportFactory>(),
-                         std::make_shared<TBinaryProtocolFactory>());
+                         get_transport_factory(config_json),
+                         get_protocol_factory(config_json));
 
   LOG(info) << "Starting the user-mention-service server...";
   server.serve();
@@ -0,0 +1,132 @@
+/*
+ * Login throughput benchmark of the password hashing backends.
+ *
+ * Usage: PasswordHashBenchmark [threads] [seconds]
+ *
+ * Checks that every backend produces the hashes already stored in MongoDB
+ * (those of picosha2), then has every thread verify passwords against stored
+ * hashes as Login does, and reports logins/s per backend. Salt generation,
+ * done once per RegisterUser, is timed against the former std::random_device
+ * + mt19937 per call.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "PasswordHasher.h"
+
+using namespace social_network;
+
+struct User {
+  std::string password;
+  std::string salt;
+  std::string password_hashed;
+};
+
+static std::string OldGenRandomString(const int len) {
+  static const std::string alphanum =
+      "0123456789"
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+      "abcdefghijklmnopqrstuvwxyz";
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int> dist(
+      0, static_cast<int>(alphanum.length() - 1));
+  std::string s;
+  for (int i = 0; i < len; ++i) {
+    s += alphanum[dist(gen)];
+  }
+  return s;
+}
+
+template <class F>
+static double RatePerSecond(int num_threads, double seconds, F op) {
+  std::atomic<bool> stop(false);
+  std::atomic<int64_t> total(0);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      int64_t count = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        op(i, count++);
+      }
+      total += count;
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return total / elapsed;
+}
+
+int main(int argc, char *argv[]) {
+  int num_threads = argc > 1 ? std::atoi(argv[1])
+                             : std::max(1u, std::thread::hardware_concurrency());
+  double seconds = argc > 2 ? std::atof(argv[2]) : 2;
+  if (num_threads <= 0 || seconds <= 0) {
+    std::cerr << "Usage: " << argv[0] << " [threads] [seconds]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  InitOpenSslLocking();
+  auto picosha2_hasher = PasswordHasher::Create("picosha2");
+  auto openssl_hasher = PasswordHasher::Create("openssl");
+
+  // Users as stored by the former RegisterUser
+  std::vector<User> users;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> length(0, 40);
+  for (int i = 0; i < 10000; ++i) {
+    User user;
+    user.password = OldGenRandomString(length(gen));
+    user.salt = GenRandomString(32);
+    user.password_hashed = picosha2_hasher->Hash(user.password, user.salt);
+    users.emplace_back(user);
+  }
+  for (auto &user : users) {
+    if (!openssl_hasher->Verify(user.password, user.salt,
+                                user.password_hashed) ||
+        openssl_hasher->Verify(user.password + "x", user.salt,
+                               user.password_hashed)) {
+      std::cerr << "openssl hashes differ from stored hashes" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << num_threads << " threads" << std::endl;
+  for (auto backend : {"picosha2", "openssl"}) {
+    auto hasher = PasswordHasher::Create(backend);
+    double rate = RatePerSecond(num_threads, seconds, [&](int, int64_t i) {
+      auto &user = users[i % users.size()];
+      if (!hasher->Verify(user.password, user.salt, user.password_hashed)) {
+        std::cerr << "Verify failed" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    });
+    std::cout << "login, " << backend << ": " << static_cast<int64_t>(rate)
+              << " logins/s" << std::endl;
+  }
+  double old_rate = RatePerSecond(num_threads, seconds, [](int, int64_t) {
+    OldGenRandomString(32);
+  });
+  double rate = RatePerSecond(num_threads, seconds, [](int, int64_t) {
+    GenRandomString(32);
+  });
+  std::cout << "salt, random_device + mt19937: "
+            << static_cast<int64_t>(old_rate) << " salts/s" << std::endl;
+  std::cout << "salt, RAND_bytes: " << static_cast<int64_t>(rate)
+            << " salts/s" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_PASSWORDHASHER_H
+#define SOCIAL_NETWORK_MICROSERVICES_PASSWORDHASHER_H
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../third_party/PicoSHA2/picosha2.h"
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+// OpenSSL 1.0.2, as on Ubuntu 16.04
+#define EVP_MD_CTX_new EVP_MD_CTX_create
+#define EVP_MD_CTX_free EVP_MD_CTX_destroy
+#include <pthread.h>
+#endif
+
+namespace social_network {
+
+// Hashes passwords into the "password" field of user documents: the
+// lowercase hex SHA-256 of password + salt. Every backend produces the same
+// strings, so hashes stored by one are verified by any other.
+class PasswordHasher {
+ public:
+  virtual ~PasswordHasher() = default;
+
+  virtual std::string Hash(const std::string &password,
+                           const std::string &salt) const = 0;
+
+  // Compares in constant time, so that the time taken does not reveal how
+  // much of the hash matched.
+  bool Verify(const std::string &password, const std::string &salt,
+              const std::string &password_hashed) const {
+    std::string hashed = Hash(password, salt);
+    return hashed.size() == password_hashed.size() &&
+           CRYPTO_memcmp(hashed.data(), password_hashed.data(),
+                         hashed.size()) == 0;
+  }
+
+  // "openssl" (the default) or "picosha2"; nullptr for an unknown backend.
+  static std::unique_ptr<PasswordHasher> Create(const std::string &backend);
+};
+
+// EVP picks the fastest SHA-256 the CPU supports (SHA-NI, AVX2, ...).
+class OpenSslPasswordHasher : public PasswordHasher {
+ public:
+  std::string Hash(const std::string &password,
+                   const std::string &salt) const override {
+    // One digest context per thread, reused across calls
+    thread_local std::unique_ptr<EVP_MD_CTX, void (*)(EVP_MD_CTX *)> ctx(
+        EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_size = 0;
+    if (!ctx || !EVP_DigestInit_ex(ctx.get(), EVP_sha256(), nullptr) ||
+        !EVP_DigestUpdate(ctx.get(), password.data(), password.size()) ||
+        !EVP_DigestUpdate(ctx.get(), salt.data(), salt.size()) ||
+        !EVP_DigestFinal_ex(ctx.get(), digest, &digest_size)) {
+      throw std::runtime_error("Failed to compute SHA-256 with OpenSSL");
+    }
+    static const char hex[] = "0123456789abcdef";
+    std::string hashed(2 * digest_size, '0');
+    for (unsigned int i = 0; i < digest_size; ++i) {
+      hashed[2 * i] = hex[digest[i] >> 4];
+      hashed[2 * i + 1] = hex[digest[i] & 0xf];
+    }
+    return hashed;
+  }
+};
+
+class PicoSha2PasswordHasher : public PasswordHasher {
+ public:
+  std::string Hash(const std::string &password,
+                   const std::string &salt) const override {
+    return picosha2::hash256_hex_string(password + salt);
+  }
+};
+
+std::unique_ptr<PasswordHasher> PasswordHasher::Create(
+    const std::string &backend) {
+  if (backend == "openssl") {
+    return std::unique_ptr<PasswordHasher>(new OpenSslPasswordHasher());
+  }
+  if (backend == "picosha2") {
+    return std::unique_ptr<PasswordHasher>(new PicoSha2PasswordHasher());
+  }
+  return nullptr;
+}
+
+// OpenSSL 1.1.0 and later lock their shared state, such as the CSPRNG,
+// themselves. 1.0.2 leaves it to the application to install locking
+// callbacks, which Thrift only does when TLS is enabled. Installs them
+// unless someone already has; does nothing on later versions. To be called
+// at startup, before threads use OpenSSL.
+void InitOpenSslLocking() {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+  static std::once_flag once;
+  std::call_once(once, []() {
+    if (CRYPTO_get_locking_callback()) {
+      return;
+    }
+    static std::vector<std::mutex> locks(CRYPTO_num_locks());
+    CRYPTO_THREADID_set_callback([](CRYPTO_THREADID *id) {
+      CRYPTO_THREADID_set_numeric(
+          id, static_cast<unsigned long>(pthread_self()));
+    });
+    CRYPTO_set_locking_callback([](int mode, int n, const char *, int) {
+      if (mode & CRYPTO_LOCK) {
+        locks[n].lock();
+      } else {
+        locks[n].unlock();
+      }
+    });
+  });
+#endif
+}
+
+// Random alphanumeric string of length len from the OpenSSL CSPRNG. Bytes
+// are mapped with rejection sampling so that every character is equally
+// likely.
+std::string GenRandomString(const int len) {
+  static const char alphanum[] =
+      "0123456789"
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+      "abcdefghijklmnopqrstuvwxyz";
+  // Largest multiple of 62 that fits in a byte
+  const unsigned char limit = 248;
+  std::string s;
+  s.reserve(len);
+  unsigned char buf[64];
+  while (static_cast<int>(s.size()) < len) {
+    if (RAND_bytes(buf, sizeof(buf)) != 1) {
+      throw std::runtime_error("Failed to generate random bytes");
+    }
+    for (size_t i = 0; i < sizeof(buf) && static_cast<int>(s.size()) < len;
+         ++i) {
+      if (buf[i] < limit) {
+        s += alphanum[buf[i] % 62];
+      }
+    }
+  }
+  return s;
+}
+
+}  // namespace social_network
+
+#endif  // SOCIAL_NETWORK_MICROSERVICES_PASSWORDHASHER_H
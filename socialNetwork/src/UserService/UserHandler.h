@@ -6,21 +6,24 @@
 #include <libmemcached/util.h>
 #include <mongoc.h>
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <jwt/jwt.hpp>
 #include <nlohmann/json.hpp>
-#include <random>
 #include <string>
+#include <vector>
 
 #include "../../gen-cpp/SocialGraphService.h"
 #include "../../gen-cpp/UserService.h"
 #include "../../gen-cpp/social_network_types.h"
-#include "../../third_party/PicoSHA2/picosha2.h"
 #include "../ClientPool.h"
 #include "../ThriftClient.h"
+#include "../UsernameFilter.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "../utils_machine_id.h"
+#include "PasswordHasher.h"
 
 // Custom Epoch (January 1, 2018 Midnight GMT = 2018-01-01T00:00:00Z)
 #define CUSTOM_EPOCH 1514764800000
@@ -51,27 +54,12 @@ static int GetCounter(int64_t timestamp) {
   }
 }
 
-std::string GenRandomString(const int len) {
-  static const std::string alphanum =
-      "0123456789"
-      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-      "abcdefghijklmnopqrstuvwxyz";
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<int> dist(
-      0, static_cast<int>(alphanum.length() - 1));
-  std::string s;
-  for (int i = 0; i < len; ++i) {
-    s += alphanum[dist(gen)];
-  }
-  return s;
-}
-
 class UserHandler : public UserServiceIf {
  public:
   UserHandler(std::mutex *, const std::string &, const std::string &,
               memcached_pool_st *, mongoc_client_pool_t *,
-              ClientPool<ThriftClient<SocialGraphServiceClient>> *);
+              ClientPool<ThriftClient<SocialGraphServiceClient>> *,
+              UsernameFilter *, PasswordHasher *);
   ~UserHandler() override = default;
   void RegisterUser(int64_t, const std::string &, const std::string &,
                     const std::string &, const std::string &,
@@ -79,6 +67,12 @@ class UserHandler : public UserServiceIf {
   void RegisterUserWithId(int64_t, const std::string &, const std::string &,
                           const std::string &, const std::string &, int64_t,
                           const std::map<std::string, std::string> &) override;
+  void RegisterUsersWithId(int64_t, const std::vector<std::string> &,
+                           const std::vector<std::string> &,
+                           const std::vector<std::string> &,
+                           const std::vector<std::string> &,
+                           const std::vector<int64_t> &,
+                           const std::map<std::string, std::string> &) override;
 
   void ComposeCreatorWithUserId(
       Creator &, int64_t, int64_t, const std::string &,
@@ -98,6 +92,9 @@ class UserHandler : public UserServiceIf {
   memcached_pool_st *_memcached_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
   ClientPool<ThriftClient<SocialGraphServiceClient>> *_social_graph_client_pool;
+  // nullptr unless the username filter is enabled
+  UsernameFilter *_username_filter;
+  PasswordHasher *_password_hasher;
 };
 
 UserHandler::UserHandler(std::mutex *thread_lock, const std::string &machine_id,
@@ -105,13 +102,17 @@ UserHandler::UserHandler(std::mutex *thread_lock, const std::string &machine_id,
                          memcached_pool_st *memcached_client_pool,
                          mongoc_client_pool_t *mongodb_client_pool,
                          ClientPool<ThriftClient<SocialGraphServiceClient>>
-                             *social_graph_client_pool) {
+                             *social_graph_client_pool,
+                         UsernameFilter *username_filter,
+                         PasswordHasher *password_hasher) {
   _thread_lock = thread_lock;
   _machine_id = machine_id;
   _memcached_client_pool = memcached_client_pool;
   _mongodb_client_pool = mongodb_client_pool;
   _secret = secret;
   _social_graph_client_pool = social_graph_client_pool;
+  _username_filter = username_filter;
+  _password_hasher = password_hasher;
 }
 
 void UserHandler::RegisterUserWithId(
@@ -177,7 +178,7 @@ void UserHandler::RegisterUserWithId(
     BSON_APPEND_UTF8(new_doc, "username", username.c_str());
     std::string salt = GenRandomString(32);
     BSON_APPEND_UTF8(new_doc, "salt", salt.c_str());
-    std::string password_hashed = picosha2::hash256_hex_string(password + salt);
+    std::string password_hashed = _password_hasher->Hash(password, salt);
     BSON_APPEND_UTF8(new_doc, "password", password_hashed.c_str());
 
     bson_error_t error;
@@ -198,6 +199,9 @@ void UserHandler::RegisterUserWithId(
       throw se;
     } else {
       LOG(debug) << "User: " << username << " registered";
+      if (_username_filter) {
+        _username_filter->Add(username);
+      }
     }
     user_insert_span->Finish();
     bson_destroy(new_doc);
@@ -229,6 +233,180 @@ void UserHandler::RegisterUserWithId(
   span->Finish();
 }
 
+// Bulk variant of RegisterUserWithId for dataset loading. Users are upserted
+// on the indexed user_id with $setOnInsert, so users that already exist are
+// left untouched and a batch can be sent again after a failure. A username
+// taken by another user_id is rejected by the unique index on username; the
+// rest of the batch is registered and the conflicts are reported as in
+// RegisterUserWithId.
+void UserHandler::RegisterUsersWithId(
+    int64_t req_id, const std::vector<std::string> &first_names,
+    const std::vector<std::string> &last_names,
+    const std::vector<std::string> &usernames,
+    const std::vector<std::string> &passwords,
+    const std::vector<int64_t> &user_ids,
+    const std::map<std::string, std::string> &carrier) {
+  // Initialize a span
+  TextMapReader reader(carrier);
+  std::map<std::string, std::string> writer_text_map;
+  TextMapWriter writer(writer_text_map);
+  auto parent_span = opentracing::Tracer::Global()->Extract(reader);
+  auto span = opentracing::Tracer::Global()->StartSpan(
+      "register_users_withid_server",
+      {opentracing::ChildOf(parent_span->get())});
+  opentracing::Tracer::Global()->Inject(span->context(), writer);
+
+  size_t num_users = user_ids.size();
+  if (first_names.size() != num_users || last_names.size() != num_users ||
+      usernames.size() != num_users || passwords.size() != num_users) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+    se.message = "All user lists must have the same length";
+    throw se;
+  }
+  if (num_users == 0) {
+    span->Finish();
+    return;
+  }
+
+  mongoc_client_t *mongodb_client =
+      mongoc_client_pool_pop(_mongodb_client_pool);
+  if (!mongodb_client) {
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = "Failed to pop a client from MongoDB pool";
+    throw se;
+  }
+  auto collection =
+      mongoc_client_get_collection(mongodb_client, "user", "user");
+
+  bson_t *bulk_opts = BCON_NEW("ordered", BCON_BOOL(false));
+  bson_t *upsert_opts = BCON_NEW("upsert", BCON_BOOL(true));
+  mongoc_bulk_operation_t *bulk =
+      mongoc_collection_create_bulk_operation_with_opts(collection, bulk_opts);
+  bson_error_t error;
+  bool success = true;
+  for (size_t i = 0; success && i < num_users; ++i) {
+    std::string salt = GenRandomString(32);
+    std::string password_hashed = _password_hasher->Hash(passwords[i], salt);
+    bson_t *selector = BCON_NEW("user_id", BCON_INT64(user_ids[i]));
+    bson_t *update = BCON_NEW(
+        "$setOnInsert", "{", "first_name", BCON_UTF8(first_names[i].c_str()),
+        "last_name", BCON_UTF8(last_names[i].c_str()), "username",
+        BCON_UTF8(usernames[i].c_str()), "salt", BCON_UTF8(salt.c_str()),
+        "password", BCON_UTF8(password_hashed.c_str()), "}");
+    success = mongoc_bulk_operation_update_one_with_opts(
+        bulk, selector, update, upsert_opts, &error);
+    bson_destroy(update);
+    bson_destroy(selector);
+  }
+
+  auto user_insert_span = opentracing::Tracer::Global()->StartSpan(
+      "user_mongo_bulk_insert_client", {opentracing::ChildOf(&span->context())});
+  // Indexes of the users whose username already existed
+  std::vector<bool> conflict(num_users, false);
+  std::string conflicting_usernames;
+  if (success) {
+    bson_t reply;
+    success = mongoc_bulk_operation_execute(bulk, &reply, &error);
+    bson_iter_t iter;
+    bson_iter_t write_errors;
+    bool write_concern_error =
+        bson_iter_init_find(&iter, &reply, "writeConcernErrors") &&
+        BSON_ITER_HOLDS_ARRAY(&iter) &&
+        bson_iter_recurse(&iter, &write_errors) &&
+        bson_iter_next(&write_errors);
+    if (!success && !write_concern_error &&
+        bson_iter_init_find(&iter, &reply, "writeErrors") &&
+        BSON_ITER_HOLDS_ARRAY(&iter) &&
+        bson_iter_recurse(&iter, &write_errors)) {
+      // Succeeds if every error is a duplicate key in the username index
+      success = true;
+      int num_errors = 0;
+      while (success && bson_iter_next(&write_errors)) {
+        bson_iter_t index_iter;
+        bson_iter_t code_iter;
+        bson_iter_t errmsg_iter;
+        success = BSON_ITER_HOLDS_DOCUMENT(&write_errors) &&
+                  bson_iter_recurse(&write_errors, &index_iter) &&
+                  bson_iter_recurse(&write_errors, &code_iter) &&
+                  bson_iter_recurse(&write_errors, &errmsg_iter) &&
+                  bson_iter_find(&index_iter, "index") &&
+                  bson_iter_find(&code_iter, "code") &&
+                  bson_iter_as_int64(&code_iter) == 11000 &&
+                  bson_iter_find(&errmsg_iter, "errmsg") &&
+                  BSON_ITER_HOLDS_UTF8(&errmsg_iter) &&
+                  strstr(bson_iter_utf8(&errmsg_iter, nullptr), "username_1");
+        int64_t index = success ? bson_iter_as_int64(&index_iter) : -1;
+        success = success && index >= 0 &&
+                  index < static_cast<int64_t>(num_users);
+        if (success) {
+          conflict[index] = true;
+          conflicting_usernames += (conflicting_usernames.empty() ? "" : ", ") +
+                                   usernames[index];
+          num_errors++;
+        }
+      }
+      success = success && num_errors > 0;
+    }
+    bson_destroy(&reply);
+  }
+  user_insert_span->Finish();
+  mongoc_bulk_operation_destroy(bulk);
+  bson_destroy(upsert_opts);
+  bson_destroy(bulk_opts);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+  if (!success) {
+    LOG(error) << "Failed to insert users to MongoDB: " << error.message;
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+    se.message = std::string("Failed to insert users to MongoDB: ") +
+                 error.message;
+    throw se;
+  }
+  std::vector<int64_t> registered_user_ids;
+  registered_user_ids.reserve(num_users);
+  for (size_t i = 0; i < num_users; ++i) {
+    if (!conflict[i]) {
+      registered_user_ids.push_back(user_ids[i]);
+      if (_username_filter) {
+        _username_filter->Add(usernames[i]);
+      }
+    }
+  }
+  LOG(debug) << registered_user_ids.size() << " users registered";
+
+  if (!registered_user_ids.empty()) {
+    auto social_graph_client_wrapper = _social_graph_client_pool->Pop();
+    if (!social_graph_client_wrapper) {
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_THRIFT_CONN_ERROR;
+      se.message = "Failed to connect to social-graph-service";
+      throw se;
+    }
+    auto social_graph_client = social_graph_client_wrapper->GetClient();
+    try {
+      social_graph_client->InsertUsers(req_id, registered_user_ids,
+                                       writer_text_map);
+    } catch (...) {
+      _social_graph_client_pool->Remove(social_graph_client_wrapper);
+      LOG(error) << "Failed to insert users to social-graph-client";
+      throw;
+    }
+    _social_graph_client_pool->Keepalive(social_graph_client_wrapper);
+  }
+
+  span->Finish();
+  if (!conflicting_usernames.empty()) {
+    LOG(warning) << "Users " << conflicting_usernames << " already existed.";
+    ServiceException se;
+    se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+    se.message = "Users " + conflicting_usernames + " already existed";
+    throw se;
+  }
+}
+
 void UserHandler::RegisterUser(
     const int64_t req_id, const std::string &first_name,
     const std::string &last_name, const std::string &username,
@@ -325,7 +503,7 @@ void UserHandler::RegisterUser(
     BSON_APPEND_UTF8(new_doc, "username", username.c_str());
     std::string salt = GenRandomString(32);
     BSON_APPEND_UTF8(new_doc, "salt", salt.c_str());
-    std::string password_hashed = picosha2::hash256_hex_string(password + salt);
+    std::string password_hashed = _password_hasher->Hash(password, salt);
     BSON_APPEND_UTF8(new_doc, "password", password_hashed.c_str());
 
     auto user_insert_span = opentracing::Tracer::Global()->StartSpan(
@@ -345,6 +523,9 @@ void UserHandler::RegisterUser(
       throw se;
     } else {
       LOG(debug) << "User: " << username << " registered";
+      if (_username_filter) {
+        _username_filter->Add(username);
+      }
     }
     user_insert_span->Finish();
     bson_destroy(new_doc);
@@ -427,6 +608,14 @@ void UserHandler::ComposeCreatorWithUsername(
   // If not cached in memcached
   else {
     LOG(debug) << "user_id not cached in Memcached";
+    if (_username_filter && !_username_filter->MayExist(username)) {
+      LOG(warning) << "User: " << username << " is not in the username filter";
+      span->SetTag("username_filter_negative", true);
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+      se.message = "User: " + username + " is not registered";
+      throw se;
+    }
     mongoc_client_t *mongodb_client =
         mongoc_client_pool_pop(_mongodb_client_pool);
     if (!mongodb_client) {
@@ -697,7 +886,7 @@ void UserHandler::Login(std::string &_return, int64_t req_id,
   if (user_id_stored != -1 && !salt_stored.empty() &&
       !password_stored.empty()) {
     bool auth =
-        picosha2::hash256_hex_string(password + salt_stored) == password_stored;
+        _password_hasher->Verify(password, salt_stored, password_stored);
     if (auth) {
       auto user_id_str = std::to_string(user_id_stored);
       auto timestamp_str = std::to_string(
@@ -795,6 +984,14 @@ int64_t UserHandler::GetUserId(
   } else {
     // If not cached in memcached
     LOG(debug) << "user_id not cached in Memcached";
+    if (_username_filter && !_username_filter->MayExist(username)) {
+      LOG(warning) << "User: " << username << " is not in the username filter";
+      span->SetTag("username_filter_negative", true);
+      ServiceException se;
+      se.errorCode = ErrorCode::SE_THRIFT_HANDLER_ERROR;
+      se.message = "User: " + username + " is not registered";
+      throw se;
+    }
     mongoc_client_t *mongodb_client =
         mongoc_client_pool_pop(_mongodb_client_pool);
     if (!mongodb_client) {
@@ -896,52 +1093,6 @@ int64_t UserHandler::GetUserId(
   return user_id;
 }
 
-/*
- * The following code which obtaines machine ID from machine's MAC address was
- * inspired from https://stackoverflow.com/a/16859693.
- *
- * MAC address is obtained from /sys/class/net/<netif>/address
- */
-u_int16_t HashMacAddressPid(const std::string &mac) {
-  u_int16_t hash = 0;
-  std::string mac_pid = mac + std::to_string(getpid());
-  for (unsigned int i = 0; i < mac_pid.size(); i++) {
-    hash += (mac[i] << ((i & 1) * 8));
-  }
-  return hash;
-}
-
-std::string GetMachineId(std::string &netif) {
-  std::string mac_hash;
-
-  std::string mac_addr_filename = "/sys/class/net/" + netif + "/address";
-  std::ifstream mac_addr_file;
-  mac_addr_file.open(mac_addr_filename);
-  if (!mac_addr_file) {
-    LOG(fatal) << "Cannot read MAC address from net interface " << netif;
-    return "";
-  }
-  std::string mac;
-  mac_addr_file >> mac;
-  if (mac == "") {
-    LOG(fatal) << "Cannot read MAC address from net interface " << netif;
-    return "";
-  }
-  mac_addr_file.close();
-
-  LOG(info) << "MAC address = " << mac;
-
-  std::stringstream stream;
-  stream << std::hex << HashMacAddressPid(mac);
-  mac_hash = stream.str();
-
-  if (mac_hash.size() > 3) {
-    mac_hash.erase(0, mac_hash.size() - 3);
-  } else if (mac_hash.size() < 3) {
-    mac_hash = std::string(3 - mac_hash.size(), '0') + mac_hash;
-  }
-  return mac_hash;
-}
 }  // namespace social_network
 
 #endif  // SOCIAL_NETWORK_MICROSERVICES_USERHANDLER_H
@@ -12,7 +12,6 @@
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -62,6 +61,16 @@ int main(int argc, char *argv[]) {
   }
   LOG(info) << "machine_id = " << machine_id;
 
+  std::string password_hash_backend =
+      config_json["user-service"].value("password_hash_backend", "openssl");
+  std::unique_ptr<PasswordHasher> password_hasher =
+      PasswordHasher::Create(password_hash_backend);
+  if (!password_hasher) {
+    LOG(fatal) << "Unknown password_hash_backend " << password_hash_backend;
+    exit(EXIT_FAILURE);
+  }
+  InitOpenSslLocking();
+
   std::mutex thread_lock;
 
   ClientPool<ThriftClient<SocialGraphServiceClient>> social_graph_client_pool(
@@ -75,22 +84,42 @@ int main(int argc, char *argv[]) {
   }
   bool r = false;
   while (!r) {
-    r = CreateIndex(mongodb_client, "user", "user_id", true);
+    r = CreateIndex(mongodb_client, "user", "user_id", true) &&
+        CreateIndex(mongodb_client, "user", "username", true);
     if (!r) {
       LOG(error) << "Failed to create mongodb index, try again";
       sleep(1);
     }
   }
   mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
+
+  std::unique_ptr<UsernameFilter> username_filter;
+  if (config_json["username-filter"]["enabled"] == 1) {
+    double error_rate = config_json["username-filter"]["error_rate"];
+    size_t initial_capacity =
+        config_json["username-filter"]["initial_capacity"];
+    size_t max_memory_mb = config_json["username-filter"]["max_memory_mb"];
+    int refresh_interval_ms =
+        config_json["username-filter"]["refresh_interval_ms"];
+    username_filter.reset(new UsernameFilter(error_rate, initial_capacity,
+                                             max_memory_mb << 20));
+    if (!username_filter->Warmup(mongodb_client_pool)) {
+      LOG(fatal) << "Failed to warm up the username filter";
+      return EXIT_FAILURE;
+    }
+    username_filter->StartRefresh(mongodb_client_pool, refresh_interval_ms);
+  }
+
   std::shared_ptr<TServerSocket> server_socket = get_server_socket(config_json, "0.0.0.0", port);
 
   TThreadedServer server(
       std::make_shared<UserServiceProcessor>(std::make_shared<UserHandler>(
           &thread_lock, machine_id, secret, memcached_client_pool,
-          mongodb_client_pool, &social_graph_client_pool)),
+          mongodb_client_pool, &social_graph_client_pool,
+          username_filter.get(), password_hasher.get())),
       server_socket,
-      std::make_shared<TFramedTransportFactory>(),
-      std::make_shared<TBinaryProtocolFactory>());
+      get_transport_factory(config_json),
+      get_protocol_factory(config_json));
   LOG(info) << "Starting the user-service server ...";
   server.serve();
 }
\ No newline at end of file
@@ -12,9 +12,13 @@
 #include "../../gen-cpp/PostStorageService.h"
 #include "../../gen-cpp/UserTimelineService.h"
 #include "../ClientPool.h"
+#include "../SingleFlight.h"
 #include "../ThriftClient.h"
 #include "../logger.h"
 #include "../tracing.h"
+#include "../utils.h"
+#include "../utils_mongodb.h"
+#include "../utils_redis.h"
 
 using namespace sw::redis;
 
@@ -25,7 +29,7 @@ class UserTimelineHandler : public UserTimelineServiceIf {
   UserTimelineHandler(Redis *, mongoc_client_pool_t *,
                       ClientPool<ThriftClient<PostStorageServiceClient>> *);
 
-  UserTimelineHandler(Redis *, Redis *, mongoc_client_pool_t *,
+  UserTimelineHandler(RedisReplicas *, Redis *, mongoc_client_pool_t *,
       ClientPool<ThriftClient<PostStorageServiceClient>> *);
 
   UserTimelineHandler(RedisCluster *, mongoc_client_pool_t *,
@@ -43,16 +47,19 @@ class UserTimelineHandler : public UserTimelineServiceIf {
 
  private:
   Redis *_redis_client_pool;
-  Redis *_redis_replica_pool;
+  RedisReplicas *_redis_replica_pool;
   Redis *_redis_primary_pool;
   RedisCluster *_redis_cluster_client_pool;
   mongoc_client_pool_t *_mongodb_client_pool;
   ClientPool<ThriftClient<PostStorageServiceClient>> *_post_client_pool;
+  // (post_id, timestamp) entries read from MongoDB on timeline misses.
+  SingleFlight<std::vector<std::pair<int64_t, int64_t>>> _timeline_flight;
 };
 
 UserTimelineHandler::UserTimelineHandler(
     Redis *redis_pool, mongoc_client_pool_t *mongodb_pool,
-    ClientPool<ThriftClient<PostStorageServiceClient>> *post_client_pool) {
+    ClientPool<ThriftClient<PostStorageServiceClient>> *post_client_pool)
+    : _timeline_flight("user-timeline-read") {
   _redis_client_pool = redis_pool;
   _redis_replica_pool = nullptr;
   _redis_primary_pool = nullptr;
@@ -62,8 +69,9 @@ UserTimelineHandler::UserTimelineHandler(
 }
 
 UserTimelineHandler::UserTimelineHandler(
-    Redis* redis_replica_pool, Redis* redis_primary_pool, mongoc_client_pool_t* mongodb_pool,
-    ClientPool<ThriftClient<PostStorageServiceClient>>* post_client_pool) {
+    RedisReplicas* redis_replica_pool, Redis* redis_primary_pool, mongoc_client_pool_t* mongodb_pool,
+    ClientPool<ThriftClient<PostStorageServiceClient>>* post_client_pool)
+    : _timeline_flight("user-timeline-read") {
     _redis_client_pool = nullptr;
     _redis_replica_pool = redis_replica_pool;
     _redis_primary_pool = redis_primary_pool;
@@ -74,7 +82,8 @@ UserTimelineHandler::UserTimelineHandler(
 
 UserTimelineHandler::UserTimelineHandler(
     RedisCluster *redis_pool, mongoc_client_pool_t *mongodb_pool,
-    ClientPool<ThriftClient<PostStorageServiceClient>> *post_client_pool) {
+    ClientPool<ThriftClient<PostStorageServiceClient>> *post_client_pool)
+    : _timeline_flight("user-timeline-read") {
   _redis_cluster_client_pool = redis_pool;
   _redis_replica_pool = nullptr;
   _redis_primary_pool = nullptr;
@@ -209,7 +218,7 @@ void UserTimelineHandler::ReadUserTimeline(
       _redis_client_pool->zrevrange(std::to_string(user_id), start, stop - 1,
                                   std::back_inserter(post_ids_str));
     else if (IsRedisReplicationEnabled()) {
-        _redis_replica_pool->zrevrange(std::to_string(user_id), start, stop - 1,
+        _redis_replica_pool->Acquire()->zrevrange(std::to_string(user_id), start, stop - 1,
             std::back_inserter(post_ids_str));
     }
     else
@@ -230,74 +239,76 @@ void UserTimelineHandler::ReadUserTimeline(
   int mongo_start = start + post_ids.size();
   std::unordered_map<std::string, double> redis_update_map;
   if (mongo_start < stop) {
-    // Instead find post_ids from mongodb
-    mongoc_client_t *mongodb_client =
-        mongoc_client_pool_pop(_mongodb_client_pool);
-    if (!mongodb_client) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to pop a client from MongoDB pool";
-      throw se;
-    }
-    auto collection = mongoc_client_get_collection(
-        mongodb_client, "user-timeline", "user-timeline");
-    if (!collection) {
-      ServiceException se;
-      se.errorCode = ErrorCode::SE_MONGODB_ERROR;
-      se.message = "Failed to create collection user-timeline from MongoDB";
-      throw se;
-    }
-
-    bson_t *query = BCON_NEW("user_id", BCON_INT64(user_id));
-    bson_t *opts = BCON_NEW("projection", "{", "posts", "{", "$slice", "[",
-                            BCON_INT32(0), BCON_INT32(stop), "]", "}", "}");
+    // Instead find post_ids from mongodb. Concurrent misses on the same
+    // timeline range share one read, and only its leader refills Redis.
+    bool coalesced = false;
+    auto posts = _timeline_flight.Do(
+        std::to_string(user_id) + ":" + std::to_string(stop), [&]() {
+      std::vector<std::pair<int64_t, int64_t>> entries;
+      mongoc_client_t *mongodb_client =
+          mongoc_client_pool_pop(_mongodb_client_pool);
+      if (!mongodb_client) {
+        ServiceException se;
+        se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+        se.message = "Failed to pop a client from MongoDB pool";
+        throw se;
+      }
+      auto collection = mongoc_client_get_collection(
+          mongodb_client, "user-timeline", "user-timeline");
+      if (!collection) {
+        ServiceException se;
+        se.errorCode = ErrorCode::SE_MONGODB_ERROR;
+        se.message = "Failed to create collection user-timeline from MongoDB";
+        throw se;
+      }
 
-    auto find_span = opentracing::Tracer::Global()->StartSpan(
-        "user_timeline_mongo_find_client",
-        {opentracing::ChildOf(&span->context())});
-    mongoc_cursor_t *cursor =
-        mongoc_collection_find_with_opts(collection, query, opts, nullptr);
-    find_span->Finish();
-    const bson_t *doc;
-    bool found = mongoc_cursor_next(cursor, &doc);
-    if (found) {
-      bson_iter_t iter_0;
-      bson_iter_t iter_1;
-      bson_iter_t post_id_child;
-      bson_iter_t timestamp_child;
-      int idx = 0;
-      bson_iter_init(&iter_0, doc);
-      bson_iter_init(&iter_1, doc);
-      while (bson_iter_find_descendant(
-                 &iter_0, ("posts." + std::to_string(idx) + ".post_id").c_str(),
-                 &post_id_child) &&
-             BSON_ITER_HOLDS_INT64(&post_id_child) &&
-             bson_iter_find_descendant(
-                 &iter_1,
-                 ("posts." + std::to_string(idx) + ".timestamp").c_str(),
-                 &timestamp_child) &&
-             BSON_ITER_HOLDS_INT64(&timestamp_child)) {
-        auto curr_post_id = bson_iter_int64(&post_id_child);
-        auto curr_timestamp = bson_iter_int64(&timestamp_child);
-        if (idx >= mongo_start) {
-          //In mixed workload condition, post may composed between redis and mongo read
-          //mongodb index will shift and duplicate post_id occurs
-          if ( std::find(post_ids.begin(), post_ids.end(), curr_post_id) == post_ids.end() ) {
-            post_ids.emplace_back(curr_post_id);
+      bson_t *query = BCON_NEW("user_id", BCON_INT64(user_id));
+      bson_t *opts = BCON_NEW("projection", "{", "posts", "{", "$slice", "[",
+                              BCON_INT32(0), BCON_INT32(stop), "]", "}", "}");
+
+      auto find_span = opentracing::Tracer::Global()->StartSpan(
+          "user_timeline_mongo_find_client",
+          {opentracing::ChildOf(&span->context())});
+      mongoc_cursor_t *cursor = mongoc_collection_find_with_opts(
+          collection, query, opts, get_stale_read_prefs(_mongodb_client_pool));
+      find_span->Finish();
+      const bson_t *doc;
+      bool found = mongoc_cursor_next(cursor, &doc);
+      if (found) {
+        ForEachArrayDocument(doc, "posts", [&](const bson_iter_t *post, int idx) {
+          int64_t curr_post_id;
+          int64_t curr_timestamp;
+          if (!GetInt64Field(post, "post_id", &curr_post_id) ||
+              !GetInt64Field(post, "timestamp", &curr_timestamp)) {
+            return false;
           }
+          entries.emplace_back(curr_post_id, curr_timestamp);
+          return true;
+        });
+      }
+      bson_destroy(opts);
+      bson_destroy(query);
+      mongoc_cursor_destroy(cursor);
+      mongoc_collection_destroy(collection);
+      mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
+      return entries;
+    }, &coalesced);
+    span->SetTag("cache_miss_coalesced", coalesced);
+
+    for (int idx = 0; idx < static_cast<int>(posts.size()); ++idx) {
+      int64_t curr_post_id = posts[idx].first;
+      if (idx >= mongo_start) {
+        //In mixed workload condition, post may composed between redis and mongo read
+        //mongodb index will shift and duplicate post_id occurs
+        if ( std::find(post_ids.begin(), post_ids.end(), curr_post_id) == post_ids.end() ) {
+          post_ids.emplace_back(curr_post_id);
         }
+      }
+      if (!coalesced) {
         redis_update_map.insert(std::make_pair(std::to_string(curr_post_id),
-                                               (double)curr_timestamp));
-        bson_iter_init(&iter_0, doc);
-        bson_iter_init(&iter_1, doc);
-        idx++;
+                                               (double)posts[idx].second));
       }
     }
-    bson_destroy(opts);
-    bson_destroy(query);
-    mongoc_cursor_destroy(cursor);
-    mongoc_collection_destroy(collection);
-    mongoc_client_pool_push(_mongodb_client_pool, mongodb_client);
   }
 
   std::future<std::vector<Post>> post_future =
@@ -18,7 +18,6 @@
 
 using apache::thrift::protocol::TBinaryProtocolFactory;
 using apache::thrift::server::TThreadedServer;
-using apache::thrift::transport::TFramedTransportFactory;
 using apache::thrift::transport::TServerSocket;
 using namespace social_network;
 
@@ -116,21 +115,22 @@ int main(int argc, char *argv[]) {
                                    &redis_client_pool, mongodb_client_pool,
                                    &post_storage_client_pool)),
                            server_socket,
-                           std::make_shared<TFramedTransportFactory>(),
-                           std::make_shared<TBinaryProtocolFactory>());
+                           get_transport_factory(config_json),
+                           get_protocol_factory(config_json));
     LOG(info) << "Starting the user-timeline-service server with Redis Cluster support...";
     server.serve();
   }
   else if (redis_replica_config_flag) {
-      Redis redis_replica_client_pool = init_redis_replica_client_pool(config_json, "redis-replica");
+      RedisReplicas redis_replica_client_pool(
+          init_redis_replica_client_pools(config_json, "redis-replica"));
       Redis redis_primary_client_pool = init_redis_replica_client_pool(config_json, "redis-primary");
       TThreadedServer server(std::make_shared<UserTimelineServiceProcessor>(
           std::make_shared<UserTimelineHandler>(
               &redis_replica_client_pool, &redis_primary_client_pool, mongodb_client_pool,
               &post_storage_client_pool)),
           server_socket,
-          std::make_shared<TFramedTransportFactory>(),
-          std::make_shared<TBinaryProtocolFactory>());
+          get_transport_factory(config_json),
+          get_protocol_factory(config_json));
       LOG(info) << "Starting the user-timeline-service server with replicated Redis support...";
       server.serve();
 
@@ -143,8 +143,8 @@ int main(int argc, char *argv[]) {
                                    &redis_client_pool, mongodb_client_pool,
                                    &post_storage_client_pool)),
                            server_socket,
-                           std::make_shared<TFramedTransportFactory>(),
-                           std::make_shared<TBinaryProtocolFactory>());
+                           get_transport_factory(config_json),
+                           get_protocol_factory(config_json));
     LOG(info) << "Starting the user-timeline-service server...";
     server.serve();
   }
@@ -0,0 +1,154 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_USERNAMEFILTER_H
+#define SOCIAL_NETWORK_MICROSERVICES_USERNAMEFILTER_H
+
+#include <bson/bson.h>
+#include <mongoc.h>
+
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <thread>
+
+#include "BloomFilter.h"
+#include "logger.h"
+
+// Users inserted up to this long before a refresh started are read again, to
+// cover clock skew between the services that write the user collection.
+#define USERNAME_FILTER_REFRESH_OVERLAP_S 60
+
+namespace social_network {
+
+// Bloom filter of the usernames of the user collection. A username the filter
+// does not contain is not registered, which saves the MongoDB lookup of
+// unknown usernames; a username it contains may or may not be registered.
+//
+// The filter is loaded from MongoDB by Warmup() and kept current by Add() for
+// users registered through this process and by a background refresh that
+// reads the users inserted since the previous one, so users registered
+// through other replicas become visible within one refresh interval.
+class UsernameFilter {
+ public:
+  UsernameFilter(double error_rate, size_t initial_capacity,
+                 size_t max_memory_bytes)
+      : _filter(error_rate, initial_capacity, max_memory_bytes),
+        _refresh_since(0) {}
+
+  bool Warmup(mongoc_client_pool_t *mongodb_client_pool);
+  void StartRefresh(mongoc_client_pool_t *mongodb_client_pool,
+                    int interval_ms);
+
+  void Add(const std::string &username) { _filter.Add(username); }
+  bool MayExist(const std::string &username) const {
+    return _filter.MayContain(username);
+  }
+
+ private:
+  // Adds the usernames of the users inserted at or after since (seconds since
+  // the epoch, as stored in their ObjectIds); since < 0 reads all users.
+  bool Load(mongoc_client_pool_t *mongodb_client_pool, int64_t since,
+            size_t *num_users);
+
+  ScalableBloomFilter _filter;
+  // Start of the window the next refresh reads
+  int64_t _refresh_since;
+};
+
+bool UsernameFilter::Load(mongoc_client_pool_t *mongodb_client_pool,
+                          int64_t since, size_t *num_users) {
+  mongoc_client_t *mongodb_client = mongoc_client_pool_pop(mongodb_client_pool);
+  if (!mongodb_client) {
+    LOG(error) << "Failed to pop a client from MongoDB pool";
+    return false;
+  }
+  auto collection =
+      mongoc_client_get_collection(mongodb_client, "user", "user");
+  if (!collection) {
+    LOG(error) << "Failed to create collection user from DB user";
+    mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
+    return false;
+  }
+
+  bson_t *query;
+  if (since < 0) {
+    query = bson_new();
+  } else {
+    // The first 4 bytes of an ObjectId are its creation time, big-endian.
+    uint8_t data[12] = {0};
+    for (int i = 0; i < 4; ++i) {
+      data[i] = static_cast<uint8_t>(since >> (8 * (3 - i)));
+    }
+    bson_oid_t oid;
+    bson_oid_init_from_data(&oid, data);
+    query = BCON_NEW("_id", "{", "$gte", BCON_OID(&oid), "}");
+  }
+  bson_t *opts = BCON_NEW("projection", "{", "_id", BCON_BOOL(false),
+                          "username", BCON_BOOL(true), "}");
+  mongoc_cursor_t *cursor =
+      mongoc_collection_find_with_opts(collection, query, opts, nullptr);
+  const bson_t *doc;
+  *num_users = 0;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    bson_iter_t iter;
+    if (bson_iter_init_find(&iter, doc, "username") &&
+        BSON_ITER_HOLDS_UTF8(&iter)) {
+      _filter.Add(bson_iter_utf8(&iter, nullptr));
+      (*num_users)++;
+    }
+  }
+  bson_error_t error;
+  bool success = !mongoc_cursor_error(cursor, &error);
+  if (!success) {
+    LOG(error) << "Failed to read usernames from MongoDB: " << error.message;
+  }
+  bson_destroy(opts);
+  bson_destroy(query);
+  mongoc_cursor_destroy(cursor);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(mongodb_client_pool, mongodb_client);
+  return success;
+}
+
+bool UsernameFilter::Warmup(mongoc_client_pool_t *mongodb_client_pool) {
+  auto start = std::chrono::steady_clock::now();
+  _refresh_since = std::time(nullptr) - USERNAME_FILTER_REFRESH_OVERLAP_S;
+  size_t num_users;
+  if (!Load(mongodb_client_pool, -1, &num_users)) {
+    return false;
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  size_t bytes = _filter.MemoryBytes();
+  LOG(info) << "Username filter warmed up in " << elapsed.count() << " ms: "
+            << num_users << " users, " << bytes << " bytes ("
+            << (num_users ? 8.0 * bytes / num_users : 0.0) << " bits/user) in "
+            << _filter.NumFilters() << " filters";
+  return true;
+}
+
+void UsernameFilter::StartRefresh(mongoc_client_pool_t *mongodb_client_pool,
+                                  int interval_ms) {
+  int64_t since = _refresh_since;
+  std::thread([this, mongodb_client_pool, interval_ms, since]() mutable {
+    bool full = false;
+    while (true) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+      int64_t next_since =
+          std::time(nullptr) - USERNAME_FILTER_REFRESH_OVERLAP_S;
+      size_t num_users;
+      if (Load(mongodb_client_pool, since, &num_users)) {
+        LOG(debug) << "Username filter refreshed with " << num_users
+                   << " users";
+        since = next_since;
+      }
+      if (!full && _filter.ExpectedErrorRate() == 0) {
+        full = true;
+        LOG(warning) << "Username filter reached its memory limit, its "
+                        "false-positive rate is no longer bounded";
+      }
+    }
+  }).detach();
+}
+
+}  // namespace social_network
+
+#endif  // SOCIAL_NETWORK_MICROSERVICES_USERNAMEFILTER_H
@@ -0,0 +1,63 @@
+#ifndef SOCIAL_NETWORK_MICROSERVICES_SRC_UTILS_MACHINE_ID_H_
+#define SOCIAL_NETWORK_MICROSERVICES_SRC_UTILS_MACHINE_ID_H_
+
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "logger.h"
+
+namespace social_network {
+
+/*
+ * The following code which obtaines machine ID from machine's MAC address was
+ * inspired from https://stackoverflow.com/a/16859693.
+ *
+ * MAC address is obtained from /sys/class/net/<netif>/address
+ */
+u_int16_t HashMacAddressPid(const std::string &mac) {
+  u_int16_t hash = 0;
+  std::string mac_pid = mac + std::to_string(getpid());
+  for (unsigned int i = 0; i < mac_pid.size(); i++) {
+    hash += (mac[i] << ((i & 1) * 8));
+  }
+  return hash;
+}
+
+std::string GetMachineId(std::string &netif) {
+  std::string mac_hash;
+
+  std::string mac_addr_filename = "/sys/class/net/" + netif + "/address";
+  std::ifstream mac_addr_file;
+  mac_addr_file.open(mac_addr_filename);
+  if (!mac_addr_file) {
+    LOG(fatal) << "Cannot read MAC address from net interface " << netif;
+    return "";
+  }
+  std::string mac;
+  mac_addr_file >> mac;
+  if (mac == "") {
+    LOG(fatal) << "Cannot read MAC address from net interface " << netif;
+    return "";
+  }
+  mac_addr_file.close();
+
+  LOG(info) << "MAC address = " << mac;
+
+  std::stringstream stream;
+  stream << std::hex << HashMacAddressPid(mac);
+  mac_hash = stream.str();
+
+  if (mac_hash.size() > 3) {
+    mac_hash.erase(0, mac_hash.size() - 3);
+  } else if (mac_hash.size() < 3) {
+    mac_hash = std::string(3 - mac_hash.size(), '0') + mac_hash;
+  }
+  return mac_hash;
+}
+
+}  // namespace social_network
+
+#endif  // SOCIAL_NETWORK_MICROSERVICES_SRC_UTILS_MACHINE_ID_H_
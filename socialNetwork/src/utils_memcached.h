@@ -4,25 +4,66 @@
 #include <libmemcached/memcached.h>
 #include <libmemcached/util.h>
 
+#include <stdexcept>
+
 namespace social_network {
 
+// "<service>-memcached" names either one server, with "addr" and "port", or
+// several, with "servers": a list of {"addr", "port", "weight"} objects whose
+// port defaults to "port" and weight to 1. Keys are spread over several
+// servers with weighted ketama consistent hashing, so adding or removing a
+// server only remaps its share of the keys. A server that fails
+// "failure_limit" times in a row is ejected from the ring and retried after
+// "retry_timeout_s"; its keys are served by the others in the meantime.
+// memcached_mget() sends the keys of every server at once, without blocking,
+// and memcached_fetch() returns the values as the servers answer.
 memcached_pool_st *init_memcached_client_pool(
     const json &config_json,
     const std::string &service_name,
     uint32_t min_size,
     uint32_t max_size
 ) {
-  std::string addr = config_json[service_name + "-memcached"]["addr"];
-  int port = config_json[service_name + "-memcached"]["port"];
-  int use_binary_protocol = config_json[service_name + "-memcached"]["binary_protocol"];
-  std::string config_str = "--SERVER=" + addr + ":" + std::to_string(port);
-  auto memcached_client = memcached(config_str.c_str(), config_str.length());
+  auto &config = config_json[service_name + "-memcached"];
+  int port = config.value("port", 11211);
+  int use_binary_protocol = config["binary_protocol"];
+  auto memcached_client = memcached_create(nullptr);
+  memcached_return_t rc;
+  if (config.find("servers") != config.end()) {
+    for (auto &server : config["servers"]) {
+      std::string server_addr = server["addr"];
+      rc = memcached_server_add_with_weight(
+          memcached_client, server_addr.c_str(), server.value("port", port),
+          server.value("weight", 1));
+      if (rc != MEMCACHED_SUCCESS) {
+        throw std::invalid_argument(
+            "Cannot add memcached server " + server_addr + " of " +
+            service_name + ": " + memcached_strerror(memcached_client, rc));
+      }
+    }
+  } else {
+    std::string addr = config["addr"];
+    memcached_server_add(memcached_client, addr.c_str(), port);
+  }
   memcached_behavior_set(memcached_client, MEMCACHED_BEHAVIOR_NO_BLOCK, 1);
   memcached_behavior_set(memcached_client, MEMCACHED_BEHAVIOR_TCP_NODELAY, 1);
   if (use_binary_protocol == 1) {
     memcached_behavior_set(memcached_client, MEMCACHED_BEHAVIOR_BINARY_PROTOCOL, 1);
   }
+  if (memcached_server_count(memcached_client) > 1) {
+    memcached_behavior_set(
+        memcached_client, MEMCACHED_BEHAVIOR_KETAMA_WEIGHTED, 1);
+    memcached_behavior_set(
+        memcached_client, MEMCACHED_BEHAVIOR_SERVER_FAILURE_LIMIT,
+        config.value("failure_limit", 2));
+    memcached_behavior_set(
+        memcached_client, MEMCACHED_BEHAVIOR_RETRY_TIMEOUT,
+        config.value("retry_timeout_s", 5));
+    memcached_behavior_set(
+        memcached_client, MEMCACHED_BEHAVIOR_REMOVE_FAILED_SERVERS, 1);
+  }
 
+  // Each pooled client is a clone, and tracks the failures of the servers
+  // on its own.
   auto memcached_client_pool =
       memcached_pool_create(memcached_client, min_size, max_size);
   return memcached_client_pool;
@@ -4,21 +4,104 @@
 #include <mongoc.h>
 #include <bson/bson.h>
 
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #define SERVER_SELECTION_TIMEOUT_MS 300
 
 namespace social_network {
 
+// The read preferences of the read-only paths on each pool, that tolerate
+// stale reads. Pools without an entry read from the primary.
+std::map<mongoc_client_pool_t *, mongoc_read_prefs_t *> &
+mongodb_stale_read_prefs() {
+  static std::map<mongoc_client_pool_t *, mongoc_read_prefs_t *> read_prefs;
+  return read_prefs;
+}
+
+std::mutex &mongodb_stale_read_prefs_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// For the reads of a pool that may be served by a secondary, such as cache
+// misses and timeline rebuilds: pass to mongoc_collection_find_with_opts().
+// nullptr, that is the primary, unless "<service>-mongodb" sets
+// "read_preference".
+const mongoc_read_prefs_t *get_stale_read_prefs(
+    mongoc_client_pool_t *client_pool) {
+  std::lock_guard<std::mutex> lock(mongodb_stale_read_prefs_mutex());
+  auto &read_prefs = mongodb_stale_read_prefs();
+  auto it = read_prefs.find(client_pool);
+  return it == read_prefs.end() ? nullptr : it->second;
+}
+
+// "read_preference" is a MongoDB read preference mode, such as
+// "secondaryPreferred", and "max_staleness_s" the maxStalenessSeconds of
+// the secondaries it may read from, at least 90, or -1 for no bound.
+mongoc_read_prefs_t *init_mongodb_stale_read_prefs(
+    const json &config) {
+  std::string mode_name = config.value("read_preference", "primary");
+  mongoc_read_mode_t mode;
+  if (mode_name == "primary") {
+    return nullptr;
+  } else if (mode_name == "primaryPreferred") {
+    mode = MONGOC_READ_PRIMARY_PREFERRED;
+  } else if (mode_name == "secondary") {
+    mode = MONGOC_READ_SECONDARY;
+  } else if (mode_name == "secondaryPreferred") {
+    mode = MONGOC_READ_SECONDARY_PREFERRED;
+  } else if (mode_name == "nearest") {
+    mode = MONGOC_READ_NEAREST;
+  } else {
+    throw std::invalid_argument("Unknown MongoDB read preference " +
+                                mode_name);
+  }
+  int64_t max_staleness_s = config.value("max_staleness_s", -1);
+  if (max_staleness_s != MONGOC_NO_MAX_STALENESS &&
+      max_staleness_s < MONGOC_SMALLEST_MAX_STALENESS_SECONDS) {
+    throw std::invalid_argument(
+        "max_staleness_s must be at least " +
+        std::to_string(MONGOC_SMALLEST_MAX_STALENESS_SECONDS) + ", or -1");
+  }
+  mongoc_read_prefs_t *read_prefs = mongoc_read_prefs_new(mode);
+  mongoc_read_prefs_set_max_staleness_seconds(read_prefs, max_staleness_s);
+  return read_prefs;
+}
+
 mongoc_client_pool_t* init_mongodb_client_pool(
     const json &config_json,
     const std::string &service_name,
     uint32_t max_size
 ) {
-  std::string addr = config_json[service_name + "-mongodb"]["addr"];
-  int port = config_json[service_name + "-mongodb"]["port"];
-  std::string uri_str = "mongodb://" + addr + ":" +
-      std::to_string(port) + "/?appname=" + service_name + "-service";
+  auto &config = config_json[service_name + "-mongodb"];
+  std::string addr = config["addr"];
+  int port = config["port"];
+  std::string hosts = addr + ":" + std::to_string(port);
+  std::string replica_set = config.value("replica_set", "");
+  if (!replica_set.empty()) {
+    // addr lists the members, the port of those without one being port
+    hosts.clear();
+    std::istringstream members(addr);
+    std::string member;
+    while (std::getline(members, member, ',')) {
+      hosts += (hosts.empty() ? "" : ",") + member;
+      if (member.find(':') == std::string::npos) {
+        hosts += ":" + std::to_string(port);
+      }
+    }
+  }
+  std::string uri_str = "mongodb://" + hosts + "/?appname=" + service_name +
+      "-service";
   uri_str += "&" MONGOC_URI_SERVERSELECTIONTIMEOUTMS "="
       + std::to_string(SERVER_SELECTION_TIMEOUT_MS);
+  if (!replica_set.empty()) {
+    uri_str += "&" MONGOC_URI_REPLICASET "=" + replica_set;
+  }
 
   mongoc_init();
   bson_error_t error;
@@ -42,6 +125,11 @@ mongoc_client_pool_t* init_mongodb_client_pool(
 
     mongoc_client_pool_t *client_pool= mongoc_client_pool_new(mongodb_uri);
     mongoc_client_pool_max_size(client_pool, max_size);
+    mongoc_read_prefs_t *read_prefs = init_mongodb_stale_read_prefs(config);
+    if (read_prefs) {
+      std::lock_guard<std::mutex> lock(mongodb_stale_read_prefs_mutex());
+      mongodb_stale_read_prefs()[client_pool] = read_prefs;
+    }
     return client_pool;
   }
 }
@@ -83,6 +171,92 @@ bool CreateIndex(
   return r;
 }
 
+bool CreateCompoundIndex(
+    mongoc_client_t *client,
+    const std::string &db_name,
+    const std::string &collection_name,
+    const std::vector<std::string> &keys,
+    bool unique) {
+  mongoc_database_t *db;
+  bson_t index_keys;
+  char *index_name;
+  bson_t *create_indexes;
+  bson_t reply;
+  bson_error_t error;
+  bool r;
+
+  db = mongoc_client_get_database(client, db_name.c_str());
+  bson_init (&index_keys);
+  for (auto &key : keys) {
+    BSON_APPEND_INT32(&index_keys, key.c_str(), 1);
+  }
+  index_name = mongoc_collection_keys_to_index_string(&index_keys);
+  create_indexes = BCON_NEW (
+      "createIndexes", BCON_UTF8(collection_name.c_str()),
+      "indexes", "[", "{",
+          "key", BCON_DOCUMENT (&index_keys),
+          "name", BCON_UTF8 (index_name),
+          "unique", BCON_BOOL(unique),
+      "}", "]");
+  r = mongoc_database_write_command_with_opts (
+      db, create_indexes, NULL, &reply, &error);
+  if (!r) {
+    LOG(error) << "Error in createIndexes: " << error.message;
+  }
+  bson_free (index_name);
+  bson_destroy (&reply);
+  bson_destroy (create_indexes);
+  bson_destroy (&index_keys);
+  mongoc_database_destroy(db);
+
+  return r;
+}
+
+// Single-pass traversal of a BSON array of sub-documents such as
+// "followers" or "posts". visitor(&element, idx) is called with an iterator
+// positioned inside each element document, in array order, until the array
+// ends, an element is not a document, or the visitor returns false. Unlike
+// looking up "<array_key>.<idx>.<field>" with bson_iter_find_descendant for
+// every index, this is linear in the length of the array.
+template <class Visitor>
+int ForEachArrayDocument(
+    const bson_t *doc,
+    const char *array_key,
+    Visitor visitor) {
+  bson_iter_t iter;
+  bson_iter_t array_iter;
+  bson_iter_t element_iter;
+  if (!bson_iter_init_find(&iter, doc, array_key) ||
+      !BSON_ITER_HOLDS_ARRAY(&iter) ||
+      !bson_iter_recurse(&iter, &array_iter)) {
+    return 0;
+  }
+  int idx = 0;
+  while (bson_iter_next(&array_iter)) {
+    if (!BSON_ITER_HOLDS_DOCUMENT(&array_iter) ||
+        !bson_iter_recurse(&array_iter, &element_iter) ||
+        !visitor(&element_iter, idx)) {
+      break;
+    }
+    idx++;
+  }
+  return idx;
+}
+
+// Reads the int64 field `key` of the element document passed to a
+// ForEachArrayDocument visitor.
+bool GetInt64Field(
+    const bson_iter_t *element_iter,
+    const char *key,
+    int64_t *value) {
+  bson_iter_t iter = *element_iter;
+  if (!bson_iter_find(&iter, key) || !BSON_ITER_HOLDS_INT64(&iter)) {
+    return false;
+  }
+  *value = bson_iter_int64(&iter);
+  return true;
+}
+
 } // namespace social_network
 
 #endif //SOCIAL_NETWORK_MICROSERVICES_SRC_UTILS_MONGODB_H_
@@ -2,7 +2,15 @@
 #define SOCIAL_NETWORK_MICROSERVICES_SRC_UTILS_REDIS_H_
 
 #include <sw/redis++/redis++.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace sw::redis;
 namespace social_network {
@@ -76,6 +84,180 @@ Redis init_redis_replica_client_pool(
     return Redis(connection_options, pool_options);
 }
 
+// One connection pool per read replica: those listed under "servers" in the
+// service_name block, each with an "addr" and a "port" defaulting to the
+// block's, or the block's own "addr" and "port".
+std::vector<Redis> init_redis_replica_client_pools(
+    const json &config_json,
+    const std::string &service_name
+) {
+  std::vector<Redis> pools;
+  auto &config = config_json[service_name];
+  if (config.find("servers") == config.end()) {
+    pools.emplace_back(init_redis_replica_client_pool(config_json, service_name));
+    return pools;
+  }
+  for (auto &server : config["servers"]) {
+    json replica_config = config_json;
+    replica_config[service_name]["addr"] = server["addr"];
+    replica_config[service_name]["port"] =
+        server.value("port", config["port"].get<int>());
+    pools.emplace_back(
+        init_redis_replica_client_pool(replica_config, service_name));
+  }
+  return pools;
+}
+
+// Spreads reads over the Redis read replicas. Each read goes to the replica
+// with the fewest reads in flight, trying them from a different one each
+// time, so that ties rotate:
+//
+//   auto replica = redis_replicas->Acquire();
+//   replica->zrevrange(key, start, stop, std::back_inserter(members));
+class RedisReplicas {
+ private:
+  struct Replica {
+    explicit Replica(Redis &&redis) : pool(std::move(redis)), in_flight(0) {}
+    Redis pool;
+    std::atomic<int> in_flight;
+  };
+
+ public:
+  // Holds a replica and counts a read in flight on it until destroyed.
+  class Lease {
+   public:
+    explicit Lease(Replica *replica)
+        : _replica(replica) {}
+    Lease(Lease &&other) : _replica(other._replica) {
+      other._replica = nullptr;
+    }
+    Lease(const Lease &) = delete;
+    Lease &operator=(const Lease &) = delete;
+    ~Lease() {
+      if (_replica) {
+        _replica->in_flight.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+
+    Redis *operator->() const { return &_replica->pool; }
+
+   private:
+    Replica *_replica;
+  };
+
+  explicit RedisReplicas(std::vector<Redis> &&pools) : _next(0) {
+    for (auto &pool : pools) {
+      _replicas.emplace_back(new Replica(std::move(pool)));
+    }
+  }
+
+  std::size_t size() const { return _replicas.size(); }
+
+  Lease Acquire() {
+    std::size_t n = _replicas.size();
+    std::size_t first = _next.fetch_add(1, std::memory_order_relaxed) % n;
+    auto *least = _replicas[first].get();
+    int least_in_flight = least->in_flight.load(std::memory_order_relaxed);
+    for (std::size_t i = 1; i < n && least_in_flight > 0; ++i) {
+      auto *replica = _replicas[(first + i) % n].get();
+      int in_flight = replica->in_flight.load(std::memory_order_relaxed);
+      if (in_flight < least_in_flight) {
+        least = replica;
+        least_in_flight = in_flight;
+      }
+    }
+    least->in_flight.fetch_add(1, std::memory_order_relaxed);
+    return Lease(least);
+  }
+
+ private:
+  std::vector<std::unique_ptr<Replica>> _replicas;
+  std::atomic<std::size_t> _next;
+};
+
+// Batches commands on keys that may be served by different Redis Cluster
+// nodes. Commands are grouped by the node owning each key's hash slot, every
+// node gets a single pipeline, the pipelines are executed concurrently, and
+// the replies are read back in the order the commands were added:
+//
+//   ClusterPipeline pipe(redis_cluster);
+//   for (auto &key : keys) {
+//     pipe.Add(key, [&](Pipeline &p) { p.zadd(key, member, score); });
+//   }
+//   auto replies = pipe.Exec();
+//   long long added = replies.get<long long>(0);
+class ClusterPipeline {
+ public:
+  class Replies {
+   public:
+    std::size_t size() const { return _index.size(); }
+
+    template <typename Result>
+    Result get(std::size_t idx) {
+      auto &pos = _index[idx];
+      return _node_replies[pos.first].template get<Result>(pos.second);
+    }
+
+   private:
+    friend class ClusterPipeline;
+    std::vector<QueuedReplies> _node_replies;
+    std::vector<std::pair<std::size_t, std::size_t>> _index;
+  };
+
+  explicit ClusterPipeline(RedisCluster *redis_cluster)
+      : _redis_cluster(redis_cluster) {}
+
+  // Queues the command added by add_command on the pipeline of the node that
+  // serves key. add_command must add exactly one command, on key itself or on
+  // a key with the same hash tag.
+  template <typename AddCommand>
+  ClusterPipeline &Add(const std::string &key, AddCommand &&add_command) {
+    auto pool = _redis_cluster->get_shards_pool()->fetch(key);
+    auto node_it = _nodes.find(pool);
+    std::size_t node;
+    if (node_it == _nodes.end()) {
+      node = _pipes.size();
+      _nodes.emplace(pool, node);
+      _pipes.emplace_back(new Pipeline(_redis_cluster->pipeline(key, false)));
+      _num_commands.push_back(0);
+    } else {
+      node = node_it->second;
+    }
+    add_command(*_pipes[node]);
+    _index.emplace_back(node, _num_commands[node]++);
+    return *this;
+  }
+
+  std::size_t size() const { return _index.size(); }
+
+  // Sends all queued commands, one round trip per node, and waits for every
+  // node. Throws the first redis++ Error raised by any node.
+  Replies Exec() {
+    std::vector<std::future<QueuedReplies>> node_execs;
+    for (std::size_t node = 1; node < _pipes.size(); ++node) {
+      node_execs.emplace_back(std::async(
+          std::launch::async, [this, node]() { return _pipes[node]->exec(); }));
+    }
+    Replies replies;
+    if (!_pipes.empty()) {
+      replies._node_replies.emplace_back(_pipes[0]->exec());
+    }
+    for (auto &node_exec : node_execs) {
+      replies._node_replies.emplace_back(node_exec.get());
+    }
+    replies._index = std::move(_index);
+    _index.clear();
+    std::fill(_num_commands.begin(), _num_commands.end(), 0);
+    return replies;
+  }
+
+ private:
+  RedisCluster *_redis_cluster;
+  std::map<std::shared_ptr<ConnectionPool>, std::size_t> _nodes;
+  std::vector<std::unique_ptr<Pipeline>> _pipes;
+  std::vector<std::size_t> _num_commands;
+  std::vector<std::pair<std::size_t, std::size_t>> _index;
+};
 
 } // namespace social_network
 
@@ -1,15 +1,29 @@
 #ifndef SOCIAL_NETWORK_MICROSERVICES_SRC_UTILS_THRIFT_H_
 #define SOCIAL_NETWORK_MICROSERVICES_SRC_UTILS_THRIFT_H_
 
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <nlohmann/json.hpp>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
 #include <thrift/transport/TServerSocket.h>
 #include <thrift/transport/TSSLSocket.h>
 #include <thrift/transport/TSSLServerSocket.h>
 
+#include "ResumableSSLSocket.h"
+#include "PooledFramedTransport.h"
+
 namespace social_network{
 using json = nlohmann::json;
+using apache::thrift::protocol::TBinaryProtocolFactoryT;
+using apache::thrift::protocol::TCompactProtocolFactoryT;
+using apache::thrift::protocol::TProtocol;
+using apache::thrift::protocol::TProtocolFactory;
 using apache::thrift::transport::TServerSocket;
+using apache::thrift::transport::TTransport;
 using apache::thrift::transport::TSSLServerSocket;
 using apache::thrift::transport::TSSLSocketFactory;
 
@@ -21,8 +35,8 @@ std::shared_ptr<TServerSocket> get_server_socket(const json &config_json, const
     std::string ca_path = config_json["ssl"]["caPath"];
     std::string ciphers = config_json["ssl"]["ciphers"];
 
-    std::shared_ptr<TSSLSocketFactory> ssl_socket_factory;
-    ssl_socket_factory = std::make_shared<TSSLSocketFactory>();
+    std::shared_ptr<ResumableSSLSocketFactory> ssl_socket_factory;
+    ssl_socket_factory = std::make_shared<ResumableSSLSocketFactory>();
     ssl_socket_factory->loadCertificate(cert_path.c_str());
     ssl_socket_factory->loadPrivateKey(key_path.c_str());
     ssl_socket_factory->ciphers(ciphers);
@@ -30,11 +44,123 @@ std::shared_ptr<TServerSocket> get_server_socket(const json &config_json, const
     //   ssl_socket_factory->loadTrustedCertificates(ca_path.c_str());
     //   ssl_socket_factory->authenticate(true);
     // }
+    if (config_json["ssl"].value("sessionResumption", true) &&
+        !ssl_socket_factory->EnableServerResumption(
+            "social-network", config_json["ssl"].value("sessionTimeoutS", 300),
+            config_json["ssl"].value("sessionTicketKeyPath", ""))) {
+      LOG(fatal) << "Failed to enable TLS session resumption";
+      exit(EXIT_FAILURE);
+    }
+    ResumableSSLSocketFactory::StartStatsLogger(
+        ssl_socket_factory, config_json["ssl"].value("statsIntervalMs", 60000));
     return std::make_shared<TSSLServerSocket>(address, port, ssl_socket_factory);
   }
   return std::make_shared<TServerSocket>(address, port);
 };
 
+// "thrift" -> "protocol": "binary" (the default) or "compact". Clients and
+// servers must agree, including the nginx Lua clients ("thrift_protocol" in
+// nginx.conf).
+std::string get_protocol_name(const json &config_json) {
+  auto thrift = config_json.find("thrift");
+  std::string protocol = "binary";
+  if (thrift != config_json.end()) {
+    protocol = thrift->value("protocol", protocol);
+  }
+  if (protocol != "binary" && protocol != "compact") {
+    throw std::invalid_argument("Unknown Thrift protocol " + protocol);
+  }
+  return protocol;
+}
+
+// The protocols read and write PooledFramedTransport without virtual calls,
+// and TBinaryProtocol borrows strings from its frame buffer.
+std::shared_ptr<TProtocolFactory> get_protocol_factory(
+    const json &config_json) {
+  if (get_protocol_name(config_json) == "compact") {
+    return std::make_shared<TCompactProtocolFactoryT<PooledFramedTransport>>();
+  }
+  return std::make_shared<TBinaryProtocolFactoryT<PooledFramedTransport>>();
+}
+
+std::shared_ptr<TProtocol> get_protocol(
+    const json &config_json, std::shared_ptr<TTransport> transport) {
+  return get_protocol_factory(config_json)->getProtocol(transport);
+}
+
+// "thrift" -> "compression": frames of at least threshold_bytes are
+// compressed with codec, "lz4" or "zstd", on connections between processes
+// that both enable it. Read on first use; nullptr with "none", the default.
+std::shared_ptr<FrameCompression> get_frame_compression(
+    const json &config_json) {
+  static std::shared_ptr<FrameCompression> compression =
+      [&config_json]() -> std::shared_ptr<FrameCompression> {
+    auto thrift = config_json.find("thrift");
+    if (thrift == config_json.end() ||
+        thrift->find("compression") == thrift->end()) {
+      return nullptr;
+    }
+    auto &config = (*thrift)["compression"];
+    std::string codec_name = config.value("codec", "none");
+    FrameCodec codec;
+    if (codec_name == "none") {
+      return nullptr;
+    } else if (codec_name == "lz4") {
+      codec = FrameCodec::LZ4;
+    } else if (codec_name == "zstd") {
+      codec = FrameCodec::ZSTD;
+    } else {
+      throw std::invalid_argument("Unknown Thrift compression codec " +
+                                  codec_name);
+    }
+    auto frame_compression = std::make_shared<FrameCompression>(
+        codec, config.value("threshold_bytes", 4096),
+        config.value("zstd_level", 1));
+    int interval_ms = config.value("metrics_interval_ms", 60000);
+    std::thread([frame_compression, codec_name, interval_ms]() {
+      while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        auto stats = frame_compression->GetStats();
+        if (stats.frames_compressed + stats.frames_incompressible +
+                stats.frames_decompressed == 0) {
+          continue;
+        }
+        uint64_t sent = stats.frames_compressed + stats.frames_incompressible;
+        LOG(info) << "Thrift " << codec_name << " compression: "
+                  << stats.frames_compressed << " frames compressed, "
+                  << stats.bytes_in << " -> " << stats.bytes_out << " bytes ("
+                  << (stats.bytes_in ? 100 * stats.bytes_out / stats.bytes_in
+                                     : 0)
+                  << "%), " << stats.frames_incompressible
+                  << " incompressible, "
+                  << (sent ? stats.compress_ns / 1000 / sent : 0)
+                  << " us/frame; " << stats.frames_decompressed
+                  << " frames decompressed, "
+                  << (stats.frames_decompressed
+                          ? stats.decompress_ns / 1000 /
+                                stats.frames_decompressed
+                          : 0)
+                  << " us/frame";
+      }
+    }).detach();
+    return frame_compression;
+  }();
+  return compression;
+}
+
+// Transports of the servers, and of clients, which offer compression first
+std::shared_ptr<TTransportFactory> get_transport_factory(
+    const json &config_json) {
+  return std::make_shared<PooledFramedTransportFactory>(
+      get_frame_compression(config_json));
+}
+
+std::shared_ptr<TTransport> get_client_transport(
+    const json &config_json, std::shared_ptr<TTransport> socket) {
+  return std::make_shared<PooledFramedTransport>(
+      socket, get_frame_compression(config_json), true);
+}
+
 } //namespace social_network
 
 #endif //SOCIAL_NETWORK_MICROSERVICES_SRC_UTILS_THRIFT_H_
@@ -2,6 +2,7 @@ import sys
 sys.path.append('../gen-py')
 
 import random
+import threading
 from social_network import PostStorageService
 from social_network.ttypes import Media
 from social_network.ttypes import PostType
@@ -68,10 +69,75 @@ def read_posts():
   posts = client.ReadPosts(req_id, post_id, {})
   print(posts)
 
+def read_post_concurrently():
+  # Concurrent memcached misses on one post are served by a single MongoDB
+  # read; every caller must still get the post.
+  post_id = 783799431931478016
+  results = [None] * 16
+
+  def read(i):
+    socket = TSocket.TSocket("ath-8.ece.cornell.edu", 9090)
+    transport = TTransport.TFramedTransport(socket)
+    protocol = TBinaryProtocol.TBinaryProtocol(transport)
+    client = PostStorageService.Client(protocol)
+
+    transport.open()
+    req_id = random.getrandbits(63)
+    results[i] = client.ReadPost(req_id, post_id, {})
+    transport.close()
+
+  threads = [threading.Thread(target=read, args=(i,))
+             for i in range(len(results))]
+  for thread in threads:
+    thread.start()
+  for thread in threads:
+    thread.join()
+  print(results[0])
+  assert all(post == results[0] for post in results)
+  assert results[0].post_id == post_id
+
+def read_posts_overlapping():
+  # Two requests miss the same posts in memcached at once, and each leads the
+  # MongoDB read of some posts the other waits for. The missing post must
+  # fail both with "Return set incomplete" instead of leaving them waiting on
+  # each other until the socket times out.
+  missing_post_id = (1 << 62) + random.getrandbits(32)
+  post_ids = [[783799431931478016, 783799431931547648, missing_post_id],
+              [missing_post_id, 783799431931547648, 783799431931551744]]
+  results = [None, None]
+
+  def read(i):
+    socket = TSocket.TSocket("ath-8.ece.cornell.edu", 9090)
+    socket.setTimeout(10000)
+    transport = TTransport.TFramedTransport(socket)
+    protocol = TBinaryProtocol.TBinaryProtocol(transport)
+    client = PostStorageService.Client(protocol)
+
+    transport.open()
+    req_id = random.getrandbits(63)
+    try:
+      client.ReadPosts(req_id, post_ids[i], {})
+      results[i] = "returned posts"
+    except ServiceException as se:
+      results[i] = se.message
+    except Thrift.TException as tx:
+      results[i] = tx.message
+    transport.close()
+
+  threads = [threading.Thread(target=read, args=(i,)) for i in range(2)]
+  for thread in threads:
+    thread.start()
+  for thread in threads:
+    thread.join()
+  print(results)
+  assert results == ["Return set incomplete", "Return set incomplete"]
+
 
 if __name__ == '__main__':
   try:
     read_posts()
+    read_post_concurrently()
+    read_posts_overlapping()
   except ServiceException as se:
     print('%s' % se.message)
   except Thrift.TException as tx:
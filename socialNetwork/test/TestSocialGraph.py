@@ -1,6 +1,7 @@
 import sys
 sys.path.append('../gen-py')
 
+import threading
 import uuid
 from social_network import SocialGraphService
 
@@ -38,8 +39,57 @@ def main():
 
   transport.close()
 
+def follow_many():
+  socket = TSocket.TSocket("ath-8.ece.cornell.edu", 10000)
+  transport = TTransport.TFramedTransport(socket)
+  protocol = TBinaryProtocol.TBinaryProtocol(transport)
+  client = SocialGraphService.Client(protocol)
+
+  transport.open()
+  req_id = uuid.uuid4().int & (1<<32)
+  client.InsertUsers(req_id, [100, 101, 102], {})
+  # Both calls are idempotent: loading the same edges twice adds nothing.
+  for _ in range(2):
+    client.FollowMany(req_id, [100, 100, 101], [101, 102, 102], {})
+    client.InsertUsers(req_id, [100, 101, 102], {})
+
+  print(client.GetFollowers(req_id, 102, {}))
+  print(client.GetFollowees(req_id, 100, {}))
+  assert sorted(client.GetFollowers(req_id, 102, {})) == [100, 101]
+  assert sorted(client.GetFollowees(req_id, 100, {})) == [101, 102]
+  assert client.GetFollowers(req_id, 100, {}) == []
+
+  transport.close()
+
+def get_followers_concurrently():
+  # Concurrent misses on the same user are served by one MongoDB read; every
+  # caller must still get the whole list.
+  results = [None] * 16
+
+  def get_followers(i):
+    socket = TSocket.TSocket("ath-8.ece.cornell.edu", 10000)
+    transport = TTransport.TFramedTransport(socket)
+    protocol = TBinaryProtocol.TBinaryProtocol(transport)
+    client = SocialGraphService.Client(protocol)
+
+    transport.open()
+    req_id = uuid.uuid4().int & (1<<32)
+    results[i] = sorted(client.GetFollowers(req_id, 102, {}))
+    transport.close()
+
+  threads = [threading.Thread(target=get_followers, args=(i,))
+             for i in range(len(results))]
+  for thread in threads:
+    thread.start()
+  for thread in threads:
+    thread.join()
+  print(results[0])
+  assert results == [[100, 101]] * len(results)
+
 if __name__ == '__main__':
   try:
     main()
+    follow_many()
+    get_followers_concurrently()
   except Thrift.TException as tx:
     print('%s' % tx.message)
\ No newline at end of file
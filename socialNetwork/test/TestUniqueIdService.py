@@ -4,6 +4,7 @@ sys.path.append('../gen-py')
 import uuid
 from social_network import UniqueIdService
 from social_network.ttypes import PostType
+from social_network.ttypes import ServiceException
 
 from thrift import Thrift
 from thrift.transport import TSocket
@@ -21,8 +22,32 @@ def main():
   print(client.UploadUniqueId(req_id, PostType.POST, {}))
   transport.close()
 
+def compose_unique_ids():
+  socket = TSocket.TSocket("ath-8.ece.cornell.edu", 9090)
+  transport = TTransport.TFramedTransport(socket)
+  protocol = TBinaryProtocol.TBinaryProtocol(transport)
+  client = UniqueIdService.Client(protocol)
+
+  transport.open()
+  req_id = uuid.uuid4().int & (1<<32)
+  post_ids = client.ComposeUniqueIds(req_id, PostType.POST, 1000, {})
+  post_ids += client.ComposeUniqueIds(req_id, PostType.POST, 1000, {})
+  post_ids.append(client.ComposeUniqueId(req_id, PostType.POST, {}))
+  print(post_ids[:3])
+  assert len(post_ids) == 2001
+  assert len(set(post_ids)) == len(post_ids)
+
+  for num_ids in [0, 65537]:
+    try:
+      client.ComposeUniqueIds(req_id, PostType.POST, num_ids, {})
+      assert False, "%d post_ids were leased" % num_ids
+    except ServiceException as se:
+      print('%s' % se.message)
+  transport.close()
+
 if __name__ == '__main__':
   try:
     main()
+    compose_unique_ids()
   except Thrift.TException as tx:
     print('%s' % tx.message)
\ No newline at end of file
@@ -24,8 +24,30 @@ def main():
   print(client.UploadUrls(req_id, urls, {}))
   transport.close()
 
+def get_extended_urls():
+  socket = TSocket.TSocket("ath-8.ece.cornell.edu", 9090)
+  transport = TTransport.TFramedTransport(socket)
+  protocol = TBinaryProtocol.TBinaryProtocol(transport)
+  client = UrlShortenService.Client(protocol)
+
+  transport.open()
+  req_id = uuid.uuid4().int & ( 1 << 32 )
+
+  urls = ["https://url_%d.com/%s" % (i, uuid.uuid4().hex) for i in range(3)]
+  shortened_urls = [url.shortened_url for url in
+                    client.ComposeUrls(req_id, urls, {})]
+  # Read twice: from MongoDB on the first call, from memcached after it.
+  for _ in range(2):
+    extended_urls = client.GetExtendedUrls(
+        req_id, shortened_urls + ["http://short-url.com/unknown"], {})
+    print(extended_urls)
+    assert extended_urls == urls + [""]
+  assert client.GetExtendedUrls(req_id, [], {}) == []
+  transport.close()
+
 if __name__ == '__main__':
   try:
     main()
+    get_extended_urls()
   except Thrift.TException as tx:
     print('%s' % tx.message)
\ No newline at end of file
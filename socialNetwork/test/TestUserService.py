@@ -37,9 +37,45 @@ def login():
   # print(client.Login(req_id, "username_2", "password_2", {}))
   transport.close()
 
+def register_users_with_id():
+  socket = TSocket.TSocket("ath-8.ece.cornell.edu", 10005)
+  transport = TTransport.TFramedTransport(socket)
+  protocol = TBinaryProtocol.TBinaryProtocol(transport)
+  client = UserService.Client(protocol)
+  transport.open()
+  req_id = uuid.uuid4().int & 0x7FFFFFFFFFFFFFFF
+  first_id = (uuid.uuid4().int & 0xFFFFFFFF) << 16
+  user_ids = [first_id, first_id + 1, first_id + 2]
+  usernames = ["bulk_username_%d" % user_id for user_id in user_ids]
+  client.RegisterUsersWithId(req_id, ["first_name"] * 3, ["last_name"] * 3,
+    usernames, ["password"] * 3, user_ids, {})
+  print(client.Login(req_id, usernames[2], "password", {}))
+
+  # A username taken by an earlier call fails only its own user.
+  new_user_id = first_id + 3
+  new_username = "bulk_username_%d" % new_user_id
+  try:
+    client.RegisterUsersWithId(req_id, ["first_name"] * 2,
+      ["last_name"] * 2, [usernames[0], new_username], ["password"] * 2,
+      [new_user_id + 1, new_user_id], {})
+    assert False, "%s was registered twice" % usernames[0]
+  except ServiceException as se:
+    print('%s' % se.message)
+    assert se.message == "Users %s already existed" % usernames[0]
+  print(client.Login(req_id, new_username, "password", {}))
+
+  # The lists must describe the same users.
+  try:
+    client.RegisterUsersWithId(req_id, ["first_name"], [], [], [], [], {})
+    assert False, "lists of different lengths were accepted"
+  except ServiceException as se:
+    print('%s' % se.message)
+  transport.close()
+
 if __name__ == '__main__':
   try:
     login()
+    register_users_with_id()
   except ServiceException as se:
     print('%s' % se.message)
   except Thrift.TException as tx:
@@ -12,6 +12,9 @@ local decset = {'1', '2', '3', '4', '5', '6', '7', '8', '9', '0'}
 
 -- load env vars
 local max_user_index = tonumber(os.getenv("max_user_index")) or 962
+-- when set, urls are drawn from this many distinct links instead of being
+-- random, as when popular links are shared over and over
+local num_popular_urls = tonumber(os.getenv("num_popular_urls")) or 0
 
 local function stringRandom(length)
   if length > 0 then
@@ -52,7 +55,12 @@ request = function()
   end
 
   for i = 0, num_urls, 1 do
-    text = text .. " http://" .. stringRandom(64)
+    if num_popular_urls > 0 then
+      text = text .. " http://popular-url/" ..
+          tostring(math.random(1, num_popular_urls))
+    else
+      text = text .. " http://" .. stringRandom(64)
+    end
   end
 
   for i = 0, num_media, 1 do